@@ -0,0 +1,221 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTestUtils.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideBakedLUTs.h"
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideSettings.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "RHI.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideCPULUTReferenceTest, "TonemapOverride.CPU.SIMDMatchesReference", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideCPULUTReferenceTest::RunTest(const FString& Parameters)
+{
+	const int32 LUTSize = 17;
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	const TArray<FPostProcessSettings> Settings = TonemapOverrideTest::GetTestSettings();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (int32 SettingsIndex = 0; SettingsIndex < Settings.Num(); ++SettingsIndex)
+		{
+			FTonemapOverrideCPUTexture3D LUTTexture;
+			FTonemapOverrideLUTSnapshot Snapshot;
+			TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), Settings[SettingsIndex], LUTSize, TonemapOverrideSettings, LUTTexture, Snapshot);
+
+			const FTonemapOverrideCPULUT CPULUT(Snapshot, &LUTTexture);
+
+			TArray<FLinearColor> Texels;
+			CPULUT.Generate(LUTSize, Texels);
+
+			int32 NumMismatchedNaN = 0;
+			const double MaxError = TonemapOverride::MeasureLUTReferenceError(CPULUT, Texels, LUTSize, NumMismatchedNaN);
+
+			const FString Name = TonemapOverrideTest::GetTestName(ECustomTonemapOperator(Operator), SettingsIndex);
+			TestTrue(FString::Printf(TEXT("%s max error %g within %g"), *Name, MaxError, TonemapOverride::CPULUTTolerance), MaxError <= TonemapOverride::CPULUTTolerance);
+			TestEqual(FString::Printf(TEXT("%s NaN mismatches"), *Name), NumMismatchedNaN, 0);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideCPULUTGPUTest, "TonemapOverride.CPU.MatchesGPU", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideCPULUTGPUTest::RunTest(const FString& Parameters)
+{
+	if (!FApp::CanEverRender() || GUsingNullRHI)
+	{
+		AddInfo(TEXT("No GPU, the GPU LUT is not compared"));
+		return true;
+	}
+
+	// Float texture so that only the shader math differs, not the quantization of the runtime format
+	const int32 LUTSize = 17;
+	const EPixelFormat Format = PF_A32B32G32R32F;
+
+	// Encoded output of the GPU LUT against the double reference, and its perceived difference to the CPU LUT
+	const double Tolerance = TonemapOverrideTest::GPULUTTolerance;
+	const double MaxDeltaETolerance = TonemapOverrideTest::GPULUTDeltaETolerance;
+
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	const FTonemapOverrideCompiledPermutations CompiledPermutations = TonemapOverride::GetCompiledPermutations();
+	const TArray<FPostProcessSettings> Settings = TonemapOverrideTest::GetTestSettings();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)) || !CompiledPermutations.IsTonemapOperatorCompiled(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (int32 SettingsIndex = 0; SettingsIndex < Settings.Num(); ++SettingsIndex)
+		{
+			FTonemapOverrideCPUTexture3D LUTTexture;
+			FTonemapOverrideLUTBakeKey Key;
+			Key.Format = Format;
+			TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), Settings[SettingsIndex], LUTSize, TonemapOverrideSettings, LUTTexture, Key.Snapshot);
+
+			const FString Name = TonemapOverrideTest::GetTestName(ECustomTonemapOperator(Operator), SettingsIndex);
+
+			FTonemapOverrideBakedLUT GPULUT;
+			if (!TestTrue(FString::Printf(TEXT("%s GPU LUT read back"), *Name), TonemapOverride::BakeLUT(Key, GPULUT)))
+			{
+				continue;
+			}
+
+			const TConstArrayView<FLinearColor> GPUTexels(reinterpret_cast<const FLinearColor*>(GPULUT.Data.GetData()), LUTSize * LUTSize * LUTSize);
+			const FTonemapOverrideCPULUT CPULUT(Key.Snapshot, &LUTTexture);
+
+			int32 NumMismatchedNaN = 0;
+			const double MaxError = TonemapOverride::MeasureLUTReferenceError(CPULUT, GPUTexels, LUTSize, NumMismatchedNaN);
+
+			// Perceived difference of the GPU and the SIMD CPU LUT, which the CPU LUT path uploads in place of the GPU one
+			TArray<FLinearColor> CPUTexels;
+			CPULUT.Generate(LUTSize, CPUTexels);
+
+			double MaxDeltaE = 0.0;
+			for (int32 Index = 0; Index < CPUTexels.Num(); ++Index)
+			{
+				const double DeltaE = TonemapOverride::DeltaE2000(TonemapOverride::LUTOutputToLab(CPUTexels[Index]), TonemapOverride::LUTOutputToLab(GPUTexels[Index]));
+				MaxDeltaE = FMath::IsFinite(DeltaE) ? FMath::Max(MaxDeltaE, DeltaE) : MaxDeltaE;
+			}
+
+			TestTrue(FString::Printf(TEXT("%s GPU max error %g within %g"), *Name, MaxError, Tolerance), MaxError <= Tolerance);
+			TestTrue(FString::Printf(TEXT("%s GPU max delta E %.4f within %.2f"), *Name, MaxDeltaE, MaxDeltaETolerance), MaxDeltaE <= MaxDeltaETolerance);
+			TestEqual(FString::Printf(TEXT("%s GPU NaN mismatches"), *Name), NumMismatchedNaN, 0);
+		}
+	}
+
+	return true;
+}
+
+namespace
+{
+	// Texel of a LUT encoded in one of the formats the CPU LUT path uploads
+	FLinearColor DecodeLUTTexel(TConstArrayView<uint8> Data, EPixelFormat Format, int32 Index)
+	{
+		if (Format == PF_A2B10G10R10)
+		{
+			const uint32 Packed = reinterpret_cast<const uint32*>(Data.GetData())[Index];
+			return FLinearColor(float(Packed & 1023) / 1023.0f, float((Packed >> 10) & 1023) / 1023.0f, float((Packed >> 20) & 1023) / 1023.0f, 0.0f);
+		}
+
+		return reinterpret_cast<const FFloat16Color*>(Data.GetData())[Index].GetFloats();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideCPULUTUploadTest, "TonemapOverride.CPU.UploadedLUTMatchesGPU", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideCPULUTUploadTest::RunTest(const FString& Parameters)
+{
+	if (!FApp::CanEverRender() || GUsingNullRHI)
+	{
+		AddInfo(TEXT("No GPU, the GPU LUT is not compared"));
+		return true;
+	}
+
+	// Runtime formats of the LUT the CPU LUT path uploads in place of the LUT pass, at the default r.LUT.Size
+	const int32 LUTSize = 32;
+	const EPixelFormat Formats[] = { PF_A2B10G10R10, PF_FloatRGBA };
+
+	// Both against the double reference plus the rounding of the two encodings, one 10 bit code or two half float steps.
+	// Relative above 1 for the float LUT of the HDR captures
+	const double Tolerance = TonemapOverrideTest::GPULUTTolerance + TonemapOverride::CPULUTTolerance + 1.0 / 1023.0;
+
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	const FTonemapOverrideCompiledPermutations CompiledPermutations = TonemapOverride::GetCompiledPermutations();
+	const TArray<FPostProcessSettings> Settings = TonemapOverrideTest::GetTestSettings();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)) || !CompiledPermutations.IsTonemapOperatorCompiled(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (int32 SettingsIndex = 0; SettingsIndex < Settings.Num(); ++SettingsIndex)
+		{
+			for (const EPixelFormat Format : Formats)
+			{
+				FTonemapOverrideCPUTexture3D LUTTexture;
+				FTonemapOverrideLUTBakeKey Key;
+				Key.Format = Format;
+				TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), Settings[SettingsIndex], LUTSize, TonemapOverrideSettings, LUTTexture, Key.Snapshot);
+
+				const FString Name = FString::Printf(TEXT("%s %s"), *TonemapOverrideTest::GetTestName(ECustomTonemapOperator(Operator), SettingsIndex), GPixelFormats[Format].Name);
+
+				FTonemapOverrideBakedLUT CPULUT;
+				FTonemapOverrideBakedLUT GPULUT;
+				if (!TestTrue(FString::Printf(TEXT("%s CPU LUT evaluated"), *Name), TonemapOverride::BakeCPULUT(Key, &LUTTexture, CPULUT))
+					|| !TestTrue(FString::Printf(TEXT("%s GPU LUT read back"), *Name), TonemapOverride::BakeLUT(Key, GPULUT))
+					|| !TestEqual(FString::Printf(TEXT("%s LUT sizes"), *Name), CPULUT.Data.Num(), GPULUT.Data.Num()))
+				{
+					continue;
+				}
+
+				double MaxError = 0.0;
+				int32 NumMismatchedNaN = 0;
+
+				for (int32 Index = 0; Index < LUTSize * LUTSize * LUTSize; ++Index)
+				{
+					const FLinearColor CPUTexel = DecodeLUTTexel(CPULUT.Data, Format, Index);
+					const FLinearColor GPUTexel = DecodeLUTTexel(GPULUT.Data, Format, Index);
+
+					for (int32 Channel = 0; Channel < 3; ++Channel)
+					{
+						const double CPUValue = CPUTexel.Component(Channel);
+						const double GPUValue = GPUTexel.Component(Channel);
+
+						if (FMath::IsFinite(CPUValue) != FMath::IsFinite(GPUValue))
+						{
+							++NumMismatchedNaN;
+						}
+						else if (FMath::IsFinite(CPUValue))
+						{
+							MaxError = FMath::Max(MaxError, FMath::Abs(CPUValue - GPUValue) / FMath::Max(1.0, FMath::Abs(GPUValue)));
+						}
+					}
+				}
+
+				TestTrue(FString::Printf(TEXT("%s max error %g within %g"), *Name, MaxError, Tolerance), MaxError <= Tolerance);
+				TestEqual(FString::Printf(TEXT("%s NaN mismatches"), *Name), NumMismatchedNaN, 0);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideLUTBenchmark.h"
+#include "TonemapOverrideSettings.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/DateTime.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	const FTonemapOverrideBenchmarkResult* FindResult(TConstArrayView<FTonemapOverrideBenchmarkResult> Results, const FString& Operator, const TCHAR* Layout, int32 LUTSize, const TCHAR* Stage)
+	{
+		return Results.FindByPredicate([&](const FTonemapOverrideBenchmarkResult& Result)
+		{
+			return Result.Operator == Operator && Result.Layout == Layout && Result.LUTSize == LUTSize && Result.Stage == Stage;
+		});
+	}
+}
+
+// Same run as the TonemapOverrideBenchmark commandlet, so that the timings are tracked with the other automation performance tests
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideLUTBenchmarkTest, "TonemapOverride.Perf.LUTBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FTonemapOverrideLUTBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FTonemapOverrideBenchmarkOptions Options;
+
+	TArray<FTonemapOverrideBenchmarkResult> Results;
+	TonemapOverride::RunLUTBenchmark(Options, Results);
+
+	const UEnum* OperatorEnum = StaticEnum<ECustomTonemapOperator>();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		const FString OperatorName = OperatorEnum->GetNameStringByValue(Operator);
+
+		for (const int32 LUTSize : Options.LUTSizes)
+		{
+			for (const TCHAR* Layout : { TEXT("Volume"), TEXT("2D") })
+			{
+				const FTonemapOverrideBenchmarkResult* CacheUpdate = FindResult(Results, OperatorName, Layout, LUTSize, TEXT("CacheUpdate"));
+				const FTonemapOverrideBenchmarkResult* LegacyUpdate = FindResult(Results, OperatorName, Layout, LUTSize, TEXT("LegacyUpdate"));
+				const FString Context = FString::Printf(TEXT("%s %s %d"), *OperatorName, Layout, LUTSize);
+
+				if (!TestNotNull(*(Context + TEXT(" CacheUpdate")), CacheUpdate) || !TestNotNull(*(Context + TEXT(" LegacyUpdate")), LegacyUpdate))
+				{
+					continue;
+				}
+
+				if (FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+				{
+					TestNotNull(*(Context + TEXT(" CPU")), FindResult(Results, OperatorName, Layout, LUTSize, TEXT("CPU")));
+				}
+
+				// Timings vary with the machine load, a slower snapshot is reported but does not fail the test
+				if (CacheUpdate->MedianMs > LegacyUpdate->MedianMs)
+				{
+					AddWarning(FString::Printf(TEXT("%s: CacheUpdate median %.4f ms is slower than LegacyUpdate %.4f ms"), *Context, CacheUpdate->MedianMs, LegacyUpdate->MedianMs));
+				}
+			}
+		}
+	}
+
+	for (const FTonemapOverrideBenchmarkResult& Result : Results)
+	{
+		AddInfo(FString::Printf(TEXT("%s %s %d %s: min %.4f median %.4f p99 %.4f ms"), *Result.Operator, *Result.Layout, Result.LUTSize, *Result.Stage, Result.MinMs, Result.MedianMs, Result.P99Ms));
+	}
+
+	TestTrue(TEXT("Results written"), TonemapOverride::WriteLUTBenchmarkResults(Results, TonemapOverride::GetLUTBenchmarkDir(), FString::Printf(TEXT("Automation_%s"), *FDateTime::Now().ToString())));
+
+	return true;
+}
+
+#endif
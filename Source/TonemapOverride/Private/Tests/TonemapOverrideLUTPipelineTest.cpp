@@ -0,0 +1,246 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTestUtils.h"
+#include "TonemapOverrideEngineSubsystem.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideSettings.h"
+#include "Engine/Engine.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "GlobalShader.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "RenderGraphBuilder.h"
+#include "RenderingThread.h"
+#include "RHI.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// LUT pass of one permutation, with what the render thread saw when it was added
+	struct FLUTPassCase
+	{
+		const FPostProcessSettings* Settings = nullptr;
+		FTonemapperOutputDeviceParameters OutputDevice;
+		EPixelFormat Format = PF_Unknown;
+		// GT7 UCS set on the snapshot, -1 keeps the one of the settings
+		int32 UCSType = -1;
+		FString Name;
+
+		ECustomTonemapOperator Operator = ECustomTonemapOperator::MAX;
+		bool bFastMath = false;
+		bool bSeparableCurve = false;
+		int32 NumOnDemand = -1;
+	};
+
+	// Current priority, so that a value set from the console or an ini is not left behind at a higher one
+	int32 SetConsoleVariable(const TCHAR* Name, int32 Value)
+	{
+		IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+		if (!CVar)
+		{
+			return Value;
+		}
+
+		const int32 PreviousValue = CVar->GetInt();
+		CVar->SetWithCurrentPriority(Value);
+		return PreviousValue;
+	}
+
+	// Add the LUT pass of every case on the render thread the way the view extension does and wait for it
+	void AddLUTPasses(TArray<FLUTPassCase>& Cases, bool bUseComputePass, int32 LUTSize)
+	{
+		ENQUEUE_RENDER_COMMAND(TonemapOverrideTestLUTPasses)(
+			[&Cases, bUseComputePass, LUTSize](FRHICommandListImmediate& RHICmdList)
+			{
+				const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+				const bool bUseVolumeTextureLUT = TonemapOverride::IsVolumeTextureLUTSupported(GMaxRHIShaderPlatform);
+
+				for (FLUTPassCase& Case : Cases)
+				{
+					FTonemapOverrideLUTSnapshot Snapshot;
+					TonemapOverride::BuildLUTSnapshot(*Case.Settings, Case.OutputDevice, FLinearColor::White, FLinearColor::Transparent, LUTSize, RenderSettings, Snapshot);
+					if (Case.UCSType >= 0)
+					{
+						Snapshot.GT7UCSType = uint32(Case.UCSType);
+					}
+
+					Case.Operator = Snapshot.GetTonemapOperator();
+					Case.bFastMath = Snapshot.bFastMath != 0;
+					Case.bSeparableCurve = Snapshot.bSeparableCurve != 0;
+
+					FRDGBuilder GraphBuilder(RHICmdList);
+					const FRDGTextureDesc Desc = TonemapOverride::GetLUTTextureDesc(LUTSize, bUseVolumeTextureLUT, bUseComputePass, Case.Format);
+					FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, TEXT("TonemapOverride.TestLUT"));
+					TonemapOverride::AddLUTPass(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), Texture, Snapshot, bUseComputePass, bUseVolumeTextureLUT, LUTSize);
+					GraphBuilder.Execute();
+
+					Case.NumOnDemand = TonemapOverride::GetNumOnDemandLUTPipelines();
+				}
+			});
+		FlushRenderingCommands();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideLUTPipelineTest, "TonemapOverride.Rendering.OperatorSwitchUsesPrecachedPipelines", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideLUTPipelineTest::RunTest(const FString& Parameters)
+{
+	if (!FApp::CanEverRender() || GUsingNullRHI)
+	{
+		AddInfo(TEXT("No GPU, the LUT pipelines are not checked"));
+		return true;
+	}
+
+	UTonemapOverrideEngineSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UTonemapOverrideEngineSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("Engine subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	const int32 LUTSize = 16;
+	const FTonemapOverrideCompiledPermutations CompiledPermutations = TonemapOverride::GetCompiledPermutations();
+
+	// Permutation dimensions a graphics quality menu or a display change can reach: operator, GT7 UCS, output device and
+	// white balance (graded settings), in the LDR and HDR LUT formats of the engine
+	const FTonemapperOutputDeviceParameters OutputDevices[] =
+	{
+		TonemapOverride::GetDefaultOutputDeviceParameters(),
+		TonemapOverride::GetDefaultOutputDeviceParameters(EDisplayOutputFormat::HDR_ACES_1000nit_ST2084, EDisplayColorGamut::Rec2020_D65),
+	};
+	const EPixelFormat Formats[] = { PF_A2B10G10R10, PF_FloatRGBA };
+
+	const TArray<FPostProcessSettings> Settings = TonemapOverrideTest::GetTestSettings();
+
+	// The engine picks the pixel shader pass with r.PostProcessing.PreferCompute 0 and where compute is not supported,
+	// the pipelines are precached for the pass of the current setting at startup and level load
+	TArray<bool, TInlineAllocator<2>> ComputePasses = { false };
+	if (IsFeatureLevelSupported(GMaxRHIShaderPlatform, ERHIFeatureLevel::SM5))
+	{
+		ComputePasses.Add(true);
+	}
+
+	const int32 PreviousPreferCompute = SetConsoleVariable(TEXT("r.PostProcessing.PreferCompute"), 1);
+	const int32 PreviousFastMath = SetConsoleVariable(TEXT("r.TonemapOverride.FastMath"), 0);
+	const int32 PreviousSeparableCurve = SetConsoleVariable(TEXT("r.TonemapOverride.SeparableCurve"), 0);
+	const int32 PreviousOperator = SetConsoleVariable(TEXT("r.TonemapOverride.Operator"), -1);
+
+	int32 NumFastMathPasses = 0;
+	int32 NumSeparableCurvePasses = 0;
+	bool bPrecachingOff = false;
+
+	for (const bool bUseComputePass : ComputePasses)
+	{
+		SetConsoleVariable(TEXT("r.PostProcessing.PreferCompute"), bUseComputePass ? 1 : 0);
+		IConsoleManager::Get().CallAllConsoleVariableSinks();
+		TonemapOverride::PrecacheLUTPipelines();
+
+		int32 NumOnDemand = -1;
+		ENQUEUE_RENDER_COMMAND(TonemapOverrideTestGetNumOnDemandLUTPipelines)(
+			[&NumOnDemand](FRHICommandListImmediate& RHICmdList)
+			{
+				NumOnDemand = TonemapOverride::GetNumOnDemandLUTPipelines();
+			});
+		FlushRenderingCommands();
+
+		if (NumOnDemand < 0)
+		{
+			bPrecachingOff = true;
+			break;
+		}
+
+		for (int32 FastMath = 0; FastMath < 2; ++FastMath)
+		{
+			for (int32 SeparableCurve = 0; SeparableCurve < 2; ++SeparableCurve)
+			{
+				SetConsoleVariable(TEXT("r.TonemapOverride.FastMath"), FastMath);
+				SetConsoleVariable(TEXT("r.TonemapOverride.SeparableCurve"), SeparableCurve);
+
+				for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+				{
+					if (!CompiledPermutations.IsTonemapOperatorCompiled(ECustomTonemapOperator(Operator)))
+					{
+						continue;
+					}
+
+					// What a graphics quality menu does, the console variable sink passes the operator to the render settings
+					Subsystem->SetTonemapOperator(ECustomTonemapOperator(Operator));
+					IConsoleManager::Get().CallAllConsoleVariableSinks();
+
+					const int32 NumUCSTypes = ECustomTonemapOperator(Operator) == ECustomTonemapOperator::GT7 ? int32(EGT7UCSType::MAX) : 1;
+
+					TArray<FLUTPassCase> Cases;
+					for (int32 UCSType = 0; UCSType < NumUCSTypes; ++UCSType)
+					{
+						for (int32 OutputDevice = 0; OutputDevice < UE_ARRAY_COUNT(OutputDevices); ++OutputDevice)
+						{
+							for (int32 SettingsIndex = 0; SettingsIndex < Settings.Num(); ++SettingsIndex)
+							{
+								for (const EPixelFormat Format : Formats)
+								{
+									FLUTPassCase& Case = Cases.AddDefaulted_GetRef();
+									Case.Settings = &Settings[SettingsIndex];
+									Case.OutputDevice = OutputDevices[OutputDevice];
+									Case.Format = Format;
+									Case.UCSType = NumUCSTypes > 1 ? UCSType : -1;
+									Case.Name = FString::Printf(TEXT("%s%s, %s, %s, %s pass, fast math %d, separable curve %d"),
+										*TonemapOverrideTest::GetTestName(ECustomTonemapOperator(Operator), SettingsIndex),
+										NumUCSTypes > 1 ? *FString::Printf(TEXT(" %s"), *StaticEnum<EGT7UCSType>()->GetNameStringByValue(UCSType)) : TEXT(""),
+										OutputDevice == 0 ? TEXT("sRGB") : TEXT("ST2084"),
+										GetPixelFormatString(Format),
+										bUseComputePass ? TEXT("CS") : TEXT("PS"),
+										FastMath, SeparableCurve);
+								}
+							}
+						}
+					}
+
+					AddLUTPasses(Cases, bUseComputePass, LUTSize);
+
+					for (const FLUTPassCase& Case : Cases)
+					{
+						TestEqual(FString::Printf(TEXT("%s operator of the render settings"), *Case.Name), int32(Case.Operator), Operator);
+
+						// Each on demand pipeline is counted once, so a failure does not repeat for the following passes
+						TestEqual(FString::Printf(TEXT("%s pipelines created on demand"), *Case.Name), Case.NumOnDemand - NumOnDemand, 0);
+						NumOnDemand = Case.NumOnDemand;
+
+						NumFastMathPasses += Case.bFastMath ? 1 : 0;
+						NumSeparableCurvePasses += Case.bSeparableCurve ? 1 : 0;
+					}
+				}
+			}
+		}
+	}
+
+	SetConsoleVariable(TEXT("r.TonemapOverride.Operator"), PreviousOperator);
+	SetConsoleVariable(TEXT("r.PostProcessing.PreferCompute"), PreviousPreferCompute);
+	SetConsoleVariable(TEXT("r.TonemapOverride.FastMath"), PreviousFastMath);
+	SetConsoleVariable(TEXT("r.TonemapOverride.SeparableCurve"), PreviousSeparableCurve);
+	IConsoleManager::Get().CallAllConsoleVariableSinks();
+
+	if (bPrecachingOff)
+	{
+		AddInfo(TEXT("PSO precaching is off (r.PSOPrecaching, r.TonemapOverride.PSOPrecache), the LUT pipelines are not checked"));
+		return true;
+	}
+
+	// Separable curve operators always take the curve permutation, fast math only when its measured error is within Fast Math Max Delta E
+	bool bSeparableOperatorCompiled = false;
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		bSeparableOperatorCompiled |= CompiledPermutations.IsTonemapOperatorCompiled(ECustomTonemapOperator(Operator)) && FTonemapOverrideCPULUT::HasSeparableCurve(ECustomTonemapOperator(Operator));
+	}
+
+	if (bSeparableOperatorCompiled)
+	{
+		TestTrue(TEXT("Separable curve permutations were used"), NumSeparableCurvePasses > 0);
+	}
+	AddInfo(FString::Printf(TEXT("%d LUT passes with the fast math variant, %d with the separable curve"), NumFastMathPasses, NumSeparableCurvePasses));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTestUtils.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideSettings.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideLUTShaperTest, "TonemapOverride.CPU.ShapedLUTError", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideLUTShaperTest::RunTest(const FString& Parameters)
+{
+	// The shaper is there so that an exported 33^3 LUT can stand in for a uniform 64^3 one, the error of the uniform 64^3 LUT
+	// is measured for every operator as the reference
+	const int32 LUTSize = 33;
+	const int32 ReferenceLUTSize = 64;
+
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		FTonemapOverrideCPUTexture3D OperatorTexture;
+		FTonemapOverrideLUTSnapshot Snapshot;
+		TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), FPostProcessSettings(), 32, TonemapOverrideSettings, OperatorTexture, Snapshot);
+
+		const FTonemapOverrideCPULUT CPULUT(Snapshot, &OperatorTexture);
+		const FTonemapOverrideLUTShaper Shaper = FTonemapOverrideLUTShaper::Fit(CPULUT);
+
+		const FString Name = StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator);
+		if (!TestTrue(FString::Printf(TEXT("%s shaper fitted"), *Name), Shaper.IsValid()))
+		{
+			continue;
+		}
+
+		double UniformMax, UniformMean, ShapedMax, ShapedMean, ReferenceMax, ReferenceMean;
+		TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, UniformMax, UniformMean);
+		TonemapOverride::MeasureLUTError(CPULUT, LUTSize, &Shaper, ShapedMax, ShapedMean);
+		TonemapOverride::MeasureLUTError(CPULUT, ReferenceLUTSize, nullptr, ReferenceMax, ReferenceMean);
+
+		AddInfo(FString::Printf(TEXT("%s: uniform %d^3 dE2000 max %.3f mean %.4f, shaped %d^3 max %.3f mean %.4f, uniform %d^3 max %.3f mean %.4f"),
+			*Name, LUTSize, UniformMax, UniformMean, LUTSize, ShapedMax, ShapedMean, ReferenceLUTSize, ReferenceMax, ReferenceMean));
+
+		// Limits follow the measured reference, with a floor where the difference is not seen at all
+		const double MaxDeltaETolerance = FMath::Max(ReferenceMax * TonemapOverrideTest::ShapedLUTReferenceMargin, TonemapOverrideTest::InvisibleDeltaE);
+		const double MeanDeltaETolerance = FMath::Max(ReferenceMean * TonemapOverrideTest::ShapedLUTReferenceMargin, TonemapOverrideTest::InvisibleDeltaE);
+
+		TestTrue(FString::Printf(TEXT("%s shaped max delta E %.3f within %.3f of uniform %d^3"), *Name, ShapedMax, MaxDeltaETolerance, ReferenceLUTSize), ShapedMax <= MaxDeltaETolerance);
+		TestTrue(FString::Printf(TEXT("%s shaped mean delta E %.4f within %.4f of uniform %d^3"), *Name, ShapedMean, MeanDeltaETolerance, ReferenceLUTSize), ShapedMean <= MeanDeltaETolerance);
+		TestTrue(FString::Printf(TEXT("%s shaped mean delta E %.4f not above uniform %.4f"), *Name, ShapedMean, UniformMean), ShapedMean <= UniformMean);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideTetrahedralLUTTest, "TonemapOverride.CPU.TetrahedralLUTError", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideTetrahedralLUTTest::RunTest(const FString& Parameters)
+{
+	// Both interpolations reproduce an affine function exactly, anything else is an error in the lattice cell or weights
+	{
+		FTonemapOverrideCPUTexture3D Affine;
+		Affine.Size = FIntVector(5);
+		for (int32 Index = 0; Index < 5 * 5 * 5; ++Index)
+		{
+			const FVector3f Cell(Index % 5, (Index / 5) % 5, Index / 25);
+			Affine.Texels.Add(FVector3f(0.1f + Cell.X * 0.2f, Cell.Y * 0.1f + Cell.Z * 0.05f, 1.0f - Cell.X * 0.1f + Cell.Z * 0.15f));
+		}
+
+		FRandomStream RandomStream(0x7E7);
+		double MaxTrilinearError = 0.0;
+		double MaxTetrahedralError = 0.0;
+
+		for (int32 Sample = 0; Sample < 1024; ++Sample)
+		{
+			const FVector3f Cell = FVector3f(RandomStream.FRand(), RandomStream.FRand(), RandomStream.FRand()) * 4.0f;
+			const FVector3f Expected(0.1f + Cell.X * 0.2f, Cell.Y * 0.1f + Cell.Z * 0.05f, 1.0f - Cell.X * 0.1f + Cell.Z * 0.15f);
+			const FVector3f UVW = (Cell + FVector3f(0.5f)) / 5.0f;
+
+			MaxTrilinearError = FMath::Max(MaxTrilinearError, double((Affine.Sample(UVW) - Expected).GetAbsMax()));
+			MaxTetrahedralError = FMath::Max(MaxTetrahedralError, double((Affine.SampleTetrahedral(UVW) - Expected).GetAbsMax()));
+		}
+
+		TestTrue(FString::Printf(TEXT("Trilinear affine error %g"), MaxTrilinearError), MaxTrilinearError <= TonemapOverrideTest::AffineInterpolationTolerance);
+		TestTrue(FString::Printf(TEXT("Tetrahedral affine error %g"), MaxTetrahedralError), MaxTetrahedralError <= TonemapOverrideTest::AffineInterpolationTolerance);
+	}
+
+	// Tetrahedral lookup of the 33^3 LUT has to stay clean and not lose to trilinear on average
+	const int32 LUTSize = 33;
+	const double MaxDeltaETolerance = TonemapOverrideTest::TetrahedralLUTDeltaETolerance;
+
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		FTonemapOverrideCPUTexture3D OperatorTexture;
+		FTonemapOverrideLUTSnapshot Snapshot;
+		TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), FPostProcessSettings(), 32, TonemapOverrideSettings, OperatorTexture, Snapshot);
+
+		const FTonemapOverrideCPULUT CPULUT(Snapshot, &OperatorTexture);
+
+		double TrilinearMax, TrilinearMean, TetrahedralMax, TetrahedralMean;
+		TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, TrilinearMax, TrilinearMean);
+		TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, TetrahedralMax, TetrahedralMean, true);
+
+		const FString Name = StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator);
+		AddInfo(FString::Printf(TEXT("%s %d^3: trilinear dE2000 max %.3f mean %.4f, tetrahedral max %.3f mean %.4f"), *Name, LUTSize, TrilinearMax, TrilinearMean, TetrahedralMax, TetrahedralMean));
+
+		TestTrue(FString::Printf(TEXT("%s tetrahedral max delta E %.3f within %.1f"), *Name, TetrahedralMax, MaxDeltaETolerance), TetrahedralMax <= MaxDeltaETolerance);
+		TestTrue(FString::Printf(TEXT("%s tetrahedral mean delta E %.4f not above trilinear %.4f"), *Name, TetrahedralMean, TrilinearMean), TetrahedralMean <= TrilinearMean);
+	}
+
+	return true;
+}
+
+#endif
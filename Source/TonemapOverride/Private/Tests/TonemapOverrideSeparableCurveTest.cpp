@@ -0,0 +1,57 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTestUtils.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideSettings.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideSeparableCurveTest, "TonemapOverride.CPU.SeparableCurveMatchesOperator", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideSeparableCurveTest::RunTest(const FString& Parameters)
+{
+	const int32 LUTSize = 33;
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	// Shared settings and a gain that pushes the curve input past the diffuse range
+	TArray<FPostProcessSettings> Settings = TonemapOverrideTest::GetTestSettings();
+	Settings.Last().ColorGain = FVector4(1.2, 1.0, 0.8, 2.0);
+	Settings.Last().ColorContrast = FVector4(1.0, 1.0, 1.0, 1.2);
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::HasSeparableCurve(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (int32 SettingsIndex = 0; SettingsIndex < Settings.Num(); ++SettingsIndex)
+		{
+			FTonemapOverrideCPUTexture3D OperatorTexture;
+			FTonemapOverrideLUTSnapshot Snapshot;
+			TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator(Operator), Settings[SettingsIndex], LUTSize, TonemapOverrideSettings, OperatorTexture, Snapshot);
+
+			const FString Name = TonemapOverrideTest::GetTestName(ECustomTonemapOperator(Operator), SettingsIndex);
+
+			// Curve the LUT pass uploads, every entry has to be defined
+			Snapshot.bSeparableCurve = 1;
+			TArray<FVector4f> Entries;
+			FTonemapOverrideCPULUT(Snapshot).BakeSeparableCurve(Entries);
+
+			TestEqual(FString::Printf(TEXT("%s curve entries"), *Name), Entries.Num(), FTonemapOverrideSeparableCurve::NumEntries);
+			TestFalse(FString::Printf(TEXT("%s curve has no NaN or infinite entries"), *Name), Entries.ContainsByPredicate([](const FVector4f& Entry) { return Entry.ContainsNaN(); }));
+
+			double MaxError = 0.0;
+			double MaxDeltaE = 0.0;
+			TonemapOverride::MeasureSeparableCurveError(Snapshot, LUTSize, MaxError, MaxDeltaE);
+
+			TestTrue(FString::Printf(TEXT("%s max error %g within %g"), *Name, MaxError, TonemapOverride::SeparableCurveTolerance), MaxError <= TonemapOverride::SeparableCurveTolerance);
+			TestTrue(FString::Printf(TEXT("%s max delta E %.4f within %.2f"), *Name, MaxDeltaE, TonemapOverride::SeparableCurveDeltaETolerance), MaxDeltaE <= TonemapOverride::SeparableCurveDeltaETolerance);
+		}
+	}
+
+	return true;
+}
+
+#endif
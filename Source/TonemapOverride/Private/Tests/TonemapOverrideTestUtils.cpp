@@ -0,0 +1,46 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TonemapOverrideSettings.h"
+#include "Engine/Texture.h"
+
+TArray<FPostProcessSettings> TonemapOverrideTest::GetTestSettings()
+{
+	TArray<FPostProcessSettings> Settings;
+	Settings.AddDefaulted();
+
+	FPostProcessSettings& Graded = Settings.AddDefaulted_GetRef();
+	Graded.WhiteTemp = 5200.0f;
+	Graded.WhiteTint = 0.1f;
+	Graded.ExpandGamut = 0.5f;
+	Graded.ColorSaturation = FVector4(1.1, 0.9, 1.0, 1.05);
+	Graded.ColorContrastShadows = FVector4(1.1, 1.1, 1.1, 1.0);
+	Graded.ColorGainHighlights = FVector4(1.0, 0.95, 0.9, 1.0);
+
+	return Settings;
+}
+
+FString TonemapOverrideTest::GetTestName(ECustomTonemapOperator Operator, int32 SettingsIndex)
+{
+	return FString::Printf(TEXT("%s %s"), *StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(int64(Operator)), SettingsIndex == 0 ? TEXT("neutral") : TEXT("graded"));
+}
+
+uint32 TonemapOverrideTest::LoadOperatorTexture(ECustomTonemapOperator Operator, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideCPUTexture3D& OutTexture)
+{
+	const TSoftObjectPtr<UTexture>* OperatorTexture = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, Operator);
+	const UTexture* Texture = OperatorTexture ? OperatorTexture->LoadSynchronous() : nullptr;
+	return FTonemapOverrideCPUTexture3D::LoadFromTexture(Texture, OutTexture) ? TonemapOverride::GetLUTTextureId(Texture) : 0;
+}
+
+void TonemapOverrideTest::BuildOperatorSnapshot(ECustomTonemapOperator Operator, const FPostProcessSettings& Settings, int32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideCPUTexture3D& OutTexture, FTonemapOverrideLUTSnapshot& OutSnapshot)
+{
+	const uint32 LUTTextureId = LoadOperatorTexture(Operator, TonemapOverrideSettings, OutTexture);
+
+	TonemapOverride::BuildLUTSnapshot(Settings, TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, LUTSize, TonemapOverrideSettings, OutSnapshot);
+	TonemapOverride::SetSnapshotOperator(Operator, TonemapOverrideSettings, LUTTextureId, OutSnapshot);
+}
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TonemapOverrideCPU.h"
+
+class UTonemapOverrideSettings;
+
+// Helpers and limits shared by the TonemapOverride automation tests
+// The runtime LUT of the engine is PF_A2B10G10R10, one code of the encoded output is 1/1023 (~9.8e-4), and a CIEDE2000
+// difference of about 1 is the just noticeable one for colors seen side by side
+namespace TonemapOverrideTest
+{
+	// GPU against the double precision reference, float LUT. The GPU exp2 / log2 / pow are approximations with a vendor
+	// specific error, 5e-3 is five 10 bit codes. Chosen as a bound, not measured on every vendor
+	constexpr double GPULUTTolerance = 5e-3;
+
+	// GPU against the SIMD CPU LUT, half of the just noticeable difference so that swapping one for the other is not seen
+	constexpr double GPULUTDeltaETolerance = 0.5;
+
+	// Trilinear and tetrahedral lookups reproduce an affine function exactly, 1e-4 covers the float rounding of the cell
+	// and weight computation and is 500 times below the smallest step (0.05) of the affine test lattice
+	constexpr double AffineInterpolationTolerance = 1e-4;
+
+	// Tetrahedral lookup of a 33^3 LUT against the direct operator, 2 is the upper end of the just noticeable range
+	// Not measured, the mean against trilinear is the actual regression check
+	constexpr double TetrahedralLUTDeltaETolerance = 2.0;
+
+	// Below half of the just noticeable difference a LUT error is not seen even side by side
+	constexpr double InvisibleDeltaE = 0.5;
+
+	// Shaped 33^3 LUT against the measured error of a uniform 64^3 one. Trilinear error falls with the square of the lattice
+	// step, so at half the steps the shaper has to win back about 4x, 1.5 leaves room for the jittered error sampling
+	constexpr double ShapedLUTReferenceMargin = 1.5;
+
+	// Neutral settings and a graded setup that exercises white balance, gamut expansion and the grading ranges
+	TArray<FPostProcessSettings> GetTestSettings();
+
+	// Operator name with "neutral" or "graded" for the index into GetTestSettings
+	FString GetTestName(ECustomTonemapOperator Operator, int32 SettingsIndex);
+
+	// Texture of a texture operator from its source data, returns its id or 0 so that the fallback is compared when it is not available
+	uint32 LoadOperatorTexture(ECustomTonemapOperator Operator, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideCPUTexture3D& OutTexture);
+
+	// Snapshot of the operator with the settings and the default output device, the operator texture loaded into OutTexture
+	void BuildOperatorSnapshot(ECustomTonemapOperator Operator, const FPostProcessSettings& Settings, int32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideCPUTexture3D& OutTexture, FTonemapOverrideLUTSnapshot& OutSnapshot);
+}
+
+#endif
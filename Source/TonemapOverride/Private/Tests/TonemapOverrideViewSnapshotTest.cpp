@@ -0,0 +1,73 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideSettings.h"
+#include "SceneView.h"
+#include "UnrealClient.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Render target of the test family, the output device parameters read its display format
+	class FTestRenderTarget : public FRenderTarget
+	{
+	public:
+		virtual FIntPoint GetSizeXY() const override { return FIntPoint(128, 64); }
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTonemapOverrideViewSnapshotTest, "TonemapOverride.Snapshot.SplitScreenViewsKeepGrading", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTonemapOverrideViewSnapshotTest::RunTest(const FString& Parameters)
+{
+	const FTonemapOverrideRenderSettings RenderSettings(UTonemapOverrideSettings::Get());
+	const FTestRenderTarget RenderTarget;
+
+	// Split-screen family, each player in a differently graded volume
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(&RenderTarget, nullptr, FEngineShowFlags(ESFIM_Game)));
+
+	for (int32 ViewIndex = 0; ViewIndex < 2; ++ViewIndex)
+	{
+		FSceneViewInitOptions ViewInitOptions;
+		ViewInitOptions.ViewFamily = &ViewFamily;
+		ViewInitOptions.SetViewRectangle(FIntRect(ViewIndex * 64, 0, (ViewIndex + 1) * 64, 64));
+		ViewInitOptions.ViewOrigin = FVector::ZeroVector;
+		ViewInitOptions.ViewRotationMatrix = FMatrix::Identity;
+		ViewInitOptions.ProjectionMatrix = FReversedZPerspectiveMatrix(UE_HALF_PI * 0.5f, 1.0f, 1.0f, 10.0f);
+
+		FSceneView* View = new FSceneView(ViewInitOptions);
+		View->FinalPostProcessSettings.ColorSaturation = ViewIndex == 0 ? FVector4(1.2, 1.0, 0.8, 1.0) : FVector4(1.0, 1.0, 1.0, 0.7);
+		View->FinalPostProcessSettings.ColorContrast = FVector4(1.0, 1.0, 1.0, ViewIndex == 0 ? 1.1 : 0.9);
+		ViewFamily.Views.Add(View);
+	}
+
+	FSceneView& FirstView = *const_cast<FSceneView*>(ViewFamily.Views[0]);
+	const FSceneView& SecondView = *ViewFamily.Views[1];
+
+	// Snapshots of the family before the LUT passes, as the LUTs are generated ahead of the post chain
+	FTonemapOverrideLUTSnapshot FirstSnapshot;
+	FTonemapOverrideLUTSnapshot SecondSnapshot;
+	TonemapOverride::BuildLUTSnapshot(FirstView, 32, RenderSettings, FirstSnapshot);
+	TonemapOverride::BuildLUTSnapshot(SecondView, 32, RenderSettings, SecondSnapshot);
+
+	TestTrue(TEXT("Views with different grading have different LUTs"), FirstSnapshot.GetHash() != SecondSnapshot.GetHash());
+
+	// First view is handed its LUT, which resets what the engine LUT pass of that view reads
+	TonemapOverride::ResetEngineLUTSettings(FirstView);
+
+	TestTrue(TEXT("Color grading show flag of the family is kept"), ViewFamily.EngineShowFlags.ColorGrading != 0);
+
+	FTonemapOverrideLUTSnapshot SecondSnapshotAfter;
+	TonemapOverride::BuildLUTSnapshot(SecondView, 32, RenderSettings, SecondSnapshotAfter);
+	TestTrue(TEXT("Second view keeps the LUT built for it ahead of the post chain"), SecondSnapshotAfter.GetHash() == SecondSnapshot.GetHash());
+
+	FTonemapOverrideLUTSnapshot FirstSnapshotAfter;
+	TonemapOverride::BuildLUTSnapshot(FirstView, 32, RenderSettings, FirstSnapshotAfter);
+	TestTrue(TEXT("Second view is still graded, unlike the reset first view"), FirstSnapshotAfter.GetHash() != SecondSnapshotAfter.GetHash());
+
+	return true;
+}
+
+#endif
@@ -1,6 +1,7 @@
 // Copyright 2024 Ossi Luoto
 
 #include "TonemapOverride.h"
+#include "TonemapOverrideLUTRendering.h"
 #include "Interfaces/IPluginManager.h"
 
 #define LOCTEXT_NAMESPACE "FTonemapOverrideModule"
@@ -13,6 +14,9 @@ void FTonemapOverrideModule::StartupModule()
 	FString PluginShaderDir = FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("TonemapOverride"))->GetBaseDir(), TEXT("Shaders"));
 	AddShaderSourceDirectoryMapping(TEXT("/Plugins/TonemapOverride"), PluginShaderDir);
 	UE_LOG(TonemapOverrideLog, Log, TEXT("TonemapOverride module loaded and Shader directory %s registered"), *PluginShaderDir);
+
+	// Before any LUT shader is compiled, the settings object is not available yet in this loading phase
+	TonemapOverride::CaptureCompiledPermutations();
 }
 
 void FTonemapOverrideModule::ShutdownModule()
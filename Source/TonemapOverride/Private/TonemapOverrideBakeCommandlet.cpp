@@ -0,0 +1,148 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideBakeCommandlet.h"
+#include "TonemapOverrideBakedLUTs.h"
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Engine/Texture.h"
+#include "Misc/App.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+static const TCHAR* DefaultBakedLUTsPackage = TEXT("/Game/TonemapOverride/BakedLUTs");
+
+UTonemapOverrideBakeCommandlet::UTonemapOverrideBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTonemapOverrideBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	// Without a GPU the LUTs the CPU evaluation covers are baked on the CPU, the others are skipped
+	const bool bUseGPU = FApp::CanEverRender() && !GUsingNullRHI;
+	UE_CLOG(!bUseGPU, TonemapOverrideLog, Display, TEXT("No GPU, ACES LUTs are skipped. Run the commandlet with -AllowCommandletRendering to bake them"));
+
+	const FString* KeysParam = ParamVals.Find(TEXT("Keys"));
+	const FString KeysFilename = KeysParam ? *KeysParam : TonemapOverride::GetDefaultLUTBakeKeysFilename();
+
+	TArray<FTonemapOverrideLUTBakeKey> Keys;
+	if (!TonemapOverride::LoadLUTBakeKeys(KeysFilename, Keys))
+	{
+		return 1;
+	}
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	// Texture operator keys are generated with the configured textures, keys recorded with another texture would not match anymore
+	uint32 LUTTextureIds[int32(ECustomTonemapOperator::MAX)] = {};
+	FTonemapOverrideCPUTexture3D LUTTextures[int32(ECustomTonemapOperator::MAX)];
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (const TSoftObjectPtr<UTexture>* OperatorTexture = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, ECustomTonemapOperator(Operator)))
+		{
+			const UTexture* Texture = OperatorTexture->LoadSynchronous();
+			LUTTextureIds[Operator] = TonemapOverride::GetLUTTextureId(Texture);
+
+			if (!bUseGPU)
+			{
+				FTonemapOverrideCPUTexture3D::LoadFromTexture(Texture, LUTTextures[Operator]);
+			}
+		}
+	}
+
+	FString PackageName = DefaultBakedLUTsPackage;
+	if (const FString* AssetParam = ParamVals.Find(TEXT("Asset")))
+	{
+		PackageName = *AssetParam;
+	}
+	else if (!TonemapOverrideSettings.BakedLUTs.IsNull())
+	{
+		PackageName = TonemapOverrideSettings.BakedLUTs.ToSoftObjectPath().GetLongPackageName();
+	}
+
+	const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+	const FString ObjectPath = PackageName + TEXT(".") + AssetName;
+
+	// Keep the LUTs baked earlier, new keys are added on top
+	UTonemapOverrideBakedLUTs* BakedLUTs = LoadObject<UTonemapOverrideBakedLUTs>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+	if (!BakedLUTs)
+	{
+		UPackage* NewPackage = CreatePackage(*PackageName);
+		BakedLUTs = NewObject<UTonemapOverrideBakedLUTs>(NewPackage, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	UPackage* Package = BakedLUTs->GetPackage();
+
+	if (Switches.Contains(TEXT("Clean")))
+	{
+		BakedLUTs->Reset();
+	}
+
+	int32 NumBaked = 0;
+
+	for (const FTonemapOverrideLUTBakeKey& Key : Keys)
+	{
+		const ECustomTonemapOperator KeyOperator = Key.Snapshot.GetTonemapOperator();
+		if (Key.Snapshot.LUTTextureId != 0 && (KeyOperator >= ECustomTonemapOperator::MAX || Key.Snapshot.LUTTextureId != LUTTextureIds[int32(KeyOperator)]))
+		{
+			UE_LOG(TonemapOverrideLog, Warning, TEXT("Skipping LUT key recorded with another %s LUT texture"), *UEnum::GetDisplayValueAsText(KeyOperator).ToString());
+			continue;
+		}
+
+		if (!bUseGPU && !FTonemapOverrideCPULUT::IsOperatorSupported(KeyOperator))
+		{
+			UE_LOG(TonemapOverrideLog, Warning, TEXT("Skipping %s LUT, it is only generated on the GPU"), *UEnum::GetDisplayValueAsText(KeyOperator).ToString());
+			continue;
+		}
+
+		FTonemapOverrideBakedLUT BakedLUT;
+		const bool bBaked = bUseGPU ? TonemapOverride::BakeLUT(Key, BakedLUT) : TonemapOverride::BakeCPULUT(Key, &LUTTextures[int32(KeyOperator)], BakedLUT);
+		if (bBaked)
+		{
+			BakedLUTs->AddLUT(MoveTemp(BakedLUT));
+			++NumBaked;
+		}
+		else
+		{
+			UE_LOG(TonemapOverrideLog, Warning, TEXT("Failed to bake LUT of size %d"), FMath::RoundToInt(Key.Snapshot.LUTSize));
+		}
+	}
+
+	BakedLUTs->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+	if (!UPackage::SavePackage(Package, BakedLUTs, *Filename, SaveArgs))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to save baked LUTs to %s"), *Filename);
+		return 1;
+	}
+
+	// Point the runtime to the asset so that it gets cooked and used
+	if (TonemapOverrideSettings.BakedLUTs.Get() != BakedLUTs)
+	{
+		TonemapOverrideSettings.BakedLUTs = BakedLUTs;
+		TonemapOverrideSettings.TryUpdateDefaultConfigFile();
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Baked %d of %d LUTs into %s (%d total)"), NumBaked, Keys.Num(), *PackageName, BakedLUTs->LUTs.Num());
+	return 0;
+#else
+	UE_LOG(TonemapOverrideLog, Error, TEXT("LUT baking requires an editor build"));
+	return 1;
+#endif
+}
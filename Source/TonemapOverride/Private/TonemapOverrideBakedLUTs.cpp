@@ -0,0 +1,59 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideBakedLUTs.h"
+#include "Hash/CityHash.h"
+
+uint64 UTonemapOverrideBakedLUTs::GetKey(uint64 ContentHash, int32 LUTSize, EPixelFormat Format)
+{
+	const uint32 Key[] = { uint32(LUTSize), uint32(Format) };
+	return CityHash64WithSeed(reinterpret_cast<const char*>(Key), sizeof(Key), ContentHash);
+}
+
+const FTonemapOverrideBakedLUT* UTonemapOverrideBakedLUTs::Find(uint64 ContentHash, int32 LUTSize, EPixelFormat Format) const
+{
+	const int32* Index = LUTIndices.Find(GetKey(ContentHash, LUTSize, Format));
+	return Index ? &LUTs[*Index] : nullptr;
+}
+
+void UTonemapOverrideBakedLUTs::AddLUT(FTonemapOverrideBakedLUT&& LUT)
+{
+	const uint64 Key = GetKey(LUT.ContentHash, LUT.LUTSize, LUT.Format);
+
+	if (const int32* Index = LUTIndices.Find(Key))
+	{
+		LUTs[*Index] = MoveTemp(LUT);
+	}
+	else
+	{
+		LUTIndices.Add(Key, LUTs.Add(MoveTemp(LUT)));
+	}
+}
+
+void UTonemapOverrideBakedLUTs::Reset()
+{
+	LUTs.Reset();
+	LUTIndices.Reset();
+}
+
+void UTonemapOverrideBakedLUTs::PostLoad()
+{
+	Super::PostLoad();
+	RebuildIndex();
+}
+
+void UTonemapOverrideBakedLUTs::RebuildIndex()
+{
+	LUTIndices.Reset();
+
+	for (int32 Index = 0; Index < LUTs.Num(); ++Index)
+	{
+		const FTonemapOverrideBakedLUT& LUT = LUTs[Index];
+
+		// Skip entries that would not fit the texture, ie. edited by hand
+		const int64 ExpectedSize = int64(GPixelFormats[LUT.Format].BlockBytes) * LUT.LUTSize * LUT.LUTSize * LUT.LUTSize;
+		if (LUT.Data.Num() == ExpectedSize && ExpectedSize > 0)
+		{
+			LUTIndices.Add(GetKey(LUT.ContentHash, LUT.LUTSize, LUT.Format), Index);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideBenchmarkCommandlet.h"
+#include "TonemapOverrideLUTBenchmark.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Misc/DateTime.h"
+
+UTonemapOverrideBenchmarkCommandlet::UTonemapOverrideBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTonemapOverrideBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const UEnum* OperatorEnum = StaticEnum<ECustomTonemapOperator>();
+
+	FTonemapOverrideBenchmarkOptions Options;
+	if (const FString* OperatorParam = ParamVals.Find(TEXT("Operator")))
+	{
+		TArray<FString> OperatorStrings;
+		OperatorParam->ParseIntoArray(OperatorStrings, TEXT(","));
+
+		for (const FString& OperatorString : OperatorStrings)
+		{
+			const int64 Value = OperatorEnum->GetValueByNameString(OperatorString);
+			if (Value == INDEX_NONE || Value >= int64(ECustomTonemapOperator::MAX))
+			{
+				UE_LOG(TonemapOverrideLog, Error, TEXT("Unknown tonemap operator %s"), *OperatorString);
+				return 1;
+			}
+			Options.Operators.AddUnique(ECustomTonemapOperator(Value));
+		}
+	}
+
+	if (const FString* SizeParam = ParamVals.Find(TEXT("Size")))
+	{
+		TArray<FString> SizeStrings;
+		SizeParam->ParseIntoArray(SizeStrings, TEXT(","));
+		Options.LUTSizes.Reset();
+
+		for (const FString& SizeString : SizeStrings)
+		{
+			const int32 LUTSize = FCString::Atoi(*SizeString);
+			if (LUTSize < 2 || LUTSize > 256)
+			{
+				UE_LOG(TonemapOverrideLog, Error, TEXT("Invalid LUT size %s"), *SizeString);
+				return 1;
+			}
+			Options.LUTSizes.AddUnique(LUTSize);
+		}
+	}
+
+	if (const FString* IterationsParam = ParamVals.Find(TEXT("Iterations")))
+	{
+		Options.NumIterations = FMath::Max(1, FCString::Atoi(**IterationsParam));
+	}
+
+	// Results are not validated here, a regression in the LUT output shows up in the automation tests
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Timings only, run \"Automation RunTests TonemapOverride\" to check the LUT output"));
+
+	TArray<FTonemapOverrideBenchmarkResult> Results;
+	TonemapOverride::RunLUTBenchmark(Options, Results);
+
+	const FString* OutputParam = ParamVals.Find(TEXT("Output"));
+	const FString OutputDir = OutputParam ? *OutputParam : TonemapOverride::GetLUTBenchmarkDir();
+	const FString* NameParam = ParamVals.Find(TEXT("Name"));
+	const FString BaseName = NameParam ? *NameParam : FString::Printf(TEXT("Benchmark_%s"), *FDateTime::Now().ToString());
+
+	return TonemapOverride::WriteLUTBenchmarkResults(Results, OutputDir, BaseName) ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideBlendable.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "SceneView.h"
+#include "Engine/Texture.h"
+
+void UTonemapOverrideBlendable::OverrideBlendableSettings(FSceneView& View, float Weight) const
+{
+	FTonemapOverrideBlendableData Data;
+	Data.Weight = Weight;
+
+	Data.bOverride_ReinhardWhitePoint = bOverride_ReinhardWhitePoint;
+	Data.bOverride_HejlWhitePoint = bOverride_HejlWhitePoint;
+	Data.bOverride_GT7BlendRatio = bOverride_GT7BlendRatio;
+	Data.bOverride_GT7FadeStart = bOverride_GT7FadeStart;
+	Data.bOverride_GT7FadeEnd = bOverride_GT7FadeEnd;
+
+	Data.ReinhardWhitePoint = ReinhardWhitePoint;
+	Data.HejlWhitePoint = HejlWhitePoint;
+	Data.GT7BlendRatio = GT7BlendRatio;
+	Data.GT7FadeStart = GT7FadeStart;
+	Data.GT7FadeEnd = GT7FadeEnd;
+
+	// The render thread holds a reference to the RHI texture by id, the data can't as it is copied as raw bytes
+	if (bOverride_LUTTexture && LUTTexture && LUTTexture->GetResource())
+	{
+		TonemapOverride::RegisterVolumeLUTTexture(LUTTexture);
+
+		Data.bOverride_LUTTexture = true;
+		Data.LUTTextureId = TonemapOverride::GetLUTTextureId(LUTTexture);
+		Data.bLUTTexturePrecomposed = bLUTTexturePrecomposed;
+	}
+
+	if (Data.bOverride_ReinhardWhitePoint || Data.bOverride_HejlWhitePoint || Data.bOverride_GT7BlendRatio || Data.bOverride_GT7FadeStart || Data.bOverride_GT7FadeEnd || Data.bOverride_LUTTexture)
+	{
+		View.FinalPostProcessSettings.BlendableManager.PushBlendableData(Weight, Data);
+	}
+}
@@ -0,0 +1,1574 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverride.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Texture.h"
+
+using namespace TonemapOverride::CPU;
+
+namespace
+{
+	// Matrices from ACES.ush, rows as in the shaders
+	const FMatrix3d AP1_2_XYZ_MAT = { { { 0.6624541811, 0.1340042065, 0.1561876870 }, { 0.2722287168, 0.6740817658, 0.0536895174 }, { -0.0055746495, 0.0040607335, 1.0103391003 } } };
+	const FMatrix3d XYZ_2_AP1_MAT = { { { 1.6410233797, -0.3248032942, -0.2364246952 }, { -0.6636628587, 1.6153315917, 0.0167563477 }, { 0.0117218943, -0.0082844420, 0.9883948585 } } };
+	const FMatrix3d AP1_2_AP0_MAT = { { { 0.6954522414, 0.1406786965, 0.1638690622 }, { 0.0447945634, 0.8596711185, 0.0955343182 }, { -0.0055258826, 0.0040252103, 1.0015006723 } } };
+	const FMatrix3d D65_2_D60_CAT = { { { 1.01303, 0.00610531, -0.014971 }, { 0.00769823, 0.998165, -0.00503203 }, { -0.00284131, 0.00468516, 0.924507 } } };
+	const FMatrix3d D60_2_D65_CAT = { { { 0.987224, -0.00611327, 0.0159533 }, { -0.00759836, 1.00186, 0.00533002 }, { 0.00307257, -0.00509595, 1.08168 } } };
+	const FMatrix3d sRGB_2_XYZ_MAT = { { { 0.4124564, 0.3575761, 0.1804375 }, { 0.2126729, 0.7151522, 0.0721750 }, { 0.0193339, 0.1191920, 0.9503041 } } };
+	const FMatrix3d XYZ_2_sRGB_MAT = { { { 3.2409699419, -1.5373831776, -0.4986107603 }, { -0.9692436363, 1.8759675015, 0.0415550574 }, { 0.0556300797, -0.2039769589, 1.0569715142 } } };
+	const FMatrix3d XYZ_2_Rec2020_MAT = { { { 1.7166511880, -0.3556707838, -0.2533662814 }, { -0.6666843518, 1.6164812366, 0.0157685458 }, { 0.0176398574, -0.0427706133, 0.9421031212 } } };
+	const FMatrix3d Rec2020_2_XYZ_MAT = { { { 0.6369580483, 0.1446169036, 0.1688809752 }, { 0.2627002120, 0.6779980715, 0.0593017165 }, { 0.0000000000, 0.0280726930, 1.0609850577 } } };
+	const FMatrix3d XYZ_2_P3D65_MAT = { { { 2.4934969119, -0.9313836179, -0.4027107845 }, { -0.8294889696, 1.7626640603, 0.0236246858 }, { 0.0358458302, -0.0761723893, 0.9568845240 } } };
+
+	const FMatrix3d AP1_2_sRGB = XYZ_2_sRGB_MAT * (D60_2_D65_CAT * AP1_2_XYZ_MAT);
+	const FMatrix3d sRGB_2_AP1 = XYZ_2_AP1_MAT * (D65_2_D60_CAT * sRGB_2_XYZ_MAT);
+	const FMatrix3d AP1_2_REC2020 = XYZ_2_Rec2020_MAT * AP1_2_XYZ_MAT;
+	const FMatrix3d REC2020_2_AP1 = XYZ_2_AP1_MAT * Rec2020_2_XYZ_MAT;
+
+	const FVector3d AP1_RGB2Y(0.2722287168, 0.6740817658, 0.0536895174);
+
+	// Engine color helpers (PostProcessCombineLUTs.usf, TonemapOverride uses the same white balance as the engine)
+
+	FVector2d PlanckianLocusChromaticity(double Temp)
+	{
+		const double U = (0.860117757 + 1.54118254e-4 * Temp + 1.28641212e-7 * Temp * Temp) / (1.0 + 8.42420235e-4 * Temp + 7.08145163e-7 * Temp * Temp);
+		const double V = (0.317398726 + 4.22806245e-5 * Temp + 4.20481691e-8 * Temp * Temp) / (1.0 - 2.89741816e-5 * Temp + 1.61456053e-7 * Temp * Temp);
+
+		return FVector2d(3 * U / (2 * U - 8 * V + 4), 2 * V / (2 * U - 8 * V + 4));
+	}
+
+	FVector2d D_IlluminantChromaticity(double Temp)
+	{
+		// Correct for revision of Plank's law, this makes 6500 == D65
+		Temp *= 1.4388 / 1.438;
+		const double OneOverTemp = 1.0 / Temp;
+		const double X = Temp <= 7000
+			? 0.244063 + (0.09911e3 + (2.9678e6 - 4.6070e9 * OneOverTemp) * OneOverTemp) * OneOverTemp
+			: 0.237040 + (0.24748e3 + (1.9018e6 - 2.0064e9 * OneOverTemp) * OneOverTemp) * OneOverTemp;
+
+		return FVector2d(X, -3 * X * X + 2.87 * X - 0.275);
+	}
+
+	FVector2d PlanckianIsothermal(double Temp, double Tint)
+	{
+		double U = (0.860117757 + 1.54118254e-4 * Temp + 1.28641212e-7 * Temp * Temp) / (1.0 + 8.42420235e-4 * Temp + 7.08145163e-7 * Temp * Temp);
+		double V = (0.317398726 + 4.22806245e-5 * Temp + 4.20481691e-8 * Temp * Temp) / (1.0 - 2.89741816e-5 * Temp + 1.61456053e-7 * Temp * Temp);
+
+		const double UD = (-1.13758118e9 - 1.91615621e6 * Temp - 1.53177 * Temp * Temp) / FMath::Square(1.41213984e6 + 1189.62 * Temp + Temp * Temp);
+		const double VD = (1.97471536e9 - 705674.0 * Temp - 308.607 * Temp * Temp) / FMath::Square(6.19363586e6 - 179.456 * Temp + Temp * Temp);
+
+		const FVector2d UVD = FVector2d(UD, VD).GetSafeNormal();
+
+		// Correlated color temperature is meaningful within +/- 0.05
+		U += -UVD.Y * Tint * 0.05;
+		V += UVD.X * Tint * 0.05;
+
+		return FVector2d(3 * U / (2 * U - 8 * V + 4), 2 * V / (2 * U - 8 * V + 4));
+	}
+
+	FVector3d xyY_2_XYZ(const FVector2d& xy)
+	{
+		const double Y = 1.0;
+		const double Divisor = FMath::Max(xy.Y, 1e-10);
+		return FVector3d(xy.X * Y / Divisor, Y, (1.0 - xy.X - xy.Y) * Y / Divisor);
+	}
+
+	// Von Kries transform with the Bradford cone response
+	FMatrix3d ChromaticAdaptation(const FVector2d& SrcWhite, const FVector2d& DstWhite)
+	{
+		const FMatrix3d ToLMS = { { { 0.8951, 0.2664, -0.1614 }, { -0.7502, 1.7135, 0.0367 }, { 0.0389, -0.0685, 1.0296 } } };
+		const FMatrix3d FromLMS = { { { 0.986993, -0.147054, 0.159963 }, { 0.432305, 0.51836, 0.0492912 }, { -0.00852866, 0.0400428, 0.968487 } } };
+
+		const FVector3d SrcWhiteLMS = Mul(ToLMS, xyY_2_XYZ(SrcWhite));
+		const FVector3d DstWhiteLMS = Mul(ToLMS, xyY_2_XYZ(DstWhite));
+
+		const FMatrix3d Scale = { { { DstWhiteLMS.X / SrcWhiteLMS.X, 0, 0 }, { 0, DstWhiteLMS.Y / SrcWhiteLMS.Y, 0 }, { 0, 0, DstWhiteLMS.Z / SrcWhiteLMS.Z } } };
+
+		return FromLMS * (Scale * ToLMS);
+	}
+
+	FMatrix3d WhiteBalanceMatrix(double WhiteTemp, double WhiteTint, bool bIsTemperatureWhiteBalance, const FMatrix3d& ToXYZ, const FMatrix3d& FromXYZ)
+	{
+		const FVector2d SrcWhiteDaylight = D_IlluminantChromaticity(WhiteTemp);
+		const FVector2d SrcWhitePlankian = PlanckianLocusChromaticity(WhiteTemp);
+
+		FVector2d SrcWhite = WhiteTemp < 4000 ? SrcWhitePlankian : SrcWhiteDaylight;
+		FVector2d D65White(0.31270, 0.32900);
+
+		// Offset along isotherm
+		SrcWhite += PlanckianIsothermal(WhiteTemp, WhiteTint) - SrcWhitePlankian;
+
+		if (!bIsTemperatureWhiteBalance)
+		{
+			Swap(SrcWhite, D65White);
+		}
+
+		return FromXYZ * (ChromaticAdaptation(SrcWhite, D65White) * ToXYZ);
+	}
+
+	FMatrix3d OutputGamutMappingMatrix(uint32 OutputGamut)
+	{
+		switch (OutputGamut)
+		{
+		case 1: return XYZ_2_P3D65_MAT * (D60_2_D65_CAT * AP1_2_XYZ_MAT);
+		case 2: return XYZ_2_Rec2020_MAT * (D60_2_D65_CAT * AP1_2_XYZ_MAT);
+		case 3: return AP1_2_AP0_MAT;
+		case 4: return FMatrix3d::Identity();
+		default: return AP1_2_sRGB;
+		}
+	}
+
+	// Kernel, written once for the double reference and the SIMD lanes
+
+	template<typename V>
+	TRGB<V> LogToLin(const TRGB<V>& LogColor)
+	{
+		const double LinearRange = 14;
+		const double LinearGrey = 0.18;
+		const double ExposureGrey = 444;
+
+		return Exp2((LogColor - TRGB<V>(V(ExposureGrey / 1023.0))) * TRGB<V>(V(LinearRange))) * TRGB<V>(V(LinearGrey));
+	}
+
+	template<typename V>
+	TRGB<V> LinToLog(const TRGB<V>& LinearColor)
+	{
+		const double LinearRange = 14;
+		const double LinearGrey = 0.18;
+		const double ExposureGrey = 444;
+
+		const TRGB<V> LogColor = Log2(LinearColor) * TRGB<V>(V(1.0 / LinearRange)) - TRGB<V>(V(FMath::Log2(LinearGrey) / LinearRange - ExposureGrey / 1023.0));
+		return Clamp(LogColor, TRGB<V>(V(0.0)), TRGB<V>(V(1.0)));
+	}
+
+	template<typename V>
+	TRGB<V> ColorCorrect(const TRGB<V>& InColor, const FTonemapOverrideCPUParameters::FColorCorrect& CC)
+	{
+		const V Luma = Dot(InColor, TRGB<V>(AP1_RGB2Y));
+		TRGB<V> Color = Max(Lerp(TRGB<V>(Luma), InColor, TRGB<V>(CC.Saturation)), TRGB<V>(V(0.0)));
+		Color = Pow(Color * TRGB<V>(V(1.0 / 0.18)), TRGB<V>(CC.Contrast)) * TRGB<V>(V(0.18));
+		Color = Pow(Color, TRGB<V>(FVector3d(1.0, 1.0, 1.0) / CC.Gamma));
+		return Color * TRGB<V>(CC.Gain) + TRGB<V>(CC.Offset);
+	}
+
+	template<typename V>
+	TRGB<V> ColorCorrectAll(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Color)
+	{
+		const V Luma = Dot(Color, TRGB<V>(AP1_RGB2Y));
+
+		const TRGB<V> Shadows = ColorCorrect(Color, P.Shadows);
+		const V ShadowsWeight = V(1.0) - SmoothStep(V(0.0), V(P.ColorCorrectionShadowsMax), Luma);
+
+		const TRGB<V> Highlights = ColorCorrect(Color, P.Highlights);
+		const V HighlightsWeight = SmoothStep(V(P.ColorCorrectionHighlightsMin), V(P.ColorCorrectionHighlightsMax), Luma);
+
+		const TRGB<V> Midtones = ColorCorrect(Color, P.Midtones);
+		const V MidtonesWeight = V(1.0) - ShadowsWeight - HighlightsWeight;
+
+		return Shadows * ShadowsWeight + Midtones * MidtonesWeight + Highlights * HighlightsWeight;
+	}
+
+	// Separable curve (SeparableCurve.usf), linear interpolation between the entries of each channel
+
+	float SampleSeparableCurve(const TArray<FVector4f>& Curve, int32 Channel, float X)
+	{
+		const double Entry = FTonemapOverrideSeparableCurve::InputToEntry(X);
+		const int32 Entry0 = int32(Entry);
+		const int32 Entry1 = FMath::Min(Entry0 + 1, Curve.Num() - 1);
+		return FMath::Lerp(Curve[Entry0][Channel], Curve[Entry1][Channel], float(Entry - Entry0));
+	}
+
+	TRGB<double> SampleSeparableCurve(const FTonemapOverrideCPUParameters& P, const TRGB<double>& X)
+	{
+		return TRGB<double>(SampleSeparableCurve(P.SeparableCurve, 0, X.R), SampleSeparableCurve(P.SeparableCurve, 1, X.G), SampleSeparableCurve(P.SeparableCurve, 2, X.B));
+	}
+
+	TRGB<FFloat4> SampleSeparableCurve(const FTonemapOverrideCPUParameters& P, const TRGB<FFloat4>& X)
+	{
+		// Gather lane by lane
+		alignas(16) float R[4], G[4], B[4];
+		X.R.Store(R);
+		X.G.Store(G);
+		X.B.Store(B);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			R[Lane] = SampleSeparableCurve(P.SeparableCurve, 0, R[Lane]);
+			G[Lane] = SampleSeparableCurve(P.SeparableCurve, 1, G[Lane]);
+			B[Lane] = SampleSeparableCurve(P.SeparableCurve, 2, B[Lane]);
+		}
+
+		return TRGB<FFloat4>(FFloat4::Load(R), FFloat4::Load(G), FFloat4::Load(B));
+	}
+
+	// AgX (AgX.usf)
+
+	template<typename V>
+	V AgxDefaultContrastApprox(const V& X, bool bFastMath)
+	{
+		if (bFastMath)
+		{
+			// 6th order fit of the same curve
+			return X * (V(0.1191) + X * (V(0.4298) + X * (V(-6.868) + X * (V(31.96) + X * (V(-40.14) + X * V(15.5)))))) - V(0.00232);
+		}
+
+		const V X2 = X * X;
+		const V X4 = X2 * X2;
+		const V X6 = X4 * X2;
+
+		return V(-17.86) * X6 * X + V(78.01) * X6 - V(126.7) * X4 * X + V(92.06) * X4 - V(28.72) * X2 * X + V(4.361) * X2 - V(0.1718) * X + V(0.002857);
+	}
+
+	// Per channel part of AgX after the inset matrix
+	template<typename V>
+	TRGB<V> AgxCurve(const FTonemapOverrideCPUParameters& P, TRGB<V> Color)
+	{
+		const double MinEv = -12.47393;
+		const double MaxEv = 4.026069;
+
+		Color = Clamp(Log2(Color), TRGB<V>(V(MinEv)), TRGB<V>(V(MaxEv)));
+		Color = (Color - TRGB<V>(V(MinEv))) / TRGB<V>(V(MaxEv - MinEv));
+
+		// Sigmoid function approximation
+		return Map(Color, [&P](const V& X) { return AgxDefaultContrastApprox(X, P.bFastMath); });
+	}
+
+	template<typename V>
+	TRGB<V> Agx(const FTonemapOverrideCPUParameters& P, TRGB<V> Color)
+	{
+		const FMatrix3d AgxMat = { { { 0.842479062253094, 0.0423282422610123, 0.0423756549057051 }, { 0.0784335999999992, 0.878468636469772, 0.0784336 }, { 0.0792237451477643, 0.0791661274605434, 0.879142973793104 } } };
+		const FMatrix3d AgxMatInv = { { { 1.19687900512017, -0.0528968517574562, -0.0529716355144438 }, { -0.0980208811401368, 1.15190312990417, -0.0980434501171241 }, { -0.0990297440797205, -0.0989611768448433, 1.15107367264116 } } };
+
+		// Input transform (inset), log2 space encoding and sigmoid
+		Color = Mul(AgxMat, Color);
+		Color = P.SeparableCurve.IsEmpty() ? AgxCurve(P, Color) : SampleSeparableCurve(P, Color);
+
+		// Look, ASC CDL with offset 0 and slope 1
+		const bool bPunchy = P.TonemapOperator == ECustomTonemapOperator::AgxPunchy;
+		const V Power = V(bPunchy ? 1.35 : 1.0);
+		const V Saturation = V(bPunchy ? 1.4 : 1.0);
+
+		const V Luma = Dot(Color, TRGB<V>(FVector3d(0.2126, 0.7152, 0.0722)));
+		Color = Map(Color, [&P, &Power](const V& X) { return OperatorPow(X, Power, P.bFastMath); });
+		Color = TRGB<V>(Luma) + (Color - TRGB<V>(Luma)) * Saturation;
+
+		// Inverse input transform (outset) and 2.2 display EOTF
+		Color = Mul(AgxMatInv, Color);
+		return Map(Color, [&P](const V& X) { return OperatorPow(X, V(2.2), P.bFastMath); });
+	}
+
+	// Reinhard (Reinhard.usf)
+
+	template<typename V>
+	TRGB<V> LumaBasedReinhard(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Color)
+	{
+		const V Luma = Dot(Color, TRGB<V>(FVector3d(0.2126, 0.7152, 0.0722)));
+		const V ToneMappedLuma = Luma / (V(1.0) + Luma / V(P.ReinhardWhitePoint * P.ReinhardWhitePoint)) / (V(1.0) + Luma);
+		return Color * (ToneMappedLuma / Luma);
+	}
+
+	// Hejl 2015 (Hejl.usf)
+
+	template<typename V>
+	V HejlCurve(const V& X)
+	{
+		const V A = V(1.425) * X + V(0.05);
+		return ((X * A + V(0.004)) / (X * (A + V(0.55)) + V(0.0491))) - V(0.0821);
+	}
+
+	template<typename V>
+	TRGB<V> ToneMapFilmic_Hejl2015(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Color)
+	{
+		const V WhiteScale = HejlCurve(V(P.HejlWhitePoint));
+		return Map(Color, [](const V& X) { return HejlCurve(X); }) / WhiteScale;
+	}
+
+	// Uchimura (Uchimura.usf) with the default parameters
+
+	template<typename V>
+	V Uchimura(const V& X)
+	{
+		const double P = 1.0;
+		const double A = 1.0;
+		const double M = 0.22;
+		const double L = 0.4;
+		const double C = 1.33;
+		const double B = 0.0;
+
+		const double L0 = ((P - M) * L) / A;
+		const double S0 = M + L0;
+		const double S1 = M + A * L0;
+		const double C2 = (A * P) / (P - S1);
+		const double CP = -C2 / P;
+
+		const V W0 = V(1.0) - SmoothStep(V(0.0), V(M), X);
+		const V W2 = Step(V(M + L0), X);
+		const V W1 = V(1.0) - W0 - W2;
+
+		const V T = V(M) * Pow(X / V(M), V(C)) + V(B);
+		const V S = V(P) - V(P - S1) * Exp(V(CP) * (X - V(S0)));
+		const V Linear = V(M) + V(A) * (X - V(M));
+
+		return T * W0 + Linear * W1 + S * W2;
+	}
+
+	// Tony McMapface (Tony.usf)
+
+	TRGB<double> SampleLUTTexture(const FTonemapOverrideCPUParameters& P, const TRGB<double>& UVW)
+	{
+		if (!P.LUTTexture)
+		{
+			return TRGB<double>(0.0);
+		}
+
+		const FVector3f Coordinate(UVW.R, UVW.G, UVW.B);
+		const FVector3f Sample = P.bTetrahedralLUT ? P.LUTTexture->SampleTetrahedral(Coordinate) : P.LUTTexture->Sample(Coordinate);
+		return TRGB<double>(Sample.X, Sample.Y, Sample.Z);
+	}
+
+	TRGB<FFloat4> SampleLUTTexture(const FTonemapOverrideCPUParameters& P, const TRGB<FFloat4>& UVW)
+	{
+		if (!P.LUTTexture)
+		{
+			return TRGB<FFloat4>(FFloat4(0.0));
+		}
+
+		// Gather lane by lane
+		alignas(16) float U[4], V[4], W[4], R[4], G[4], B[4];
+		UVW.R.Store(U);
+		UVW.G.Store(V);
+		UVW.B.Store(W);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const FVector3f Coordinate(U[Lane], V[Lane], W[Lane]);
+			const FVector3f Sample = P.bTetrahedralLUT ? P.LUTTexture->SampleTetrahedral(Coordinate) : P.LUTTexture->Sample(Coordinate);
+			R[Lane] = Sample.X;
+			G[Lane] = Sample.Y;
+			B[Lane] = Sample.Z;
+		}
+
+		return TRGB<FFloat4>(FFloat4::Load(R), FFloat4::Load(G), FFloat4::Load(B));
+	}
+
+	template<typename V>
+	TRGB<V> TonyMcMapface(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Stimulus)
+	{
+		// Non-linear transform that the LUT is encoded with, the encoding curve alone until the texture is loaded
+		const TRGB<V> Encoded = Stimulus / (Stimulus + TRGB<V>(V(1.0)));
+		if (P.TonyLUTMode == ETonyLUTMode::Fallback)
+		{
+			return Encoded;
+		}
+
+		// Precomposed LUT is indexed with the engine LUT log encoding
+		const TRGB<V> Coordinate = P.TonyLUTMode == ETonyLUTMode::Precomposed ? LinToLog(Stimulus + LogToLin(TRGB<V>(V(0.0)))) : Encoded;
+
+		// Aligned to texel centers
+		const FVector3d LUTDims(P.LUTTexture->Size);
+		const TRGB<V> UVW = Coordinate * TRGB<V>(V((LUTDims.X - 1.0) / LUTDims.X), V((LUTDims.Y - 1.0) / LUTDims.Y), V((LUTDims.Z - 1.0) / LUTDims.Z))
+			+ TRGB<V>(V(0.5 / LUTDims.X), V(0.5 / LUTDims.Y), V(0.5 / LUTDims.Z));
+
+		return SampleLUTTexture(P, UVW);
+	}
+
+	// Custom LUT (CustomLUT.usf)
+
+	template<typename V>
+	V SrgbToLinearChannel(const V& Color)
+	{
+		// Mirrors sRGBToLinear of the engine GammaCorrectionCommon.ush
+		const V X = Max(V(6.10352e-5), Color);
+		return Select(X > V(0.04045), Pow(X * V(1.0 / 1.055) + V(0.0521327), V(2.4)), X * V(1.0 / 12.92));
+	}
+
+	template<typename V>
+	V ACEScctChannel(const V& Linear)
+	{
+		return Select(Linear <= V(0.0078125), Linear * V(10.5402377416545) + V(0.0729055341958355), (Log2(Max(Linear, V(1e-10))) + V(9.72)) * V(1.0 / 17.52));
+	}
+
+	template<typename V>
+	TRGB<V> CustomLUT(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Stimulus)
+	{
+		if (P.TonyLUTMode == ETonyLUTMode::Fallback)
+		{
+			return Stimulus / (Stimulus + TRGB<V>(V(1.0)));
+		}
+
+		TRGB<V> Encoded = Stimulus;
+		if (P.CustomLUTInput == ECustomLUTInputEncoding::EngineLog)
+		{
+			Encoded = LinToLog(Stimulus + LogToLin(TRGB<V>(V(0.0))));
+		}
+		else if (P.CustomLUTInput == ECustomLUTInputEncoding::ACEScct)
+		{
+			Encoded = Map(Mul(sRGB_2_AP1, Stimulus), [](const V& X) { return ACEScctChannel(X); });
+		}
+
+		// Domain of the file to 0..1, aligned to texel centers
+		const TRGB<V> Coordinate = Clamp((Encoded - TRGB<V>(P.CustomLUTDomainMin)) * TRGB<V>(P.CustomLUTDomainScale), TRGB<V>(V(0.0)), TRGB<V>(V(1.0)));
+		const FVector3d LUTDims(P.LUTTexture->Size);
+		const TRGB<V> UVW = Coordinate * TRGB<V>(V((LUTDims.X - 1.0) / LUTDims.X), V((LUTDims.Y - 1.0) / LUTDims.Y), V((LUTDims.Z - 1.0) / LUTDims.Z))
+			+ TRGB<V>(V(0.5 / LUTDims.X), V(0.5 / LUTDims.Y), V(0.5 / LUTDims.Z));
+
+		const TRGB<V> Color = SampleLUTTexture(P, UVW);
+		return P.CustomLUTOutput == ECustomLUTOutputEncoding::sRGB ? Map(Color, [](const V& X) { return SrgbToLinearChannel(X); }) : Color;
+	}
+
+	// Flim (Flim.usf)
+
+	template<typename V>
+	V FlimRemap01(const V& X, double InStart, double InEnd)
+	{
+		return Saturate((X - V(InStart)) / V(InEnd - InStart));
+	}
+
+	template<typename V>
+	V FlimSuperSigmoid(V X, double ToeX, double ToeY, double ShoulderX, double ShoulderY, bool bFastMath)
+	{
+		X = Saturate(X);
+		ToeX = FMath::Clamp(ToeX, 0.0, 1.0);
+		ToeY = FMath::Clamp(ToeY, 0.0, 1.0);
+		ShoulderX = FMath::Clamp(ShoulderX, 0.0, 1.0);
+		ShoulderY = FMath::Clamp(ShoulderY, 0.0, 1.0);
+
+		const double Slope = (ShoulderY - ToeY) / (ShoulderX - ToeX);
+
+		const double ToePow = Slope * ToeX / ToeY;
+		const V Toe = V(ToeY) * OperatorPow(X / V(ToeX), V(ToePow), bFastMath);
+
+		const double Intercept = ToeY - (Slope * ToeX);
+		const V Line = V(Slope) * X + V(Intercept);
+
+		const double ShoulderPow = -Slope / (((ShoulderX - 1.0) / FMath::Pow(1.0 - ShoulderX, 2.0)) * (1.0 - ShoulderY));
+		const V Shoulder = (V(1.0) - OperatorPow(V(1.0) - (X - V(ShoulderX)) / V(1.0 - ShoulderX), V(ShoulderPow), bFastMath)) * V(1.0 - ShoulderY) + V(ShoulderY);
+
+		return Select(X < V(ToeX), Toe, Select(X < V(ShoulderX), Line, Shoulder));
+	}
+
+	template<typename V>
+	V FlimDyeMixFactor(const FTonemapOverrideFlimConstants& F, const V& Mono, double MaxDensity, bool bFastMath)
+	{
+		// log2 and map range
+		const double Offset = FMath::Pow(2.0, F.SigmoidLog2Min);
+		V Factor = FlimRemap01(OperatorLog2(Mono + V(Offset), bFastMath), F.SigmoidLog2Min, F.SigmoidLog2Max);
+
+		// Amount of exposure from 0 to 1, dye density and mix factor
+		Factor = FlimSuperSigmoid(Factor, F.SigmoidToeX, F.SigmoidToeY, F.SigmoidShoulderX, F.SigmoidShoulderY, bFastMath);
+		Factor = Factor * V(MaxDensity);
+		Factor = OperatorExp2(-Factor, bFastMath);
+
+		return Saturate(Factor);
+	}
+
+	template<typename V>
+	TRGB<V> FlimDevelop(const FTonemapOverrideFlimConstants& F, const TRGB<V>& InColor, double Exposure, double MaxDensity, bool bFastMath)
+	{
+		// The three color layers have unit sensitivity and dye tones, so each of them ends up scaling only its own channel
+		const TRGB<V> Color = InColor * TRGB<V>(V(FMath::Pow(2.0, Exposure)));
+		return Map(Color, [&F, MaxDensity, bFastMath](const V& X) { return FlimDyeMixFactor(F, X, MaxDensity, bFastMath); });
+	}
+
+	template<typename V>
+	TRGB<V> FlimNegativeAndPrint(const FTonemapOverrideFlimConstants& F, const TRGB<V>& InColor, bool bFastMath = false)
+	{
+		TRGB<V> Color = FlimDevelop(F, InColor, F.NegativeFilmExposure, F.NegativeFilmDensity, bFastMath);
+		Color = Color * TRGB<V>(F.BacklightExt);
+		return FlimDevelop(F, Color, F.PrintFilmExposure, F.PrintFilmDensity, bFastMath);
+	}
+
+	template<typename V>
+	TRGB<V> FlimRGBToHSV(const TRGB<V>& RGB)
+	{
+		const V CMax = Max(RGB.R, Max(RGB.G, RGB.B));
+		const V CMin = Min(RGB.R, Min(RGB.G, RGB.B));
+		const V CDelta = CMax - CMin;
+
+		const V S = Select(CMax != V(0.0), CDelta / CMax, V(0.0));
+
+		const TRGB<V> C = (TRGB<V>(CMax) - RGB) / CDelta;
+		V H = Select(RGB.R == CMax, C.B - C.G, Select(RGB.G == CMax, V(2.0) + C.R - C.B, V(4.0) + C.G - C.R));
+		H = H / V(6.0);
+		H = Select(H < V(0.0), H + V(1.0), H);
+		H = Select(S == V(0.0), V(0.0), H);
+
+		return TRGB<V>(H, S, CMax);
+	}
+
+	template<typename V>
+	TRGB<V> FlimHSVToRGB(const TRGB<V>& HSV)
+	{
+		const V S = HSV.G;
+		const V Value = HSV.B;
+
+		V H = Select(HSV.R == V(1.0), V(0.0), HSV.R);
+		H = H * V(6.0);
+		const V I = Floor(H);
+		const V F = H - I;
+		const V P = Value * (V(1.0) - S);
+		const V Q = Value * (V(1.0) - S * F);
+		const V T = Value * (V(1.0) - S * (V(1.0) - F));
+
+		auto Sextant = [&I](const V& C0, const V& C1, const V& C2, const V& C3, const V& C4, const V& C5)
+		{
+			return Select(I == V(0.0), C0, Select(I == V(1.0), C1, Select(I == V(2.0), C2, Select(I == V(3.0), C3, Select(I == V(4.0), C4, C5)))));
+		};
+
+		const TRGB<V> RGB(
+			Sextant(Value, Q, P, P, T, Value),
+			Sextant(T, Value, Value, Q, P, P),
+			Sextant(P, P, T, Value, Value, Q));
+
+		const auto Grey = S == V(0.0);
+		return TRGB<V>(Select(Grey, Value, RGB.R), Select(Grey, Value, RGB.G), Select(Grey, Value, RGB.B));
+	}
+
+	template<typename V>
+	TRGB<V> FlimHueSat(const TRGB<V>& Color, double Hue, double Saturation)
+	{
+		TRGB<V> HSV = FlimRGBToHSV(Color);
+		HSV.R = Frac(HSV.R + V(Hue + 0.5));
+		HSV.G = Saturate(HSV.G * V(Saturation));
+		return FlimHSVToRGB(HSV);
+	}
+
+	// FAST_MATH form of the midtone hue / saturation: the hue turns a full circle, so only the hsv saturation changes
+	template<typename V>
+	TRGB<V> FlimSaturate(const TRGB<V>& Color, double Saturation)
+	{
+		const V CMax = Max(Color.R, Max(Color.G, Color.B));
+		const V CMin = Min(Color.R, Min(Color.G, Color.B));
+		const V HSVSaturation = Select(CMax > V(0.0), (CMax - CMin) / CMax, V(0.0));
+		const V Ratio = Select(HSVSaturation > V(0.0), Saturate(HSVSaturation * V(Saturation)) / HSVSaturation, V(0.0));
+		return TRGB<V>(CMax) - (TRGB<V>(CMax) - Color) * Ratio;
+	}
+
+	template<typename V>
+	V FlimAverage(const TRGB<V>& Color)
+	{
+		return (Color.R + Color.G + Color.B) / V(3.0);
+	}
+
+	template<typename V>
+	TRGB<V> FlimUniformOffset(const TRGB<V>& Color, double BlackPoint, double WhitePoint)
+	{
+		const V Mono = FlimAverage(Color);
+		const V Mono2 = FlimRemap01(Mono, BlackPoint / 1000.0, 1.0 - (WhitePoint / 1000.0));
+		return Color * (Mono2 / Mono);
+	}
+
+	template<typename V>
+	TRGB<V> FlimTransform(const FTonemapOverrideCPUParameters& P, TRGB<V> Color)
+	{
+		const FTonemapOverrideFlimConstants& F = P.Flim;
+		const TRGB<V> Zero(V(0.0));
+		const TRGB<V> One(V(1.0));
+
+		// Eliminate negative values, pre-exposure and clip very large values for float precision issues
+		Color = Max(Color, Zero);
+		Color = Color * TRGB<V>(V(FMath::Pow(2.0, F.PreExposure)));
+		Color = Min(Color, TRGB<V>(V(5000.0)));
+
+		// Pre-formation filter
+		Color = Lerp(Color, Color * TRGB<V>(F.PreFormationFilter), V(F.PreFormationFilterStrength));
+
+		// Negative & print in the extended gamut
+		Color = Mul(F.Extend, Color);
+		Color = P.SeparableCurve.IsEmpty() ? FlimNegativeAndPrint(F, Color, P.bFastMath) : SampleSeparableCurve(P, Color);
+		Color = Mul(F.ExtendInverse, Color);
+
+		// Eliminate negative values, white cap and black cap
+		Color = Max(Color, Zero);
+		Color = Color / TRGB<V>(F.WhiteCap);
+		Color = FlimUniformOffset(Color, F.BlackPoint, 0.0);
+
+		// Post-formation filter and clip
+		Color = Lerp(Color, Color * TRGB<V>(F.PostFormationFilter), V(F.PostFormationFilterStrength));
+		Color = Clamp(Color, Zero, One);
+
+		// Midtone saturation
+		const V Mono = FlimAverage(Color);
+		const V MixFactor = Select(Mono < V(0.5), FlimRemap01(Mono, 0.05, 0.5), FlimRemap01(Mono, 0.95, 0.5));
+		Color = Lerp(Color, P.bFastMath ? FlimSaturate(Color, F.MidtoneSaturation) : FlimHueSat(Color, 0.5, F.MidtoneSaturation), MixFactor);
+
+		return Clamp(Color, Zero, One);
+	}
+
+	// GT7 (GT7.usf)
+
+	namespace GT7
+	{
+		const double SdrPaperWhite = 250.0;
+		const double ReferenceLuminance = 100.0;
+		const double MinPeakLuminance = 250.0;
+		const double MaxPeakLuminance = 10000.0;
+		const double CurveAlpha = 0.25;
+		const double CurveLinearSection = 0.444;
+		const double JzazbzExponentScaleFactor = 1.7;
+	}
+
+	template<typename V>
+	V GT7SmoothStep(const V& X, double Edge0, double Edge1)
+	{
+		const V T = (X - V(Edge0)) / V(Edge1 - Edge0);
+		return Select(X < V(Edge0), V(0.0), Select(X > V(Edge1), V(1.0), T * T * (V(3.0) - V(2.0) * T)));
+	}
+
+	template<typename V>
+	V GT7EvaluateCurve(const FTonemapOverrideCPUParameters& P, const V& X)
+	{
+		const double MidPoint = 0.538;
+		const double LinearSection = GT7::CurveLinearSection;
+		const double ToeStrength = 1.280;
+
+		const V WeightLinear = GT7SmoothStep(X, 0.0, MidPoint);
+		const V WeightToe = V(1.0) - WeightLinear;
+
+		// Shoulder mapping for highlights
+		const V Shoulder = V(P.GT7.kA) + V(P.GT7.kB) * OperatorExp(X * V(P.GT7.kC), P.bFastMath);
+		const V ToeMapped = V(MidPoint) * OperatorPow(X / V(MidPoint), V(ToeStrength), P.bFastMath);
+		const V Toe = WeightToe * ToeMapped + WeightLinear * X;
+
+		return Select(X < V(0.0), V(0.0), Select(X < V(LinearSection * P.GT7.PeakIntensity), Toe, Shoulder));
+	}
+
+	template<typename V>
+	V EotfSt2084(const V& InN, double ExponentScaleFactor, bool bFastMath)
+	{
+		const double M1 = 0.1593017578125;
+		const double M2 = 78.84375 * ExponentScaleFactor;
+		const double C1 = 0.8359375;
+		const double C2 = 18.8515625;
+		const double C3 = 18.6875;
+		const double PQC = 10000.0;
+
+		const V N = Saturate(InN);
+		const V NP = OperatorPow(N, V(1.0 / M2), bFastMath);
+		V L = Max(NP - V(C1), V(0.0));
+		L = L / (V(C2) - V(C3) * NP);
+		L = OperatorPow(L, V(1.0 / M1), bFastMath);
+
+		// Absolute luminance into the frame-buffer linear scale
+		return L * V(PQC / GT7::ReferenceLuminance);
+	}
+
+	template<typename V>
+	V InverseEotfSt2084(const V& Value, double ExponentScaleFactor, bool bFastMath)
+	{
+		const double M1 = 0.1593017578125;
+		const double M2 = 78.84375 * ExponentScaleFactor;
+		const double C1 = 0.8359375;
+		const double C2 = 18.8515625;
+		const double C3 = 18.6875;
+		const double PQC = 10000.0;
+
+		const V Y = Value * V(GT7::ReferenceLuminance / PQC);
+		const V YM = OperatorPow(Y, V(M1), bFastMath);
+		if (bFastMath)
+		{
+			// One log2 of the ratio instead of the difference of two
+			return FastExp2(V(M2) * FastLog2((V(C1) + V(C2) * YM) / (V(1.0) + V(C3) * YM)));
+		}
+		return Exp2(V(M2) * (Log2(V(C1) + V(C2) * YM) - Log2(V(1.0) + V(C3) * YM)));
+	}
+
+	template<typename V>
+	TRGB<V> RGBToICtCp(const TRGB<V>& RGB, bool bFastMath)
+	{
+		const V L = (RGB.R * V(1688.0) + RGB.G * V(2146.0) + RGB.B * V(262.0)) / V(4096.0);
+		const V M = (RGB.R * V(683.0) + RGB.G * V(2951.0) + RGB.B * V(462.0)) / V(4096.0);
+		const V S = (RGB.R * V(99.0) + RGB.G * V(309.0) + RGB.B * V(3688.0)) / V(4096.0);
+
+		const V LPQ = InverseEotfSt2084(L, 1.0, bFastMath);
+		const V MPQ = InverseEotfSt2084(M, 1.0, bFastMath);
+		const V SPQ = InverseEotfSt2084(S, 1.0, bFastMath);
+
+		return TRGB<V>(
+			(V(2048.0) * LPQ + V(2048.0) * MPQ) / V(4096.0),
+			(V(6610.0) * LPQ - V(13613.0) * MPQ + V(7003.0) * SPQ) / V(4096.0),
+			(V(17933.0) * LPQ - V(17390.0) * MPQ - V(543.0) * SPQ) / V(4096.0));
+	}
+
+	template<typename V>
+	TRGB<V> ICtCpToRGB(const TRGB<V>& ICtCp, bool bFastMath)
+	{
+		const V L = ICtCp.R + V(0.00860904) * ICtCp.G + V(0.11103) * ICtCp.B;
+		const V M = ICtCp.R - V(0.00860904) * ICtCp.G - V(0.11103) * ICtCp.B;
+		const V S = ICtCp.R + V(0.560031) * ICtCp.G - V(0.320627) * ICtCp.B;
+
+		const V LLin = EotfSt2084(L, 1.0, bFastMath);
+		const V MLin = EotfSt2084(M, 1.0, bFastMath);
+		const V SLin = EotfSt2084(S, 1.0, bFastMath);
+
+		return TRGB<V>(
+			Max(V(3.43661) * LLin - V(2.50645) * MLin + V(0.0698454) * SLin, V(0.0)),
+			Max(V(-0.79133) * LLin + V(1.9836) * MLin - V(0.192271) * SLin, V(0.0)),
+			Max(V(-0.0259499) * LLin - V(0.0989137) * MLin + V(1.12486) * SLin, V(0.0)));
+	}
+
+	template<typename V>
+	TRGB<V> RGBToJzazbz(const TRGB<V>& RGB, bool bFastMath)
+	{
+		const V L = RGB.R * V(0.530004) + RGB.G * V(0.355704) + RGB.B * V(0.086090);
+		const V M = RGB.R * V(0.289388) + RGB.G * V(0.525395) + RGB.B * V(0.157481);
+		const V S = RGB.R * V(0.091098) + RGB.G * V(0.147588) + RGB.B * V(0.734234);
+
+		const V LPQ = InverseEotfSt2084(L, GT7::JzazbzExponentScaleFactor, bFastMath);
+		const V MPQ = InverseEotfSt2084(M, GT7::JzazbzExponentScaleFactor, bFastMath);
+		const V SPQ = InverseEotfSt2084(S, GT7::JzazbzExponentScaleFactor, bFastMath);
+
+		const V IZ = V(0.5) * LPQ + V(0.5) * MPQ;
+
+		return TRGB<V>(
+			(V(0.44) * IZ) / (V(1.0) - V(0.56) * IZ) - V(1.6295499532821566e-11),
+			V(3.524000) * LPQ - V(4.066708) * MPQ + V(0.542708) * SPQ,
+			V(0.199076) * LPQ + V(1.096799) * MPQ - V(1.295875) * SPQ);
+	}
+
+	template<typename V>
+	TRGB<V> JzazbzToRGB(const TRGB<V>& Jab, bool bFastMath)
+	{
+		const V JZ = Jab.R + V(1.6295499532821566e-11);
+		const V IZ = JZ / (V(0.44) + V(0.56) * JZ);
+		const V A = Jab.G;
+		const V B = Jab.B;
+
+		const V L = IZ + A * V(1.386050432715393e-1) + B * V(5.804731615611869e-2);
+		const V M = IZ + A * V(-1.386050432715393e-1) + B * V(-5.804731615611869e-2);
+		const V S = IZ + A * V(-9.601924202631895e-2) + B * V(-8.118918960560390e-1);
+
+		const V LLin = EotfSt2084(L, GT7::JzazbzExponentScaleFactor, bFastMath);
+		const V MLin = EotfSt2084(M, GT7::JzazbzExponentScaleFactor, bFastMath);
+		const V SLin = EotfSt2084(S, GT7::JzazbzExponentScaleFactor, bFastMath);
+
+		return TRGB<V>(
+			LLin * V(2.990669) + MLin * V(-2.049742) + SLin * V(0.088977),
+			LLin * V(-1.634525) + MLin * V(3.145627) + SLin * V(-0.483037),
+			LLin * V(-0.042505) + MLin * V(-0.377983) + SLin * V(1.448019));
+	}
+
+	template<typename V>
+	TRGB<V> RGBToUCS(EGT7UCSType UCSType, const TRGB<V>& RGB, bool bFastMath = false)
+	{
+		return UCSType == EGT7UCSType::Jzazbz ? RGBToJzazbz(RGB, bFastMath) : RGBToICtCp(RGB, bFastMath);
+	}
+
+	template<typename V>
+	TRGB<V> UCSToRGB(EGT7UCSType UCSType, const TRGB<V>& UCS, bool bFastMath = false)
+	{
+		return UCSType == EGT7UCSType::Jzazbz ? JzazbzToRGB(UCS, bFastMath) : ICtCpToRGB(UCS, bFastMath);
+	}
+
+	template<typename V>
+	TRGB<V> GT7Tonemap(const FTonemapOverrideCPUParameters& P, const TRGB<V>& ColorAP1)
+	{
+		const TRGB<V> RGB = Mul(AP1_2_REC2020, ColorAP1);
+
+		// Luminance and chroma separated in UCS, per-channel tone mapping for the skewed color
+		const TRGB<V> UCS = RGBToUCS(P.GT7UCSType, RGB, P.bFastMath);
+		const TRGB<V> SkewedRGB = P.SeparableCurve.IsEmpty() ? Map(RGB, [&P](const V& X) { return GT7EvaluateCurve(P, X); }) : SampleSeparableCurve(P, RGB);
+		const TRGB<V> SkewedUCS = RGBToUCS(P.GT7UCSType, SkewedRGB, P.bFastMath);
+
+		const V ChromaScale = V(1.0) - GT7SmoothStep(UCS.R / V(P.GT7.LuminanceTargetUcs), P.GT7FadeStart, P.GT7FadeEnd);
+		const TRGB<V> ScaledUCS(SkewedUCS.R, UCS.G * ChromaScale, UCS.B * ChromaScale);
+		const TRGB<V> ScaledRGB = UCSToRGB(P.GT7UCSType, ScaledUCS, P.bFastMath);
+
+		// Final blend between per-channel and UCS-scaled results
+		const TRGB<V> Blended = Lerp(SkewedRGB, ScaledRGB, V(P.GT7BlendRatio));
+		const TRGB<V> Tonemapped = Min(Blended, TRGB<V>(V(P.GT7.PeakIntensity))) * V(P.GT7.SdrCorrectionFactor);
+
+		return Mul(REC2020_2_AP1, Tonemapped);
+	}
+
+	// Per channel part of the separable operators, what FTonemapOverrideSeparableCurve holds
+	template<typename V>
+	TRGB<V> SeparableOperatorCurve(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Color)
+	{
+		switch (P.TonemapOperator)
+		{
+		case ECustomTonemapOperator::Agx:
+		case ECustomTonemapOperator::AgxPunchy:
+			return AgxCurve(P, Color);
+		case ECustomTonemapOperator::Flim:
+			return FlimNegativeAndPrint(P.Flim, Color, P.bFastMath);
+		case ECustomTonemapOperator::Hejl:
+			return ToneMapFilmic_Hejl2015(P, Color);
+		case ECustomTonemapOperator::GranTurismo:
+			return Map(Color, [](const V& X) { return Uchimura(X); });
+		case ECustomTonemapOperator::GT7:
+			return Map(Color, [&P](const V& X) { return GT7EvaluateCurve(P, X); });
+		default:
+			return Color;
+		}
+	}
+
+	// Output device encodings (GammaCorrectionCommon.ush, TonemapCommon.ush)
+
+	template<typename V>
+	V LinearToSrgbChannel(const V& Linear)
+	{
+		return Select(Linear < V(0.00313067), Linear * V(12.92), Pow(Linear, V(1.0 / 2.4)) * V(1.055) - V(0.055));
+	}
+
+	template<typename V>
+	V LinearTo709Channel(const V& InLinear)
+	{
+		const V Linear = Max(InLinear, V(6.10352e-5));
+		return Min(Linear * V(4.5), Pow(Max(Linear, V(0.018)), V(0.45)) * V(1.099) - V(0.099));
+	}
+
+	template<typename V>
+	V LinearToST2084Channel(const V& Linear)
+	{
+		const double M1 = 0.1593017578125;
+		const double M2 = 78.84375;
+		const double C1 = 0.8359375;
+		const double C2 = 18.8515625;
+		const double C3 = 18.6875;
+		const double C = 10000.0;
+
+		const V LM = Pow(Linear / V(C), V(M1));
+		const V N = (V(C1) + V(C2) * LM) / (V(1.0) + V(C3) * LM);
+		return Pow(N, V(M2));
+	}
+
+	// CreateLUT of CustomTonemapLUT.usf from the neutral coordinate on
+	template<typename V>
+	TRGB<V> CreateLUT(const FTonemapOverrideCPUParameters& P, const TRGB<V>& Neutral)
+	{
+		const TRGB<V> Zero(V(0.0));
+
+		// Log encoding of the LUT
+		const TRGB<V> LinearColor = LogToLin(Neutral) - LogToLin(Zero);
+
+		// Grading in engine style
+		const TRGB<V> BalancedColor = P.bSkipTemperature ? LinearColor : Mul(P.WhiteBalance, LinearColor);
+
+		TRGB<V> ColorAP1 = Mul(P.WorkingToAP1, BalancedColor);
+		const V LumaAP1 = Dot(ColorAP1, TRGB<V>(AP1_RGB2Y));
+		const TRGB<V> ChromaAP1 = ColorAP1 / LumaAP1;
+
+		const TRGB<V> ChromaOffset = ChromaAP1 - TRGB<V>(V(1.0));
+		const V ChromaDistSqr = Dot(ChromaOffset, ChromaOffset);
+		const V ExpandAmount = (V(1.0) - Exp2(V(-4.0) * ChromaDistSqr)) * (V(1.0) - Exp2(V(-4.0 * P.ExpandGamutAmount) * LumaAP1 * LumaAP1));
+		ColorAP1 = Lerp(ColorAP1, Mul(P.ExpandGamut, ColorAP1), ExpandAmount);
+		ColorAP1 = ColorCorrectAll(P, ColorAP1);
+		TRGB<V> GradedColor = Mul(P.WorkingFromAP1, ColorAP1);
+
+		// Tonemap operator, all but GT7 operate in clipped linear sRGB
+		TRGB<V> ToneMappedAP1;
+
+		if (P.TonemapOperator == ECustomTonemapOperator::GT7)
+		{
+			ToneMappedAP1 = GT7Tonemap(P, ColorAP1);
+		}
+		else
+		{
+			TRGB<V> ToneMapSRGB = Max(Mul(AP1_2_sRGB, ColorAP1), Zero);
+
+			switch (P.TonemapOperator)
+			{
+			case ECustomTonemapOperator::Agx:
+			case ECustomTonemapOperator::AgxPunchy:
+				ToneMapSRGB = Agx(P, ToneMapSRGB);
+				break;
+			case ECustomTonemapOperator::Reinhard:
+				ToneMapSRGB = LumaBasedReinhard(P, ToneMapSRGB);
+				break;
+			case ECustomTonemapOperator::TonyMcMapface:
+				ToneMapSRGB = TonyMcMapface(P, ToneMapSRGB);
+				break;
+			case ECustomTonemapOperator::Flim:
+				ToneMapSRGB = FlimTransform(P, ToneMapSRGB);
+				break;
+			case ECustomTonemapOperator::Hejl:
+			case ECustomTonemapOperator::GranTurismo:
+				ToneMapSRGB = P.SeparableCurve.IsEmpty() ? SeparableOperatorCurve(P, ToneMapSRGB) : SampleSeparableCurve(P, ToneMapSRGB);
+				break;
+			case ECustomTonemapOperator::CustomLUT:
+				ToneMapSRGB = CustomLUT(P, ToneMapSRGB);
+				break;
+			default:
+				break;
+			}
+
+			ToneMappedAP1 = Mul(sRGB_2_AP1, ToneMapSRGB);
+		}
+
+		ColorAP1 = Lerp(ColorAP1, ToneMappedAP1, V(P.ToneCurveAmount));
+
+		// Back from AP1, polynomial mapping, fade tracks and gamma
+		TRGB<V> FilmColor = Max(Mul(P.WorkingFromAP1, ColorAP1), Zero);
+		FilmColor = TRGB<V>(V(P.MappingPolynomial.X)) * FilmColor * FilmColor + TRGB<V>(V(P.MappingPolynomial.Y)) * FilmColor + TRGB<V>(V(P.MappingPolynomial.Z));
+
+		const TRGB<V> OverlayColor(FVector3d(P.OverlayColor.X, P.OverlayColor.Y, P.OverlayColor.Z));
+		const V OverlayAlpha = V(P.OverlayColor.W);
+		const TRGB<V> FilmColorNoGamma = Lerp(FilmColor * TRGB<V>(P.ColorScale), OverlayColor, OverlayAlpha);
+		GradedColor = Lerp(GradedColor * TRGB<V>(P.ColorScale), OverlayColor, OverlayAlpha);
+		FilmColor = Pow(Max(FilmColorNoGamma, Zero), TRGB<V>(V(P.InverseGamma.Y)));
+
+		// Output device
+		TRGB<V> OutDeviceColor;
+
+		switch (EDisplayOutputFormat(P.OutputDevice))
+		{
+		case EDisplayOutputFormat::SDR_sRGB:
+			OutDeviceColor = Map(P.bWorkingColorSpaceIsSRGB ? FilmColor : Mul(P.AP1ToOutput, FilmColor), [](const V& X) { return LinearToSrgbChannel(X); });
+			break;
+		case EDisplayOutputFormat::SDR_Rec709:
+			OutDeviceColor = Map(Mul(P.AP1ToOutput, FilmColor), [](const V& X) { return LinearTo709Channel(X); });
+			break;
+		case EDisplayOutputFormat::HDR_LinearEXR:
+			OutDeviceColor = Map(Mul(P.AP1ToOutput, GradedColor), [](const V& X) { return LinearToST2084Channel(X); });
+			break;
+		case EDisplayOutputFormat::HDR_LinearNoToneCurve:
+			OutDeviceColor = GradedColor;
+			break;
+		case EDisplayOutputFormat::HDR_LinearWithToneCurve:
+			OutDeviceColor = Mul(P.AP1ToOutput, FilmColorNoGamma);
+			break;
+		case EDisplayOutputFormat::HDR_ACES_1000nit_ST2084:
+		case EDisplayOutputFormat::HDR_ACES_2000nit_ST2084:
+		case EDisplayOutputFormat::HDR_ACES_1000nit_ScRGB:
+		case EDisplayOutputFormat::HDR_ACES_2000nit_ScRGB:
+			if (P.TonemapOperator == ECustomTonemapOperator::GT7)
+			{
+				// GT7 is mapped to the display peak, 1.0 is 100 nits
+				OutDeviceColor = Map(Mul(P.AP1ToOutput, FilmColorNoGamma) * V(GT7::ReferenceLuminance), [](const V& X) { return LinearToST2084Channel(X); });
+				break;
+			}
+			OutDeviceColor = Pow(Mul(P.AP1ToOutput, FilmColor), TRGB<V>(V(P.InverseGamma.Z)));
+			break;
+		default:
+			OutDeviceColor = Pow(Mul(P.AP1ToOutput, FilmColor), TRGB<V>(V(P.InverseGamma.Z)));
+			break;
+		}
+
+		return OutDeviceColor / V(1.05);
+	}
+
+	FTonemapOverrideCPUParameters::FColorCorrect GetColorCorrect(const FVector4f& Saturation, const FVector4f& Contrast, const FVector4f& Gamma, const FVector4f& Gain, const FVector4f& Offset)
+	{
+		// ColorCorrect uses xyz * w, and xyz + w for the offset
+		FTonemapOverrideCPUParameters::FColorCorrect CC;
+		CC.Saturation = FVector3d(Saturation.X, Saturation.Y, Saturation.Z) * Saturation.W;
+		CC.Contrast = FVector3d(Contrast.X, Contrast.Y, Contrast.Z) * Contrast.W;
+		CC.Gamma = FVector3d(Gamma.X, Gamma.Y, Gamma.Z) * Gamma.W;
+		CC.Gain = FVector3d(Gain.X, Gain.Y, Gain.Z) * Gain.W;
+		CC.Offset = FVector3d(Offset.X, Offset.Y, Offset.Z) + FVector3d(Offset.W);
+		return CC;
+	}
+}
+
+void TonemapOverride::GetFlimConstants(const FTonemapOverrideFlimPreset& Preset, FTonemapOverrideFlimConstants& OutConstants)
+{
+	FTonemapOverrideFlimConstants& F = OutConstants;
+
+	F.PreExposure = Preset.PreExposure;
+	F.PreFormationFilter = FVector3d(Preset.PreFormationFilter.R, Preset.PreFormationFilter.G, Preset.PreFormationFilter.B);
+	F.PreFormationFilterStrength = Preset.PreFormationFilterStrength;
+	F.SigmoidLog2Min = Preset.SigmoidLog2Min;
+	F.SigmoidLog2Max = Preset.SigmoidLog2Max;
+	F.SigmoidToeX = Preset.SigmoidToeX;
+	F.SigmoidToeY = Preset.SigmoidToeY;
+	F.SigmoidShoulderX = Preset.SigmoidShoulderX;
+	F.SigmoidShoulderY = Preset.SigmoidShoulderY;
+	F.NegativeFilmExposure = Preset.NegativeFilmExposure;
+	F.NegativeFilmDensity = Preset.NegativeFilmDensity;
+	F.PrintFilmExposure = Preset.PrintFilmExposure;
+	F.PrintFilmDensity = Preset.PrintFilmDensity;
+	F.PostFormationFilter = FVector3d(Preset.PostFormationFilter.R, Preset.PostFormationFilter.G, Preset.PostFormationFilter.B);
+	F.PostFormationFilterStrength = Preset.PostFormationFilterStrength;
+	F.MidtoneSaturation = Preset.MidtoneSaturation;
+
+	// Extended gamut: each primary is rotated in hue and desaturated by its scale, rows keep white as white
+	for (int32 Primary = 0; Primary < 3; ++Primary)
+	{
+		const double Hue = Primary / 3.0 + Preset.ExtendedGamutRotation[Primary] / 360.0;
+		const double Saturation = FMath::Clamp(1.0 / Preset.ExtendedGamutScale[Primary], 0.0, 1.0);
+		const TRGB<double> Row = FlimHSVToRGB(TRGB<double>(Frac(Hue), Saturation, 1.0));
+		const double RowScale = Preset.ExtendedGamutMul[Primary] / (Row.R + Row.G + Row.B);
+
+		F.Extend.M[Primary][0] = Row.R * RowScale;
+		F.Extend.M[Primary][1] = Row.G * RowScale;
+		F.Extend.M[Primary][2] = Row.B * RowScale;
+	}
+	F.ExtendInverse = F.Extend.Inverse();
+
+	// Backlight in the extended gamut and the caps of the print
+	F.BacklightExt = Mul(F.Extend, FVector3d(Preset.PrintBacklight.R, Preset.PrintBacklight.G, Preset.PrintBacklight.B));
+
+	const double Big = 10000000.0;
+	const TRGB<double> WhiteCap = FlimNegativeAndPrint(F, TRGB<double>(Big));
+	F.WhiteCap = FVector3d(WhiteCap.R, WhiteCap.G, WhiteCap.B);
+
+	if (Preset.BlackPoint == -1.0f)
+	{
+		const TRGB<double> BlackCap = FlimNegativeAndPrint(F, TRGB<double>(0.0)) / TRGB<double>(F.WhiteCap);
+		F.BlackPoint = FlimAverage(BlackCap) * 1000.0;
+	}
+	else
+	{
+		F.BlackPoint = Preset.BlackPoint;
+	}
+}
+
+FVector3f FTonemapOverrideCPUTexture3D::Sample(const FVector3f& UVW) const
+{
+	if (!IsValid())
+	{
+		return FVector3f::ZeroVector;
+	}
+
+	// Trilinear filtering between texel centers, clamped at the edges
+	int32 Index0[3];
+	int32 Index1[3];
+	float Fraction[3];
+	const int32 Sizes[3] = { Size.X, Size.Y, Size.Z };
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const float Coordinate = UVW[Axis] * Sizes[Axis] - 0.5f;
+		const float Floor = FMath::FloorToFloat(Coordinate);
+		Fraction[Axis] = Coordinate - Floor;
+		Index0[Axis] = FMath::Clamp(int32(Floor), 0, Sizes[Axis] - 1);
+		Index1[Axis] = FMath::Clamp(int32(Floor) + 1, 0, Sizes[Axis] - 1);
+	}
+
+	auto Texel = [this](int32 X, int32 Y, int32 Z) -> const FVector3f&
+	{
+		return Texels[X + (Y + Z * Size.Y) * Size.X];
+	};
+
+	const FVector3f C00 = FMath::Lerp(Texel(Index0[0], Index0[1], Index0[2]), Texel(Index1[0], Index0[1], Index0[2]), Fraction[0]);
+	const FVector3f C10 = FMath::Lerp(Texel(Index0[0], Index1[1], Index0[2]), Texel(Index1[0], Index1[1], Index0[2]), Fraction[0]);
+	const FVector3f C01 = FMath::Lerp(Texel(Index0[0], Index0[1], Index1[2]), Texel(Index1[0], Index0[1], Index1[2]), Fraction[0]);
+	const FVector3f C11 = FMath::Lerp(Texel(Index0[0], Index1[1], Index1[2]), Texel(Index1[0], Index1[1], Index1[2]), Fraction[0]);
+
+	return FMath::Lerp(FMath::Lerp(C00, C10, Fraction[1]), FMath::Lerp(C01, C11, Fraction[1]), Fraction[2]);
+}
+
+FVector3f FTonemapOverrideCPUTexture3D::SampleTetrahedral(const FVector3f& UVW) const
+{
+	if (!IsValid())
+	{
+		return FVector3f::ZeroVector;
+	}
+
+	// Lattice position clamped to the edge texels, the cell is split along its diagonal into six tetrahedra
+	int32 Index0[3];
+	int32 Index1[3];
+	float Fraction[3];
+	const int32 Sizes[3] = { Size.X, Size.Y, Size.Z };
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const float Coordinate = FMath::Clamp(UVW[Axis] * Sizes[Axis] - 0.5f, 0.0f, float(Sizes[Axis] - 1));
+		Index0[Axis] = FMath::Max(FMath::Min(int32(Coordinate), Sizes[Axis] - 2), 0);
+		Index1[Axis] = FMath::Min(Index0[Axis] + 1, Sizes[Axis] - 1);
+		Fraction[Axis] = FMath::Clamp(Coordinate - float(Index0[Axis]), 0.0f, 1.0f);
+	}
+
+	// Axes from the largest fraction to the smallest, the tetrahedron is walked from the first corner to the last
+	int32 Order[3] = { 0, 1, 2 };
+	if (Fraction[Order[0]] < Fraction[Order[1]]) { Swap(Order[0], Order[1]); }
+	if (Fraction[Order[1]] < Fraction[Order[2]]) { Swap(Order[1], Order[2]); }
+	if (Fraction[Order[0]] < Fraction[Order[1]]) { Swap(Order[0], Order[1]); }
+
+	auto Texel = [this](const int32 (&Index)[3]) -> const FVector3f&
+	{
+		return Texels[Index[0] + (Index[1] + Index[2] * Size.Y) * Size.X];
+	};
+
+	int32 Corner[3] = { Index0[0], Index0[1], Index0[2] };
+	FVector3f Result = Texel(Corner) * (1.0f - Fraction[Order[0]]);
+
+	for (int32 Step = 0; Step < 3; ++Step)
+	{
+		Corner[Order[Step]] = Index1[Order[Step]];
+		const float Weight = Fraction[Order[Step]] - (Step < 2 ? Fraction[Order[Step + 1]] : 0.0f);
+		Result += Texel(Corner) * Weight;
+	}
+
+	return Result;
+}
+
+bool FTonemapOverrideCPUTexture3D::LoadFromTexture(const UTexture* Texture, FTonemapOverrideCPUTexture3D& OutTexture)
+{
+#if WITH_EDITORONLY_DATA
+	if (!Texture || !Texture->Source.IsValid())
+	{
+		return false;
+	}
+
+	FTextureSource& Source = const_cast<UTexture*>(Texture)->Source;
+	const FIntVector SourceSize(Source.GetSizeX(), Source.GetSizeY(), Source.GetNumSlices());
+	const int64 NumTexels = int64(SourceSize.X) * SourceSize.Y * SourceSize.Z;
+
+	TArray64<uint8> MipData;
+	if (!Source.GetMipData(MipData, 0, 0, 0))
+	{
+		return false;
+	}
+
+	OutTexture.Size = SourceSize;
+	OutTexture.Texels.SetNumUninitialized(NumTexels);
+
+	switch (Source.GetFormat())
+	{
+	case TSF_RGBA32F:
+		if (MipData.Num() < NumTexels * int64(sizeof(FLinearColor)))
+		{
+			return false;
+		}
+		for (int64 Index = 0; Index < NumTexels; ++Index)
+		{
+			const FLinearColor& Color = reinterpret_cast<const FLinearColor*>(MipData.GetData())[Index];
+			OutTexture.Texels[Index] = FVector3f(Color.R, Color.G, Color.B);
+		}
+		return true;
+
+	case TSF_RGBA16F:
+		if (MipData.Num() < NumTexels * int64(sizeof(FFloat16Color)))
+		{
+			return false;
+		}
+		for (int64 Index = 0; Index < NumTexels; ++Index)
+		{
+			const FFloat16Color& Color = reinterpret_cast<const FFloat16Color*>(MipData.GetData())[Index];
+			OutTexture.Texels[Index] = FVector3f(Color.R.GetFloat(), Color.G.GetFloat(), Color.B.GetFloat());
+		}
+		return true;
+
+	default:
+		UE_LOG(TonemapOverrideLog, Warning, TEXT("%s: only float volume textures can be evaluated on the CPU"), *Texture->GetName());
+		OutTexture = FTonemapOverrideCPUTexture3D();
+		return false;
+	}
+#else
+	return false;
+#endif
+}
+
+FTonemapOverrideCPULUT::FTonemapOverrideCPULUT(const FTonemapOverrideLUTSnapshot& S, const FTonemapOverrideCPUTexture3D* LUTTexture)
+{
+	FTonemapOverrideCPUParameters& P = Parameters;
+
+	P.TonemapOperator = S.GetTonemapOperator();
+	P.GT7UCSType = S.GetGT7UCSType();
+	P.OutputDevice = S.OutputDevice;
+	P.bFastMath = S.bFastMath != 0;
+	P.LUTTexture = (S.LUTTextureId != 0 && LUTTexture && LUTTexture->IsValid()) ? LUTTexture : nullptr;
+	P.TonyLUTMode = P.LUTTexture ? TonemapOverride::GetTonyLUTMode(S) : ETonyLUTMode::Fallback;
+	P.bTetrahedralLUT = S.bTetrahedralLUT != 0;
+
+	const FVector3d DomainMin(S.CustomLUTDomainMin);
+	const FVector3d DomainRange = FVector3d(S.CustomLUTDomainMax) - DomainMin;
+	P.CustomLUTInput = ECustomLUTInputEncoding(S.CustomLUTInput);
+	P.CustomLUTOutput = ECustomLUTOutputEncoding(S.CustomLUTOutput);
+	P.CustomLUTDomainMin = DomainMin;
+	P.CustomLUTDomainScale = FVector3d(
+		FMath::Abs(DomainRange.X) > UE_SMALL_NUMBER ? 1.0 / DomainRange.X : 1.0,
+		FMath::Abs(DomainRange.Y) > UE_SMALL_NUMBER ? 1.0 / DomainRange.Y : 1.0,
+		FMath::Abs(DomainRange.Z) > UE_SMALL_NUMBER ? 1.0 / DomainRange.Z : 1.0);
+
+	// Working color space, sRGB when the snapshot was made without the engine working color space
+	FMatrix3d ToXYZ = FMatrix3d::FromShaderMatrix(S.WorkingColorSpaceToXYZ);
+	FMatrix3d FromXYZ = FMatrix3d::FromShaderMatrix(S.WorkingColorSpaceFromXYZ);
+	P.WorkingToAP1 = FMatrix3d::FromShaderMatrix(S.WorkingColorSpaceToAP1);
+	P.WorkingFromAP1 = FMatrix3d::FromShaderMatrix(S.WorkingColorSpaceFromAP1);
+	P.bWorkingColorSpaceIsSRGB = S.bWorkingColorSpaceIsSRGB != 0;
+
+	if (P.WorkingToAP1.IsZero())
+	{
+		ToXYZ = sRGB_2_XYZ_MAT;
+		FromXYZ = XYZ_2_sRGB_MAT;
+		P.WorkingToAP1 = sRGB_2_AP1;
+		P.WorkingFromAP1 = AP1_2_sRGB;
+		P.bWorkingColorSpaceIsSRGB = true;
+	}
+
+	// Same condition as the SKIP_TEMPERATURE permutation
+	P.bSkipTemperature = FMath::IsNearlyEqual(S.WhiteTemp, 6500.0f) && FMath::IsNearlyEqual(S.WhiteTint, 0.0f);
+	P.WhiteBalance = WhiteBalanceMatrix(S.WhiteTemp, S.WhiteTint, S.bIsTemperatureWhiteBalance != 0, ToXYZ, FromXYZ);
+
+	const FMatrix3d Wide_2_XYZ_MAT = { { { 0.5441691, 0.2395926, 0.1666943 }, { 0.2394656, 0.7021530, 0.0583814 }, { -0.0023439, 0.0361834, 1.0552183 } } };
+	P.ExpandGamut = (XYZ_2_AP1_MAT * Wide_2_XYZ_MAT) * AP1_2_sRGB;
+	P.ExpandGamutAmount = S.ExpandGamut;
+
+	P.Shadows = GetColorCorrect(S.ColorSaturationShadows * S.ColorSaturation, S.ColorContrastShadows * S.ColorContrast, S.ColorGammaShadows * S.ColorGamma, S.ColorGainShadows * S.ColorGain, S.ColorOffsetShadows + S.ColorOffset);
+	P.Midtones = GetColorCorrect(S.ColorSaturationMidtones * S.ColorSaturation, S.ColorContrastMidtones * S.ColorContrast, S.ColorGammaMidtones * S.ColorGamma, S.ColorGainMidtones * S.ColorGain, S.ColorOffsetMidtones + S.ColorOffset);
+	P.Highlights = GetColorCorrect(S.ColorSaturationHighlights * S.ColorSaturation, S.ColorContrastHighlights * S.ColorContrast, S.ColorGammaHighlights * S.ColorGamma, S.ColorGainHighlights * S.ColorGain, S.ColorOffsetHighlights + S.ColorOffset);
+	P.ColorCorrectionShadowsMax = S.ColorCorrectionShadowsMax;
+	P.ColorCorrectionHighlightsMin = S.ColorCorrectionHighlightsMin;
+	P.ColorCorrectionHighlightsMax = S.ColorCorrectionHighlightsMax;
+	P.ToneCurveAmount = S.ToneCurveAmount;
+
+	P.MappingPolynomial = FVector3d(S.MappingPolynomial);
+	P.ColorScale = FVector3d(S.ColorScale);
+	P.OverlayColor = FVector4d(S.OverlayColor);
+	P.InverseGamma = FVector3d(S.InverseGamma);
+	P.AP1ToOutput = OutputGamutMappingMatrix(S.OutputGamut) * P.WorkingToAP1;
+
+	P.ReinhardWhitePoint = S.ReinhardWhitePoint;
+	P.HejlWhitePoint = S.HejlWhitePoint;
+
+	TonemapOverride::GetFlimConstants(TonemapOverride::GetFlimPreset(S), P.Flim);
+
+	P.GT7BlendRatio = S.GT7BlendRatio;
+	P.GT7FadeStart = S.GT7FadeStart;
+	P.GT7FadeEnd = S.GT7FadeEnd;
+	TonemapOverride::GetGT7Constants(S.OutputDevice, S.OutputMaxLuminance, P.GT7UCSType, P.GT7);
+
+	// Baked last, the curve is evaluated with the parameters above
+	if (S.bSeparableCurve != 0 && HasSeparableCurve(P.TonemapOperator))
+	{
+		TArray<FVector4f> Curve;
+		BakeSeparableCurve(Curve);
+		P.SeparableCurve = MoveTemp(Curve);
+	}
+}
+
+bool FTonemapOverrideCPULUT::HasSeparableCurve(ECustomTonemapOperator TonemapOperator)
+{
+	switch (TonemapOperator)
+	{
+	case ECustomTonemapOperator::Agx:
+	case ECustomTonemapOperator::AgxPunchy:
+	case ECustomTonemapOperator::Flim:
+	case ECustomTonemapOperator::Hejl:
+	case ECustomTonemapOperator::GranTurismo:
+	case ECustomTonemapOperator::GT7:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void FTonemapOverrideCPULUT::BakeSeparableCurve(TArray<FVector4f>& OutEntries) const
+{
+	const int32 NumEntries = FTonemapOverrideSeparableCurve::NumEntries;
+	OutEntries.SetNumUninitialized(NumEntries);
+
+	FTonemapOverrideCPUParameters DirectParameters = Parameters;
+	DirectParameters.SeparableCurve.Empty();
+
+	// Same input on every channel, each output channel is the curve of its own channel
+	alignas(16) float Input[4], OutR[4], OutG[4], OutB[4];
+	for (int32 First = 0; First < NumEntries; First += 4)
+	{
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			Input[Lane] = float(FTonemapOverrideSeparableCurve::EntryToInput(First + Lane));
+		}
+
+		const FFloat4 X = FFloat4::Load(Input);
+		const TRGB<FFloat4> Out = SeparableOperatorCurve(DirectParameters, TRGB<FFloat4>(X, X, X));
+		Out.R.Store(OutR);
+		Out.G.Store(OutG);
+		Out.B.Store(OutB);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			OutEntries[First + Lane] = FVector4f(OutR[Lane], OutG[Lane], OutB[Lane], 0.0f);
+		}
+	}
+}
+
+bool TonemapOverride::IsGT7HDROutputDevice(uint32 OutputDevice)
+{
+	switch (EDisplayOutputFormat(OutputDevice))
+	{
+	case EDisplayOutputFormat::HDR_ACES_1000nit_ST2084:
+	case EDisplayOutputFormat::HDR_ACES_2000nit_ST2084:
+	case EDisplayOutputFormat::HDR_ACES_1000nit_ScRGB:
+	case EDisplayOutputFormat::HDR_ACES_2000nit_ScRGB:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void TonemapOverride::GetGT7Constants(uint32 OutputDevice, float OutputMaxLuminance, EGT7UCSType UCSType, FTonemapOverrideGT7Constants& OutConstants)
+{
+	FTonemapOverrideGT7Constants& G = OutConstants;
+
+	// initializeAsHDR / initializeAsSDR of GT7ToneMapping
+	double PhysicalTargetLuminance = GT7::SdrPaperWhite;
+	G.SdrCorrectionFactor = 1.0 / (GT7::SdrPaperWhite / GT7::ReferenceLuminance);
+
+	if (IsGT7HDROutputDevice(OutputDevice))
+	{
+		// Curve parameters were fitted for the SDR paper white, so the peak is kept at or above it
+		const bool b2000nit = OutputDevice == uint32(EDisplayOutputFormat::HDR_ACES_2000nit_ST2084) || OutputDevice == uint32(EDisplayOutputFormat::HDR_ACES_2000nit_ScRGB);
+		const double DevicePeakLuminance = OutputMaxLuminance > 0.0f ? OutputMaxLuminance : (b2000nit ? 2000.0 : 1000.0);
+		PhysicalTargetLuminance = FMath::Clamp(DevicePeakLuminance, GT7::MinPeakLuminance, GT7::MaxPeakLuminance);
+		G.SdrCorrectionFactor = 1.0;
+	}
+
+	// initializeCurve, shoulder constants
+	G.PeakIntensity = PhysicalTargetLuminance / GT7::ReferenceLuminance;
+	const double K = (GT7::CurveLinearSection - 1.0) / (GT7::CurveAlpha - 1.0);
+	G.kA = G.PeakIntensity * GT7::CurveLinearSection + G.PeakIntensity * K;
+	G.kB = -G.PeakIntensity * K * FMath::Exp(GT7::CurveLinearSection / K);
+	G.kC = -1.0 / (K * G.PeakIntensity);
+
+	// First UCS component (I or Jz) of the target luminance
+	G.LuminanceTargetUcs = RGBToUCS(UCSType, TRGB<double>(G.PeakIntensity)).R;
+}
+
+FVector3d FTonemapOverrideCPULUT::EvaluateReference(const FVector3d& Neutral) const
+{
+	const TRGB<double> Out = CreateLUT(Parameters, TRGB<double>(Neutral));
+	return FVector3d(Out.R, Out.G, Out.B);
+}
+
+void FTonemapOverrideCPULUT::Evaluate4(const float* InR, const float* InG, const float* InB, float* OutR, float* OutG, float* OutB) const
+{
+	const TRGB<FFloat4> Neutral(FFloat4(VectorLoad(InR)), FFloat4(VectorLoad(InG)), FFloat4(VectorLoad(InB)));
+	const TRGB<FFloat4> Out = CreateLUT(Parameters, Neutral);
+
+	VectorStore(Out.R.V, OutR);
+	VectorStore(Out.G.V, OutG);
+	VectorStore(Out.B.V, OutB);
+}
+
+void FTonemapOverrideCPULUT::Generate(int32 LUTSize, TArray<FLinearColor>& OutTexels) const
+{
+	OutTexels.SetNumUninitialized(LUTSize * LUTSize * LUTSize);
+	GenerateSlices(LUTSize, 0, LUTSize, OutTexels);
+}
+
+void FTonemapOverrideCPULUT::GenerateSlices(int32 LUTSize, int32 FirstSlice, int32 NumSlices, TArrayView<FLinearColor> OutTexels) const
+{
+	check(LUTSize > 1);
+
+	TArray<float, TInlineAllocator<256>> LatticeCoordinates;
+	LatticeCoordinates.SetNumUninitialized(LUTSize);
+
+	const float Scale = 1.0f / float(LUTSize - 1);
+	for (int32 Index = 0; Index < LUTSize; ++Index)
+	{
+		LatticeCoordinates[Index] = float(Index) * Scale;
+	}
+
+	GenerateSlicesAt(LatticeCoordinates, FirstSlice, NumSlices, OutTexels);
+}
+
+void FTonemapOverrideCPULUT::GenerateAt(TConstArrayView<float> LatticeCoordinates, TArray<FLinearColor>& OutTexels) const
+{
+	const int32 LUTSize = LatticeCoordinates.Num();
+	OutTexels.SetNumUninitialized(LUTSize * LUTSize * LUTSize);
+	GenerateSlicesAt(LatticeCoordinates, 0, LUTSize, OutTexels);
+}
+
+void FTonemapOverrideCPULUT::GenerateSlicesAt(TConstArrayView<float> LatticeCoordinates, int32 FirstSlice, int32 NumSlices, TArrayView<FLinearColor> OutTexels) const
+{
+	const int32 LUTSize = LatticeCoordinates.Num();
+	check(LUTSize > 1 && OutTexels.Num() == LUTSize * LUTSize * LUTSize);
+	check(FirstSlice >= 0 && FirstSlice + NumSlices <= LUTSize);
+
+	ParallelFor(NumSlices, [this, LUTSize, FirstSlice, LatticeCoordinates, &OutTexels](int32 SliceIndex)
+	{
+		const int32 Blue = FirstSlice + SliceIndex;
+
+		alignas(16) float InR[4], InG[4], InB[4], OutR[4], OutG[4], OutB[4];
+
+		for (int32 Green = 0; Green < LUTSize; ++Green)
+		{
+			FLinearColor* Row = &OutTexels[(Blue * LUTSize + Green) * LUTSize];
+
+			// Four texels of the row at a time, the last batch is padded with the row end
+			for (int32 Red = 0; Red < LUTSize; Red += 4)
+			{
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					InR[Lane] = LatticeCoordinates[FMath::Min(Red + Lane, LUTSize - 1)];
+					InG[Lane] = LatticeCoordinates[Green];
+					InB[Lane] = LatticeCoordinates[Blue];
+				}
+
+				Evaluate4(InR, InG, InB, OutR, OutG, OutB);
+
+				for (int32 Lane = 0; Lane < 4 && Red + Lane < LUTSize; ++Lane)
+				{
+					Row[Red + Lane] = FLinearColor(OutR[Lane], OutG[Lane], OutB[Lane], 0.0f);
+				}
+			}
+		}
+	});
+}
+
+double TonemapOverride::MeasureLUTReferenceError(const FTonemapOverrideCPULUT& CPULUT, TConstArrayView<FLinearColor> Texels, int32 LUTSize, int32& OutNumMismatchedNaN)
+{
+	double MaxError = 0.0;
+	OutNumMismatchedNaN = 0;
+
+	for (int32 Index = 0; Index < Texels.Num(); ++Index)
+	{
+		const FVector3d Neutral(Index % LUTSize, (Index / LUTSize) % LUTSize, Index / (LUTSize * LUTSize));
+		const FVector3d Reference = CPULUT.EvaluateReference(Neutral / double(LUTSize - 1));
+		const FVector3d Value(Texels[Index].R, Texels[Index].G, Texels[Index].B);
+
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			if (FMath::IsNaN(Reference[Channel]) || FMath::IsNaN(Value[Channel]))
+			{
+				OutNumMismatchedNaN += FMath::IsNaN(Reference[Channel]) != FMath::IsNaN(Value[Channel]) ? 1 : 0;
+				continue;
+			}
+			MaxError = FMath::Max(MaxError, FMath::Abs(Reference[Channel] - Value[Channel]) / FMath::Max(1.0, FMath::Abs(Reference[Channel])));
+		}
+	}
+
+	return MaxError;
+}
+
+static void VerifyCPULUT(const TArray<FString>& Args)
+{
+	const int32 LUTSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 17;
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	// Texture of each texture operator, the fallback is verified when the source data is not available
+	FTonemapOverrideCPUTexture3D LUTTextures[int32(ECustomTonemapOperator::MAX)];
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (const TSoftObjectPtr<UTexture>* OperatorTexture = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, ECustomTonemapOperator(Operator)))
+		{
+			FTonemapOverrideCPUTexture3D::LoadFromTexture(OperatorTexture->LoadSynchronous(), LUTTextures[Operator]);
+		}
+	}
+
+	// Neutral settings and a graded setup that exercises white balance, gamut expansion and the grading ranges
+	FPostProcessSettings GradedSettings;
+	GradedSettings.WhiteTemp = 5200.0f;
+	GradedSettings.WhiteTint = 0.1f;
+	GradedSettings.ExpandGamut = 0.5f;
+	GradedSettings.ColorSaturation = FVector4(1.1, 0.9, 1.0, 1.05);
+	GradedSettings.ColorContrastShadows = FVector4(1.1, 1.1, 1.1, 1.0);
+	GradedSettings.ColorGainHighlights = FVector4(1.0, 0.95, 0.9, 1.0);
+
+	const FPostProcessSettings DefaultSettings;
+	const FPostProcessSettings* SettingsToVerify[] = { &DefaultSettings, &GradedSettings };
+
+	bool bAllPassed = true;
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (const FPostProcessSettings* Settings : SettingsToVerify)
+		{
+			FTonemapOverrideLUTSnapshot Snapshot;
+			TonemapOverride::BuildLUTSnapshot(*Settings, TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, LUTSize, TonemapOverrideSettings, Snapshot);
+			TonemapOverride::SetSnapshotOperator(ECustomTonemapOperator(Operator), TonemapOverrideSettings, LUTTextures[Operator].IsValid() ? 1 : 0, Snapshot);
+
+			const FTonemapOverrideCPULUT CPULUT(Snapshot, &LUTTextures[Operator]);
+
+			TArray<FLinearColor> Texels;
+			CPULUT.Generate(LUTSize, Texels);
+
+			// Float lanes against the double reference
+			int32 NumMismatchedNaN = 0;
+			const double MaxError = TonemapOverride::MeasureLUTReferenceError(CPULUT, Texels, LUTSize, NumMismatchedNaN);
+
+			const double Tolerance = TonemapOverride::CPULUTTolerance;
+			const bool bPassed = MaxError <= Tolerance && NumMismatchedNaN == 0;
+			bAllPassed &= bPassed;
+
+			UE_LOG(TonemapOverrideLog, Display, TEXT("CPU LUT %s %s: max error %g, NaN mismatches %d: %s"),
+				*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator),
+				Settings == &DefaultSettings ? TEXT("neutral") : TEXT("graded"),
+				MaxError, NumMismatchedNaN, bPassed ? TEXT("OK") : TEXT("FAILED"));
+		}
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("CPU LUT verification %s"), bAllPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideVerifyCPU(
+	TEXT("r.TonemapOverride.CPU.Verify"),
+	TEXT("Evaluate every tonemap operator with the SIMD CPU LUT path and compare against the double precision reference. Optional LUT size argument (17)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&VerifyCPULUT));
+
+void TonemapOverride::MeasureSeparableCurveError(const FTonemapOverrideLUTSnapshot& Snapshot, int32 LUTSize, double& OutMaxError, double& OutMaxDeltaE)
+{
+	FTonemapOverrideLUTSnapshot DirectSnapshot = Snapshot;
+	DirectSnapshot.bSeparableCurve = 0;
+	TArray<FLinearColor> Direct;
+	FTonemapOverrideCPULUT(DirectSnapshot).Generate(LUTSize, Direct);
+
+	FTonemapOverrideLUTSnapshot SeparableSnapshot = Snapshot;
+	SeparableSnapshot.bSeparableCurve = 1;
+	TArray<FLinearColor> Separable;
+	FTonemapOverrideCPULUT(SeparableSnapshot).Generate(LUTSize, Separable);
+
+	// Encoded output difference and the perceived difference of the texels
+	OutMaxError = 0.0;
+	OutMaxDeltaE = 0.0;
+
+	for (int32 Index = 0; Index < Direct.Num(); ++Index)
+	{
+		OutMaxError = FMath::Max3(OutMaxError, double(FMath::Abs(Direct[Index].R - Separable[Index].R)), double(FMath::Max(FMath::Abs(Direct[Index].G - Separable[Index].G), FMath::Abs(Direct[Index].B - Separable[Index].B))));
+		OutMaxDeltaE = FMath::Max(OutMaxDeltaE, TonemapOverride::DeltaE2000(TonemapOverride::LUTOutputToLab(Direct[Index]), TonemapOverride::LUTOutputToLab(Separable[Index])));
+	}
+}
+
+static void VerifySeparableCurve(const TArray<FString>& Args)
+{
+	const int32 LUTSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 33;
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	// Neutral settings and a graded setup that pushes the curve input past the diffuse range
+	FPostProcessSettings GradedSettings;
+	GradedSettings.ColorGain = FVector4(1.2, 1.0, 0.8, 2.0);
+	GradedSettings.ColorContrast = FVector4(1.0, 1.0, 1.0, 1.2);
+
+	const FPostProcessSettings DefaultSettings;
+	const FPostProcessSettings* SettingsToVerify[] = { &DefaultSettings, &GradedSettings };
+
+	bool bAllPassed = true;
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::HasSeparableCurve(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		for (const FPostProcessSettings* Settings : SettingsToVerify)
+		{
+			FTonemapOverrideLUTSnapshot Snapshot;
+			TonemapOverride::BuildLUTSnapshot(*Settings, TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, LUTSize, TonemapOverrideSettings, Snapshot);
+			TonemapOverride::SetSnapshotOperator(ECustomTonemapOperator(Operator), TonemapOverrideSettings, 0, Snapshot);
+
+			double MaxError = 0.0;
+			double MaxDeltaE = 0.0;
+			TonemapOverride::MeasureSeparableCurveError(Snapshot, LUTSize, MaxError, MaxDeltaE);
+
+			const bool bPassed = MaxError <= TonemapOverride::SeparableCurveTolerance && MaxDeltaE <= TonemapOverride::SeparableCurveDeltaETolerance;
+			bAllPassed &= bPassed;
+
+			UE_LOG(TonemapOverrideLog, Display, TEXT("Separable curve %s %s: max error %g, max delta E %.4f: %s"),
+				*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator),
+				Settings == &DefaultSettings ? TEXT("neutral") : TEXT("graded"),
+				MaxError, MaxDeltaE, bPassed ? TEXT("OK") : TEXT("FAILED"));
+		}
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Separable curve verification %s"), bAllPassed ? TEXT("passed") : TEXT("FAILED"));
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideVerifySeparableCurve(
+	TEXT("r.TonemapOverride.CPU.VerifySeparableCurve"),
+	TEXT("Generate every separable operator with the baked 1D curve and with direct evaluation on the CPU and compare the LUTs. Optional LUT size argument (33)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&VerifySeparableCurve));
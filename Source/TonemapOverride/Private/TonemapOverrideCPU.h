@@ -0,0 +1,227 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TonemapOverrideCPUMath.h"
+#include "TonemapOverrideLUTSettings.h"
+
+class UTexture;
+
+// CPU mirror of CreateLUT in CustomTonemapLUT.usf for tools and headless verification
+// Stages follow the shader: neutral cube, log to linear, white balance, AP1 grading, tonemap operator, output device
+
+// Volume texture sampled on the CPU like Texture3DSample with a bilinear clamp sampler (Tony, Custom LUT)
+struct FTonemapOverrideCPUTexture3D
+{
+	FIntVector Size = FIntVector::ZeroValue;
+	TArray<FVector3f> Texels;
+
+	bool IsValid() const { return Size.X > 0 && Size.Y > 0 && Size.Z > 0 && Texels.Num() == Size.X * Size.Y * Size.Z; }
+
+	FVector3f Sample(const FVector3f& UVW) const;
+
+	// Same coordinates as Sample, interpolated inside the tetrahedron of the lattice cell (r.TonemapOverride.TetrahedralLUT)
+	FVector3f SampleTetrahedral(const FVector3f& UVW) const;
+
+	// Reads the source data of a float volume texture, editor only as cooked textures do not keep the source
+	static bool LoadFromTexture(const UTexture* Texture, FTonemapOverrideCPUTexture3D& OutTexture);
+};
+
+// Flim preset resolved for LUT generation, shared by the shader parameters and the CPU LUT
+struct FTonemapOverrideFlimConstants
+{
+	using FMatrix3d = TonemapOverride::CPU::FMatrix3d;
+
+	double PreExposure = 0;
+	FVector3d PreFormationFilter;
+	double PreFormationFilterStrength = 0;
+	double SigmoidLog2Min = 0;
+	double SigmoidLog2Max = 0;
+	double SigmoidToeX = 0;
+	double SigmoidToeY = 0;
+	double SigmoidShoulderX = 0;
+	double SigmoidShoulderY = 0;
+	double NegativeFilmExposure = 0;
+	double NegativeFilmDensity = 0;
+	double PrintFilmExposure = 0;
+	double PrintFilmDensity = 0;
+	FVector3d PostFormationFilter;
+	double PostFormationFilterStrength = 0;
+	double MidtoneSaturation = 0;
+
+	// Derived from the preset, these cost two full negative / print developments per texel in the shader otherwise
+	FMatrix3d Extend;
+	FMatrix3d ExtendInverse;
+	FVector3d BacklightExt;
+	FVector3d WhiteCap;
+	double BlackPoint = 0;
+};
+
+// GT7 curve and UCS constants for the target display, the shader would otherwise initialize them per texel
+struct FTonemapOverrideGT7Constants
+{
+	double PeakIntensity = 0;			// Target luminance as a frame buffer value, 1.0 is 100 nits
+	double SdrCorrectionFactor = 1;
+	double LuminanceTargetUcs = 0;
+	double kA = 0;
+	double kB = 0;
+	double kC = 0;
+};
+
+// Per channel part of the separable operators as a 1D curve per channel, sampled instead of evaluated for every texel
+// Entries are log spaced over the input 0..DomainMax with a linear toe, constants match SeparableCurve.usf
+struct FTonemapOverrideSeparableCurve
+{
+	static constexpr int32 NumEntries = 4096;
+	static constexpr double DomainStops = 24.0;
+	static constexpr double DomainMax = 16384.0;
+
+	static double EntryToInput(double Entry)
+	{
+		return (FMath::Pow(2.0, Entry / (NumEntries - 1) * DomainStops) - 1.0) * GetDomainScale();
+	}
+
+	static double InputToEntry(double Input)
+	{
+		return FMath::Clamp(FMath::Log2(FMath::Max(Input, 0.0) / GetDomainScale() + 1.0) / DomainStops, 0.0, 1.0) * (NumEntries - 1);
+	}
+
+	static double GetDomainScale() { return DomainMax / (FMath::Pow(2.0, DomainStops) - 1.0); }
+};
+
+namespace TonemapOverride
+{
+	void GetFlimConstants(const FTonemapOverrideFlimPreset& Preset, FTonemapOverrideFlimConstants& OutConstants);
+
+	// ST2084 and scRGB outputs, GT7 maps to the display peak luminance on these instead of the SDR paper white
+	bool IsGT7HDROutputDevice(uint32 OutputDevice);
+
+	void GetGT7Constants(uint32 OutputDevice, float OutputMaxLuminance, EGT7UCSType UCSType, FTonemapOverrideGT7Constants& OutConstants);
+}
+
+// Per snapshot constants, everything that does not depend on the texel is resolved once here
+struct FTonemapOverrideCPUParameters
+{
+	using FMatrix3d = TonemapOverride::CPU::FMatrix3d;
+
+	ECustomTonemapOperator TonemapOperator = ECustomTonemapOperator::Agx;
+	EGT7UCSType GT7UCSType = EGT7UCSType::ICtCp;
+	uint32 OutputDevice = 0;
+	bool bSkipTemperature = true;
+	bool bWorkingColorSpaceIsSRGB = true;
+	// FAST_MATH operator variant (FastMath.usf)
+	bool bFastMath = false;
+
+	FMatrix3d WhiteBalance;
+	FMatrix3d WorkingToAP1;
+	FMatrix3d WorkingFromAP1;
+	FMatrix3d AP1ToOutput;
+	FMatrix3d ExpandGamut;
+
+	// Grading, shadows / midtones / highlights already combined with the global values as in ColorCorrectAll
+	struct FColorCorrect
+	{
+		FVector3d Saturation;
+		FVector3d Contrast;
+		FVector3d Gamma;
+		FVector3d Gain;
+		FVector3d Offset;
+	};
+	FColorCorrect Shadows;
+	FColorCorrect Midtones;
+	FColorCorrect Highlights;
+
+	double ColorCorrectionShadowsMax = 0;
+	double ColorCorrectionHighlightsMin = 0;
+	double ColorCorrectionHighlightsMax = 0;
+	double ExpandGamutAmount = 0;
+	double ToneCurveAmount = 1;
+
+	FVector3d MappingPolynomial;
+	FVector3d ColorScale;
+	FVector4d OverlayColor;
+	FVector3d InverseGamma;
+
+	double ReinhardWhitePoint = 0;
+	double HejlWhitePoint = 0;
+
+	FTonemapOverrideFlimConstants Flim;
+
+	double GT7BlendRatio = 0;
+	double GT7FadeStart = 0;
+	double GT7FadeEnd = 0;
+	FTonemapOverrideGT7Constants GT7;
+
+	// Baked curve of a separable operator (FTonemapOverrideSeparableCurve), empty evaluates the operator directly
+	TArray<FVector4f> SeparableCurve;
+
+	const FTonemapOverrideCPUTexture3D* LUTTexture = nullptr;
+	ETonyLUTMode TonyLUTMode = ETonyLUTMode::Fallback;
+	bool bTetrahedralLUT = false;
+
+	ECustomLUTInputEncoding CustomLUTInput = ECustomLUTInputEncoding::EngineLog;
+	ECustomLUTOutputEncoding CustomLUTOutput = ECustomLUTOutputEncoding::sRGB;
+	FVector3d CustomLUTDomainMin = FVector3d::ZeroVector;
+	FVector3d CustomLUTDomainScale = FVector3d::OneVector;
+};
+
+class FTonemapOverrideCPULUT
+{
+public:
+	// Tony and Custom LUT need the LUT texture data, without it the shader fallback is mirrored
+	FTonemapOverrideCPULUT(const FTonemapOverrideLUTSnapshot& Snapshot, const FTonemapOverrideCPUTexture3D* LUTTexture = nullptr);
+
+	// ACES goes through the full engine ACES implementation which is not mirrored on the CPU
+	static bool IsOperatorSupported(ECustomTonemapOperator TonemapOperator) { return TonemapOperator != ECustomTonemapOperator::ACES && TonemapOperator < ECustomTonemapOperator::MAX; }
+	bool IsSupported() const { return IsOperatorSupported(Parameters.TonemapOperator); }
+
+	// Operators that are per channel curves between fixed matrices: AgX, Flim (negative and print), Hejl, Uchimura and
+	// the skewed color of GT7. With bSeparableCurve in the snapshot the curve is baked once and sampled per texel
+	static bool HasSeparableCurve(ECustomTonemapOperator TonemapOperator);
+
+	// Evaluate the per channel part of the operator at the curve entries, in the layout SeparableCurve.usf reads
+	void BakeSeparableCurve(TArray<FVector4f>& OutEntries) const;
+
+	// Double precision scalar reference for a neutral LUT coordinate in 0..1
+	FVector3d EvaluateReference(const FVector3d& Neutral) const;
+
+	// SIMD evaluation of four neutral coordinates in structure of arrays layout
+	void Evaluate4(const float* InR, const float* InG, const float* InB, float* OutR, float* OutG, float* OutB) const;
+
+	// Whole LUT in canonical layout (R + G * Size + B * Size * Size), slices are generated in parallel
+	void Generate(int32 LUTSize, TArray<FLinearColor>& OutTexels) const;
+
+	// Generate slices [FirstSlice, FirstSlice + NumSlices) into OutTexels that holds the whole LUT
+	void GenerateSlices(int32 LUTSize, int32 FirstSlice, int32 NumSlices, TArrayView<FLinearColor> OutTexels) const;
+
+	// Whole LUT with the lattice at the given neutral coordinates per axis instead of uniform steps (shaped LUTs)
+	void GenerateAt(TConstArrayView<float> LatticeCoordinates, TArray<FLinearColor>& OutTexels) const;
+
+	const FTonemapOverrideCPUParameters& GetParameters() const { return Parameters; }
+
+private:
+	void GenerateSlicesAt(TConstArrayView<float> LatticeCoordinates, int32 FirstSlice, int32 NumSlices, TArrayView<FLinearColor> OutTexels) const;
+
+	FTonemapOverrideCPUParameters Parameters;
+};
+
+namespace TonemapOverride
+{
+	// Largest error of the SIMD CPU LUT against the double precision reference (r.TonemapOverride.CPU.Verify, automation tests)
+	// Just above one code of the 10 bit runtime LUT (1/1023), float lanes may move a texel by one code but not more
+	constexpr double CPULUTTolerance = 1e-3;
+
+	// Largest error of a LUT in canonical layout against the double precision reference of CPULUT, relative to the magnitude
+	// for HDR outputs. Channels where only one of them is NaN are counted in OutNumMismatchedNaN
+	double MeasureLUTReferenceError(const FTonemapOverrideCPULUT& CPULUT, TConstArrayView<FLinearColor> Texels, int32 LUTSize, int32& OutNumMismatchedNaN);
+
+	// Largest encoded output and CIEDE2000 difference of the LUT with the baked separable curve to direct evaluation
+	// Two codes of the 10 bit runtime LUT for the linear interpolation between curve entries, and a quarter of the
+	// just noticeable CIEDE2000 difference of 1 so that the curve is never the visible part of the LUT error
+	constexpr double SeparableCurveTolerance = 2e-3;
+	constexpr double SeparableCurveDeltaETolerance = 0.25;
+
+	// LUT of the snapshot generated with the baked separable curve and with the operator evaluated directly, compared texel by texel
+	void MeasureSeparableCurveError(const FTonemapOverrideLUTSnapshot& Snapshot, int32 LUTSize, double& OutMaxError, double& OutMaxDeltaE);
+}
@@ -0,0 +1,263 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include <cmath>
+
+// Math layer for the CPU LUT kernel. Every function exists for double (the scalar reference) and FFloat4 (four texels
+// in SIMD lanes), so the kernel is written once as a template. Branches are written as selects.
+// Min / Max return the second operand for NaN input, matching the HLSL min / max behavior the shaders rely on.
+
+namespace TonemapOverride::CPU
+{
+	struct FMask4
+	{
+		VectorRegister4Float V;
+	};
+
+	struct FFloat4
+	{
+		VectorRegister4Float V;
+
+		FFloat4() = default;
+		FORCEINLINE FFloat4(const VectorRegister4Float& In) : V(In) {}
+		FORCEINLINE FFloat4(double In) : V(VectorSetFloat1(float(In))) {}
+
+		FORCEINLINE static FFloat4 Load(const float* Source) { return FFloat4(VectorLoad(Source)); }
+		FORCEINLINE void Store(float* Dest) const { VectorStore(V, Dest); }
+	};
+
+	FORCEINLINE FFloat4 operator+(const FFloat4& A, const FFloat4& B) { return VectorAdd(A.V, B.V); }
+	FORCEINLINE FFloat4 operator-(const FFloat4& A, const FFloat4& B) { return VectorSubtract(A.V, B.V); }
+	FORCEINLINE FFloat4 operator*(const FFloat4& A, const FFloat4& B) { return VectorMultiply(A.V, B.V); }
+	FORCEINLINE FFloat4 operator/(const FFloat4& A, const FFloat4& B) { return VectorDivide(A.V, B.V); }
+	FORCEINLINE FFloat4 operator-(const FFloat4& A) { return VectorNegate(A.V); }
+
+	FORCEINLINE FMask4 operator<(const FFloat4& A, const FFloat4& B) { return { VectorCompareLT(A.V, B.V) }; }
+	FORCEINLINE FMask4 operator<=(const FFloat4& A, const FFloat4& B) { return { VectorCompareLE(A.V, B.V) }; }
+	FORCEINLINE FMask4 operator>(const FFloat4& A, const FFloat4& B) { return { VectorCompareGT(A.V, B.V) }; }
+	FORCEINLINE FMask4 operator>=(const FFloat4& A, const FFloat4& B) { return { VectorCompareGE(A.V, B.V) }; }
+	FORCEINLINE FMask4 operator==(const FFloat4& A, const FFloat4& B) { return { VectorCompareEQ(A.V, B.V) }; }
+	FORCEINLINE FMask4 operator!=(const FFloat4& A, const FFloat4& B) { return { VectorCompareNE(A.V, B.V) }; }
+
+	FORCEINLINE FMask4 And(const FMask4& A, const FMask4& B) { return { VectorBitwiseAnd(A.V, B.V) }; }
+	FORCEINLINE bool And(bool A, bool B) { return A && B; }
+
+	FORCEINLINE FFloat4 Select(const FMask4& Mask, const FFloat4& A, const FFloat4& B) { return VectorSelect(Mask.V, A.V, B.V); }
+	FORCEINLINE double Select(bool bMask, double A, double B) { return bMask ? A : B; }
+
+	FORCEINLINE FFloat4 Min(const FFloat4& A, const FFloat4& B) { return Select(A < B, A, B); }
+	FORCEINLINE FFloat4 Max(const FFloat4& A, const FFloat4& B) { return Select(A > B, A, B); }
+	FORCEINLINE double Min(double A, double B) { return A < B ? A : B; }
+	FORCEINLINE double Max(double A, double B) { return A > B ? A : B; }
+
+	FORCEINLINE FFloat4 Floor(const FFloat4& A) { return VectorFloor(A.V); }
+	FORCEINLINE FFloat4 Pow(const FFloat4& A, const FFloat4& B) { return VectorPow(A.V, B.V); }
+	FORCEINLINE FFloat4 Exp(const FFloat4& A) { return VectorExp(A.V); }
+	FORCEINLINE FFloat4 Exp2(const FFloat4& A) { return VectorExp2(A.V); }
+	FORCEINLINE FFloat4 Log2(const FFloat4& A) { return VectorLog2(A.V); }
+	FORCEINLINE double Floor(double A) { return FMath::FloorToDouble(A); }
+	FORCEINLINE double Pow(double A, double B) { return FMath::Pow(A, B); }
+	FORCEINLINE double Exp(double A) { return FMath::Exp(A); }
+	FORCEINLINE double Exp2(double A) { return FMath::Pow(2.0, A); }
+	FORCEINLINE double Log2(double A) { return FMath::Log2(A); }
+
+	// FastMath.usf approximations of the FAST_MATH operator variants, polynomials shared by both lane types
+	template<typename V> FORCEINLINE V FastLog2Mantissa(const V& T)
+	{
+		return T * (V(1.44191695) + T * (V(-0.70909574) + T * (V(0.41560423) + T * (V(-0.19357379) + T * V(0.04514835)))));
+	}
+
+	template<typename V> FORCEINLINE V FastExp2Fraction(const V& F)
+	{
+		return V(1.0) + F * (V(0.69303212) + F * (V(0.24137978) + F * (V(0.05203237) + F * V(0.01355574))));
+	}
+
+	FORCEINLINE FFloat4 FastLog2(const FFloat4& A)
+	{
+		const VectorRegister4Int Bits = VectorCastFloatToInt(A.V);
+		const FFloat4 Exponent = VectorIntToFloat(VectorIntSubtract(VectorShiftRightImmArithmetic(Bits, 23), VectorIntSet1(127)));
+		const FFloat4 T = FFloat4(VectorCastIntToFloat(VectorIntOr(VectorIntAnd(Bits, VectorIntSet1(0x007FFFFF)), VectorIntSet1(0x3F800000)))) - FFloat4(1.0);
+		return Exponent + FastLog2Mantissa(T);
+	}
+
+	FORCEINLINE FFloat4 FastExp2(const FFloat4& A)
+	{
+		const FFloat4 X = Min(Max(A, FFloat4(-126.0)), FFloat4(126.0));
+		const FFloat4 I = Floor(X);
+		const FFloat4 P = FastExp2Fraction(X - I);
+		return VectorCastIntToFloat(VectorIntAdd(VectorCastFloatToInt(P.V), VectorShiftLeftImm(VectorFloatToInt(I.V), 23)));
+	}
+
+	FORCEINLINE double FastLog2(double A)
+	{
+		// Mantissa in 1..2 as the float bit layout gives it
+		int32 Exponent = 0;
+		const double Mantissa = std::frexp(A, &Exponent) * 2.0;
+		return double(Exponent - 1) + FastLog2Mantissa(Mantissa - 1.0);
+	}
+
+	FORCEINLINE double FastExp2(double A)
+	{
+		const double X = Min(Max(A, -126.0), 126.0);
+		const double I = Floor(X);
+		return std::ldexp(FastExp2Fraction(X - I), int32(I));
+	}
+
+	template<typename V> FORCEINLINE V FastPow(const V& A, const V& B) { return Select(A > V(0.0), FastExp2(B * FastLog2(A)), V(0.0)); }
+
+	// Exact or fast by the operator variant
+	template<typename V> FORCEINLINE V OperatorPow(const V& A, const V& B, bool bFastMath) { return bFastMath ? FastPow(A, B) : Pow(A, B); }
+	template<typename V> FORCEINLINE V OperatorExp2(const V& A, bool bFastMath) { return bFastMath ? FastExp2(A) : Exp2(A); }
+	template<typename V> FORCEINLINE V OperatorExp(const V& A, bool bFastMath) { return bFastMath ? FastExp2(A * V(1.4426950408889634)) : Exp(A); }
+	template<typename V> FORCEINLINE V OperatorLog2(const V& A, bool bFastMath) { return bFastMath ? FastLog2(A) : Log2(A); }
+
+	template<typename V> FORCEINLINE V Clamp(const V& X, const V& Lo, const V& Hi) { return Min(Max(X, Lo), Hi); }
+	template<typename V> FORCEINLINE V Saturate(const V& X) { return Clamp(X, V(0.0), V(1.0)); }
+	template<typename V> FORCEINLINE V Frac(const V& X) { return X - Floor(X); }
+	template<typename V> FORCEINLINE V Lerp(const V& A, const V& B, const V& T) { return A + (B - A) * T; }
+	template<typename V> FORCEINLINE V Step(const V& Edge, const V& X) { return Select(X >= Edge, V(1.0), V(0.0)); }
+
+	template<typename V> FORCEINLINE V SmoothStep(const V& A, const V& B, const V& X)
+	{
+		const V T = Saturate((X - A) / (B - A));
+		return T * T * (V(3.0) - V(2.0) * T);
+	}
+
+	// float3 of the shaders
+	template<typename V>
+	struct TRGB
+	{
+		V R, G, B;
+
+		TRGB() = default;
+		TRGB(const V& In) : R(In), G(In), B(In) {}
+		TRGB(const V& InR, const V& InG, const V& InB) : R(InR), G(InG), B(InB) {}
+		TRGB(const FVector3d& In) : R(In.X), G(In.Y), B(In.Z) {}
+	};
+
+	template<typename V> FORCEINLINE TRGB<V> operator+(const TRGB<V>& A, const TRGB<V>& B) { return { A.R + B.R, A.G + B.G, A.B + B.B }; }
+	template<typename V> FORCEINLINE TRGB<V> operator-(const TRGB<V>& A, const TRGB<V>& B) { return { A.R - B.R, A.G - B.G, A.B - B.B }; }
+	template<typename V> FORCEINLINE TRGB<V> operator*(const TRGB<V>& A, const TRGB<V>& B) { return { A.R * B.R, A.G * B.G, A.B * B.B }; }
+	template<typename V> FORCEINLINE TRGB<V> operator/(const TRGB<V>& A, const TRGB<V>& B) { return { A.R / B.R, A.G / B.G, A.B / B.B }; }
+	template<typename V> FORCEINLINE TRGB<V> operator*(const TRGB<V>& A, const V& B) { return { A.R * B, A.G * B, A.B * B }; }
+	template<typename V> FORCEINLINE TRGB<V> operator/(const TRGB<V>& A, const V& B) { return { A.R / B, A.G / B, A.B / B }; }
+
+	template<typename V> FORCEINLINE V Dot(const TRGB<V>& A, const TRGB<V>& B) { return A.R * B.R + A.G * B.G + A.B * B.B; }
+	template<typename V> FORCEINLINE TRGB<V> Min(const TRGB<V>& A, const TRGB<V>& B) { return { Min(A.R, B.R), Min(A.G, B.G), Min(A.B, B.B) }; }
+	template<typename V> FORCEINLINE TRGB<V> Max(const TRGB<V>& A, const TRGB<V>& B) { return { Max(A.R, B.R), Max(A.G, B.G), Max(A.B, B.B) }; }
+	template<typename V> FORCEINLINE TRGB<V> Pow(const TRGB<V>& A, const TRGB<V>& B) { return { Pow(A.R, B.R), Pow(A.G, B.G), Pow(A.B, B.B) }; }
+	template<typename V> FORCEINLINE TRGB<V> Exp2(const TRGB<V>& A) { return { Exp2(A.R), Exp2(A.G), Exp2(A.B) }; }
+	template<typename V> FORCEINLINE TRGB<V> Log2(const TRGB<V>& A) { return { Log2(A.R), Log2(A.G), Log2(A.B) }; }
+	template<typename V> FORCEINLINE TRGB<V> Clamp(const TRGB<V>& X, const TRGB<V>& Lo, const TRGB<V>& Hi) { return Min(Max(X, Lo), Hi); }
+	template<typename V> FORCEINLINE TRGB<V> Lerp(const TRGB<V>& A, const TRGB<V>& B, const V& T) { return { Lerp(A.R, B.R, T), Lerp(A.G, B.G, T), Lerp(A.B, B.B, T) }; }
+
+	template<typename V, typename FunctionType>
+	FORCEINLINE TRGB<V> Map(const TRGB<V>& A, FunctionType&& Function) { return { Function(A.R), Function(A.G), Function(A.B) }; }
+
+	// 3x3 matrix applied like HLSL mul(M, v), rows as written in the shaders
+	struct FMatrix3d
+	{
+		double M[3][3];
+
+		static FMatrix3d Identity()
+		{
+			return { { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } } };
+		}
+
+		// Upper 3x3 of a shader parameter matrix, which the shaders cast to float3x3
+		static FMatrix3d FromShaderMatrix(const FMatrix44f& In)
+		{
+			FMatrix3d Out;
+			for (int32 Row = 0; Row < 3; ++Row)
+			{
+				for (int32 Column = 0; Column < 3; ++Column)
+				{
+					Out.M[Row][Column] = In.M[Row][Column];
+				}
+			}
+			return Out;
+		}
+
+		// Inverse to the shader parameter layout that FromShaderMatrix reads
+		FMatrix44f ToShaderMatrix() const
+		{
+			FMatrix44f Out(EForceInit::ForceInitToZero);
+			for (int32 Row = 0; Row < 3; ++Row)
+			{
+				for (int32 Column = 0; Column < 3; ++Column)
+				{
+					Out.M[Row][Column] = float(M[Row][Column]);
+				}
+			}
+			Out.M[3][3] = 1.0f;
+			return Out;
+		}
+
+		FMatrix3d Inverse() const
+		{
+			const double C00 = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+			const double C01 = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+			const double C02 = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+			const double Determinant = M[0][0] * C00 + M[0][1] * C01 + M[0][2] * C02;
+			const double InvDeterminant = Determinant != 0.0 ? 1.0 / Determinant : 0.0;
+
+			FMatrix3d Out;
+			Out.M[0][0] = C00 * InvDeterminant;
+			Out.M[0][1] = (M[0][2] * M[2][1] - M[0][1] * M[2][2]) * InvDeterminant;
+			Out.M[0][2] = (M[0][1] * M[1][2] - M[0][2] * M[1][1]) * InvDeterminant;
+			Out.M[1][0] = C01 * InvDeterminant;
+			Out.M[1][1] = (M[0][0] * M[2][2] - M[0][2] * M[2][0]) * InvDeterminant;
+			Out.M[1][2] = (M[0][2] * M[1][0] - M[0][0] * M[1][2]) * InvDeterminant;
+			Out.M[2][0] = C02 * InvDeterminant;
+			Out.M[2][1] = (M[0][1] * M[2][0] - M[0][0] * M[2][1]) * InvDeterminant;
+			Out.M[2][2] = (M[0][0] * M[1][1] - M[0][1] * M[1][0]) * InvDeterminant;
+			return Out;
+		}
+
+		bool IsZero() const
+		{
+			for (int32 Row = 0; Row < 3; ++Row)
+			{
+				for (int32 Column = 0; Column < 3; ++Column)
+				{
+					if (M[Row][Column] != 0.0)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	};
+
+	FORCEINLINE FMatrix3d operator*(const FMatrix3d& A, const FMatrix3d& B)
+	{
+		FMatrix3d Out;
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Column = 0; Column < 3; ++Column)
+			{
+				Out.M[Row][Column] = A.M[Row][0] * B.M[0][Column] + A.M[Row][1] * B.M[1][Column] + A.M[Row][2] * B.M[2][Column];
+			}
+		}
+		return Out;
+	}
+
+	template<typename V>
+	FORCEINLINE TRGB<V> Mul(const FMatrix3d& A, const TRGB<V>& C)
+	{
+		return {
+			V(A.M[0][0]) * C.R + V(A.M[0][1]) * C.G + V(A.M[0][2]) * C.B,
+			V(A.M[1][0]) * C.R + V(A.M[1][1]) * C.G + V(A.M[1][2]) * C.B,
+			V(A.M[2][0]) * C.R + V(A.M[2][1]) * C.G + V(A.M[2][2]) * C.B };
+	}
+
+	FORCEINLINE FVector3d Mul(const FMatrix3d& A, const FVector3d& C)
+	{
+		const TRGB<double> Out = Mul(A, TRGB<double>(C));
+		return FVector3d(Out.R, Out.G, Out.B);
+	}
+}
@@ -4,17 +4,70 @@
 #include "TonemapOverrideEngineSubsystem.h"
 #include "TonemapOverrideSceneViewExtension.h"
 #include "TonemapOverride.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverrideBakedLUTs.h"
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "RenderingThread.h"
+#include "Engine/Texture.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
 
 void UTonemapOverrideEngineSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	// Baked LUTs are optional, without them all LUTs are generated live
+	BakedLUTs = UTonemapOverrideSettings::Get().BakedLUTs.LoadSynchronous();
 
-	TonemapOverrideSceneViewExtension = FSceneViewExtensions::NewExtension<FTonemapOverrideSceneViewExtension>();
+	TonemapOverrideSceneViewExtension = FSceneViewExtensions::NewExtension<FTonemapOverrideSceneViewExtension>(BakedLUTs.Get());
 	UE_LOG(TonemapOverrideLog, Log, TEXT("TonemapOverride SceneViewExtension created"));
 
+	// Render thread reads a copy of the settings, updated when they change
+	TonemapOverride::UpdateRenderSettings();
+
+	// Pipelines of all compiled operators are requested up front and again when a level is loaded,
+	// global shaders compiled in the meantime are picked up then
+	TonemapOverride::PrecacheLUTPipelines();
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UTonemapOverrideEngineSubsystem::OnPostLoadMapWithWorld);
+
+	// LUT textures are loaded in the background, generated LUTs use the operator fallback until the texture is ready
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	for (const TSoftObjectPtr<UTexture>* TexturePtr : { &TonemapOverrideSettings.LUTTexture, &TonemapOverrideSettings.CustomLUTTexture })
+	{
+		const FSoftObjectPath LUTTexturePath = TexturePtr->ToSoftObjectPath();
+		if (!LUTTexturePath.IsValid())
+		{
+			continue;
+		}
+
+		TWeakObjectPtr<UTonemapOverrideEngineSubsystem> WeakThis(this);
+
+		LoadPackageAsync(LUTTexturePath.GetLongPackageName(), FLoadPackageAsyncDelegate::CreateLambda(
+			[WeakThis, LUTTexturePath](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+			{
+				UTexture* Texture = Result == EAsyncLoadingResult::Succeeded ? Cast<UTexture>(LUTTexturePath.ResolveObject()) : nullptr;
+				if (!Texture)
+				{
+					UE_LOG(TonemapOverrideLog, Warning, TEXT("Failed to load LUT texture %s"), *LUTTexturePath.ToString());
+					return;
+				}
+
+				if (WeakThis.IsValid())
+				{
+					WeakThis->LUTTextures.AddUnique(Texture);
+				}
+
+				// Resource of the texture is initialized on load, the render settings pick it up from here on
+				TonemapOverride::UpdateRenderSettings();
+			}));
+	}
+
 }
 
 void UTonemapOverrideEngineSubsystem::Deinitialize()
 {
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
 	{
 		TonemapOverrideSceneViewExtension->IsActiveThisFrameFunctions.Empty();
 
@@ -30,4 +83,43 @@ void UTonemapOverrideEngineSubsystem::Deinitialize()
 
 	TonemapOverrideSceneViewExtension.Reset();
 	TonemapOverrideSceneViewExtension = nullptr;
+
+	// Render thread may still reference the baked LUTs
+	FlushRenderingCommands();
+	BakedLUTs = nullptr;
+	LUTTextures.Empty();
+
+	TonemapOverride::SaveLUTBakeKeys(TonemapOverride::GetDefaultLUTBakeKeysFilename());
+
+	// Cook logs carry the permutation counts and compile times of the plugin shaders
+	if (IsRunningCookCommandlet())
+	{
+		TonemapOverride::LogShaderReport();
+	}
+}
+
+void UTonemapOverrideEngineSubsystem::SetTonemapOperator(ECustomTonemapOperator Operator)
+{
+	if (Operator == ECustomTonemapOperator::MAX)
+	{
+		ResetTonemapOperator();
+		return;
+	}
+
+	UE_CLOG(!TonemapOverride::GetCompiledPermutations().IsTonemapOperatorCompiled(Operator), TonemapOverrideLog, Warning, TEXT("%s is not in the Compiled Operators of the plugin settings, ACES is used instead"), *UEnum::GetValueAsString(Operator));
+
+	// Console variable sink passes the change to the render thread at the end of the frame
+	static IConsoleVariable* CVarOperator = IConsoleManager::Get().FindConsoleVariable(TEXT("r.TonemapOverride.Operator"));
+	CVarOperator->Set(int32(Operator), ECVF_SetByCode);
+}
+
+void UTonemapOverrideEngineSubsystem::ResetTonemapOperator()
+{
+	static IConsoleVariable* CVarOperator = IConsoleManager::Get().FindConsoleVariable(TEXT("r.TonemapOverride.Operator"));
+	CVarOperator->Set(-1, ECVF_SetByCode);
+}
+
+void UTonemapOverrideEngineSubsystem::OnPostLoadMapWithWorld(UWorld* World)
+{
+	TonemapOverride::PrecacheLUTPipelines();
 }
@@ -0,0 +1,205 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideExportCommandlet.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideLUTExport.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Texture.h"
+#include "Interfaces/Interface_PostProcessVolume.h"
+#include "Misc/Paths.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// Overridden values of the volume on top of the defaults, like the engine does for a single volume at full weight
+	void ApplyOverriddenSettings(const FPostProcessSettings& Source, FPostProcessSettings& Dest)
+	{
+		const UScriptStruct* Struct = FPostProcessSettings::StaticStruct();
+		const FString OverridePrefix = TEXT("bOverride_");
+
+		for (TFieldIterator<FBoolProperty> It(Struct); It; ++It)
+		{
+			const FString OverrideName = It->GetName();
+			if (!OverrideName.StartsWith(OverridePrefix) || !It->GetPropertyValue_InContainer(&Source))
+			{
+				continue;
+			}
+
+			if (const FProperty* Property = Struct->FindPropertyByName(FName(*OverrideName.RightChop(OverridePrefix.Len()))))
+			{
+				Property->CopyCompleteValue_InContainer(&Dest, &Source);
+			}
+		}
+	}
+}
+
+UTonemapOverrideExportCommandlet::UTonemapOverrideExportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTonemapOverrideExportCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	ECustomTonemapOperator TonemapOperator = TonemapOverrideSettings.CustomTonemapOperator;
+	if (const FString* OperatorParam = ParamVals.Find(TEXT("Operator")))
+	{
+		const int64 Value = StaticEnum<ECustomTonemapOperator>()->GetValueByNameString(*OperatorParam);
+		if (Value == INDEX_NONE || Value >= int64(ECustomTonemapOperator::MAX))
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("Unknown tonemap operator %s"), **OperatorParam);
+			return 1;
+		}
+		TonemapOperator = ECustomTonemapOperator(Value);
+	}
+
+	if (!FTonemapOverrideCPULUT::IsOperatorSupported(TonemapOperator))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("%s is not available on the CPU and can not be exported"), *StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(int64(TonemapOperator)));
+		return 1;
+	}
+
+	TArray<int32> LUTSizes;
+	{
+		const FString* SizeParam = ParamVals.Find(TEXT("Size"));
+		TArray<FString> SizeStrings;
+		(SizeParam ? *SizeParam : FString(TEXT("33"))).ParseIntoArray(SizeStrings, TEXT(","));
+
+		for (const FString& SizeString : SizeStrings)
+		{
+			const int32 LUTSize = FCString::Atoi(*SizeString);
+			if (LUTSize < 2 || LUTSize > 256)
+			{
+				UE_LOG(TonemapOverrideLog, Error, TEXT("Invalid LUT size %s"), *SizeString);
+				return 1;
+			}
+			LUTSizes.AddUnique(LUTSize);
+		}
+	}
+
+	TArray<ETonemapOverrideLUTExportFormat> Formats;
+	{
+		const FString* FormatParam = ParamVals.Find(TEXT("Format"));
+		TArray<FString> FormatStrings;
+		(FormatParam ? *FormatParam : FString(TEXT("cube,spi3d,exr"))).ParseIntoArray(FormatStrings, TEXT(","));
+
+		for (const FString& FormatString : FormatStrings)
+		{
+			int32 Format = 0;
+			while (Format < int32(ETonemapOverrideLUTExportFormat::MAX) && !FormatString.Equals(TonemapOverride::GetLUTExportExtension(ETonemapOverrideLUTExportFormat(Format))))
+			{
+				++Format;
+			}
+
+			if (Format == int32(ETonemapOverrideLUTExportFormat::MAX))
+			{
+				UE_LOG(TonemapOverrideLog, Error, TEXT("Unknown LUT export format %s"), *FormatString);
+				return 1;
+			}
+			Formats.AddUnique(ETonemapOverrideLUTExportFormat(Format));
+		}
+	}
+
+	// Grading from the chosen volume, otherwise the post process defaults
+	FPostProcessSettings PostProcessSettings;
+	if (const FString* VolumeParam = ParamVals.Find(TEXT("Volume")))
+	{
+		UObject* VolumeObject = LoadObject<UObject>(nullptr, **VolumeParam);
+		IInterface_PostProcessVolume* Volume = Cast<IInterface_PostProcessVolume>(VolumeObject);
+		const FPostProcessSettings* VolumeSettings = Volume ? Volume->GetProperties().Settings : nullptr;
+
+		if (!VolumeSettings)
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("%s is not a post process volume"), **VolumeParam);
+			return 1;
+		}
+		ApplyOverriddenSettings(*VolumeSettings, PostProcessSettings);
+	}
+
+	FTonemapOverrideCPUTexture3D LUTTexture;
+	const TSoftObjectPtr<UTexture>* OperatorTexture = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, TonemapOperator);
+	const UTexture* Texture = OperatorTexture ? OperatorTexture->LoadSynchronous() : nullptr;
+	if (OperatorTexture && !FTonemapOverrideCPUTexture3D::LoadFromTexture(Texture, LUTTexture))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("%s LUT texture source data is not available"), *StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(int64(TonemapOperator)));
+		return 1;
+	}
+
+	const FString OperatorName = StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(int64(TonemapOperator));
+	const FString* OutputParam = ParamVals.Find(TEXT("Output"));
+	const FString OutputDir = OutputParam ? *OutputParam : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TonemapOverride"), TEXT("Export"));
+	const FString* NameParam = ParamVals.Find(TEXT("Name"));
+	const FString BaseName = NameParam ? *NameParam : OperatorName;
+	const bool bShaper = Switches.Contains(TEXT("Shaper"));
+
+	int32 NumFailed = 0;
+
+	for (const int32 LUTSize : LUTSizes)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		FTonemapOverrideLUTSnapshot Snapshot;
+		TonemapOverride::BuildLUTSnapshot(PostProcessSettings, TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, LUTSize, TonemapOverrideSettings, Snapshot);
+		TonemapOverride::SetSnapshotOperator(TonemapOperator, TonemapOverrideSettings, LUTTexture.IsValid() ? TonemapOverride::GetLUTTextureId(Texture) : 0, Snapshot);
+
+		const FTonemapOverrideCPULUT CPULUT(Snapshot, &LUTTexture);
+
+		TArray<FLinearColor> Texels;
+		FTonemapOverrideLUTShaper Shaper;
+
+		if (bShaper)
+		{
+			Shaper = FTonemapOverrideLUTShaper::Fit(CPULUT);
+
+			TArray<float> LatticeCoordinates;
+			Shaper.GetLatticeCoordinates(LUTSize, LatticeCoordinates);
+			CPULUT.GenerateAt(LatticeCoordinates, Texels);
+		}
+		else
+		{
+			CPULUT.Generate(LUTSize, Texels);
+		}
+
+		// The tonemapper scales the LUT output by 1.05, applied here so the files hold the final display values
+		ParallelFor(LUTSize, [&Texels, LUTSize](int32 Slice)
+		{
+			for (FLinearColor& Color : TArrayView<FLinearColor>(Texels).Slice(Slice * LUTSize * LUTSize, LUTSize * LUTSize))
+			{
+				Color *= 1.05f;
+			}
+		});
+
+		const double GenerateTime = FPlatformTime::Seconds() - StartTime;
+		const FString Title = FString::Printf(TEXT("TonemapOverride %s %d"), *OperatorName, LUTSize);
+
+		for (const ETonemapOverrideLUTExportFormat Format : Formats)
+		{
+			const FString Filename = FPaths::Combine(OutputDir, FString::Printf(TEXT("%s_%d.%s"), *BaseName, LUTSize, TonemapOverride::GetLUTExportExtension(Format)));
+			if (TonemapOverride::ExportLUT(Format, Texels, LUTSize, Title, Filename, bShaper ? &Shaper : nullptr))
+			{
+				UE_LOG(TonemapOverrideLog, Display, TEXT("Wrote %s"), *Filename);
+			}
+			else
+			{
+				++NumFailed;
+			}
+		}
+
+		UE_LOG(TonemapOverrideLog, Display, TEXT("Exported %d^3 LUT in %.2f s (generation %.2f s)"), LUTSize, FPlatformTime::Seconds() - StartTime, GenerateTime);
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+}
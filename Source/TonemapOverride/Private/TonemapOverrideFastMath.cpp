@@ -0,0 +1,173 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideFastMath.h"
+#include "TonemapOverride.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideSettings.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// LUT size of the measurement, the default engine LUT size
+	const int32 FastMathMeasureLUTSize = 32;
+
+	enum class EFastMathState : uint8
+	{
+		Unmeasured,
+		Measuring,
+		Allowed,
+		Rejected,
+	};
+
+	FCriticalSection GFastMathLock;
+	EFastMathState GFastMathStates[uint32(ECustomTonemapOperator::MAX)] = {};
+
+	bool ContainsNaN(const FLinearColor& Color)
+	{
+		return FMath::IsNaN(Color.R) || FMath::IsNaN(Color.G) || FMath::IsNaN(Color.B);
+	}
+}
+
+bool TonemapOverride::HasFastMathVariant(ECustomTonemapOperator Operator)
+{
+	switch (Operator)
+	{
+	case ECustomTonemapOperator::Agx:
+	case ECustomTonemapOperator::AgxPunchy:
+	case ECustomTonemapOperator::Flim:
+	case ECustomTonemapOperator::GT7:
+		return true;
+	default:
+		return false;
+	}
+}
+
+double TonemapOverride::MeasureFastMathDeltaE(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings, int32 LUTSize, double* OutMeanDeltaE)
+{
+	if (!HasFastMathVariant(Operator))
+	{
+		return -1.0;
+	}
+
+	const FPostProcessSettings DefaultSettings;
+
+	FTonemapOverrideLUTSnapshot Snapshot;
+	TonemapOverride::BuildLUTSnapshot(DefaultSettings, TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, LUTSize, RenderSettings, Snapshot);
+	TonemapOverride::SetSnapshotOperator(Operator, RenderSettings, 0, Snapshot);
+
+	Snapshot.bFastMath = 0;
+	TArray<FLinearColor> Exact;
+	FTonemapOverrideCPULUT(Snapshot).Generate(LUTSize, Exact);
+
+	Snapshot.bFastMath = 1;
+	TArray<FLinearColor> Fast;
+	FTonemapOverrideCPULUT(Snapshot).Generate(LUTSize, Fast);
+
+	double MaxDeltaE = 0.0;
+	double SumDeltaE = 0.0;
+	int32 NumTexels = 0;
+
+	for (int32 Index = 0; Index < Exact.Num(); ++Index)
+	{
+		// Texels the exact operator leaves undefined have nothing to compare against
+		if (ContainsNaN(Exact[Index]))
+		{
+			continue;
+		}
+
+		const double DeltaE = ContainsNaN(Fast[Index])
+			? UE_DOUBLE_BIG_NUMBER
+			: TonemapOverride::DeltaE2000(TonemapOverride::LUTOutputToLab(Exact[Index]), TonemapOverride::LUTOutputToLab(Fast[Index]));
+
+		MaxDeltaE = FMath::Max(MaxDeltaE, DeltaE);
+		SumDeltaE += DeltaE;
+		NumTexels++;
+	}
+
+	if (OutMeanDeltaE)
+	{
+		*OutMeanDeltaE = NumTexels > 0 ? SumDeltaE / NumTexels : 0.0;
+	}
+
+	return MaxDeltaE;
+}
+
+bool TonemapOverride::IsFastMathVariantAllowed(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings)
+{
+	if (!RenderSettings.CompiledPermutations.IsFastMathVariantCompiled(Operator))
+	{
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&GFastMathLock);
+		EFastMathState& State = GFastMathStates[uint32(Operator)];
+		if (State != EFastMathState::Unmeasured)
+		{
+			// Exact while the measurement is running, it builds snapshots itself
+			return State == EFastMathState::Allowed;
+		}
+		State = EFastMathState::Measuring;
+	}
+
+	double MeanDeltaE = 0.0;
+	const double MaxDeltaE = MeasureFastMathDeltaE(Operator, RenderSettings, FastMathMeasureLUTSize, &MeanDeltaE);
+	const float Budget = RenderSettings.FastMathMaxDeltaE;
+	const bool bAllowed = MaxDeltaE <= Budget;
+
+	UE_LOG(TonemapOverrideLog, Log, TEXT("Fast math %s: max delta E %.3f, mean %.4f, budget %.3f: %s"),
+		*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(int64(Operator)), MaxDeltaE, MeanDeltaE, Budget, bAllowed ? TEXT("used") : TEXT("exact operator used"));
+
+	FScopeLock Lock(&GFastMathLock);
+	GFastMathStates[uint32(Operator)] = bAllowed ? EFastMathState::Allowed : EFastMathState::Rejected;
+	return bAllowed;
+}
+
+void TonemapOverride::ResetFastMathMeasurements()
+{
+	FScopeLock Lock(&GFastMathLock);
+	for (EFastMathState& State : GFastMathStates)
+	{
+		// A running measurement stores its result when it finishes
+		if (State != EFastMathState::Measuring)
+		{
+			State = EFastMathState::Unmeasured;
+		}
+	}
+}
+
+static void FastMathReport(const TArray<FString>& Args)
+{
+	const int32 LUTSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : FastMathMeasureLUTSize;
+	const FTonemapOverrideRenderSettings RenderSettings(UTonemapOverrideSettings::Get());
+	const float Budget = RenderSettings.FastMathMaxDeltaE;
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Fast math variants, CIEDE2000 to the exact operator over a %d^3 LUT, budget %.3f"), LUTSize, Budget);
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!TonemapOverride::HasFastMathVariant(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		double MeanDeltaE = 0.0;
+		const double MaxDeltaE = TonemapOverride::MeasureFastMathDeltaE(ECustomTonemapOperator(Operator), RenderSettings, LUTSize, &MeanDeltaE);
+
+		UE_LOG(TonemapOverrideLog, Display, TEXT("  %-16s max %.3f, mean %.4f, %s, %s"),
+			*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator), MaxDeltaE, MeanDeltaE,
+			MaxDeltaE <= Budget ? TEXT("within budget") : TEXT("over budget"),
+			RenderSettings.CompiledPermutations.IsFastMathVariantCompiled(ECustomTonemapOperator(Operator)) ? TEXT("compiled") : TEXT("not compiled"));
+	}
+
+	// Settings may have changed since the variants were last measured
+	TonemapOverride::ResetFastMathMeasurements();
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideFastMathReport(
+	TEXT("r.TonemapOverride.CPU.FastMathReport"),
+	TEXT("Measure the max and mean CIEDE2000 difference of every fast math operator variant to the exact operator on the CPU. Optional LUT size argument (32)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FastMathReport));
@@ -0,0 +1,27 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ECustomTonemapOperator : uint8;
+struct FTonemapOverrideRenderSettings;
+
+// Fast math operator variants (FAST_MATH permutation, FastMath.usf) replace log2 / exp2 / pow with polynomials
+// A variant is only used when its CIEDE2000 difference to the exact operator stays within Fast Math Max Delta E
+
+namespace TonemapOverride
+{
+	// AgX, Flim and GT7 have a fast math variant
+	bool HasFastMathVariant(ECustomTonemapOperator Operator);
+
+	// Largest CIEDE2000 difference between the exact and the fast CPU LUT over the whole LUT domain, with the default
+	// grading and the operator settings. Returns a negative value when the operator has no variant
+	double MeasureFastMathDeltaE(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings, int32 LUTSize, double* OutMeanDeltaE = nullptr);
+
+	// Variant compiled and measured within the budget of the settings, measured once per operator on first use
+	bool IsFastMathVariantAllowed(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings);
+
+	// Forget the measurements, the next use measures again with the current settings
+	void ResetFastMathMeasurements();
+}
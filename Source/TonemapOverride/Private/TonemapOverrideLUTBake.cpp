@@ -0,0 +1,332 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideBakedLUTs.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverride.h"
+#include "Hash/CityHash.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+#include "RenderingThread.h"
+#include "RenderGraphUtils.h"
+#include "RHIGPUReadback.h"
+#include "GlobalShader.h"
+#include "DataDrivenShaderPlatformInfo.h"
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideBakeRecordKeys(
+	TEXT("r.TonemapOverride.Bake.RecordKeys"),
+	WITH_EDITOR ? 1 : 0,
+	TEXT("Record the settings of live generated LUTs for the TonemapOverrideBake commandlet.\n")
+	TEXT("Keys are written to Saved/TonemapOverride on exit or with r.TonemapOverride.Bake.SaveKeys."),
+	ECVF_RenderThreadSafe);
+
+static FAutoConsoleCommand CmdTonemapOverrideBakeSaveKeys(
+	TEXT("r.TonemapOverride.Bake.SaveKeys"),
+	TEXT("Write the LUT settings keys recorded in this session for the TonemapOverrideBake commandlet."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		TonemapOverride::SaveLUTBakeKeys(TonemapOverride::GetDefaultLUTBakeKeysFilename());
+	}));
+
+namespace
+{
+	const uint32 LUTBakeKeysMagic = 0x4B4C4F54; // 'TOLK'
+	const uint32 LUTBakeKeysVersion = 1;
+
+	// Any change to the snapshot fields changes the layout hash and invalidates the recorded keys
+	uint32 GetSnapshotLayoutHash()
+	{
+#define TONEMAPOVERRIDE_SNAPSHOT_LAYOUT(Type, Name, Quantization) TEXT(#Type) TEXT(#Name)
+		static const uint32 LayoutHash = FCrc::StrCrc32(TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_LAYOUT)) ^ uint32(sizeof(FTonemapOverrideLUTSnapshot));
+#undef TONEMAPOVERRIDE_SNAPSHOT_LAYOUT
+		return LayoutHash;
+	}
+
+	uint64 GetBakeKeyHash(const FTonemapOverrideLUTSnapshot& Snapshot, EPixelFormat Format)
+	{
+		return CityHash128to64(Uint128_64(Snapshot.GetContentHash(), uint64(Format)));
+	}
+
+	FCriticalSection RecordedKeysCS;
+	TMap<uint64, FTonemapOverrideLUTBakeKey> RecordedKeys;
+}
+
+void TonemapOverride::RecordLUTBakeKey(const FTonemapOverrideLUTSnapshot& Snapshot, EPixelFormat Format)
+{
+	if (CVarTonemapOverrideBakeRecordKeys.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+
+	const uint64 KeyHash = GetBakeKeyHash(Snapshot, Format);
+
+	FScopeLock Lock(&RecordedKeysCS);
+	if (!RecordedKeys.Contains(KeyHash))
+	{
+		FTonemapOverrideLUTBakeKey& Key = RecordedKeys.Add(KeyHash);
+		Key.Snapshot = Snapshot;
+		Key.Format = Format;
+	}
+}
+
+FString TonemapOverride::GetDefaultLUTBakeKeysFilename()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TonemapOverride"), TEXT("LUTBakeKeys.bin"));
+}
+
+bool TonemapOverride::SaveLUTBakeKeys(const FString& Filename)
+{
+	TMap<uint64, FTonemapOverrideLUTBakeKey> Keys;
+	{
+		FScopeLock Lock(&RecordedKeysCS);
+		if (RecordedKeys.IsEmpty())
+		{
+			return true;
+		}
+		Keys = RecordedKeys;
+	}
+
+	// Merge with the keys of previous sessions
+	TArray<FTonemapOverrideLUTBakeKey> ExistingKeys;
+	if (IFileManager::Get().FileExists(*Filename) && LoadLUTBakeKeys(Filename, ExistingKeys))
+	{
+		for (const FTonemapOverrideLUTBakeKey& Key : ExistingKeys)
+		{
+			Keys.FindOrAdd(GetBakeKeyHash(Key.Snapshot, Key.Format), Key);
+		}
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer)
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to write LUT bake keys to %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = LUTBakeKeysMagic;
+	uint32 Version = LUTBakeKeysVersion;
+	uint32 LayoutHash = GetSnapshotLayoutHash();
+	int32 NumKeys = Keys.Num();
+	*Writer << Magic << Version << LayoutHash << NumKeys;
+
+	for (TPair<uint64, FTonemapOverrideLUTBakeKey>& Pair : Keys)
+	{
+		uint8 Format = uint8(Pair.Value.Format);
+		Writer->Serialize(&Pair.Value.Snapshot, sizeof(FTonemapOverrideLUTSnapshot));
+		*Writer << Format;
+	}
+
+	const bool bSuccess = Writer->Close();
+	UE_LOG(TonemapOverrideLog, Log, TEXT("Saved %d LUT bake keys to %s"), NumKeys, *Filename);
+	return bSuccess;
+}
+
+bool TonemapOverride::LoadLUTBakeKeys(const FString& Filename, TArray<FTonemapOverrideLUTBakeKey>& OutKeys)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader)
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to read LUT bake keys from %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	uint32 LayoutHash = 0;
+	int32 NumKeys = 0;
+	*Reader << Magic << Version << LayoutHash << NumKeys;
+
+	if (Magic != LUTBakeKeysMagic || Version != LUTBakeKeysVersion || LayoutHash != GetSnapshotLayoutHash() || NumKeys < 0)
+	{
+		UE_LOG(TonemapOverrideLog, Warning, TEXT("LUT bake keys in %s are from an incompatible version, record them again"), *Filename);
+		return false;
+	}
+
+	OutKeys.Reserve(OutKeys.Num() + NumKeys);
+
+	for (int32 Index = 0; Index < NumKeys && !Reader->IsError(); ++Index)
+	{
+		FTonemapOverrideLUTBakeKey& Key = OutKeys.AddDefaulted_GetRef();
+		uint8 Format = 0;
+		Reader->Serialize(&Key.Snapshot, sizeof(FTonemapOverrideLUTSnapshot));
+		*Reader << Format;
+		Key.Format = EPixelFormat(Format);
+	}
+
+	return !Reader->IsError();
+}
+
+bool TonemapOverride::BakeLUT(const FTonemapOverrideLUTBakeKey& Key, FTonemapOverrideBakedLUT& OutLUT)
+{
+	check(IsInGameThread());
+
+	const int32 LUTSize = FMath::RoundToInt(Key.Snapshot.LUTSize);
+	const int32 BytesPerTexel = Key.Format < PF_MAX ? GPixelFormats[Key.Format].BlockBytes : 0;
+
+	if (LUTSize <= 0 || BytesPerTexel <= 0)
+	{
+		return false;
+	}
+
+	OutLUT.ContentHash = Key.Snapshot.GetContentHash();
+	OutLUT.LUTSize = LUTSize;
+	OutLUT.Format = Key.Format;
+	OutLUT.Data.SetNumZeroed(BytesPerTexel * LUTSize * LUTSize * LUTSize);
+
+	bool bSuccess = false;
+
+	// Textures the tool has loaded are only seen by the render thread once the render settings are updated
+	TonemapOverride::UpdateRenderSettings();
+
+	ENQUEUE_RENDER_COMMAND(TonemapOverrideBakeLUT)(
+		[&Key, &OutLUT, &bSuccess, LUTSize, BytesPerTexel](FRHICommandListImmediate& RHICmdList)
+		{
+			// Layout and pass type follow the baking platform, the canonical layout makes the result usable on all of them
+			const bool bUseVolumeTextureLUT = TonemapOverride::IsVolumeTextureLUTSupported(GMaxRHIShaderPlatform);
+			const bool bUseComputePass = IsFeatureLevelSupported(GMaxRHIShaderPlatform, ERHIFeatureLevel::SM5);
+
+			FRHIGPUTextureReadback Readback(TEXT("TonemapOverride.BakeLUTReadback"));
+
+			{
+				FRDGBuilder GraphBuilder(RHICmdList);
+
+				const FRDGTextureDesc Desc = TonemapOverride::GetLUTTextureDesc(LUTSize, bUseVolumeTextureLUT, bUseComputePass, Key.Format);
+				FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, TEXT("TonemapOverride.BakeLUT"));
+
+				TonemapOverride::AddLUTPass(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), Texture, Key.Snapshot, bUseComputePass, bUseVolumeTextureLUT, LUTSize);
+				AddEnqueueCopyPass(GraphBuilder, &Readback, Texture);
+
+				GraphBuilder.Execute();
+			}
+
+			RHICmdList.BlockUntilGPUIdle();
+
+			int32 RowPitchInPixels = 0;
+			int32 BufferHeight = 0;
+			const uint8* Source = static_cast<const uint8*>(Readback.Lock(RowPitchInPixels, &BufferHeight));
+
+			if (Source)
+			{
+				const int32 RowPitchInBytes = RowPitchInPixels * BytesPerTexel;
+				const int32 RowBytes = LUTSize * BytesPerTexel;
+
+				if (bUseVolumeTextureLUT)
+				{
+					const int32 SlicePitchInBytes = RowPitchInBytes * BufferHeight;
+
+					for (int32 Blue = 0; Blue < LUTSize; ++Blue)
+					{
+						for (int32 Green = 0; Green < LUTSize; ++Green)
+						{
+							FMemory::Memcpy(OutLUT.Data.GetData() + (Blue * LUTSize + Green) * RowBytes, Source + Blue * SlicePitchInBytes + Green * RowPitchInBytes, RowBytes);
+						}
+					}
+				}
+				else
+				{
+					TonemapOverride::UnwrappedToCanonicalLUT(Source, RowPitchInBytes, LUTSize, BytesPerTexel, OutLUT.Data.GetData());
+				}
+
+				Readback.Unlock();
+				bSuccess = true;
+			}
+		});
+
+	FlushRenderingCommands();
+
+	return bSuccess;
+}
+
+bool TonemapOverride::BakeCPULUT(const FTonemapOverrideLUTBakeKey& Key, const FTonemapOverrideCPUTexture3D* LUTTexture, FTonemapOverrideBakedLUT& OutLUT)
+{
+	const int32 LUTSize = FMath::RoundToInt(Key.Snapshot.LUTSize);
+	const FTonemapOverrideCPULUT CPULUT(Key.Snapshot, LUTTexture);
+
+	// Without the texture the fallback would be stored under the key of the texture
+	const bool bHasTexture = Key.Snapshot.LUTTextureId == 0 || (LUTTexture && LUTTexture->IsValid());
+
+	if (LUTSize <= 1 || !CPULUT.IsSupported() || !bHasTexture)
+	{
+		return false;
+	}
+
+	TArray<FLinearColor> Texels;
+	CPULUT.Generate(LUTSize, Texels);
+
+	OutLUT.ContentHash = Key.Snapshot.GetContentHash();
+	OutLUT.LUTSize = LUTSize;
+	OutLUT.Format = Key.Format;
+	return TonemapOverride::EncodeLUTTexels(Texels, Key.Format, OutLUT.Data);
+}
+
+bool TonemapOverride::MeasureLUTPass(const FTonemapOverrideLUTBakeKey& Key, bool bUseVolumeTextureLUT, int32 NumIterations, TArray<double>& OutMilliseconds)
+{
+	check(IsInGameThread());
+
+	const int32 LUTSize = FMath::RoundToInt(Key.Snapshot.LUTSize);
+	OutMilliseconds.Reset();
+
+	if (LUTSize <= 0 || NumIterations <= 0 || Key.Format >= PF_MAX || !GSupportsTimestampRenderQueries)
+	{
+		return false;
+	}
+
+	TonemapOverride::UpdateRenderSettings();
+
+	ENQUEUE_RENDER_COMMAND(TonemapOverrideMeasureLUTPass)(
+		[&Key, &OutMilliseconds, LUTSize, bUseVolumeTextureLUT, NumIterations](FRHICommandListImmediate& RHICmdList)
+		{
+			const bool bVolume = bUseVolumeTextureLUT && TonemapOverride::IsVolumeTextureLUTSupported(GMaxRHIShaderPlatform);
+			const bool bUseComputePass = IsFeatureLevelSupported(GMaxRHIShaderPlatform, ERHIFeatureLevel::SM5);
+			const FRDGTextureDesc Desc = TonemapOverride::GetLUTTextureDesc(LUTSize, bVolume, bUseComputePass, Key.Format);
+
+			FRenderQueryPoolRHIRef QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime, NumIterations * 2);
+			TArray<FRHIPooledRenderQuery> Queries;
+			Queries.Reserve(NumIterations * 2);
+
+			// Iteration 0 is the warm up, it pays for the shader and pipeline creation
+			for (int32 Iteration = 0; Iteration <= NumIterations; ++Iteration)
+			{
+				if (Iteration > 0)
+				{
+					FRHIPooledRenderQuery& BeginQuery = Queries.Add_GetRef(QueryPool->AllocateQuery());
+					RHICmdList.EndRenderQuery(BeginQuery.GetQuery());
+				}
+
+				{
+					FRDGBuilder GraphBuilder(RHICmdList);
+					FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, TEXT("TonemapOverride.BenchmarkLUT"));
+					TonemapOverride::AddLUTPass(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), Texture, Key.Snapshot, bUseComputePass, bVolume, LUTSize);
+
+					// Extracted so that the unread pass is not culled
+					TRefCountPtr<IPooledRenderTarget> PooledTexture;
+					GraphBuilder.QueueTextureExtraction(Texture, &PooledTexture);
+					GraphBuilder.Execute();
+				}
+
+				if (Iteration > 0)
+				{
+					FRHIPooledRenderQuery& EndQuery = Queries.Add_GetRef(QueryPool->AllocateQuery());
+					RHICmdList.EndRenderQuery(EndQuery.GetQuery());
+				}
+			}
+
+			RHICmdList.BlockUntilGPUIdle();
+
+			for (int32 Index = 0; Index + 1 < Queries.Num(); Index += 2)
+			{
+				uint64 BeginMicroseconds = 0;
+				uint64 EndMicroseconds = 0;
+				if (RHIGetRenderQueryResult(Queries[Index].GetQuery(), BeginMicroseconds, true) && RHIGetRenderQueryResult(Queries[Index + 1].GetQuery(), EndMicroseconds, true))
+				{
+					OutMilliseconds.Add(double(EndMicroseconds - BeginMicroseconds) / 1000.0);
+				}
+			}
+		});
+
+	FlushRenderingCommands();
+
+	return !OutMilliseconds.IsEmpty();
+}
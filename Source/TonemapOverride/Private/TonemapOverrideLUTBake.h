@@ -0,0 +1,43 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "TonemapOverrideLUTSettings.h"
+
+struct FTonemapOverrideBakedLUT;
+struct FTonemapOverrideCPUTexture3D;
+
+// Settings keys discovered at runtime, the bake step generates a LUT for each of them
+struct FTonemapOverrideLUTBakeKey
+{
+	FTonemapOverrideLUTSnapshot Snapshot;
+	EPixelFormat Format = PF_Unknown;
+};
+
+namespace TonemapOverride
+{
+	// Remember a live generated LUT for baking, thread safe. Does nothing unless r.TonemapOverride.Bake.RecordKeys is set
+	void RecordLUTBakeKey(const FTonemapOverrideLUTSnapshot& Snapshot, EPixelFormat Format);
+
+	// Key file in the project Saved folder, shared by the runtime recording and the bake commandlet
+	FString GetDefaultLUTBakeKeysFilename();
+
+	// Merge the keys recorded in this session into the key file
+	bool SaveLUTBakeKeys(const FString& Filename);
+
+	// Keys written with a different snapshot layout are rejected as the snapshots can not be interpreted anymore
+	bool LoadLUTBakeKeys(const FString& Filename, TArray<FTonemapOverrideLUTBakeKey>& OutKeys);
+
+	// Generate the LUT on the GPU and read it back, game thread only and blocks until the GPU is done
+	bool BakeLUT(const FTonemapOverrideLUTBakeKey& Key, FTonemapOverrideBakedLUT& OutLUT);
+
+	// Evaluate the LUT on the CPU into the same canonical layout, for the operators FTonemapOverrideCPULUT covers and the
+	// formats EncodeLUTTexels writes. Needs no RHI, the texture of a texture operator is passed in (LoadFromTexture)
+	bool BakeCPULUT(const FTonemapOverrideLUTBakeKey& Key, const FTonemapOverrideCPUTexture3D* LUTTexture, FTonemapOverrideBakedLUT& OutLUT);
+
+	// GPU time of the LUT pass with timestamp queries, one sample per iteration after a warm up pass
+	// Game thread only and blocks until the GPU is done. Volume layout falls back to 2D where unsupported
+	bool MeasureLUTPass(const FTonemapOverrideLUTBakeKey& Key, bool bUseVolumeTextureLUT, int32 NumIterations, TArray<double>& OutMilliseconds);
+}
@@ -0,0 +1,455 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTBenchmark.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideLUTCache.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Engine/Texture.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SceneView.h"
+#include "UnrealClient.h"
+
+namespace
+{
+	// Calls per sample of the cache update, a single update is below the timer resolution
+	const int32 CacheUpdateBatchSize = 64;
+
+	// Render target of the benchmark view family, the output device parameters read its display format
+	class FBenchmarkRenderTarget : public FRenderTarget
+	{
+	public:
+		virtual FIntPoint GetSizeXY() const override { return FIntPoint(1920, 1080); }
+	};
+
+	void AddResult(TArray<FTonemapOverrideBenchmarkResult>& Results, const FString& Operator, const TCHAR* Layout, int32 LUTSize, const TCHAR* Stage, TArray<double>& Samples)
+	{
+		if (Samples.IsEmpty())
+		{
+			return;
+		}
+
+		Samples.Sort();
+
+		FTonemapOverrideBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Operator = Operator;
+		Result.Layout = Layout;
+		Result.LUTSize = LUTSize;
+		Result.Stage = Stage;
+		Result.NumSamples = Samples.Num();
+		Result.MinMs = Samples[0];
+		Result.MedianMs = Samples[Samples.Num() / 2];
+		Result.P99Ms = Samples[FMath::Clamp(FMath::CeilToInt(Samples.Num() * 0.99) - 1, 0, Samples.Num() - 1)];
+
+		for (const double Sample : Samples)
+		{
+			Result.MeanMs += Sample;
+		}
+		Result.MeanMs /= Samples.Num();
+
+		UE_LOG(TonemapOverrideLog, Display, TEXT("%-14s %-6s %3d %-12s min %9.4f  median %9.4f  p99 %9.4f ms"), *Result.Operator, Layout, LUTSize, Stage, Result.MinMs, Result.MedianMs, Result.P99Ms);
+	}
+
+	// Change detection of the view extension before the LUT snapshot, as it was in the first version of TonemapOverrideSceneViewExtension.cpp
+	// Only the view input differs: a FSceneView with bUseComputePasses passed in, as a FViewInfo only exists inside the renderer
+	// Kept unchanged so that the LegacyUpdate stage measures what shipped, not a copy following the current code
+#define UPDATE_CACHE_SETTINGS(DestParameters, ParamValue, bOutHasChanged) \
+if(DestParameters != (ParamValue)) \
+{ \
+	DestParameters = (ParamValue); \
+	bOutHasChanged = true; \
+}
+
+	struct FCachedLUTSettings
+	{
+		uint32 UniqueID = 0;
+		EShaderPlatform ShaderPlatform = GMaxRHIShaderPlatform;
+		FTonemapOverrideLUTParameters Parameters;
+		FWorkingColorSpaceShaderParameters WorkingColorSpaceShaderParameters;
+		bool bUseCompute = false;
+		ECustomTonemapOperator CachedTonemapOperator;
+		EGT7UCSType CachedGT7UCSType;
+
+		bool UpdateCachedValues(const FSceneView& View, bool bUseComputePasses, uint32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings)
+		{
+			bool bHasChanged = false;
+			GetCombineLUTParameters(View, LUTSize, bHasChanged);
+			GetCustomLUTParameters(TonemapOverrideSettings, bHasChanged);
+			UPDATE_CACHE_SETTINGS(UniqueID, View.State ? View.State->GetViewKey() : 0, bHasChanged);
+			UPDATE_CACHE_SETTINGS(ShaderPlatform, View.GetShaderPlatform(), bHasChanged);
+			UPDATE_CACHE_SETTINGS(bUseCompute, bUseComputePasses, bHasChanged);
+			UPDATE_CACHE_SETTINGS(CachedTonemapOperator,TonemapOverrideSettings.CustomTonemapOperator, bHasChanged);
+			UPDATE_CACHE_SETTINGS(CachedGT7UCSType,TonemapOverrideSettings.UCSType, bHasChanged);
+
+			const FWorkingColorSpaceShaderParameters* InWorkingColorSpaceShaderParameters = reinterpret_cast<const FWorkingColorSpaceShaderParameters*>(GDefaultWorkingColorSpaceUniformBuffer.GetContents());
+			if (InWorkingColorSpaceShaderParameters)
+			{
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToXYZ, InWorkingColorSpaceShaderParameters->ToXYZ, bHasChanged);
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.FromXYZ, InWorkingColorSpaceShaderParameters->FromXYZ, bHasChanged);
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToAP1, InWorkingColorSpaceShaderParameters->ToAP1, bHasChanged);
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.FromAP1, InWorkingColorSpaceShaderParameters->FromAP1, bHasChanged);
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToAP0, InWorkingColorSpaceShaderParameters->ToAP0, bHasChanged);
+				UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.bIsSRGB, InWorkingColorSpaceShaderParameters->bIsSRGB, bHasChanged);
+			}
+
+			return bHasChanged;
+		}
+
+		FVector3f GetMappingPolynomial()
+		{
+			static const auto CVarMinValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Min"));
+			static const auto CVarMidValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Mid"));
+			static const auto CVarMaxValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Max"));
+
+			float MinValue = FMath::Clamp(CVarMinValue->GetFloat() , -10.0f, 10.0f);
+			float MidValue = FMath::Clamp(CVarMidValue->GetFloat(), -10.0f, 10.0f);
+			float MaxValue = FMath::Clamp(CVarMaxValue->GetFloat(), -10.0f, 10.0f);
+
+			float c = MinValue;
+			float b = 4 * MidValue - 3 * MinValue - MaxValue;
+			float a = MaxValue - MinValue - b;
+
+			return FVector3f(a, b, c);
+		}
+
+		void GetCombineLUTParameters(
+			const FSceneView& View,
+			int32 LUTSize,
+			bool& bHasChanged)
+		{
+
+			static const FPostProcessSettings DefaultSettings;
+
+			const FSceneViewFamily& ViewFamily = *(View.Family);
+
+			const FPostProcessSettings& Settings = ViewFamily.EngineShowFlags.ColorGrading
+				? View.FinalPostProcessSettings
+				: DefaultSettings;
+
+			Parameters.WorkingColorSpace = GDefaultWorkingColorSpaceUniformBuffer.GetUniformBufferRef();
+
+			FACESTonemapParams TonemapperParams;
+			GetACESTonemapParameters(TonemapperParams);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESMinMaxData, TonemapperParams.ACESMinMaxData, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESMidData, TonemapperParams.ACESMidData, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsLow_0, TonemapperParams.ACESCoefsLow_0, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsHigh_0, TonemapperParams.ACESCoefsHigh_0, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsLow_4, TonemapperParams.ACESCoefsLow_4, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsHigh_4, TonemapperParams.ACESCoefsHigh_4, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESSceneColorMultiplier, TonemapperParams.ACESSceneColorMultiplier, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESGamutCompression, TonemapperParams.ACESGamutCompression, bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.ColorScale, FVector3f(View.ColorScale), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.OverlayColor, FVector4f(View.OverlayColor), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.MappingPolynomial, GetMappingPolynomial(), bHasChanged);
+
+			// White balance
+			UPDATE_CACHE_SETTINGS(Parameters.bIsTemperatureWhiteBalance, uint32(Settings.TemperatureType == ETemperatureMethod::TEMP_WhiteBalance), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.LUTSize, LUTSize, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.WhiteTemp, Settings.WhiteTemp, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.WhiteTint, Settings.WhiteTint, bHasChanged);
+
+			// Color grade
+			UPDATE_CACHE_SETTINGS(Parameters.ColorSaturation, FVector4f(Settings.ColorSaturation), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorContrast, FVector4f(Settings.ColorContrast), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGamma, FVector4f(Settings.ColorGamma), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGain, FVector4f(Settings.ColorGain), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorOffset, FVector4f(Settings.ColorOffset), bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationShadows, FVector4f(Settings.ColorSaturationShadows), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorContrastShadows, FVector4f(Settings.ColorContrastShadows), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGammaShadows, FVector4f(Settings.ColorGammaShadows), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGainShadows, FVector4f(Settings.ColorGainShadows), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetShadows, FVector4f(Settings.ColorOffsetShadows), bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationMidtones, FVector4f(Settings.ColorSaturationMidtones), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorContrastMidtones, FVector4f(Settings.ColorContrastMidtones), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGammaMidtones, FVector4f(Settings.ColorGammaMidtones), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGainMidtones, FVector4f(Settings.ColorGainMidtones), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetMidtones, FVector4f(Settings.ColorOffsetMidtones), bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationHighlights, FVector4f(Settings.ColorSaturationHighlights), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorContrastHighlights, FVector4f(Settings.ColorContrastHighlights), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGammaHighlights, FVector4f(Settings.ColorGammaHighlights), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorGainHighlights, FVector4f(Settings.ColorGainHighlights), bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetHighlights, FVector4f(Settings.ColorOffsetHighlights), bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionShadowsMax, Settings.ColorCorrectionShadowsMax, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionHighlightsMin, Settings.ColorCorrectionHighlightsMin, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionHighlightsMax, Settings.ColorCorrectionHighlightsMax, bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.BlueCorrection, Settings.BlueCorrection, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ExpandGamut, Settings.ExpandGamut, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.ToneCurveAmount, Settings.ToneCurveAmount, bHasChanged);
+
+			UPDATE_CACHE_SETTINGS(Parameters.FilmSlope, Settings.FilmSlope, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.FilmToe, Settings.FilmToe, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.FilmShoulder, Settings.FilmShoulder, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.FilmBlackClip, Settings.FilmBlackClip, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.FilmWhiteClip, Settings.FilmWhiteClip, bHasChanged);
+
+			FTonemapperOutputDeviceParameters TonemapperOutputDeviceParameters = GetTonemapperOutputDeviceParameters(ViewFamily);
+			UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.InverseGamma, TonemapperOutputDeviceParameters.InverseGamma, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputDevice, TonemapperOutputDeviceParameters.OutputDevice, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputGamut, TonemapperOutputDeviceParameters.OutputGamut, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputMaxLuminance, TonemapperOutputDeviceParameters.OutputMaxLuminance, bHasChanged);
+		}
+
+		void GetCustomLUTParameters(
+		const UTonemapOverrideSettings& TonemapOverrideSettings,
+		bool& bHasChanged)
+		{
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.ReinhardWhitePoint, TonemapOverrideSettings.ReinhardWhitePoint, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.HejlWhitePoint, TonemapOverrideSettings.HejlWhitePoint, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7BlendRatio, TonemapOverrideSettings.GT7BlendRatio, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7FadeStart, TonemapOverrideSettings.GT7FadeStart, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7FadeEnd, TonemapOverrideSettings.GT7FadeEnd, bHasChanged);
+
+			// Use fallback texture if not set
+			FTextureRHIRef LUTTexture = GBlackTexture->TextureRHI;
+			FRHISamplerState* LUTSamplerState = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+			if (TonemapOverrideSettings.CustomTonemapOperator == ECustomTonemapOperator::TonyMcMapface)
+			{
+				if (TonemapOverrideSettings.LUTTexture && TonemapOverrideSettings.LUTTexture->GetResource() && TonemapOverrideSettings.LUTTexture->GetResource()->TextureRHI)
+				{
+					LUTTexture = TonemapOverrideSettings.LUTTexture->GetResource()->TextureRHI;
+				}
+			}
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.LUTTexture, LUTTexture, bHasChanged);
+			UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.LUTTextureSampler, LUTSamplerState, bHasChanged);
+		}
+	};
+
+#undef UPDATE_CACHE_SETTINGS
+
+	// Canonical layout to the unwrapped 2D LUT of Size * Size x Size, blue slices side by side
+	void CanonicalToUnwrappedLUT(TConstArrayView<FLinearColor> Canonical, int32 LUTSize, TArrayView<FLinearColor> OutUnwrapped)
+	{
+		for (int32 Blue = 0; Blue < LUTSize; ++Blue)
+		{
+			for (int32 Green = 0; Green < LUTSize; ++Green)
+			{
+				FMemory::Memcpy(&OutUnwrapped[Green * LUTSize * LUTSize + Blue * LUTSize], &Canonical[(Blue * LUTSize + Green) * LUTSize], LUTSize * sizeof(FLinearColor));
+			}
+		}
+	}
+
+	bool WriteCSV(TConstArrayView<FTonemapOverrideBenchmarkResult> Results, const FString& Filename)
+	{
+		FString Text = TEXT("Operator,Layout,LUTSize,Stage,Samples,MinMs,MedianMs,P99Ms,MeanMs\n");
+		for (const FTonemapOverrideBenchmarkResult& Result : Results)
+		{
+			Text += FString::Printf(TEXT("%s,%s,%d,%s,%d,%.6f,%.6f,%.6f,%.6f\n"), *Result.Operator, *Result.Layout, Result.LUTSize, *Result.Stage, Result.NumSamples, Result.MinMs, Result.MedianMs, Result.P99Ms, Result.MeanMs);
+		}
+		return FFileHelper::SaveStringToFile(Text, *Filename);
+	}
+
+	bool WriteJSON(TConstArrayView<FTonemapOverrideBenchmarkResult> Results, const FString& Filename)
+	{
+		FString Text = TEXT("{\n");
+		Text += FString::Printf(TEXT("\t\"platform\": \"%s\",\n"), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+		Text += FString::Printf(TEXT("\t\"cpu\": \"%s\",\n"), *FPlatformMisc::GetCPUBrand().TrimStartAndEnd().ReplaceCharWithEscapedChar());
+		Text += FString::Printf(TEXT("\t\"rhi\": \"%s\",\n"), GDynamicRHI ? GDynamicRHI->GetName() : TEXT("Null"));
+		Text += FString::Printf(TEXT("\t\"gpu\": \"%s\",\n"), *GRHIAdapterName.ReplaceCharWithEscapedChar());
+		Text += TEXT("\t\"results\": [\n");
+
+		for (int32 Index = 0; Index < Results.Num(); ++Index)
+		{
+			const FTonemapOverrideBenchmarkResult& Result = Results[Index];
+			Text += FString::Printf(TEXT("\t\t{ \"operator\": \"%s\", \"layout\": \"%s\", \"lutSize\": %d, \"stage\": \"%s\", \"samples\": %d, \"minMs\": %.6f, \"medianMs\": %.6f, \"p99Ms\": %.6f, \"meanMs\": %.6f }%s\n"),
+				*Result.Operator, *Result.Layout, Result.LUTSize, *Result.Stage, Result.NumSamples, Result.MinMs, Result.MedianMs, Result.P99Ms, Result.MeanMs, Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+
+		Text += TEXT("\t]\n}\n");
+		return FFileHelper::SaveStringToFile(Text, *Filename);
+	}
+}
+
+void TonemapOverride::RunLUTBenchmark(const FTonemapOverrideBenchmarkOptions& Options, TArray<FTonemapOverrideBenchmarkResult>& OutResults)
+{
+	check(IsInGameThread());
+
+	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	const UEnum* OperatorEnum = StaticEnum<ECustomTonemapOperator>();
+
+	TArray<ECustomTonemapOperator> Operators = Options.Operators;
+	if (Operators.IsEmpty())
+	{
+		for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+		{
+			Operators.Add(ECustomTonemapOperator(Operator));
+		}
+	}
+
+	const int32 NumIterations = FMath::Max(1, Options.NumIterations);
+
+	const bool bMeasureGPU = FApp::CanEverRender() && !GUsingNullRHI;
+	if (!bMeasureGPU)
+	{
+		UE_LOG(TonemapOverrideLog, Display, TEXT("No GPU, the LUT pass is not measured (run with -AllowCommandletRendering to include it)"));
+	}
+
+	// View of a single player game, both update paths read the view the same way the view extension does
+	const FBenchmarkRenderTarget RenderTarget;
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(&RenderTarget, nullptr, FEngineShowFlags(ESFIM_Game)));
+	{
+		FSceneViewInitOptions ViewInitOptions;
+		ViewInitOptions.ViewFamily = &ViewFamily;
+		ViewInitOptions.SetViewRectangle(FIntRect(FIntPoint::ZeroValue, RenderTarget.GetSizeXY()));
+		ViewInitOptions.ViewOrigin = FVector::ZeroVector;
+		ViewInitOptions.ViewRotationMatrix = FMatrix::Identity;
+		ViewInitOptions.ProjectionMatrix = FReversedZPerspectiveMatrix(UE_HALF_PI * 0.5f, 16.0f, 9.0f, 10.0f);
+		ViewFamily.Views.Add(new FSceneView(ViewInitOptions));
+	}
+	const FSceneView& View = *ViewFamily.Views[0];
+
+	const EPixelFormat LUTFormat = PF_A2B10G10R10;
+	TArray<double> Samples;
+
+	for (const ECustomTonemapOperator TonemapOperator : Operators)
+	{
+		const FString OperatorName = OperatorEnum->GetNameStringByValue(int64(TonemapOperator));
+
+		FTonemapOverrideRenderSettings RenderSettings(TonemapOverrideSettings);
+		RenderSettings.CustomTonemapOperator = TonemapOperator;
+
+		// Texture operators on the CPU need the texture source data, without it the fallback curve is measured
+		FTonemapOverrideCPUTexture3D LUTTexture;
+		const TSoftObjectPtr<UTexture>* OperatorTexture = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, TonemapOperator);
+		const UTexture* Texture = OperatorTexture ? OperatorTexture->LoadSynchronous() : nullptr;
+		if (OperatorTexture && !FTonemapOverrideCPUTexture3D::LoadFromTexture(Texture, LUTTexture))
+		{
+			UE_LOG(TonemapOverrideLog, Warning, TEXT("%s LUT texture source data is not available, the CPU stage measures the fallback curve"), *OperatorName);
+		}
+
+		for (const int32 LUTSize : Options.LUTSizes)
+		{
+			for (const bool bUseVolumeTextureLUT : { true, false })
+			{
+				const TCHAR* LayoutName = bUseVolumeTextureLUT ? TEXT("Volume") : TEXT("2D");
+				const FRDGTextureDesc Desc = TonemapOverride::GetLUTTextureDesc(LUTSize, bUseVolumeTextureLUT, true, LUTFormat);
+
+				// What the view extension does every frame to find the LUT of a view: snapshot against the displayed one, fingerprint and cache key
+				FTonemapOverrideLUTSnapshot DisplayedSnapshot;
+				TonemapOverride::BuildLUTSnapshot(View, LUTSize, RenderSettings, DisplayedSnapshot);
+
+				FTonemapOverrideLUTSnapshot Snapshot;
+				Samples.Reset();
+				for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+				{
+					uint64 EntryKey = 0;
+					const uint64 StartCycles = FPlatformTime::Cycles64();
+
+					for (int32 Call = 0; Call < CacheUpdateBatchSize; ++Call)
+					{
+						TonemapOverride::BuildLUTSnapshot(View, LUTSize, RenderSettings, Snapshot, &DisplayedSnapshot);
+						EntryKey ^= FTonemapOverrideLUTCache::GetEntryKey(Snapshot.GetHash(), Desc);
+					}
+
+					Samples.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) / CacheUpdateBatchSize);
+
+					if (EntryKey == 1)
+					{
+						// Keeps the loop from being optimized out
+						UE_LOG(TonemapOverrideLog, Verbose, TEXT("%llu"), EntryKey);
+					}
+				}
+				AddResult(OutResults, OperatorName, LayoutName, LUTSize, TEXT("CacheUpdate"), Samples);
+
+				// The first version compared the shader parameters of the view one by one, the operator came from the settings object
+				// and does not change the cost apart from the Tony texture lookup
+				FCachedLUTSettings CachedLUTSettings;
+				Samples.Reset();
+				for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+				{
+					int32 NumChanged = 0;
+					const uint64 StartCycles = FPlatformTime::Cycles64();
+
+					for (int32 Call = 0; Call < CacheUpdateBatchSize; ++Call)
+					{
+						NumChanged += CachedLUTSettings.UpdateCachedValues(View, true, LUTSize, TonemapOverrideSettings) ? 1 : 0;
+					}
+
+					Samples.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) / CacheUpdateBatchSize);
+
+					if (NumChanged > CacheUpdateBatchSize)
+					{
+						UE_LOG(TonemapOverrideLog, Verbose, TEXT("%d"), NumChanged);
+					}
+				}
+				AddResult(OutResults, OperatorName, LayoutName, LUTSize, TEXT("LegacyUpdate"), Samples);
+
+				TonemapOverride::SetSnapshotOperator(TonemapOperator, TonemapOverrideSettings, LUTTexture.IsValid() ? TonemapOverride::GetLUTTextureId(Texture) : 0, Snapshot);
+
+				// ACES runs the engine implementation which only exists on the GPU
+				if (FTonemapOverrideCPULUT::IsOperatorSupported(TonemapOperator))
+				{
+					TArray<FLinearColor> Texels;
+					TArray<FLinearColor> Unwrapped;
+					Unwrapped.SetNumUninitialized(LUTSize * LUTSize * LUTSize);
+
+					Samples.Reset();
+					for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+					{
+						const uint64 StartCycles = FPlatformTime::Cycles64();
+
+						const FTonemapOverrideCPULUT CPULUT(Snapshot, &LUTTexture);
+						CPULUT.Generate(LUTSize, Texels);
+
+						if (!bUseVolumeTextureLUT)
+						{
+							CanonicalToUnwrappedLUT(Texels, LUTSize, Unwrapped);
+						}
+
+						Samples.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+					}
+					AddResult(OutResults, OperatorName, LayoutName, LUTSize, TEXT("CPU"), Samples);
+				}
+
+				if (bMeasureGPU && TonemapOverride::GetCompiledPermutations().IsTonemapOperatorCompiled(TonemapOperator))
+				{
+					if (bUseVolumeTextureLUT && !TonemapOverride::IsVolumeTextureLUTSupported(GMaxRHIShaderPlatform))
+					{
+						continue;
+					}
+
+					FTonemapOverrideLUTBakeKey Key;
+					Key.Snapshot = Snapshot;
+					Key.Format = LUTFormat;
+
+					if (TonemapOverride::MeasureLUTPass(Key, bUseVolumeTextureLUT, NumIterations, Samples))
+					{
+						AddResult(OutResults, OperatorName, LayoutName, LUTSize, TEXT("GPU"), Samples);
+					}
+				}
+			}
+		}
+	}
+}
+
+FString TonemapOverride::GetLUTBenchmarkDir()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TonemapOverride"), TEXT("Benchmark"));
+}
+
+bool TonemapOverride::WriteLUTBenchmarkResults(TConstArrayView<FTonemapOverrideBenchmarkResult> Results, const FString& OutputDir, const FString& BaseName)
+{
+	const FString CSVFilename = FPaths::Combine(OutputDir, BaseName + TEXT(".csv"));
+	const FString JSONFilename = FPaths::Combine(OutputDir, BaseName + TEXT(".json"));
+
+	if (!WriteCSV(Results, CSVFilename) || !WriteJSON(Results, JSONFilename))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to write the benchmark results to %s"), *OutputDir);
+		return false;
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Wrote %s and %s"), *CSVFilename, *JSONFilename);
+	return true;
+}
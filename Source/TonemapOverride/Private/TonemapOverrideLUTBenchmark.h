@@ -0,0 +1,46 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ECustomTonemapOperator : uint8;
+
+// One stage of the LUT benchmark for an operator, layout and LUT size, times in milliseconds
+struct FTonemapOverrideBenchmarkResult
+{
+	FString Operator;
+	FString Layout;
+	int32 LUTSize = 0;
+	FString Stage;
+	int32 NumSamples = 0;
+	double MinMs = 0;
+	double MedianMs = 0;
+	double P99Ms = 0;
+	double MeanMs = 0;
+};
+
+struct FTonemapOverrideBenchmarkOptions
+{
+	// All operators when empty
+	TArray<ECustomTonemapOperator> Operators;
+	TArray<int32> LUTSizes = { 16, 32, 48, 64 };
+	int32 NumIterations = 50;
+};
+
+namespace TonemapOverride
+{
+	// Stages per operator, LUT size and layout (volume and unwrapped 2D):
+	// CacheUpdate, the snapshot and cache key the view extension builds for a view every frame
+	// LegacyUpdate, the change detection of the first plugin version the snapshot replaced
+	// CPU, the LUT evaluated on the CPU and unwrapped for the 2D layout
+	// GPU, the LUT pass with timestamp queries, only when the RHI can render
+	// Game thread, shared by the TonemapOverrideBenchmark commandlet and the TonemapOverride.Perf.LUTBenchmark automation test
+	void RunLUTBenchmark(const FTonemapOverrideBenchmarkOptions& Options, TArray<FTonemapOverrideBenchmarkResult>& OutResults);
+
+	// Saved/TonemapOverride/Benchmark
+	FString GetLUTBenchmarkDir();
+
+	// Write <BaseName>.csv and <BaseName>.json into OutputDir
+	bool WriteLUTBenchmarkResults(TConstArrayView<FTonemapOverrideBenchmarkResult> Results, const FString& OutputDir, const FString& BaseName);
+}
@@ -0,0 +1,202 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTCache.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverride.h"
+#include "Hash/CityHash.h"
+
+static TAutoConsoleVariable<float> CVarTonemapOverrideLUTCacheBudget(
+	TEXT("r.TonemapOverride.LUTCache.BudgetMB"),
+	16.0f,
+	TEXT("Memory budget in megabytes for cached tonemap LUTs. Least recently used LUTs are released when exceeded."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideLUTCacheMaxAge(
+	TEXT("r.TonemapOverride.LUTCache.MaxAge"),
+	600,
+	TEXT("Number of frames an unused tonemap LUT is kept in the cache. 0 keeps LUTs until the budget is exceeded."),
+	ECVF_RenderThreadSafe);
+
+static uint64 GetLUTSizeInBytes(const FRDGTextureDesc& Desc)
+{
+	return uint64(GPixelFormats[Desc.Format].BlockBytes) * Desc.Extent.X * Desc.Extent.Y * FMath::Max<uint32>(Desc.Depth, 1);
+}
+
+uint64 FTonemapOverrideLUTCache::GetEntryKey(uint64 Fingerprint, const FRDGTextureDesc& Desc)
+{
+	// The same settings may end up in LUTs with different layout or format (ie. float output for HDR scene captures)
+	const uint32 DescKey[] =
+	{
+		uint32(Desc.Format),
+		uint32(Desc.Extent.X),
+		uint32(Desc.Extent.Y),
+		uint32(Desc.Depth),
+		uint32(Desc.Dimension),
+		uint32(EnumHasAnyFlags(Desc.Flags, TexCreate_UAV))
+	};
+
+	return CityHash64WithSeed(reinterpret_cast<const char*>(DescKey), sizeof(DescKey), Fingerprint);
+}
+
+FRDGTextureRef FTonemapOverrideLUTCache::FindOrCreate(FRDGBuilder& GraphBuilder, const FTonemapOverrideLUTSnapshot& Snapshot, uint64 Fingerprint, const FRDGTextureDesc& Desc, uint32 FrameNumber, bool& bOutNeedsRender)
+{
+	const uint64 Key = GetEntryKey(Fingerprint, Desc);
+
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		if (Entry->Snapshot != Snapshot)
+		{
+			UE_LOG(TonemapOverrideLog, Verbose, TEXT("LUT cache fingerprint collision, regenerating"));
+			Entry->Snapshot = Snapshot;
+			Entry->bValid = false;
+			Entry->NumGeneratedSlices = 0;
+		}
+
+		Entry->LastUsedFrame = FrameNumber;
+		bOutNeedsRender = !Entry->bValid;
+		return GraphBuilder.RegisterExternalTexture(Entry->RenderTarget);
+	}
+
+	const uint64 SizeInBytes = GetLUTSizeInBytes(Desc);
+	Trim(FrameNumber, SizeInBytes);
+
+	FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, TEXT("TonemapOverride.CachedLUT"));
+
+	FEntry& NewEntry = Entries.Add(Key);
+	NewEntry.RenderTarget = GraphBuilder.ConvertToExternalTexture(Texture);
+	NewEntry.Snapshot = Snapshot;
+	NewEntry.SizeInBytes = SizeInBytes;
+	NewEntry.LastUsedFrame = FrameNumber;
+	NewEntry.bValid = false;
+	TotalSizeInBytes += SizeInBytes;
+
+	bOutNeedsRender = true;
+	return Texture;
+}
+
+void FTonemapOverrideLUTCache::MarkValid(uint64 Fingerprint, const FRDGTextureDesc& Desc, uint32 FrameNumber, bool bAsyncCompute)
+{
+	if (FEntry* Entry = Entries.Find(GetEntryKey(Fingerprint, Desc)))
+	{
+		Entry->bValid = true;
+		Entry->bAsyncCompute = bAsyncCompute;
+		Entry->GeneratedFrame = FrameNumber;
+	}
+}
+
+bool FTonemapOverrideLUTCache::IsPending(uint64 Key, uint32 FrameNumber) const
+{
+	const FEntry* Entry = Entries.Find(Key);
+	return Entry && Entry->bValid && Entry->bAsyncCompute && Entry->GeneratedFrame == FrameNumber;
+}
+
+FRDGTextureRef FTonemapOverrideLUTCache::FindReadable(FRDGBuilder& GraphBuilder, uint64 Key, uint32 FrameNumber)
+{
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry || !Entry->bValid || IsPending(Key, FrameNumber))
+	{
+		return nullptr;
+	}
+
+	Entry->LastUsedFrame = FrameNumber;
+	return GraphBuilder.RegisterExternalTexture(Entry->RenderTarget);
+}
+
+void FTonemapOverrideLUTCache::Touch(uint64 Key, uint32 FrameNumber)
+{
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		Entry->LastUsedFrame = FrameNumber;
+	}
+}
+
+bool FTonemapOverrideLUTCache::IsValid(uint64 Key) const
+{
+	const FEntry* Entry = Entries.Find(Key);
+	return Entry && Entry->bValid;
+}
+
+const FTonemapOverrideLUTSnapshot* FTonemapOverrideLUTCache::FindSnapshot(uint64 Key) const
+{
+	const FEntry* Entry = Entries.Find(Key);
+	return Entry ? &Entry->Snapshot : nullptr;
+}
+
+int32 FTonemapOverrideLUTCache::GetNumGeneratedSlices(uint64 Key) const
+{
+	const FEntry* Entry = Entries.Find(Key);
+	return Entry ? Entry->NumGeneratedSlices : 0;
+}
+
+void FTonemapOverrideLUTCache::SetNumGeneratedSlices(uint64 Key, int32 NumSlices)
+{
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		Entry->NumGeneratedSlices = NumSlices;
+	}
+}
+
+void FTonemapOverrideLUTCache::Empty()
+{
+	Entries.Empty();
+	TotalSizeInBytes = 0;
+	TonemapOverride::ReleaseLUTShaderCaches();
+}
+
+void FTonemapOverrideLUTCache::Trim(uint32 FrameNumber, uint64 IncomingSizeInBytes)
+{
+	const int32 NumEntries = Entries.Num();
+
+	// Release LUTs that have not been used for a while, once per frame is enough
+	const int32 MaxAge = CVarTonemapOverrideLUTCacheMaxAge.GetValueOnRenderThread();
+	if (MaxAge > 0 && LastTrimFrame != FrameNumber)
+	{
+		LastTrimFrame = FrameNumber;
+
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (FrameNumber - It.Value().LastUsedFrame > uint32(MaxAge))
+			{
+				TotalSizeInBytes -= It.Value().SizeInBytes;
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	const uint64 BudgetInBytes = uint64(FMath::Max(CVarTonemapOverrideLUTCacheBudget.GetValueOnRenderThread(), 0.0f) * 1024.0f * 1024.0f);
+
+	while (TotalSizeInBytes + ReservedSizeInBytes + IncomingSizeInBytes > BudgetInBytes)
+	{
+		uint64 OldestKey = 0;
+		uint32 OldestAge = 0;
+		bool bFound = false;
+
+		for (const TPair<uint64, FEntry>& Pair : Entries)
+		{
+			const uint32 Age = FrameNumber - Pair.Value.LastUsedFrame;
+
+			// Never evict LUTs that are in use this frame
+			if (Age > 0 && (!bFound || Age > OldestAge))
+			{
+				OldestKey = Pair.Key;
+				OldestAge = Age;
+				bFound = true;
+			}
+		}
+
+		if (!bFound)
+		{
+			UE_LOG(TonemapOverrideLog, Verbose, TEXT("LUT cache over budget with %d LUTs in use this frame"), Entries.Num());
+			break;
+		}
+
+		TotalSizeInBytes -= Entries.FindChecked(OldestKey).SizeInBytes;
+		Entries.Remove(OldestKey);
+	}
+
+	// Expanded curves and parameters of the evicted LUTs go with them
+	if (Entries.Num() < NumEntries)
+	{
+		TonemapOverride::ReleaseLUTShaderCaches();
+	}
+}
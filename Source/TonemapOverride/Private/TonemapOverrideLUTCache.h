@@ -0,0 +1,74 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphBuilder.h"
+#include "RendererInterface.h"
+#include "TonemapOverrideLUTSettings.h"
+
+// Render thread cache for the generated LUTs
+// Entries are keyed with the settings fingerprint and the texture description, so views with identical grading share
+// one LUT while views with different grading (split screen, editor viewports, scene captures) keep their own
+
+class FTonemapOverrideLUTCache
+{
+public:
+	struct FEntry
+	{
+		TRefCountPtr<IPooledRenderTarget> RenderTarget;
+		// Full snapshot is kept to rule out fingerprint collisions
+		FTonemapOverrideLUTSnapshot Snapshot;
+		uint64 SizeInBytes = 0;
+		uint32 LastUsedFrame = 0;
+		// Frame of the async compute generation, the LUT is read from the next frame on
+		uint32 GeneratedFrame = 0;
+		// Leading slices generated so far while the LUT is generated over several frames
+		int32 NumGeneratedSlices = 0;
+		bool bValid = false;
+		bool bAsyncCompute = false;
+	};
+
+	// Returns the cached texture, bOutNeedsRender is set when the contents have to be generated
+	FRDGTextureRef FindOrCreate(FRDGBuilder& GraphBuilder, const FTonemapOverrideLUTSnapshot& Snapshot, uint64 Fingerprint, const FRDGTextureDesc& Desc, uint32 FrameNumber, bool& bOutNeedsRender);
+
+	// Call once the LUT generation pass has been added for the fingerprint
+	void MarkValid(uint64 Fingerprint, const FRDGTextureDesc& Desc, uint32 FrameNumber = 0, bool bAsyncCompute = false);
+
+	// Generated on the async compute queue during this frame
+	bool IsPending(uint64 Key, uint32 FrameNumber) const;
+
+	// Valid and not pending entry for the key, marked as used this frame
+	FRDGTextureRef FindReadable(FRDGBuilder& GraphBuilder, uint64 Key, uint32 FrameNumber);
+
+	// Keep the entry from being evicted this frame
+	void Touch(uint64 Key, uint32 FrameNumber);
+
+	bool IsValid(uint64 Key) const;
+
+	// Settings of the entry, nullptr if the entry has been evicted
+	const FTonemapOverrideLUTSnapshot* FindSnapshot(uint64 Key) const;
+
+	// Progress of a time sliced generation, kept with the entry so an evicted entry starts over
+	int32 GetNumGeneratedSlices(uint64 Key) const;
+	void SetNumGeneratedSlices(uint64 Key, int32 NumSlices);
+
+	void Empty();
+
+	// Memory kept for the LUTs outside the entries (operator stages of the staged LUT), counted against the budget
+	void SetReservedSizeInBytes(uint64 SizeInBytes) { ReservedSizeInBytes = SizeInBytes; }
+
+	int32 Num() const { return Entries.Num(); }
+	uint64 GetTotalSizeInBytes() const { return TotalSizeInBytes + ReservedSizeInBytes; }
+
+	static uint64 GetEntryKey(uint64 Fingerprint, const FRDGTextureDesc& Desc);
+
+private:
+	// Evict least recently used entries until we are within the budget, entries used this frame are kept
+	void Trim(uint32 FrameNumber, uint64 IncomingSizeInBytes);
+
+	TMap<uint64, FEntry> Entries;
+	uint64 TotalSizeInBytes = 0;
+	uint64 ReservedSizeInBytes = 0;
+	uint32 LastTrimFrame = 0;
+};
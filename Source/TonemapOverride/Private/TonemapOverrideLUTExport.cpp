@@ -0,0 +1,193 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTExport.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverride.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/StringBuilder.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+
+namespace
+{
+	// Text formats get large at 129^3, slices are formatted in parallel and joined in order
+	template<typename AppendSliceType>
+	void FormatSlices(int32 LUTSize, const FAnsiStringView& Header, AppendSliceType&& AppendSlice, TArray<uint8>& OutText)
+	{
+		TArray<TArray<uint8>> Slices;
+		Slices.SetNum(LUTSize);
+
+		ParallelFor(LUTSize, [&Slices, &AppendSlice](int32 Slice)
+		{
+			TAnsiStringBuilder<4096> Builder;
+			AppendSlice(Slice, Builder);
+			Slices[Slice].Append(reinterpret_cast<const uint8*>(Builder.GetData()), Builder.Len());
+		});
+
+		int64 TotalSize = Header.Len();
+		for (const TArray<uint8>& Slice : Slices)
+		{
+			TotalSize += Slice.Num();
+		}
+
+		OutText.Reset(TotalSize);
+		OutText.Append(reinterpret_cast<const uint8*>(Header.GetData()), Header.Len());
+		for (const TArray<uint8>& Slice : Slices)
+		{
+			OutText.Append(Slice);
+		}
+	}
+
+	bool WriteCube(TConstArrayView<FLinearColor> Texels, int32 LUTSize, const FString& Title, const FString& Filename, const FTonemapOverrideLUTShaper* Shaper)
+	{
+		TAnsiStringBuilder<256> Header;
+		Header.Appendf("TITLE \"%s\"\n", TCHAR_TO_UTF8(*Title));
+
+		if (Shaper)
+		{
+			// Resolve style 1D shaper section, applied before the 3D table
+			Header.Appendf("LUT_1D_SIZE %d\nLUT_1D_INPUT_RANGE 0.0 1.0\n", Shaper->Curve.Num());
+			Header.Appendf("LUT_3D_SIZE %d\nLUT_3D_INPUT_RANGE 0.0 1.0\n", LUTSize);
+			for (const float Value : Shaper->Curve)
+			{
+				Header.Appendf("%.6f %.6f %.6f\n", Value, Value, Value);
+			}
+		}
+		else
+		{
+			Header.Appendf("LUT_3D_SIZE %d\n", LUTSize);
+			Header << "DOMAIN_MIN 0.0 0.0 0.0\nDOMAIN_MAX 1.0 1.0 1.0\n";
+		}
+
+		// Red changes fastest, which is the canonical layout as is
+		TArray<uint8> Text;
+		FormatSlices(LUTSize, Header, [Texels, LUTSize](int32 Blue, FAnsiStringBuilderBase& Builder)
+		{
+			const int32 SliceTexels = LUTSize * LUTSize;
+			for (const FLinearColor& Color : Texels.Slice(Blue * SliceTexels, SliceTexels))
+			{
+				Builder.Appendf("%.6f %.6f %.6f\n", Color.R, Color.G, Color.B);
+			}
+		}, Text);
+
+		return FFileHelper::SaveArrayToFile(Text, *Filename);
+	}
+
+	bool WriteSpi3d(TConstArrayView<FLinearColor> Texels, int32 LUTSize, const FString& Filename)
+	{
+		TAnsiStringBuilder<256> Header;
+		Header << "SPILUT 1.0\n3 3\n";
+		Header.Appendf("%d %d %d\n", LUTSize, LUTSize, LUTSize);
+
+		// Every line carries its indices, written red major like OCIO does
+		TArray<uint8> Text;
+		FormatSlices(LUTSize, Header, [Texels, LUTSize](int32 Red, FAnsiStringBuilderBase& Builder)
+		{
+			for (int32 Green = 0; Green < LUTSize; ++Green)
+			{
+				for (int32 Blue = 0; Blue < LUTSize; ++Blue)
+				{
+					const FLinearColor& Color = Texels[Red + (Green + Blue * LUTSize) * LUTSize];
+					Builder.Appendf("%d %d %d %.6f %.6f %.6f\n", Red, Green, Blue, Color.R, Color.G, Color.B);
+				}
+			}
+		}, Text);
+
+		return FFileHelper::SaveArrayToFile(Text, *Filename);
+	}
+
+	bool WriteSpi1dShaper(const FTonemapOverrideLUTShaper& Shaper, const FString& Filename)
+	{
+		TAnsiStringBuilder<4096> Text;
+		Text.Appendf("Version 1\nFrom 0.0 1.0\nLength %d\nComponents 1\n{\n", Shaper.Curve.Num());
+		for (const float Value : Shaper.Curve)
+		{
+			Text.Appendf("    %.6f\n", Value);
+		}
+		Text << "}\n";
+
+		return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len()), *Filename);
+	}
+
+	bool WriteEXRAtlas(TConstArrayView<FLinearColor> Texels, int32 LUTSize, const FString& Filename)
+	{
+		// Slice B at x offset B * Size, same as the 2D LUT of the engine
+		const int32 Width = LUTSize * LUTSize;
+		const int32 Height = LUTSize;
+
+		TArray<FLinearColor> Atlas;
+		Atlas.SetNumUninitialized(Width * Height);
+
+		ParallelFor(LUTSize, [&Atlas, Texels, LUTSize, Width](int32 Blue)
+		{
+			for (int32 Green = 0; Green < LUTSize; ++Green)
+			{
+				for (int32 Red = 0; Red < LUTSize; ++Red)
+				{
+					FLinearColor Color = Texels[Red + (Green + Blue * LUTSize) * LUTSize];
+					Color.A = 1.0f;
+					Atlas[Green * Width + Blue * LUTSize + Red] = Color;
+				}
+			}
+		});
+
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::EXR);
+
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Atlas.GetData(), Atlas.Num() * sizeof(FLinearColor), Width, Height, ERGBFormat::RGBAF, 32))
+		{
+			return false;
+		}
+
+		const TArray64<uint8> Compressed = ImageWrapper->GetCompressed();
+		return Compressed.Num() > 0 && FFileHelper::SaveArrayToFile(Compressed, *Filename);
+	}
+}
+
+const TCHAR* TonemapOverride::GetLUTExportExtension(ETonemapOverrideLUTExportFormat Format)
+{
+	switch (Format)
+	{
+	case ETonemapOverrideLUTExportFormat::Cube: return TEXT("cube");
+	case ETonemapOverrideLUTExportFormat::Spi3d: return TEXT("spi3d");
+	case ETonemapOverrideLUTExportFormat::EXR: return TEXT("exr");
+	default: return TEXT("");
+	}
+}
+
+bool TonemapOverride::ExportLUT(ETonemapOverrideLUTExportFormat Format, TConstArrayView<FLinearColor> Texels, int32 LUTSize, const FString& Title, const FString& Filename, const FTonemapOverrideLUTShaper* Shaper)
+{
+	check(Texels.Num() == LUTSize * LUTSize * LUTSize);
+
+	bool bSuccess = false;
+
+	switch (Format)
+	{
+	case ETonemapOverrideLUTExportFormat::Cube:
+		bSuccess = WriteCube(Texels, LUTSize, Title, Filename, Shaper);
+		break;
+	case ETonemapOverrideLUTExportFormat::Spi3d:
+		bSuccess = WriteSpi3d(Texels, LUTSize, Filename);
+		break;
+	case ETonemapOverrideLUTExportFormat::EXR:
+		bSuccess = WriteEXRAtlas(Texels, LUTSize, Filename);
+		break;
+	default:
+		break;
+	}
+
+	// Formats without a 1D section get the shaper as a separate file
+	if (bSuccess && Shaper && Format != ETonemapOverrideLUTExportFormat::Cube)
+	{
+		bSuccess = WriteSpi1dShaper(*Shaper, Filename + TEXT(".shaper.spi1d"));
+	}
+
+	if (!bSuccess)
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to write LUT to %s"), *Filename);
+	}
+
+	return bSuccess;
+}
@@ -0,0 +1,27 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTonemapOverrideLUTShaper;
+
+// LUT file writers for grading applications. Texels are in the canonical layout (R + G * Size + B * Size * Size)
+// and hold display values, the input of the LUT is the engine log encoding of the scene color
+
+enum class ETonemapOverrideLUTExportFormat : uint8
+{
+	Cube,	// Resolve, Adobe, Nuke OCIOFileTransform
+	Spi3d,	// OpenColorIO
+	EXR,	// Slice atlas of Size * Size by Size in the engine unwrapped LUT layout
+	MAX
+};
+
+namespace TonemapOverride
+{
+	const TCHAR* GetLUTExportExtension(ETonemapOverrideLUTExportFormat Format);
+
+	// With a shaper the texels are the shaped lattice. The shaper is written in the .cube file as its 1D section
+	// and next to the other formats as <Filename>.shaper.spi1d
+	bool ExportLUT(ETonemapOverrideLUTExportFormat Format, TConstArrayView<FLinearColor> Texels, int32 LUTSize, const FString& Title, const FString& Filename, const FTonemapOverrideLUTShaper* Shaper = nullptr);
+}
@@ -0,0 +1,465 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTImport.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverride.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/StringBuilder.h"
+
+#if WITH_EDITOR
+#include "Engine/VolumeTexture.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#endif
+
+namespace
+{
+	using FNumbers = TArray<double, TInlineAllocator<8>>;
+
+	// Line without the comment and the surrounding white space, null terminated for the number parsing
+	void GetLineContent(FStringView Line, FStringBuilderBase& OutContent)
+	{
+		int32 CommentIndex = INDEX_NONE;
+		if (Line.FindChar(TEXT('#'), CommentIndex))
+		{
+			Line.LeftInline(CommentIndex);
+		}
+
+		OutContent.Reset();
+		OutContent << Line.TrimStartAndEnd();
+	}
+
+	// All white space separated numbers of the text, false when something else is found
+	bool ParseNumbers(const TCHAR* Text, FNumbers& OutNumbers)
+	{
+		OutNumbers.Reset();
+
+		for (const TCHAR* Ptr = Text;;)
+		{
+			while (FChar::IsWhitespace(*Ptr))
+			{
+				++Ptr;
+			}
+
+			if (*Ptr == TEXT('\0'))
+			{
+				return true;
+			}
+
+			TCHAR* End = nullptr;
+			const double Value = FCString::Strtod(Ptr, &End);
+			if (End == Ptr || (*End != TEXT('\0') && !FChar::IsWhitespace(*End)))
+			{
+				return false;
+			}
+
+			OutNumbers.Add(Value);
+			Ptr = End;
+		}
+	}
+
+	FVector3f ToVector(const FNumbers& Numbers)
+	{
+		return FVector3f(float(Numbers[0]), float(Numbers[1]), float(Numbers[2]));
+	}
+
+	FTonemapOverrideCPUTexture3D MakeTexture(const FTonemapOverrideImportedLUT& LUT)
+	{
+		FTonemapOverrideCPUTexture3D Texture;
+		Texture.Size = FIntVector(LUT.Size);
+		Texture.Texels = LUT.Texels;
+		return Texture;
+	}
+
+	// Texel center coordinate of a 0..1 position along the lattice
+	FVector3f LatticeToUVW(const FVector3f& Position, int32 Size)
+	{
+		return (Position * float(Size - 1) + 0.5f) / float(Size);
+	}
+
+	// Adobe Cube LUT Specification 1.0 with the Resolve LUT_xD_INPUT_RANGE extension
+	struct FCubeParser
+	{
+		FString Title;
+		int32 Size1D = 0;
+		int32 Size3D = 0;
+		FVector3f Domain1DMin = FVector3f::ZeroVector;
+		FVector3f Domain1DMax = FVector3f::OneVector;
+		FVector3f Domain3DMin = FVector3f::ZeroVector;
+		FVector3f Domain3DMax = FVector3f::OneVector;
+		TArray<FVector3f> Table1D;
+		TArray<FVector3f> Table3D;
+		FString Error;
+
+		void ParseLine(const FStringBuilderBase& Content, FNumbers& Numbers)
+		{
+			const TCHAR* Text = Content.ToString();
+
+			if (FChar::IsAlpha(Text[0]))
+			{
+				ParseKeyword(Content, Numbers);
+				return;
+			}
+
+			if (!ParseNumbers(Text, Numbers) || Numbers.Num() != 3)
+			{
+				Error = FString::Printf(TEXT("expected three values, got '%s'"), Text);
+				return;
+			}
+
+			// With both tables the 1D section comes first
+			if (Table1D.Num() < Size1D)
+			{
+				Table1D.Add(ToVector(Numbers));
+			}
+			else if (Table3D.Num() < Size3D * Size3D * Size3D)
+			{
+				Table3D.Add(ToVector(Numbers));
+			}
+			else
+			{
+				Error = TEXT("more table rows than LUT_1D_SIZE / LUT_3D_SIZE declare");
+			}
+		}
+
+		void ParseKeyword(const FStringBuilderBase& Content, FNumbers& Numbers)
+		{
+			const FStringView Line = Content.ToView();
+
+			int32 KeywordEnd = 0;
+			while (KeywordEnd < Line.Len() && !FChar::IsWhitespace(Line[KeywordEnd]))
+			{
+				++KeywordEnd;
+			}
+
+			const FStringView Keyword = Line.Left(KeywordEnd);
+			const TCHAR* Arguments = Content.ToString() + KeywordEnd;
+
+			if (Keyword == TEXT("TITLE"))
+			{
+				Title = FString(Line.RightChop(KeywordEnd).TrimStartAndEnd()).TrimQuotes();
+				return;
+			}
+
+			if (!Table1D.IsEmpty() || !Table3D.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("keyword %.*s after the table data"), Keyword.Len(), Keyword.GetData());
+				return;
+			}
+
+			const bool bParsed = ParseNumbers(Arguments, Numbers);
+
+			if (Keyword == TEXT("LUT_1D_SIZE") || Keyword == TEXT("LUT_3D_SIZE"))
+			{
+				const bool b3D = Keyword == TEXT("LUT_3D_SIZE");
+				const int32 Size = bParsed && Numbers.Num() == 1 ? int32(Numbers[0]) : 0;
+				if (Size < 2 || Size > (b3D ? 256 : 65536))
+				{
+					Error = FString::Printf(TEXT("invalid %s"), Content.ToString());
+					return;
+				}
+				(b3D ? Size3D : Size1D) = Size;
+			}
+			else if (Keyword == TEXT("DOMAIN_MIN") || Keyword == TEXT("DOMAIN_MAX"))
+			{
+				if (!bParsed || Numbers.Num() != 3)
+				{
+					Error = FString::Printf(TEXT("invalid %s"), Content.ToString());
+					return;
+				}
+
+				// Applies to the tables that are present
+				const bool bMin = Keyword == TEXT("DOMAIN_MIN");
+				(bMin ? Domain1DMin : Domain1DMax) = ToVector(Numbers);
+				(bMin ? Domain3DMin : Domain3DMax) = ToVector(Numbers);
+			}
+			else if (Keyword == TEXT("LUT_1D_INPUT_RANGE") || Keyword == TEXT("LUT_3D_INPUT_RANGE"))
+			{
+				if (!bParsed || Numbers.Num() != 2)
+				{
+					Error = FString::Printf(TEXT("invalid %s"), Content.ToString());
+					return;
+				}
+
+				const bool b3D = Keyword == TEXT("LUT_3D_INPUT_RANGE");
+				(b3D ? Domain3DMin : Domain1DMin) = FVector3f(float(Numbers[0]));
+				(b3D ? Domain3DMax : Domain1DMax) = FVector3f(float(Numbers[1]));
+			}
+			else
+			{
+				UE_LOG(TonemapOverrideLog, Verbose, TEXT("Ignoring .cube keyword %.*s"), Keyword.Len(), Keyword.GetData());
+			}
+		}
+
+		bool Finish(FTonemapOverrideImportedLUT& OutLUT)
+		{
+			if (Size3D == 0)
+			{
+				Error = TEXT("no LUT_3D_SIZE, 1D only files are not supported");
+				return false;
+			}
+
+			if (Table1D.Num() != Size1D || Table3D.Num() != Size3D * Size3D * Size3D)
+			{
+				Error = FString::Printf(TEXT("%d / %d rows of the 1D table and %d / %d of the 3D table"), Table1D.Num(), Size1D, Table3D.Num(), Size3D * Size3D * Size3D);
+				return false;
+			}
+
+			OutLUT.Title = Title;
+			OutLUT.Size = Size3D;
+
+			if (Size1D == 0)
+			{
+				OutLUT.Texels = MoveTemp(Table3D);
+				OutLUT.DomainMin = Domain3DMin;
+				OutLUT.DomainMax = Domain3DMax;
+				return true;
+			}
+
+			// The shaper is folded into the 3D table so that the LUT pass does a single lookup
+			FTonemapOverrideImportedLUT Lattice;
+			Lattice.Size = Size3D;
+			Lattice.Texels = MoveTemp(Table3D);
+			const FTonemapOverrideCPUTexture3D Texture3D = MakeTexture(Lattice);
+
+			auto SampleShaper = [this](int32 Channel, float Position)
+			{
+				const float Index = FMath::Clamp(Position, 0.0f, 1.0f) * float(Size1D - 1);
+				const int32 Index0 = FMath::Min(FMath::FloorToInt(Index), Size1D - 2);
+				return FMath::Lerp(Table1D[Index0][Channel], Table1D[Index0 + 1][Channel], Index - float(Index0));
+			};
+
+			const FVector3f Domain3DRange = Domain3DMax - Domain3DMin;
+
+			OutLUT.Texels.SetNumUninitialized(Size3D * Size3D * Size3D);
+			for (int32 Index = 0; Index < OutLUT.Texels.Num(); ++Index)
+			{
+				const FVector3f Position = FVector3f(Index % Size3D, (Index / Size3D) % Size3D, Index / (Size3D * Size3D)) / float(Size3D - 1);
+				const FVector3f Shaped(SampleShaper(0, Position.X), SampleShaper(1, Position.Y), SampleShaper(2, Position.Z));
+				OutLUT.Texels[Index] = Texture3D.Sample(LatticeToUVW((Shaped - Domain3DMin) / Domain3DRange, Size3D));
+			}
+
+			OutLUT.DomainMin = Domain1DMin;
+			OutLUT.DomainMax = Domain1DMax;
+			return true;
+		}
+	};
+
+	// Integer 3D LUT: optional Mesh header, a lattice line and the triplets with blue changing fastest
+	struct F3dlParser
+	{
+		int32 Size = 0;
+		int32 OutputBits = 0;
+		TArray<FVector3f> Table;
+		double MaxValue = 0.0;
+		FString Error;
+
+		void ParseLine(const FStringBuilderBase& Content, FNumbers& Numbers)
+		{
+			const TCHAR* Text = Content.ToString();
+
+			if (FChar::IsAlpha(Text[0]))
+			{
+				if (FCString::Strnicmp(Text, TEXT("Mesh"), 4) == 0 && ParseNumbers(Text + 4, Numbers) && Numbers.Num() == 2)
+				{
+					Size = (1 << FMath::Clamp(int32(Numbers[0]), 1, 8)) + 1;
+					OutputBits = FMath::Clamp(int32(Numbers[1]), 1, 16);
+				}
+				return;
+			}
+
+			if (!ParseNumbers(Text, Numbers))
+			{
+				Error = FString::Printf(TEXT("expected values, got '%s'"), Text);
+				return;
+			}
+
+			// Input lattice, only its length matters as the spacing is uniform in practice
+			if (Numbers.Num() > 3 && Table.IsEmpty())
+			{
+				Size = Numbers.Num();
+				return;
+			}
+
+			if (Numbers.Num() != 3 || Size == 0)
+			{
+				Error = FString::Printf(TEXT("unexpected line '%s'"), Text);
+				return;
+			}
+
+			MaxValue = FMath::Max(MaxValue, FMath::Max3(Numbers[0], Numbers[1], Numbers[2]));
+			Table.Add(ToVector(Numbers));
+		}
+
+		bool Finish(FTonemapOverrideImportedLUT& OutLUT)
+		{
+			if (Size < 2 || Size > 256 || Table.Num() != Size * Size * Size)
+			{
+				Error = FString::Printf(TEXT("%d rows for a lattice of %d"), Table.Num(), Size);
+				return false;
+			}
+
+			// Output depth from the Mesh header, otherwise the smallest common integer range that holds the values
+			double Scale = 1.0;
+			if (OutputBits > 0)
+			{
+				Scale = double((1 << OutputBits) - 1);
+			}
+			else if (MaxValue > 1.0)
+			{
+				for (const int32 Bits : { 10, 12, 14, 16 })
+				{
+					Scale = double((1 << Bits) - 1);
+					if (MaxValue <= Scale)
+					{
+						break;
+					}
+				}
+			}
+
+			OutLUT.Size = Size;
+			OutLUT.Texels.SetNumUninitialized(Table.Num());
+
+			// Red changes slowest in the file
+			for (int32 Index = 0; Index < Table.Num(); ++Index)
+			{
+				const int32 Blue = Index % Size;
+				const int32 Green = (Index / Size) % Size;
+				const int32 Red = Index / (Size * Size);
+				OutLUT.Texels[Red + (Green + Blue * Size) * Size] = Table[Index] / float(Scale);
+			}
+
+			return true;
+		}
+	};
+
+	template<typename ParserType>
+	bool ParseLUTFile(const FString& Filename, ParserType& Parser, FTonemapOverrideImportedLUT& OutLUT)
+	{
+		TStringBuilder<256> Content;
+		FNumbers Numbers;
+		int32 LineNumber = 0;
+		int32 ErrorLine = 0;
+
+		const bool bRead = FFileHelper::LoadFileToStringWithLineVisitor(*Filename, [&](FStringView Line)
+		{
+			++LineNumber;
+			if (!Parser.Error.IsEmpty())
+			{
+				return;
+			}
+
+			GetLineContent(Line, Content);
+			if (Content.Len() > 0)
+			{
+				Parser.ParseLine(Content, Numbers);
+				ErrorLine = Parser.Error.IsEmpty() ? 0 : LineNumber;
+			}
+		});
+
+		if (!bRead)
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to read %s"), *Filename);
+			return false;
+		}
+
+		if (Parser.Error.IsEmpty() && !Parser.Finish(OutLUT))
+		{
+			ErrorLine = LineNumber;
+		}
+
+		if (!Parser.Error.IsEmpty())
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("%s(%d): %s"), *Filename, ErrorLine, *Parser.Error);
+			return false;
+		}
+
+		return true;
+	}
+}
+
+bool TonemapOverride::ImportLUTFile(const FString& Filename, FTonemapOverrideImportedLUT& OutLUT)
+{
+	OutLUT = FTonemapOverrideImportedLUT();
+
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension.Equals(TEXT("cube"), ESearchCase::IgnoreCase))
+	{
+		FCubeParser Parser;
+		return ParseLUTFile(Filename, Parser, OutLUT);
+	}
+	if (Extension.Equals(TEXT("3dl"), ESearchCase::IgnoreCase))
+	{
+		F3dlParser Parser;
+		return ParseLUTFile(Filename, Parser, OutLUT);
+	}
+
+	UE_LOG(TonemapOverrideLog, Error, TEXT("Unknown LUT file type %s, expected .cube or .3dl"), *Filename);
+	return false;
+}
+
+void TonemapOverride::ResampleLUT(const FTonemapOverrideImportedLUT& Source, int32 LUTSize, FTonemapOverrideImportedLUT& OutLUT)
+{
+	const FTonemapOverrideCPUTexture3D Texture = MakeTexture(Source);
+
+	OutLUT.Title = Source.Title;
+	OutLUT.Size = LUTSize;
+	OutLUT.DomainMin = Source.DomainMin;
+	OutLUT.DomainMax = Source.DomainMax;
+	OutLUT.Texels.SetNumUninitialized(LUTSize * LUTSize * LUTSize);
+
+	for (int32 Index = 0; Index < OutLUT.Texels.Num(); ++Index)
+	{
+		const FVector3f Position = FVector3f(Index % LUTSize, (Index / LUTSize) % LUTSize, Index / (LUTSize * LUTSize)) / float(LUTSize - 1);
+		OutLUT.Texels[Index] = Texture.Sample(LatticeToUVW(Position, Source.Size));
+	}
+}
+
+#if WITH_EDITOR
+UVolumeTexture* TonemapOverride::SaveLUTVolumeTexture(const FString& PackageName, const FIntVector& Size, TConstArrayView<FVector3f> Texels)
+{
+	check(Texels.Num() == Size.X * Size.Y * Size.Z);
+
+	TArray<FFloat16Color> SourceData;
+	SourceData.SetNumUninitialized(Texels.Num());
+	for (int32 Index = 0; Index < Texels.Num(); ++Index)
+	{
+		const FVector3f& Texel = Texels[Index];
+		SourceData[Index] = FFloat16Color(FLinearColor(Texel.X, Texel.Y, Texel.Z, 1.0f));
+	}
+
+	const FString AssetName = FPackageName::GetLongPackageAssetName(PackageName);
+	const FString ObjectPath = PackageName + TEXT(".") + AssetName;
+
+	UVolumeTexture* Texture = LoadObject<UVolumeTexture>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+	if (!Texture)
+	{
+		UPackage* NewPackage = CreatePackage(*PackageName);
+		Texture = NewObject<UVolumeTexture>(NewPackage, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	// Half float source is built to PF_FloatRGBA
+	Texture->Source.Init(Size.X, Size.Y, Size.Z, 1, TSF_RGBA16F, reinterpret_cast<const uint8*>(SourceData.GetData()));
+	Texture->CompressionSettings = TC_HDR;
+	Texture->SRGB = false;
+	Texture->MipGenSettings = TMGS_NoMipmaps;
+	Texture->LODGroup = TEXTUREGROUP_ColorLookupTable;
+	Texture->Filter = TF_Bilinear;
+	Texture->PostEditChange();
+	Texture->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+	if (!UPackage::SavePackage(Texture->GetPackage(), Texture, *Filename, SaveArgs))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Failed to save the LUT texture to %s"), *Filename);
+		return nullptr;
+	}
+
+	return Texture;
+}
+#endif
@@ -0,0 +1,36 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UVolumeTexture;
+
+// 3D LUT read from a grading application file, texels in the canonical layout (R + G * Size + B * Size * Size)
+struct FTonemapOverrideImportedLUT
+{
+	FString Title;
+	int32 Size = 0;
+	TArray<FVector3f> Texels;
+
+	// Input mapped to the first and the last texel
+	FVector3f DomainMin = FVector3f::ZeroVector;
+	FVector3f DomainMax = FVector3f::OneVector;
+
+	bool IsValid() const { return Size > 1 && Texels.Num() == Size * Size * Size; }
+};
+
+namespace TonemapOverride
+{
+	// Reads .cube (Resolve / Adobe) and .3dl (Lustre / Flame) files line by line
+	// A .cube 1D shaper section is composed into the 3D table, the result keeps the 3D size and the shaper input range
+	bool ImportLUTFile(const FString& Filename, FTonemapOverrideImportedLUT& OutLUT);
+
+	// Trilinear resample to another lattice size over the same domain
+	void ResampleLUT(const FTonemapOverrideImportedLUT& Source, int32 LUTSize, FTonemapOverrideImportedLUT& OutLUT);
+
+#if WITH_EDITOR
+	// Half float volume texture set up for LUT sampling, created or updated in the package and saved
+	UVolumeTexture* SaveLUTVolumeTexture(const FString& PackageName, const FIntVector& Size, TConstArrayView<FVector3f> Texels);
+#endif
+}
@@ -0,0 +1,116 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTImportCommandlet.h"
+#include "TonemapOverrideLUTImport.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Engine/VolumeTexture.h"
+
+static const TCHAR* DefaultCustomLUTPackage = TEXT("/Game/TonemapOverride/CustomLUT");
+
+namespace
+{
+	template<typename EnumType>
+	bool ParseEnumParam(const TMap<FString, FString>& ParamVals, const TCHAR* Name, EnumType& InOutValue)
+	{
+		const FString* Param = ParamVals.Find(Name);
+		if (!Param)
+		{
+			return true;
+		}
+
+		const int64 Value = StaticEnum<EnumType>()->GetValueByNameString(*Param);
+		if (Value == INDEX_NONE || Value >= int64(EnumType::MAX))
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("Unknown %s encoding %s"), Name, **Param);
+			return false;
+		}
+
+		InOutValue = EnumType(Value);
+		return true;
+	}
+}
+
+UTonemapOverrideLUTImportCommandlet::UTonemapOverrideLUTImportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTonemapOverrideLUTImportCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	const FString* FileParam = ParamVals.Find(TEXT("File"));
+	if (!FileParam)
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Give the LUT file with -File"));
+		return 1;
+	}
+
+	ECustomLUTInputEncoding InputEncoding = TonemapOverrideSettings.CustomLUTInput;
+	ECustomLUTOutputEncoding OutputEncoding = TonemapOverrideSettings.CustomLUTOutput;
+	if (!ParseEnumParam(ParamVals, TEXT("Input"), InputEncoding) || !ParseEnumParam(ParamVals, TEXT("Output"), OutputEncoding))
+	{
+		return 1;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FTonemapOverrideImportedLUT LUT;
+	if (!TonemapOverride::ImportLUTFile(*FileParam, LUT))
+	{
+		return 1;
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Read %d^3 LUT '%s' in %.2f s, domain (%s) - (%s)"), LUT.Size, *LUT.Title, FPlatformTime::Seconds() - StartTime, *LUT.DomainMin.ToString(), *LUT.DomainMax.ToString());
+
+	if (const FString* SizeParam = ParamVals.Find(TEXT("Size")))
+	{
+		const int32 LUTSize = FCString::Atoi(**SizeParam);
+		if (LUTSize < 2 || LUTSize > 256)
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("Invalid LUT size %s"), **SizeParam);
+			return 1;
+		}
+
+		if (LUTSize != LUT.Size)
+		{
+			FTonemapOverrideImportedLUT Resampled;
+			TonemapOverride::ResampleLUT(LUT, LUTSize, Resampled);
+			UE_LOG(TonemapOverrideLog, Display, TEXT("Resampled the LUT to %d^3"), LUTSize);
+			LUT = MoveTemp(Resampled);
+		}
+	}
+
+	const FString* AssetParam = ParamVals.Find(TEXT("Asset"));
+	const FString PackageName = AssetParam ? *AssetParam : DefaultCustomLUTPackage;
+
+	UVolumeTexture* Texture = TonemapOverride::SaveLUTVolumeTexture(PackageName, FIntVector(LUT.Size), LUT.Texels);
+	if (!Texture)
+	{
+		return 1;
+	}
+
+	TonemapOverrideSettings.CustomLUTTexture = Texture;
+	TonemapOverrideSettings.CustomLUTInput = InputEncoding;
+	TonemapOverrideSettings.CustomLUTOutput = OutputEncoding;
+	TonemapOverrideSettings.CustomLUTDomainMin = FVector(LUT.DomainMin);
+	TonemapOverrideSettings.CustomLUTDomainMax = FVector(LUT.DomainMax);
+	TonemapOverrideSettings.TryUpdateDefaultConfigFile();
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Saved Custom LUT texture %s, select the CustomLUT operator to use it"), *PackageName);
+	return 0;
+#else
+	UE_LOG(TonemapOverrideLog, Error, TEXT("LUT import requires an editor build"));
+	return 1;
+#endif
+}
@@ -0,0 +1,1245 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverride.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideFastMath.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideSettings.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "RenderGraphUtils.h"
+#include "PixelShaderUtils.h"
+#include "ScreenPass.h"
+#include "VolumeRendering.h"
+#include "PostProcess/DrawRectangle.h"
+#include "HDRHelper.h"
+#include "Hash/CityHash.h"
+#include "PipelineStateCache.h"
+#include "Misc/ConfigCacheIni.h"
+#include "TonemapOverrideStats.h"
+#include <atomic>
+
+#if WITH_EDITOR
+#include "ShaderCompiler.h"
+#endif
+
+DECLARE_GPU_STAT_NAMED(TonemapOverrideLUT, TEXT("TonemapOverride LUT"));
+
+// Key of the compiled permutations captured at module startup, 0 until then. Shader compilation reads it on any thread
+static std::atomic<uint32> GCompiledPermutationsKey(0);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverridePSOPrecache(
+	TEXT("r.TonemapOverride.PSOPrecache"),
+	1,
+	TEXT("Precache the pipelines of every LUT shader permutation the compiled operators can reach at startup and level load, and log LUT pipelines that were not precached when they are first used. Needs PSO precaching (r.PSOPrecaching)."),
+	ECVF_RenderThreadSafe);
+
+class FTonemapOverrideShaderCommon : public FGlobalShader
+{
+public:
+	static const int32 GroupSize = 8;
+
+	static bool PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(EShaderPlatform Platform)
+	{
+		return RHIVolumeTextureRenderingSupportGuaranteed(Platform) && (RHISupportsGeometryShaders(Platform) || RHISupportsVertexShaderLayer(Platform));
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), GroupSize);
+
+		const int UseVolumeLUT = PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(Parameters.Platform) ? 1 : 0;
+		OutEnvironment.SetDefine(TEXT("USE_VOLUME_LUT"), UseVolumeLUT);
+
+		// Not read by the shaders, the pruning below depends on the plugin settings which are otherwise not part of the shader key
+		OutEnvironment.SetDefine(TEXT("COMPILED_PERMUTATIONS"), TonemapOverride::GetCompiledPermutations().GetKey());
+	}
+
+	class FTonemapOperator : SHADER_PERMUTATION_ENUM_CLASS("TONEMAP_OPERATOR", ECustomTonemapOperator);
+	class FOutputDeviceSRGB : SHADER_PERMUTATION_BOOL("OUTPUT_DEVICE_SRGB");
+	class FSkipTemperature : SHADER_PERMUTATION_BOOL("SKIP_TEMPERATURE");
+	class FGT7UCSType : SHADER_PERMUTATION_ENUM_CLASS("TONE_MAPPING_UCSTYPE", EGT7UCSType);
+	class FFlimCustomPreset : SHADER_PERMUTATION_BOOL("FLIM_CUSTOM_PRESET");
+	class FFastMath : SHADER_PERMUTATION_BOOL("FAST_MATH");
+	class FSeparableCurve : SHADER_PERMUTATION_BOOL("SEPARABLE_CURVE");
+	using FPermutationDomain = TShaderPermutationDomain<FOutputDeviceSRGB, FTonemapOperator, FSkipTemperature, FGT7UCSType, FFlimCustomPreset, FFastMath, FSeparableCurve>;
+
+	// Operator specific dimensions collapse for the other operators, operators left out of the project are replaced with ACES
+	static FPermutationDomain RemapPermutation(FPermutationDomain PermutationVector, const FTonemapOverrideCompiledPermutations& CompiledPermutations)
+	{
+		if (!CompiledPermutations.IsTonemapOperatorCompiled(PermutationVector.Get<FTonemapOperator>()))
+		{
+			PermutationVector.Set<FTonemapOperator>(ECustomTonemapOperator::ACES);
+		}
+
+		const ECustomTonemapOperator Operator = PermutationVector.Get<FTonemapOperator>();
+
+		if (Operator != ECustomTonemapOperator::GT7)
+		{
+			PermutationVector.Set<FGT7UCSType>(EGT7UCSType::ICtCp);
+		}
+
+		if (Operator != ECustomTonemapOperator::Flim)
+		{
+			PermutationVector.Set<FFlimCustomPreset>(false);
+		}
+
+		if (!CompiledPermutations.IsFastMathVariantCompiled(Operator))
+		{
+			PermutationVector.Set<FFastMath>(false);
+		}
+
+		if (!FTonemapOverrideCPULUT::HasSeparableCurve(Operator))
+		{
+			PermutationVector.Set<FSeparableCurve>(false);
+		}
+
+		return PermutationVector;
+	}
+
+	static bool ShouldCompileCommonPermutation(const FPermutationDomain& PermutationVector, const FTonemapOverrideCompiledPermutations& CompiledPermutations)
+	{
+		return RemapPermutation(PermutationVector, CompiledPermutations) == PermutationVector;
+	}
+
+	static bool ShouldCompileCommonPermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return ShouldCompileCommonPermutation(FPermutationDomain(Parameters.PermutationId), TonemapOverride::GetCompiledPermutations());
+	}
+
+	FTonemapOverrideShaderCommon() {}
+
+	FTonemapOverrideShaderCommon(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FGlobalShader(Initializer)
+	{ }
+};
+
+class FTonemapOverrideLUTShaderPS : public FTonemapOverrideShaderCommon
+{
+public:
+	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTShaderPS);
+	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTShaderPS, FTonemapOverrideShaderCommon);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return ShouldCompileCommonPermutation(Parameters);
+	}
+};
+
+class FTonemapOverrideLUTShaderCS : public FTonemapOverrideShaderCommon
+{
+public:
+	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTShaderCS);
+	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTShaderCS, FTonemapOverrideShaderCommon);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
+		SHADER_PARAMETER(FVector2f, OutputExtentInverse)
+		SHADER_PARAMETER(FIntVector, LUTDispatchOffset)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return ShouldCompilePlatform(Parameters.Platform) && ShouldCompileCommonPermutation(Parameters);
+	}
+
+	static bool ShouldCompilePlatform(EShaderPlatform Platform)
+	{
+		return IsFeatureLevelSupported(Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+// Per LUT parameters of the batched pass (FLUTVariant in BatchedLUT.usf), the grading and the operator settings
+struct FTonemapOverrideLUTVariantParameters
+{
+	FMatrix44f FlimExtendMat;
+	FMatrix44f FlimExtendMatInv;
+	FVector4f OverlayColor;
+	FVector4f ColorSaturation;
+	FVector4f ColorContrast;
+	FVector4f ColorGamma;
+	FVector4f ColorGain;
+	FVector4f ColorOffset;
+	FVector4f ColorSaturationShadows;
+	FVector4f ColorContrastShadows;
+	FVector4f ColorGammaShadows;
+	FVector4f ColorGainShadows;
+	FVector4f ColorOffsetShadows;
+	FVector4f ColorSaturationMidtones;
+	FVector4f ColorContrastMidtones;
+	FVector4f ColorGammaMidtones;
+	FVector4f ColorGainMidtones;
+	FVector4f ColorOffsetMidtones;
+	FVector4f ColorSaturationHighlights;
+	FVector4f ColorContrastHighlights;
+	FVector4f ColorGammaHighlights;
+	FVector4f ColorGainHighlights;
+	FVector4f ColorOffsetHighlights;
+	FVector4f FlimSigmoidToeShoulder;
+	FVector3f ColorScale;
+	float ColorCorrectionShadowsMax;
+	FVector3f FlimBacklightExt;
+	float ColorCorrectionHighlightsMin;
+	FVector3f FlimWhiteCap;
+	float ColorCorrectionHighlightsMax;
+	FVector3f FlimPreFormationFilter;
+	float WhiteTemp;
+	FVector3f FlimPostFormationFilter;
+	float WhiteTint;
+	FVector3f GT7CurveShoulder;
+	float ExpandGamut;
+	float ToneCurveAmount;
+	float ReinhardWhitePoint;
+	float HejlWhitePoint;
+	float GT7BlendRatio;
+	float GT7FadeStart;
+	float GT7FadeEnd;
+	float GT7PeakIntensity;
+	float GT7SdrCorrectionFactor;
+	float GT7LuminanceTargetUcs;
+	float FlimBlackPoint;
+	float FlimPreExposure;
+	float FlimPreFormationFilterStrength;
+	float FlimPostFormationFilterStrength;
+	float FlimSigmoidLog2Min;
+	float FlimSigmoidLog2Max;
+	float FlimNegativeFilmExposure;
+	float FlimNegativeFilmDensity;
+	float FlimPrintFilmExposure;
+	float FlimPrintFilmDensity;
+	float FlimMidtoneSaturation;
+};
+
+static_assert(sizeof(FTonemapOverrideLUTVariantParameters) == 656, "FTonemapOverrideLUTVariantParameters needs to match FLUTVariant in BatchedLUT.usf");
+
+class FTonemapOverrideBatchedLUTShaderCS : public FTonemapOverrideShaderCommon
+{
+public:
+	DECLARE_GLOBAL_SHADER(FTonemapOverrideBatchedLUTShaderCS);
+	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideBatchedLUTShaderCS, FTonemapOverrideShaderCommon);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FTonemapOverrideLUTVariantParameters>, LUTVariants)
+		SHADER_PARAMETER(FVector2f, OutputExtentInverse)
+		SHADER_PARAMETER(uint32, LUTVariantSlices)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture0)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture1)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture2)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture3)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		const FTonemapOverrideCompiledPermutations CompiledPermutations = TonemapOverride::GetCompiledPermutations();
+		return FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Parameters.Platform) && ShouldCompileCommonPermutation(PermutationVector, CompiledPermutations)
+			&& CompiledPermutations.IsBatchedLUTPassCompiled(PermutationVector.Get<FTonemapOperator>());
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FTonemapOverrideShaderCommon::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("BATCHED_LUT"), 1);
+	}
+};
+
+// Staged LUT: the operator stage runs only when the settings before the fades change, the output stage applies the fades and the output device
+class FTonemapOverrideLUTOperatorStageCS : public FTonemapOverrideShaderCommon
+{
+public:
+	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTOperatorStageCS);
+	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTOperatorStageCS, FTonemapOverrideShaderCommon);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
+		SHADER_PARAMETER(FVector2f, OutputExtentInverse)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOperatorStage)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Parameters.Platform) && ShouldCompileCommonPermutation(PermutationVector, TonemapOverride::GetCompiledPermutations())
+			&& PermutationVector.Get<FTonemapOperator>() != ECustomTonemapOperator::ACES;
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FTonemapOverrideShaderCommon::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("LUT_STAGES"), 1);
+	}
+};
+
+class FTonemapOverrideLUTOutputStageCS : public FTonemapOverrideShaderCommon
+{
+public:
+	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTOutputStageCS);
+	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTOutputStageCS, FTonemapOverrideShaderCommon);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, OperatorStage)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+
+	// Only the output device and the HDR output of GT7 matter after the operator, ACES stands in for the other operators
+	static FPermutationDomain GetOutputStagePermutation(const FPermutationDomain& PermutationVector)
+	{
+		const bool bGT7 = PermutationVector.Get<FTonemapOperator>() == ECustomTonemapOperator::GT7;
+
+		FPermutationDomain OutputStageVector;
+		OutputStageVector.Set<FOutputDeviceSRGB>(PermutationVector.Get<FOutputDeviceSRGB>());
+		OutputStageVector.Set<FTonemapOperator>(bGT7 ? ECustomTonemapOperator::GT7 : ECustomTonemapOperator::ACES);
+		OutputStageVector.Set<FGT7UCSType>(EGT7UCSType::ICtCp);
+		return OutputStageVector;
+	}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Parameters.Platform) && ShouldCompileCommonPermutation(PermutationVector, TonemapOverride::GetCompiledPermutations())
+			&& GetOutputStagePermutation(PermutationVector) == PermutationVector;
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FTonemapOverrideShaderCommon::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("LUT_STAGES"), 1);
+	}
+};
+
+IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTShaderPS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTPS", SF_Pixel);
+IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTShaderCS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideBatchedLUTShaderCS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateBatchedLUTCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTOperatorStageCS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTOperatorStageCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTOutputStageCS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTOutputStageCS", SF_Compute);
+
+BEGIN_SHADER_PARAMETER_STRUCT(FTonemapOverrideUploadLUTParameters, )
+	RDG_TEXTURE_ACCESS(Texture, ERHIAccess::CopyDest)
+END_SHADER_PARAMETER_STRUCT()
+
+// Curves and parameters expanded from the snapshots, render thread only. Kept for the variants of a batched pass
+// and the frames of a time sliced LUT, and released together with the LUTs the LUT cache evicts
+static TMap<uint64, TSharedRef<const TArray<FVector4f>>> GSeparableCurves;
+static TMap<uint64, TSharedRef<const FTonemapOverrideLUTParameters>> GLUTShaderParameters;
+static uint32 GLUTShaderParametersGeneration = 0;
+
+// Curve of the separable operator uploaded for the LUT pass. It is baked once per settings change, time sliced LUTs
+// and the views sharing the settings reuse the same curve
+static TSharedRef<const TArray<FVector4f>> GetSeparableCurve(const FTonemapOverrideLUTSnapshot& Snapshot)
+{
+	const uint64 Hash = Snapshot.GetContentHash();
+	if (const TSharedRef<const TArray<FVector4f>>* Curve = GSeparableCurves.Find(Hash))
+	{
+		return *Curve;
+	}
+
+	if (GSeparableCurves.Num() >= 2 * TonemapOverride::MaxBatchedLUTs)
+	{
+		GSeparableCurves.Reset();
+	}
+
+	const FTonemapOverrideCPULUT CPULUT(Snapshot);
+	return GSeparableCurves.Add(Hash, MakeShared<const TArray<FVector4f>>(CPULUT.GetParameters().SeparableCurve));
+}
+
+// Fixed function state and shaders of the LUT PS pass, the render targets are set by the caller
+// Shared by the pass and the pipeline precaching so that both describe the same pipeline
+static void SetupLUTGraphicsPipeline(FGraphicsPipelineStateInitializer& GraphicsPSOInit, FGlobalShaderMap* GlobalShaderMap, const TShaderMapRef<FTonemapOverrideLUTShaderPS>& PixelShader, bool bUseVolumeTextureLUT)
+{
+	GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+
+	if (bUseVolumeTextureLUT)
+	{
+		TShaderMapRef<FWriteToSliceVS> VertexShader(GlobalShaderMap);
+		TOptionalShaderMapRef<FWriteToSliceGS> GeometryShader(GlobalShaderMap);
+
+		GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GScreenVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.SetGeometryShader(GeometryShader.GetGeometryShader());
+	}
+	else
+	{
+		TShaderMapRef<FScreenPassVS> VertexShader(GlobalShaderMap);
+
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+	}
+
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+}
+
+enum class ELUTPipeline : uint8
+{
+	Compute,
+	BatchedCompute,
+	Graphics,
+	OperatorStage,
+	OutputStage,
+};
+
+// Compute pipelines only depend on the permutation, graphics pipelines also on the LUT layout and format
+static uint64 GetLUTPipelineKey(ELUTPipeline Pipeline, int32 PermutationId, bool bUseVolumeTextureLUT = false, EPixelFormat Format = PF_Unknown)
+{
+	return uint64(uint32(PermutationId)) | (uint64(Pipeline) << 32) | (uint64(bUseVolumeTextureLUT) << 40) | (uint64(Format) << 48);
+}
+
+// Render thread only
+static TSet<uint64> GPrecachedLUTPipelines;
+static TSet<uint64> GOnDemandLUTPipelines;
+
+static bool IsLUTPipelinePrecachingEnabled()
+{
+	return CVarTonemapOverridePSOPrecache.GetValueOnRenderThread() != 0 && PipelineStateCache::IsPSOPrecachingEnabled();
+}
+
+// Logs the first use of a pipeline that was not precached, the pipeline is then created on demand and may hitch
+static void CheckLUTPipelinePrecached(ELUTPipeline Pipeline, const FTonemapOverrideShaderCommon::FPermutationDomain& PermutationVector, bool bUseVolumeTextureLUT = false, EPixelFormat Format = PF_Unknown)
+{
+	if (!IsLUTPipelinePrecachingEnabled())
+	{
+		return;
+	}
+
+	const uint64 Key = GetLUTPipelineKey(Pipeline, PermutationVector.ToDimensionValueId(), bUseVolumeTextureLUT, Format);
+	if (GPrecachedLUTPipelines.Contains(Key))
+	{
+		return;
+	}
+
+	bool bAlreadyLogged = false;
+	GOnDemandLUTPipelines.Add(Key, &bAlreadyLogged);
+
+	if (!bAlreadyLogged)
+	{
+		static const TCHAR* PipelineNames[] = { TEXT("CS"), TEXT("batched CS"), TEXT("PS"), TEXT("operator stage CS"), TEXT("output stage CS") };
+
+		INC_DWORD_STAT(STAT_TonemapOverrideOnDemandPipelines);
+		UE_LOG(TonemapOverrideLog, Warning, TEXT("LUT %s pipeline created on demand: %s, permutation %d%s%s"),
+			PipelineNames[uint32(Pipeline)], *UEnum::GetValueAsString(PermutationVector.Get<FTonemapOverrideShaderCommon::FTonemapOperator>()), PermutationVector.ToDimensionValueId(),
+			Pipeline == ELUTPipeline::Graphics ? (bUseVolumeTextureLUT ? TEXT(", volume ") : TEXT(", 2D ")) : TEXT(""),
+			Pipeline == ELUTPipeline::Graphics ? GetPixelFormatString(Format) : TEXT(""));
+	}
+}
+
+// Parameters expanded from the render settings and a snapshot, kept while the render settings stay the same
+// Time sliced builds and batches expand the same snapshot on several frames or for several passes
+static TSharedRef<const FTonemapOverrideLUTParameters> GetCachedLUTShaderParameters(const FTonemapOverrideLUTSnapshot& Snapshot)
+{
+	// The operator textures come from the render settings
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+	if (GLUTShaderParametersGeneration != RenderSettings.Generation)
+	{
+		GLUTShaderParameters.Reset();
+		GLUTShaderParametersGeneration = RenderSettings.Generation;
+	}
+
+	const uint64 Hash = Snapshot.GetHash();
+	if (const TSharedRef<const FTonemapOverrideLUTParameters>* Found = GLUTShaderParameters.Find(Hash))
+	{
+		return *Found;
+	}
+
+	if (GLUTShaderParameters.Num() >= 2 * TonemapOverride::MaxBatchedLUTs)
+	{
+		GLUTShaderParameters.Reset();
+	}
+
+	TSharedRef<FTonemapOverrideLUTParameters> Parameters = MakeShared<FTonemapOverrideLUTParameters>();
+	TonemapOverride::GetLUTShaderParameters(Snapshot, RenderSettings, *Parameters);
+	return GLUTShaderParameters.Add(Hash, Parameters);
+}
+
+void TonemapOverride::ReleaseLUTShaderCaches()
+{
+	check(IsInRenderingThread());
+
+	GSeparableCurves.Empty();
+	GLUTShaderParameters.Empty();
+}
+
+static FRDGBufferRef CreateSeparableCurveBuffer(FRDGBuilder& GraphBuilder, TConstArrayView<FVector4f> Curve)
+{
+	return CreateVertexBuffer(GraphBuilder, TEXT("TonemapOverride.SeparableCurve"), FRDGBufferDesc::CreateBufferDesc(sizeof(FVector4f), Curve.Num()), Curve.GetData(), Curve.Num() * sizeof(FVector4f));
+}
+
+static FTonemapOverrideShaderCommon::FPermutationDomain GetLUTPermutation(const FTonemapOverrideLUTSnapshot& Snapshot)
+{
+	FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector;
+
+	const float DefaultTemperature = 6500;
+	const float DefaultTint = 0;
+
+	const bool ShouldSkipTemperature = FMath::IsNearlyEqual(Snapshot.WhiteTemp, DefaultTemperature) && FMath::IsNearlyEqual(Snapshot.WhiteTint, DefaultTint);
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FSkipTemperature>(ShouldSkipTemperature);
+
+	const bool bOutputDeviceSRGB = (Snapshot.OutputDevice == (uint32)EDisplayOutputFormat::SDR_sRGB);
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FOutputDeviceSRGB>(bOutputDeviceSRGB);
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FTonemapOperator>(Snapshot.GetTonemapOperator());
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FGT7UCSType>(Snapshot.GetGT7UCSType());
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FFlimCustomPreset>(Snapshot.GetTonemapOperator() == ECustomTonemapOperator::Flim && Snapshot.bFlimCustomPreset != 0);
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FFastMath>(Snapshot.bFastMath != 0);
+	PermutationVector.Set<FTonemapOverrideShaderCommon::FSeparableCurve>(Snapshot.bSeparableCurve != 0);
+
+	const FTonemapOverrideShaderCommon::FPermutationDomain RequestedPermutationVector = PermutationVector;
+	PermutationVector = FTonemapOverrideShaderCommon::RemapPermutation(PermutationVector, TonemapOverride::GetRenderSettings().CompiledPermutations);
+
+	if (PermutationVector.Get<FTonemapOverrideShaderCommon::FTonemapOperator>() != RequestedPermutationVector.Get<FTonemapOverrideShaderCommon::FTonemapOperator>())
+	{
+		static bool bWarned = false;
+		UE_CLOG(!bWarned, TonemapOverrideLog, Warning, TEXT("Tonemap operator %s is not in the Compiled Operators of the plugin settings, using ACES"), *UEnum::GetValueAsString(Snapshot.GetTonemapOperator()));
+		bWarned = true;
+	}
+
+	return PermutationVector;
+}
+
+static void GetLUTVariantParameters(const FTonemapOverrideLUTParameters& Parameters, FTonemapOverrideLUTVariantParameters& OutVariant)
+{
+	const FCustomTonemapperParameters& Custom = Parameters.CustomTonemapperParameters;
+	const FFlimTonemapperParameters& Flim = Parameters.FlimParameters;
+	FTonemapOverrideLUTVariantParameters& V = OutVariant;
+
+	V.OverlayColor = Parameters.OverlayColor;
+	V.ColorScale = Parameters.ColorScale;
+
+	V.ColorSaturation = Parameters.ColorSaturation;
+	V.ColorContrast = Parameters.ColorContrast;
+	V.ColorGamma = Parameters.ColorGamma;
+	V.ColorGain = Parameters.ColorGain;
+	V.ColorOffset = Parameters.ColorOffset;
+
+	V.ColorSaturationShadows = Parameters.ColorSaturationShadows;
+	V.ColorContrastShadows = Parameters.ColorContrastShadows;
+	V.ColorGammaShadows = Parameters.ColorGammaShadows;
+	V.ColorGainShadows = Parameters.ColorGainShadows;
+	V.ColorOffsetShadows = Parameters.ColorOffsetShadows;
+
+	V.ColorSaturationMidtones = Parameters.ColorSaturationMidtones;
+	V.ColorContrastMidtones = Parameters.ColorContrastMidtones;
+	V.ColorGammaMidtones = Parameters.ColorGammaMidtones;
+	V.ColorGainMidtones = Parameters.ColorGainMidtones;
+	V.ColorOffsetMidtones = Parameters.ColorOffsetMidtones;
+
+	V.ColorSaturationHighlights = Parameters.ColorSaturationHighlights;
+	V.ColorContrastHighlights = Parameters.ColorContrastHighlights;
+	V.ColorGammaHighlights = Parameters.ColorGammaHighlights;
+	V.ColorGainHighlights = Parameters.ColorGainHighlights;
+	V.ColorOffsetHighlights = Parameters.ColorOffsetHighlights;
+
+	V.ColorCorrectionShadowsMax = Parameters.ColorCorrectionShadowsMax;
+	V.ColorCorrectionHighlightsMin = Parameters.ColorCorrectionHighlightsMin;
+	V.ColorCorrectionHighlightsMax = Parameters.ColorCorrectionHighlightsMax;
+	V.WhiteTemp = Parameters.WhiteTemp;
+	V.WhiteTint = Parameters.WhiteTint;
+	V.ExpandGamut = Parameters.ExpandGamut;
+	V.ToneCurveAmount = Parameters.ToneCurveAmount;
+
+	V.ReinhardWhitePoint = Custom.ReinhardWhitePoint;
+	V.HejlWhitePoint = Custom.HejlWhitePoint;
+	V.GT7BlendRatio = Custom.GT7BlendRatio;
+	V.GT7FadeStart = Custom.GT7FadeStart;
+	V.GT7FadeEnd = Custom.GT7FadeEnd;
+	V.GT7PeakIntensity = Custom.GT7PeakIntensity;
+	V.GT7SdrCorrectionFactor = Custom.GT7SdrCorrectionFactor;
+	V.GT7LuminanceTargetUcs = Custom.GT7LuminanceTargetUcs;
+	V.GT7CurveShoulder = Custom.GT7CurveShoulder;
+
+	V.FlimExtendMat = Flim.FlimExtendMat;
+	V.FlimExtendMatInv = Flim.FlimExtendMatInv;
+	V.FlimBacklightExt = Flim.FlimBacklightExt;
+	V.FlimWhiteCap = Flim.FlimWhiteCap;
+	V.FlimPreFormationFilter = Flim.FlimPreFormationFilter;
+	V.FlimPostFormationFilter = Flim.FlimPostFormationFilter;
+	V.FlimSigmoidToeShoulder = Flim.FlimSigmoidToeShoulder;
+	V.FlimBlackPoint = Flim.FlimBlackPoint;
+	V.FlimPreExposure = Flim.FlimPreExposure;
+	V.FlimPreFormationFilterStrength = Flim.FlimPreFormationFilterStrength;
+	V.FlimPostFormationFilterStrength = Flim.FlimPostFormationFilterStrength;
+	V.FlimSigmoidLog2Min = Flim.FlimSigmoidLog2Min;
+	V.FlimSigmoidLog2Max = Flim.FlimSigmoidLog2Max;
+	V.FlimNegativeFilmExposure = Flim.FlimNegativeFilmExposure;
+	V.FlimNegativeFilmDensity = Flim.FlimNegativeFilmDensity;
+	V.FlimPrintFilmExposure = Flim.FlimPrintFilmExposure;
+	V.FlimPrintFilmDensity = Flim.FlimPrintFilmDensity;
+	V.FlimMidtoneSaturation = Flim.FlimMidtoneSaturation;
+}
+
+FTonemapOverrideCompiledPermutations FTonemapOverrideCompiledPermutations::LoadFromConfig()
+{
+	// Config names of ECustomTonemapOperator, the enum itself is not available before the UObject system is up
+	static const TCHAR* const OperatorNames[] = { TEXT("Agx"), TEXT("AgxPunchy"), TEXT("Reinhard"), TEXT("TonyMcMapface"), TEXT("Flim"), TEXT("Hejl"), TEXT("GranTurismo"), TEXT("GT7"), TEXT("ACES"), TEXT("CustomLUT") };
+	static_assert(UE_ARRAY_COUNT(OperatorNames) == int32(ECustomTonemapOperator::MAX), "Operator names out of date");
+
+	const TCHAR* const Section = TEXT("/Script/TonemapOverride.TonemapOverrideSettings");
+
+	FTonemapOverrideCompiledPermutations CompiledPermutations;
+	if (!GConfig)
+	{
+		return CompiledPermutations;
+	}
+
+	GConfig->GetBool(Section, TEXT("bCompileFastMathVariants"), CompiledPermutations.bFastMathVariants, GGameIni);
+	GConfig->GetBool(Section, TEXT("bCompileBatchedLUTPass"), CompiledPermutations.bBatchedLUTPass, GGameIni);
+
+	TArray<FString> CompiledOperators;
+	GConfig->GetArray(Section, TEXT("CompiledTonemapOperators"), CompiledOperators, GGameIni);
+
+	if (!CompiledOperators.IsEmpty())
+	{
+		CompiledPermutations.OperatorMask = 0;
+		for (FString& OperatorName : CompiledOperators)
+		{
+			OperatorName.Split(TEXT("::"), nullptr, &OperatorName);
+
+			int32 Operator = 0;
+			while (Operator < UE_ARRAY_COUNT(OperatorNames) && OperatorName.TrimStartAndEnd() != OperatorNames[Operator])
+			{
+				++Operator;
+			}
+
+			UE_CLOG(Operator == UE_ARRAY_COUNT(OperatorNames), TonemapOverrideLog, Warning, TEXT("Unknown operator %s in Compiled Operators"), *OperatorName);
+			CompiledPermutations.OperatorMask |= Operator < UE_ARRAY_COUNT(OperatorNames) ? 1u << uint32(Operator) : 0u;
+		}
+	}
+
+	return CompiledPermutations;
+}
+
+FTonemapOverrideCompiledPermutations FTonemapOverrideCompiledPermutations::FromKey(uint32 Key)
+{
+	FTonemapOverrideCompiledPermutations CompiledPermutations;
+	CompiledPermutations.OperatorMask = Key & 0xFFFF;
+	CompiledPermutations.bFastMathVariants = (Key & (1u << 16)) != 0;
+	CompiledPermutations.bBatchedLUTPass = (Key & (1u << 17)) != 0;
+	return CompiledPermutations;
+}
+
+bool FTonemapOverrideCompiledPermutations::IsTonemapOperatorCompiled(ECustomTonemapOperator Operator) const
+{
+	return Operator == ECustomTonemapOperator::ACES || (Operator < ECustomTonemapOperator::MAX && (OperatorMask & (1u << uint32(Operator))) != 0);
+}
+
+bool FTonemapOverrideCompiledPermutations::IsFastMathVariantCompiled(ECustomTonemapOperator Operator) const
+{
+	return bFastMathVariants && TonemapOverride::HasFastMathVariant(Operator) && IsTonemapOperatorCompiled(Operator);
+}
+
+bool FTonemapOverrideCompiledPermutations::IsBatchedLUTPassCompiled(ECustomTonemapOperator Operator) const
+{
+	// ACES is generated by the engine shader code, which reads the loose grading parameters
+	return bBatchedLUTPass && Operator != ECustomTonemapOperator::ACES && IsTonemapOperatorCompiled(Operator);
+}
+
+uint32 FTonemapOverrideCompiledPermutations::GetKey() const
+{
+	return (OperatorMask | (1u << uint32(ECustomTonemapOperator::ACES))) | (uint32(bFastMathVariants) << 16) | (uint32(bBatchedLUTPass) << 17);
+}
+
+void TonemapOverride::CaptureCompiledPermutations()
+{
+	check(IsInGameThread());
+	GCompiledPermutationsKey.store(FTonemapOverrideCompiledPermutations::LoadFromConfig().GetKey(), std::memory_order_release);
+}
+
+FTonemapOverrideCompiledPermutations TonemapOverride::GetCompiledPermutations()
+{
+	// Not captured yet (the module is not started), all operators without the optional variants then
+	const uint32 Key = GCompiledPermutationsKey.load(std::memory_order_acquire);
+	return Key != 0 ? FTonemapOverrideCompiledPermutations::FromKey(Key) : FTonemapOverrideCompiledPermutations();
+}
+
+uint64 TonemapOverride::GetLUTBatchKey(const FTonemapOverrideLUTSnapshot& Snapshot)
+{
+	const FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector = GetLUTPermutation(Snapshot);
+	if (!GetRenderSettings().CompiledPermutations.IsBatchedLUTPassCompiled(PermutationVector.Get<FTonemapOverrideShaderCommon::FTonemapOperator>()))
+	{
+		return 0;
+	}
+
+	// Skipped temperature is part of the permutation but its fields are per variant
+	const int32 PermutationId = PermutationVector.ToDimensionValueId();
+	return CityHash64WithSeed(reinterpret_cast<const char*>(&PermutationId), sizeof(PermutationId), Snapshot.GetBatchHash()) | 1;
+}
+
+bool TonemapOverride::IsVolumeTextureLUTSupported(EShaderPlatform Platform)
+{
+	return FTonemapOverrideShaderCommon::PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(Platform);
+}
+
+FRDGTextureDesc TonemapOverride::GetLUTTextureDesc(int32 LUTSize, bool bUseVolumeTextureLUT, bool bUseComputePass, EPixelFormat Format)
+{
+	const ETextureCreateFlags Flags = TexCreate_ShaderResource | TexCreate_RenderTargetable | (bUseComputePass ? TexCreate_UAV : TexCreate_None);
+
+	if (bUseVolumeTextureLUT)
+	{
+		return FRDGTextureDesc::Create3D(FIntVector(LUTSize, LUTSize, LUTSize), Format, FClearValueBinding::Transparent, Flags);
+	}
+
+	return FRDGTextureDesc::Create2D(FIntPoint(LUTSize * LUTSize, LUTSize), Format, FClearValueBinding::Transparent, Flags);
+}
+
+void TonemapOverride::AddLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, FRDGTextureRef OutputTexture, const FTonemapOverrideLUTSnapshot& Snapshot, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize, const bool bAsyncCompute, const int32 FirstSlice, const int32 NumSlices)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "TonemapOverride LUT");
+	RDG_GPU_STAT_SCOPE(GraphBuilder, TonemapOverrideLUT);
+
+	const FIntPoint OutputViewSize(bUseVolumeTextureLUT ? TextureLUTSize : TextureLUTSize * TextureLUTSize, TextureLUTSize);
+
+	const FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector = GetLUTPermutation(Snapshot);
+
+	FRDGBufferSRVRef SeparableCurve = nullptr;
+	if (PermutationVector.Get<FTonemapOverrideShaderCommon::FSeparableCurve>())
+	{
+		SeparableCurve = GraphBuilder.CreateSRV(CreateSeparableCurveBuffer(GraphBuilder, *GetSeparableCurve(Snapshot)), PF_A32B32G32R32F);
+	}
+
+	if (bUseComputePass)
+	{
+		FTonemapOverrideLUTShaderCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTShaderCS::FParameters>();
+		PassParameters->TonemapLUTParameters = *GetCachedLUTShaderParameters(Snapshot);
+		PassParameters->TonemapLUTParameters.CustomTonemapperParameters.SeparableCurve = SeparableCurve;
+		PassParameters->OutputExtentInverse = FVector2f(1.0f, 1.0f) / FVector2f(OutputViewSize);
+		PassParameters->RWOutputTexture = GraphBuilder.CreateUAV(OutputTexture);
+
+		// Blue slices are the depth of a volume LUT and Size wide columns of an unwrapped LUT
+		const int32 SliceCount = NumSlices > 0 ? FMath::Min(NumSlices, TextureLUTSize - FirstSlice) : TextureLUTSize;
+		PassParameters->LUTDispatchOffset = bUseVolumeTextureLUT ? FIntVector(0, 0, FirstSlice) : FIntVector(FirstSlice * TextureLUTSize, 0, 0);
+
+		// Partial groups at the end of the range write texels of the following slices, which hold the same settings
+		const uint32 GroupSizeX = FMath::DivideAndRoundUp(bUseVolumeTextureLUT ? TextureLUTSize : SliceCount * TextureLUTSize, FTonemapOverrideLUTShaderCS::GroupSize);
+		const uint32 GroupSizeY = FMath::DivideAndRoundUp(TextureLUTSize, FTonemapOverrideLUTShaderCS::GroupSize);
+		const uint32 GroupSizeZ = bUseVolumeTextureLUT ? FMath::DivideAndRoundUp(SliceCount, FTonemapOverrideLUTShaderCS::GroupSize) : 1;
+
+		TShaderMapRef<FTonemapOverrideLUTShaderCS> ComputeShader(GlobalShaderMap, PermutationVector);
+		CheckLUTPipelinePrecached(ELUTPipeline::Compute, PermutationVector);
+
+		// Async generation has no reader in this graph, the texture is picked up next frame
+		const ERDGPassFlags PassFlags = bAsyncCompute ? ERDGPassFlags::AsyncCompute | ERDGPassFlags::NeverCull : ERDGPassFlags::Compute;
+
+		FComputeShaderUtils::AddPass(
+			GraphBuilder,
+			RDG_EVENT_NAME("Tonemap Create LUT CS Shader %d Slices %d-%d%s", TextureLUTSize, FirstSlice, FirstSlice + SliceCount - 1, bAsyncCompute ? TEXT(" (Async)") : TEXT("")),
+			PassFlags,
+			ComputeShader,
+			PassParameters,
+			FIntVector(GroupSizeX, GroupSizeY, GroupSizeZ));
+	}
+	else
+	{
+		FTonemapOverrideLUTShaderPS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTShaderPS::FParameters>();
+		PassParameters->TonemapLUTParameters = *GetCachedLUTShaderParameters(Snapshot);
+		PassParameters->TonemapLUTParameters.CustomTonemapperParameters.SeparableCurve = SeparableCurve;
+		PassParameters->RenderTargets[0] = FRenderTargetBinding(OutputTexture, ERenderTargetLoadAction::ENoAction);
+
+		TShaderMapRef<FTonemapOverrideLUTShaderPS> PixelShader(GlobalShaderMap, PermutationVector);
+		CheckLUTPipelinePrecached(ELUTPipeline::Graphics, PermutationVector, bUseVolumeTextureLUT, OutputTexture->Desc.Format);
+
+		GraphBuilder.AddPass(
+			RDG_EVENT_NAME("Tonemap Create LUT PS Shader %d", TextureLUTSize),
+			PassParameters,
+			ERDGPassFlags::Raster,
+			[GlobalShaderMap, PixelShader, PassParameters, bUseVolumeTextureLUT, TextureLUTSize](FRHICommandList& RHICmdList)
+			{
+				FGraphicsPipelineStateInitializer GraphicsPSOInit;
+				RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+				SetupLUTGraphicsPipeline(GraphicsPSOInit, GlobalShaderMap, PixelShader, bUseVolumeTextureLUT);
+				SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+
+				if (bUseVolumeTextureLUT)
+				{
+					const FVolumeBounds VolumeBounds(TextureLUTSize);
+					TShaderMapRef<FWriteToSliceVS> VertexShader(GlobalShaderMap);
+
+					SetShaderParametersLegacyVS(RHICmdList, VertexShader, VolumeBounds, FIntVector(VolumeBounds.MaxX - VolumeBounds.MinX));
+					SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *PassParameters);
+
+					RasterizeToVolumeTexture(RHICmdList, VolumeBounds);
+				}
+				else
+				{
+					TShaderMapRef<FScreenPassVS> VertexShader(GlobalShaderMap);
+
+					SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *PassParameters);
+
+					const int32 LUTSize = TextureLUTSize;
+					FRHIBatchedShaderParameters& BatchedParameters = RHICmdList.GetScratchShaderParameters();
+					UE::Renderer::PostProcess::SetDrawRectangleParameters(BatchedParameters, VertexShader.GetShader(), 0, 0, LUTSize*LUTSize, LUTSize, 0, 0, LUTSize*LUTSize, LUTSize, FIntPoint(LUTSize* LUTSize, LUTSize), FIntPoint(LUTSize* LUTSize, LUTSize));
+					RHICmdList.SetBatchedShaderParameters(VertexShader.GetVertexShader(), BatchedParameters);
+
+					FPixelShaderUtils::DrawFullscreenTriangle(RHICmdList, 1);
+
+				}
+			});
+
+	}
+}
+
+bool TonemapOverride::IsStagedLUTPassSupported(const FTonemapOverrideLUTSnapshot& Snapshot, const bool bUseComputePass)
+{
+	// ACES goes through the engine LUT function which is not split
+	return bUseComputePass && FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(EShaderPlatform(Snapshot.ShaderPlatform))
+		&& GetLUTPermutation(Snapshot).Get<FTonemapOverrideShaderCommon::FTonemapOperator>() != ECustomTonemapOperator::ACES;
+}
+
+FRDGTextureDesc TonemapOverride::GetOperatorStageTextureDesc(const int32 TextureLUTSize, const bool bUseVolumeTextureLUT)
+{
+	// Full float so that the staged LUT matches the single pass
+	const ETextureCreateFlags Flags = TexCreate_ShaderResource | TexCreate_UAV;
+	return bUseVolumeTextureLUT
+		? FRDGTextureDesc::Create3D(FIntVector(TextureLUTSize), PF_A32B32G32R32F, FClearValueBinding::None, Flags)
+		: FRDGTextureDesc::Create2D(FIntPoint(TextureLUTSize * TextureLUTSize, TextureLUTSize), PF_A32B32G32R32F, FClearValueBinding::None, Flags);
+}
+
+void TonemapOverride::AddStagedLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, FRDGTextureRef OutputTexture, FRDGTextureRef OperatorStageTexture, const FTonemapOverrideLUTSnapshot& Snapshot, const bool bRenderOperatorStage, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize, const bool bAsyncCompute)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "TonemapOverride LUT");
+	RDG_GPU_STAT_SCOPE(GraphBuilder, TonemapOverrideLUT);
+
+	const FIntPoint OutputViewSize(bUseVolumeTextureLUT ? TextureLUTSize : TextureLUTSize * TextureLUTSize, TextureLUTSize);
+	const FIntVector GroupCount(
+		FMath::DivideAndRoundUp(OutputViewSize.X, FTonemapOverrideLUTShaderCS::GroupSize),
+		FMath::DivideAndRoundUp(OutputViewSize.Y, FTonemapOverrideLUTShaderCS::GroupSize),
+		bUseVolumeTextureLUT ? FMath::DivideAndRoundUp(TextureLUTSize, FTonemapOverrideLUTShaderCS::GroupSize) : 1);
+
+	const ERDGPassFlags PassFlags = bAsyncCompute ? ERDGPassFlags::AsyncCompute | ERDGPassFlags::NeverCull : ERDGPassFlags::Compute;
+	const FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector = GetLUTPermutation(Snapshot);
+
+	if (bRenderOperatorStage)
+	{
+		FRDGBufferSRVRef SeparableCurve = nullptr;
+		if (PermutationVector.Get<FTonemapOverrideShaderCommon::FSeparableCurve>())
+		{
+			SeparableCurve = GraphBuilder.CreateSRV(CreateSeparableCurveBuffer(GraphBuilder, *GetSeparableCurve(Snapshot)), PF_A32B32G32R32F);
+		}
+
+		FTonemapOverrideLUTOperatorStageCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTOperatorStageCS::FParameters>();
+		PassParameters->TonemapLUTParameters = *GetCachedLUTShaderParameters(Snapshot);
+		PassParameters->TonemapLUTParameters.CustomTonemapperParameters.SeparableCurve = SeparableCurve;
+		PassParameters->OutputExtentInverse = FVector2f(1.0f, 1.0f) / FVector2f(OutputViewSize);
+		PassParameters->RWOperatorStage = GraphBuilder.CreateUAV(OperatorStageTexture);
+
+		TShaderMapRef<FTonemapOverrideLUTOperatorStageCS> ComputeShader(GlobalShaderMap, PermutationVector);
+		CheckLUTPipelinePrecached(ELUTPipeline::OperatorStage, PermutationVector);
+
+		FComputeShaderUtils::AddPass(
+			GraphBuilder,
+			RDG_EVENT_NAME("Tonemap Create LUT Operator Stage %d%s", TextureLUTSize, bAsyncCompute ? TEXT(" (Async)") : TEXT("")),
+			PassFlags,
+			ComputeShader,
+			PassParameters,
+			GroupCount);
+	}
+
+	const FTonemapOverrideShaderCommon::FPermutationDomain OutputStageVector = FTonemapOverrideLUTOutputStageCS::GetOutputStagePermutation(PermutationVector);
+
+	FTonemapOverrideLUTOutputStageCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTOutputStageCS::FParameters>();
+	PassParameters->TonemapLUTParameters = *GetCachedLUTShaderParameters(Snapshot);
+	PassParameters->OperatorStage = OperatorStageTexture;
+	PassParameters->RWOutputTexture = GraphBuilder.CreateUAV(OutputTexture);
+
+	TShaderMapRef<FTonemapOverrideLUTOutputStageCS> ComputeShader(GlobalShaderMap, OutputStageVector);
+	CheckLUTPipelinePrecached(ELUTPipeline::OutputStage, OutputStageVector);
+
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("Tonemap Create LUT Output Stage %d%s", TextureLUTSize, bAsyncCompute ? TEXT(" (Async)") : TEXT("")),
+		PassFlags,
+		ComputeShader,
+		PassParameters,
+		GroupCount);
+}
+
+void TonemapOverride::AddBatchedLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, TConstArrayView<FTonemapOverrideLUTBatchItem> Items, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize, const bool bAsyncCompute)
+{
+	check(Items.Num() > 0 && Items.Num() <= MaxBatchedLUTs);
+
+	RDG_EVENT_SCOPE(GraphBuilder, "TonemapOverride LUT");
+	RDG_GPU_STAT_SCOPE(GraphBuilder, TonemapOverrideLUT);
+
+	// Everything but the per variant parameters is the same for the batch, so the first LUT provides it
+	const FTonemapOverrideLUTSnapshot& SharedSnapshot = *Items[0].Snapshot;
+	const FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector = GetLUTPermutation(SharedSnapshot);
+
+	FTonemapOverrideBatchedLUTShaderCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideBatchedLUTShaderCS::FParameters>();
+	PassParameters->TonemapLUTParameters = *GetCachedLUTShaderParameters(SharedSnapshot);
+
+	TArray<FTonemapOverrideLUTVariantParameters, TInlineAllocator<MaxBatchedLUTs>> Variants;
+	TArray<FVector4f> SeparableCurves;
+	const bool bSeparableCurve = PermutationVector.Get<FTonemapOverrideShaderCommon::FSeparableCurve>();
+
+	for (const FTonemapOverrideLUTBatchItem& Item : Items)
+	{
+		checkSlow(GetLUTBatchKey(*Item.Snapshot) == GetLUTBatchKey(SharedSnapshot));
+
+		GetLUTVariantParameters(*GetCachedLUTShaderParameters(*Item.Snapshot), Variants.AddDefaulted_GetRef());
+
+		if (bSeparableCurve)
+		{
+			SeparableCurves.Append(*GetSeparableCurve(*Item.Snapshot));
+		}
+	}
+
+	FRDGBufferRef VariantBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("TonemapOverride.LUTVariants"), sizeof(FTonemapOverrideLUTVariantParameters), Variants.Num(), Variants.GetData(), Variants.Num() * sizeof(FTonemapOverrideLUTVariantParameters));
+	PassParameters->LUTVariants = GraphBuilder.CreateSRV(VariantBuffer);
+
+	if (bSeparableCurve)
+	{
+		PassParameters->TonemapLUTParameters.CustomTonemapperParameters.SeparableCurve = GraphBuilder.CreateSRV(CreateSeparableCurveBuffer(GraphBuilder, SeparableCurves), PF_A32B32G32R32F);
+	}
+
+	const FIntPoint OutputViewSize(bUseVolumeTextureLUT ? TextureLUTSize : TextureLUTSize * TextureLUTSize, TextureLUTSize);
+	PassParameters->OutputExtentInverse = FVector2f(1.0f, 1.0f) / FVector2f(OutputViewSize);
+
+	// Outputs without a variant are never written, they are bound to the first LUT
+	FRDGTextureUAVRef OutputUAVs[MaxBatchedLUTs];
+	for (int32 Index = 0; Index < MaxBatchedLUTs; ++Index)
+	{
+		OutputUAVs[Index] = Index < Items.Num() ? GraphBuilder.CreateUAV(Items[Index].OutputTexture) : OutputUAVs[0];
+	}
+	PassParameters->RWOutputTexture0 = OutputUAVs[0];
+	PassParameters->RWOutputTexture1 = OutputUAVs[1];
+	PassParameters->RWOutputTexture2 = OutputUAVs[2];
+	PassParameters->RWOutputTexture3 = OutputUAVs[3];
+
+	// Variants are stacked along z, the volume LUT rounds each variant up to whole thread groups
+	const uint32 GroupSizeX = FMath::DivideAndRoundUp(OutputViewSize.X, FTonemapOverrideBatchedLUTShaderCS::GroupSize);
+	const uint32 GroupSizeY = FMath::DivideAndRoundUp(TextureLUTSize, FTonemapOverrideBatchedLUTShaderCS::GroupSize);
+	const uint32 VariantGroupsZ = bUseVolumeTextureLUT ? FMath::DivideAndRoundUp(TextureLUTSize, FTonemapOverrideBatchedLUTShaderCS::GroupSize) : 1;
+	PassParameters->LUTVariantSlices = bUseVolumeTextureLUT ? VariantGroupsZ * FTonemapOverrideBatchedLUTShaderCS::GroupSize : 1;
+
+	TShaderMapRef<FTonemapOverrideBatchedLUTShaderCS> ComputeShader(GlobalShaderMap, PermutationVector);
+	CheckLUTPipelinePrecached(ELUTPipeline::BatchedCompute, PermutationVector);
+
+	const ERDGPassFlags PassFlags = bAsyncCompute ? ERDGPassFlags::AsyncCompute | ERDGPassFlags::NeverCull : ERDGPassFlags::Compute;
+
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("Tonemap Create LUT CS Shader %d Batched x%d%s", TextureLUTSize, Items.Num(), bAsyncCompute ? TEXT(" (Async)") : TEXT("")),
+		PassFlags,
+		ComputeShader,
+		PassParameters,
+		FIntVector(GroupSizeX, GroupSizeY, VariantGroupsZ * Items.Num()));
+}
+
+void TonemapOverride::AddUploadLUTPass(FRDGBuilder& GraphBuilder, FRDGTextureRef OutputTexture, TConstArrayView<uint8> Data, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize)
+{
+	const uint32 BytesPerTexel = GPixelFormats[OutputTexture->Desc.Format].BlockBytes;
+	check(Data.Num() == int64(BytesPerTexel) * TextureLUTSize * TextureLUTSize * TextureLUTSize);
+
+	RDG_GPU_STAT_SCOPE(GraphBuilder, TonemapOverrideLUT);
+
+	FTonemapOverrideUploadLUTParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideUploadLUTParameters>();
+	PassParameters->Texture = OutputTexture;
+
+	GraphBuilder.AddPass(
+		RDG_EVENT_NAME("Tonemap Upload Baked LUT %d", TextureLUTSize),
+		PassParameters,
+		ERDGPassFlags::Copy | ERDGPassFlags::NeverCull,
+		[OutputTexture, Data, bUseVolumeTextureLUT, TextureLUTSize, BytesPerTexel](FRHICommandListImmediate& RHICmdList)
+		{
+			const uint32 RowPitch = TextureLUTSize * BytesPerTexel;
+			const uint32 SlicePitch = RowPitch * TextureLUTSize;
+
+			if (bUseVolumeTextureLUT)
+			{
+				// Canonical layout is the volume layout
+				const FUpdateTextureRegion3D Region(0, 0, 0, 0, 0, 0, TextureLUTSize, TextureLUTSize, TextureLUTSize);
+				RHICmdList.UpdateTexture3D(OutputTexture->GetRHI(), 0, Region, RowPitch, SlicePitch, Data.GetData());
+			}
+			else
+			{
+				// Every blue slice is a contiguous Size x Size block, placed side by side in the unwrapped LUT
+				for (int32 Slice = 0; Slice < TextureLUTSize; ++Slice)
+				{
+					const FUpdateTextureRegion2D Region(Slice * TextureLUTSize, 0, 0, 0, TextureLUTSize, TextureLUTSize);
+					RHICmdList.UpdateTexture2D(OutputTexture->GetRHI(), 0, Region, RowPitch, Data.GetData() + Slice * SlicePitch);
+				}
+			}
+		});
+}
+
+bool TonemapOverride::EncodeLUTTexels(TConstArrayView<FLinearColor> Texels, const EPixelFormat Format, TArray<uint8>& OutData)
+{
+	if (Format == PF_A2B10G10R10)
+	{
+		// Unorm with round to nearest like the GPU conversion, alpha is written as 0 by the LUT pass
+		OutData.SetNumUninitialized(Texels.Num() * sizeof(uint32));
+		uint32* Packed = reinterpret_cast<uint32*>(OutData.GetData());
+
+		for (int32 Index = 0; Index < Texels.Num(); ++Index)
+		{
+			const FLinearColor& Texel = Texels[Index];
+			const uint32 R = uint32(FMath::RoundToInt(FMath::Clamp(Texel.R, 0.0f, 1.0f) * 1023.0f));
+			const uint32 G = uint32(FMath::RoundToInt(FMath::Clamp(Texel.G, 0.0f, 1.0f) * 1023.0f));
+			const uint32 B = uint32(FMath::RoundToInt(FMath::Clamp(Texel.B, 0.0f, 1.0f) * 1023.0f));
+			Packed[Index] = R | (G << 10) | (B << 20);
+		}
+		return true;
+	}
+
+	if (Format == PF_FloatRGBA)
+	{
+		OutData.SetNumUninitialized(Texels.Num() * sizeof(FFloat16Color));
+		FFloat16Color* Half = reinterpret_cast<FFloat16Color*>(OutData.GetData());
+
+		for (int32 Index = 0; Index < Texels.Num(); ++Index)
+		{
+			Half[Index] = FFloat16Color(FLinearColor(Texels[Index].R, Texels[Index].G, Texels[Index].B, 0.0f));
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void TonemapOverride::UnwrappedToCanonicalLUT(const uint8* Source, int32 SourceRowPitchInBytes, int32 TextureLUTSize, int32 BytesPerTexel, uint8* OutCanonical)
+{
+	const int32 RowBytes = TextureLUTSize * BytesPerTexel;
+
+	for (int32 Green = 0; Green < TextureLUTSize; ++Green)
+	{
+		const uint8* SourceRow = Source + Green * SourceRowPitchInBytes;
+
+		for (int32 Blue = 0; Blue < TextureLUTSize; ++Blue)
+		{
+			FMemory::Memcpy(OutCanonical + (Blue * TextureLUTSize + Green) * RowBytes, SourceRow + Blue * RowBytes, RowBytes);
+		}
+	}
+}
+
+static void PrecacheLUTPipelines_RenderThread(EShaderPlatform Platform)
+{
+	if (!IsLUTPipelinePrecachingEnabled())
+	{
+		return;
+	}
+
+	using FPermutationDomain = FTonemapOverrideShaderCommon::FPermutationDomain;
+	using FTonemapOperator = FTonemapOverrideShaderCommon::FTonemapOperator;
+
+	FGlobalShaderMap* GlobalShaderMap = GetGlobalShaderMap(Platform);
+
+	// Same choice of pass and layout as the engine makes for the view
+	static const auto CVarPreferCompute = IConsoleManager::Get().FindConsoleVariable(TEXT("r.PostProcessing.PreferCompute"));
+	const bool bComputeSupported = FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Platform);
+	const bool bUseComputePass = bComputeSupported && (!CVarPreferCompute || CVarPreferCompute->GetInt() != 0);
+	const bool bUseVolumeTextureLUT = TonemapOverride::IsVolumeTextureLUTSupported(Platform);
+
+	// LDR and HDR LUT formats of the engine
+	const EPixelFormat Formats[] = { PF_A2B10G10R10, PF_FloatRGBA };
+
+	const FTonemapOverrideCompiledPermutations& CompiledPermutations = TonemapOverride::GetRenderSettings().CompiledPermutations;
+	int32 NumRequested = 0;
+
+	for (int32 PermutationId = 0; PermutationId < FPermutationDomain::PermutationCount; ++PermutationId)
+	{
+		const FPermutationDomain PermutationVector(PermutationId);
+		if (!FTonemapOverrideShaderCommon::ShouldCompileCommonPermutation(PermutationVector, CompiledPermutations))
+		{
+			continue;
+		}
+
+		// Compute pipelines are also used by the time sliced and async passes and the bake tools
+		if (bComputeSupported && GlobalShaderMap->HasShader(&FTonemapOverrideLUTShaderCS::GetStaticType(), PermutationId))
+		{
+			bool bAlreadyPrecached = false;
+			GPrecachedLUTPipelines.Add(GetLUTPipelineKey(ELUTPipeline::Compute, PermutationId), &bAlreadyPrecached);
+
+			if (!bAlreadyPrecached)
+			{
+				TShaderMapRef<FTonemapOverrideLUTShaderCS> ComputeShader(GlobalShaderMap, PermutationVector);
+				PipelineStateCache::PrecacheComputePipelineState(ComputeShader.GetComputeShader());
+				NumRequested++;
+			}
+		}
+
+		if (bComputeSupported && GlobalShaderMap->HasShader(&FTonemapOverrideBatchedLUTShaderCS::GetStaticType(), PermutationId))
+		{
+			bool bAlreadyPrecached = false;
+			GPrecachedLUTPipelines.Add(GetLUTPipelineKey(ELUTPipeline::BatchedCompute, PermutationId), &bAlreadyPrecached);
+
+			if (!bAlreadyPrecached)
+			{
+				TShaderMapRef<FTonemapOverrideBatchedLUTShaderCS> ComputeShader(GlobalShaderMap, PermutationVector);
+				PipelineStateCache::PrecacheComputePipelineState(ComputeShader.GetComputeShader());
+				NumRequested++;
+			}
+		}
+
+		if (bComputeSupported && GlobalShaderMap->HasShader(&FTonemapOverrideLUTOperatorStageCS::GetStaticType(), PermutationId))
+		{
+			bool bAlreadyPrecached = false;
+			GPrecachedLUTPipelines.Add(GetLUTPipelineKey(ELUTPipeline::OperatorStage, PermutationId), &bAlreadyPrecached);
+
+			if (!bAlreadyPrecached)
+			{
+				TShaderMapRef<FTonemapOverrideLUTOperatorStageCS> ComputeShader(GlobalShaderMap, PermutationVector);
+				PipelineStateCache::PrecacheComputePipelineState(ComputeShader.GetComputeShader());
+				NumRequested++;
+			}
+		}
+
+		if (bComputeSupported && GlobalShaderMap->HasShader(&FTonemapOverrideLUTOutputStageCS::GetStaticType(), PermutationId))
+		{
+			bool bAlreadyPrecached = false;
+			GPrecachedLUTPipelines.Add(GetLUTPipelineKey(ELUTPipeline::OutputStage, PermutationId), &bAlreadyPrecached);
+
+			if (!bAlreadyPrecached)
+			{
+				TShaderMapRef<FTonemapOverrideLUTOutputStageCS> ComputeShader(GlobalShaderMap, PermutationVector);
+				PipelineStateCache::PrecacheComputePipelineState(ComputeShader.GetComputeShader());
+				NumRequested++;
+			}
+		}
+
+		if (bUseComputePass || !GlobalShaderMap->HasShader(&FTonemapOverrideLUTShaderPS::GetStaticType(), PermutationId))
+		{
+			continue;
+		}
+
+		TShaderMapRef<FTonemapOverrideLUTShaderPS> PixelShader(GlobalShaderMap, PermutationVector);
+
+		for (const EPixelFormat Format : Formats)
+		{
+			bool bAlreadyPrecached = false;
+			GPrecachedLUTPipelines.Add(GetLUTPipelineKey(ELUTPipeline::Graphics, PermutationId, bUseVolumeTextureLUT, Format), &bAlreadyPrecached);
+
+			if (bAlreadyPrecached)
+			{
+				continue;
+			}
+
+			FGraphicsPipelineStateInitializer GraphicsPSOInit;
+			SetupLUTGraphicsPipeline(GraphicsPSOInit, GlobalShaderMap, PixelShader, bUseVolumeTextureLUT);
+
+			GraphicsPSOInit.RenderTargetsEnabled = 1;
+			GraphicsPSOInit.RenderTargetFormats[0] = Format;
+			GraphicsPSOInit.RenderTargetFlags[0] = TonemapOverride::GetLUTTextureDesc(32, bUseVolumeTextureLUT, false, Format).Flags;
+			GraphicsPSOInit.NumSamples = 1;
+			GraphicsPSOInit.StatePrecachePSOHash = RHIComputeStatePrecachePSOHash(GraphicsPSOInit);
+
+			PipelineStateCache::PrecacheGraphicsPipelineState(GraphicsPSOInit);
+			NumRequested++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_TonemapOverridePrecachedPipelines, GPrecachedLUTPipelines.Num());
+	UE_CLOG(NumRequested > 0, TonemapOverrideLog, Log, TEXT("Precaching %d LUT pipelines for %s (%s pass)"), NumRequested, *LegacyShaderPlatformToShaderFormat(Platform).ToString(), bUseComputePass ? TEXT("compute") : TEXT("pixel shader"));
+}
+
+void TonemapOverride::PrecacheLUTPipelines()
+{
+	check(IsInGameThread());
+
+	if (!FApp::CanEverRender())
+	{
+		return;
+	}
+
+	ENQUEUE_RENDER_COMMAND(TonemapOverridePrecacheLUTPipelines)(
+		[Platform = GMaxRHIShaderPlatform](FRHICommandListImmediate& RHICmdList)
+		{
+			PrecacheLUTPipelines_RenderThread(Platform);
+		});
+}
+
+int32 TonemapOverride::GetNumOnDemandLUTPipelines()
+{
+	check(IsInRenderingThread());
+	return IsLUTPipelinePrecachingEnabled() ? GOnDemandLUTPipelines.Num() : -1;
+}
+
+void TonemapOverride::LogShaderReport()
+{
+	using FPermutationDomain = FTonemapOverrideShaderCommon::FPermutationDomain;
+	using FTonemapOperator = FTonemapOverrideShaderCommon::FTonemapOperator;
+
+	// Platforms that compiled shaders this session (cook targets), otherwise the running platform
+	TArray<EShaderPlatform> Platforms;
+	TArray<FString> CompileStatLines;
+
+#if WITH_EDITOR
+	if (GShaderCompilerStats)
+	{
+		const TSparseArray<FShaderCompilerStats::ShaderCompilerStats>& PlatformStats = GShaderCompilerStats->GetShaderCompilerStats();
+		for (auto It = PlatformStats.CreateConstIterator(); It; ++It)
+		{
+			for (const TPair<FString, FShaderCompilerStats::FShaderStats>& Pair : *It)
+			{
+				if (Pair.Key.Contains(TEXT("TonemapOverride")) || Pair.Key.Contains(TEXT("CustomTonemapLUT")))
+				{
+					Platforms.AddUnique(EShaderPlatform(It.GetIndex()));
+					CompileStatLines.Add(FString::Printf(TEXT("%s %s: compiled %u, cooked %u, compile time %.2f s"),
+						*LegacyShaderPlatformToShaderFormat(EShaderPlatform(It.GetIndex())).ToString(), *Pair.Key, Pair.Value.Compiled, Pair.Value.Cooked, Pair.Value.CompileTime));
+				}
+			}
+		}
+	}
+#endif
+
+	if (Platforms.IsEmpty())
+	{
+		Platforms.Add(GMaxRHIShaderPlatform);
+	}
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("TonemapOverride shader report, %d permutations per shader before pruning"), FPermutationDomain::PermutationCount);
+
+	const FTonemapOverrideCompiledPermutations CompiledPermutations = TonemapOverride::GetCompiledPermutations();
+
+	for (const EShaderPlatform Platform : Platforms)
+	{
+		int32 NumPermutations[uint32(ECustomTonemapOperator::MAX)] = {};
+		int32 NumTotal = 0;
+		int32 NumBatched = 0;
+
+		for (int32 PermutationId = 0; PermutationId < FPermutationDomain::PermutationCount; ++PermutationId)
+		{
+			const FPermutationDomain PermutationVector(PermutationId);
+			if (FTonemapOverrideShaderCommon::ShouldCompileCommonPermutation(PermutationVector, CompiledPermutations))
+			{
+				NumPermutations[uint32(PermutationVector.Get<FTonemapOperator>())]++;
+				NumTotal++;
+				NumBatched += CompiledPermutations.IsBatchedLUTPassCompiled(PermutationVector.Get<FTonemapOperator>()) ? 1 : 0;
+			}
+		}
+
+		// Pixel and compute shaders share the permutations, compute shaders need SM5
+		const int32 NumShaders = FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Platform) ? 2 : 1;
+
+		UE_LOG(TonemapOverrideLog, Display, TEXT("%s: %d permutations x %d shader types"), *LegacyShaderPlatformToShaderFormat(Platform).ToString(), NumTotal, NumShaders);
+
+		if (NumBatched > 0 && FTonemapOverrideLUTShaderCS::ShouldCompilePlatform(Platform))
+		{
+			UE_LOG(TonemapOverrideLog, Display, TEXT("  batched LUT pass: %d permutations"), NumBatched);
+		}
+
+		for (uint32 Operator = 0; Operator < uint32(ECustomTonemapOperator::MAX); ++Operator)
+		{
+			UE_LOG(TonemapOverrideLog, Display, TEXT("  %-16s %d"), *UEnum::GetDisplayValueAsText(ECustomTonemapOperator(Operator)).ToString(), NumPermutations[Operator]);
+		}
+	}
+
+	for (const FString& Line : CompileStatLines)
+	{
+		UE_LOG(TonemapOverrideLog, Display, TEXT("%s"), *Line);
+	}
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideShaderReport(
+	TEXT("r.TonemapOverride.ShaderReport"),
+	TEXT("Log the LUT shader permutations compiled per platform and operator, and the compile stats of this session in editor builds."),
+	FConsoleCommandDelegate::CreateStatic(&TonemapOverride::LogShaderReport));
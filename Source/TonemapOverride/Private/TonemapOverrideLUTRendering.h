@@ -0,0 +1,88 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphBuilder.h"
+#include "RHIDefinitions.h"
+
+struct FTonemapOverrideLUTSnapshot;
+struct FTonemapOverrideCompiledPermutations;
+enum class ECustomTonemapOperator : uint8;
+class FGlobalShaderMap;
+
+// One LUT of a batched LUT pass
+struct FTonemapOverrideLUTBatchItem
+{
+	const FTonemapOverrideLUTSnapshot* Snapshot = nullptr;
+	FRDGTextureRef OutputTexture = nullptr;
+};
+
+// LUT generation passes shared by the scene view extension and the offline tools (bake commandlet)
+// Baked and read back LUT data uses a canonical layout independent of the platform LUT layout:
+// texel (R, G, B) is found at index R + G * Size + B * Size * Size, which matches the volume texture layout
+
+namespace TonemapOverride
+{
+	// Read the permutations the plugin settings compile from the config, game thread at module startup
+	void CaptureCompiledPermutations();
+
+	// Permutations captured at module startup, any thread
+	FTonemapOverrideCompiledPermutations GetCompiledPermutations();
+
+	// Most LUTs generated by one batched pass, split-screen views
+	constexpr int32 MaxBatchedLUTs = 4;
+
+	// LUTs with the same key can be generated by one batched pass, 0 when the LUT needs a pass of its own
+	uint64 GetLUTBatchKey(const FTonemapOverrideLUTSnapshot& Snapshot);
+
+	// Log the compiled permutations per platform and operator, and the shader compile stats when available
+	void LogShaderReport();
+
+	// Request the pipelines of all compiled LUT permutations from the PSO precaching, so that switching the operator,
+	// the GT7 UCS or the output device doesn't create a pipeline on first use. Game thread, already requested pipelines are skipped
+	void PrecacheLUTPipelines();
+
+	// LUT pipelines used this session without having been precached, -1 while the precaching is off. Render thread
+	int32 GetNumOnDemandLUTPipelines();
+
+	// Release the separable curves and shader parameters expanded for the LUT passes, render thread
+	// Called by the LUT cache when it evicts LUTs, the next pass expands its snapshot again
+	void ReleaseLUTShaderCaches();
+
+	// Volume texture LUTs are used when the platform can render to them, otherwise the LUT is unwrapped to 2D
+	bool IsVolumeTextureLUTSupported(EShaderPlatform Platform);
+
+	// Description matching the LUT the engine would create for the tonemap pass
+	FRDGTextureDesc GetLUTTextureDesc(int32 LUTSize, bool bUseVolumeTextureLUT, bool bUseComputePass, EPixelFormat Format);
+
+	// Add the CS or PS pass generating the LUT for the snapshot into OutputTexture
+	// With bAsyncCompute the CS pass runs on the async compute queue, readers of the texture in the same graph wait for it
+	// NumSlices > 0 limits the CS pass to the blue slices [FirstSlice, FirstSlice + NumSlices), the PS pass always writes the whole LUT
+	void AddLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, FRDGTextureRef OutputTexture, const FTonemapOverrideLUTSnapshot& Snapshot, bool bUseComputePass, bool bUseVolumeTextureLUT, int32 TextureLUTSize, bool bAsyncCompute = false, int32 FirstSlice = 0, int32 NumSlices = 0);
+
+	// Staged generation is available for the compute pass of the custom operators
+	bool IsStagedLUTPassSupported(const FTonemapOverrideLUTSnapshot& Snapshot, bool bUseComputePass);
+
+	// Intermediate of the staged LUT, the operator stage result in the layout of the LUT
+	FRDGTextureDesc GetOperatorStageTextureDesc(int32 TextureLUTSize, bool bUseVolumeTextureLUT);
+
+	// Generate the LUT in two CS passes: the operator stage (grading and the operator) into OperatorStageTexture, only with bRenderOperatorStage,
+	// and the output stage (ColorScale, OverlayColor, gamma and the output device) from it into OutputTexture
+	// Keeping OperatorStageTexture while GetOperatorStageHash stays the same makes fades cost only the output stage
+	void AddStagedLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, FRDGTextureRef OutputTexture, FRDGTextureRef OperatorStageTexture, const FTonemapOverrideLUTSnapshot& Snapshot, bool bRenderOperatorStage, bool bUseVolumeTextureLUT, int32 TextureLUTSize, bool bAsyncCompute = false);
+
+	// Add one CS pass generating up to MaxBatchedLUTs LUTs with the same batch key, size and layout
+	// The grading of each LUT is read from a structured buffer, the outputs are written directly without an atlas
+	void AddBatchedLUTPass(FRDGBuilder& GraphBuilder, FGlobalShaderMap* GlobalShaderMap, TConstArrayView<FTonemapOverrideLUTBatchItem> Items, bool bUseVolumeTextureLUT, int32 TextureLUTSize, bool bAsyncCompute = false);
+
+	// Upload LUT data in canonical layout into OutputTexture. Data needs to stay alive until the graph is executed
+	void AddUploadLUTPass(FRDGBuilder& GraphBuilder, FRDGTextureRef OutputTexture, TConstArrayView<uint8> Data, bool bUseVolumeTextureLUT, int32 TextureLUTSize);
+
+	// Encode LUT texels in canonical layout into the texel data of the LUT format, for the formats the engine uses for its LUT
+	// (PF_A2B10G10R10 and PF_FloatRGBA). Returns false for other formats
+	bool EncodeLUTTexels(TConstArrayView<FLinearColor> Texels, EPixelFormat Format, TArray<uint8>& OutData);
+
+	// Reorder texels of an unwrapped 2D LUT (Size * Size x Size) into the canonical layout
+	void UnwrappedToCanonicalLUT(const uint8* Source, int32 SourceRowPitchInBytes, int32 TextureLUTSize, int32 BytesPerTexel, uint8* OutCanonical);
+}
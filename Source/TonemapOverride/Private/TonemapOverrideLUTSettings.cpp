@@ -0,0 +1,986 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideFastMath.h"
+#include "SceneRendering.h"
+#include "ScenePrivate.h"
+#include "Hash/CityHash.h"
+#include "Engine/Texture.h"
+#include "TextureResource.h"
+#include "TonemapOverride.h"
+#include <atomic>
+
+static TAutoConsoleVariable<float> CVarTonemapOverrideQuantizeGrading(
+	TEXT("r.TonemapOverride.Quantize.Grading"),
+	0.0005f,
+	TEXT("Quantization step for color grading and operator parameters. Changes smaller than this do not regenerate the LUT. 0 disables."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarTonemapOverrideQuantizeTemperature(
+	TEXT("r.TonemapOverride.Quantize.Temperature"),
+	1.0f,
+	TEXT("Quantization step for white balance temperature in Kelvin. 0 disables."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarTonemapOverrideQuantizeFade(
+	TEXT("r.TonemapOverride.Quantize.Fade"),
+	1.0f / 1024.0f,
+	TEXT("Quantization step for view ColorScale and OverlayColor (fades). 0 disables."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarTonemapOverrideQuantizeHysteresis(
+	TEXT("r.TonemapOverride.Quantize.Hysteresis"),
+	0.25f,
+	TEXT("Fraction of the quantization step a value has to move past the edge of the bucket of the LUT the view shows before the LUT is regenerated. Keeps values oscillating around a bucket edge from regenerating every frame. 0 disables."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideFastMath(
+	TEXT("r.TonemapOverride.FastMath"),
+	0,
+	TEXT("Use the fast math variant of the operator when it is compiled and its measured CIEDE2000 error is within Fast Math Max Delta E of the plugin settings."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideSeparableCurve(
+	TEXT("r.TonemapOverride.SeparableCurve"),
+	1,
+	TEXT("Bake the per channel curve of AgX, Flim, Hejl, Uchimura and GT7 into a 1D curve once per settings change and sample it in the LUT pass instead of evaluating the curve for every texel."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideTetrahedralLUT(
+	TEXT("r.TonemapOverride.TetrahedralLUT"),
+	0,
+	TEXT("Read the Tony McMapface and Custom LUT textures with tetrahedral instead of trilinear interpolation. Four texel loads instead of one filtered sample, with less hue error between the lattice points."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideOperator(
+	TEXT("r.TonemapOverride.Operator"),
+	-1,
+	TEXT("Tonemap operator used instead of the one in the plugin settings, as the index of ECustomTonemapOperator (0 AgX, 1 AgX Punchy, 2 Reinhard, 3 Tony McMapface, 4 Flim, 5 Hejl, 6 GranTurismo, 7 GT7, 8 ACES, 9 Custom LUT). -1 uses the plugin settings."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<FString> CVarTonemapOverrideQuantizeOverrides(
+	TEXT("r.TonemapOverride.Quantize.Overrides"),
+	TEXT(""),
+	TEXT("Per parameter quantization steps overriding the group defaults, ie. \"WhiteTemp=10,ColorGain=0.002\""),
+	ECVF_RenderThreadSafe);
+
+namespace
+{
+	// Bumped by the console variable sink, so the CVar derived values are only rebuilt when something has changed
+	std::atomic<uint32> GTonemapOverrideCVarEpoch(1);
+
+	void OnTonemapOverrideCVarsChanged()
+	{
+		GTonemapOverrideCVarEpoch.fetch_add(1, std::memory_order_relaxed);
+
+		// Console variables captured by the render settings, settings object is not available during early startup
+		if (UObjectInitialized())
+		{
+			TonemapOverride::UpdateRenderSettings();
+		}
+	}
+
+	FAutoConsoleVariableSink GTonemapOverrideCVarSink(FConsoleCommandDelegate::CreateStatic(&OnTonemapOverrideCVarsChanged));
+
+	struct FCVarDerivedValues
+	{
+		uint32 Epoch = 0;
+		FACESTonemapParams ACESParams;
+		FVector3f MappingPolynomial = FVector3f::ZeroVector;
+		float QuantizationSteps[int32(ELUTSnapshotField::Num)] = {};
+		float QuantizationHysteresis = 0.0f;
+	};
+
+	// Render thread and game thread copies, other threads derive the values per call
+	FCVarDerivedValues GRenderThreadCVarValues;
+	FCVarDerivedValues GGameThreadCVarValues;
+
+	// Engine ACES parameters read the render thread values of its console variables, other threads use the last render thread result
+	FCriticalSection GACESParamsLock;
+	FACESTonemapParams GRenderThreadACESParams;
+
+	const ELUTSnapshotQuantization GFieldQuantization[] =
+	{
+#define TONEMAPOVERRIDE_SNAPSHOT_QUANTIZATION(Type, Name, Quantization) ELUTSnapshotQuantization::Quantization,
+		TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_QUANTIZATION)
+#undef TONEMAPOVERRIDE_SNAPSHOT_QUANTIZATION
+	};
+
+	const TCHAR* GFieldNames[] =
+	{
+#define TONEMAPOVERRIDE_SNAPSHOT_NAME(Type, Name, Quantization) TEXT(#Name),
+		TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_NAME)
+#undef TONEMAPOVERRIDE_SNAPSHOT_NAME
+	};
+
+	FVector3f GetMappingPolynomial()
+	{
+		static const auto CVarMinValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Min"));
+		static const auto CVarMidValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Mid"));
+		static const auto CVarMaxValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Max"));
+
+		float MinValue = FMath::Clamp(CVarMinValue->GetFloat() , -10.0f, 10.0f);
+		float MidValue = FMath::Clamp(CVarMidValue->GetFloat(), -10.0f, 10.0f);
+		float MaxValue = FMath::Clamp(CVarMaxValue->GetFloat(), -10.0f, 10.0f);
+
+		float c = MinValue;
+		float b = 4 * MidValue - 3 * MinValue - MaxValue;
+		float a = MaxValue - MinValue - b;
+
+		return FVector3f(a, b, c);
+	}
+
+	void UpdateQuantizationSteps(float* OutSteps)
+	{
+		const float GroupSteps[] =
+		{
+			0.0f,
+			CVarTonemapOverrideQuantizeGrading.GetValueOnAnyThread(),
+			CVarTonemapOverrideQuantizeTemperature.GetValueOnAnyThread(),
+			CVarTonemapOverrideQuantizeFade.GetValueOnAnyThread()
+		};
+
+		for (int32 FieldIndex = 0; FieldIndex < int32(ELUTSnapshotField::Num); ++FieldIndex)
+		{
+			OutSteps[FieldIndex] = FMath::Max(GroupSteps[int32(GFieldQuantization[FieldIndex])], 0.0f);
+		}
+
+		TArray<FString> Overrides;
+		CVarTonemapOverrideQuantizeOverrides.GetValueOnAnyThread().ParseIntoArray(Overrides, TEXT(","));
+
+		for (const FString& Override : Overrides)
+		{
+			FString Name, Value;
+			if (!Override.Split(TEXT("="), &Name, &Value))
+			{
+				continue;
+			}
+
+			Name.TrimStartAndEndInline();
+			bool bFound = false;
+
+			for (int32 FieldIndex = 0; FieldIndex < int32(ELUTSnapshotField::Num); ++FieldIndex)
+			{
+				// Discrete values can't be quantized
+				if (Name.Equals(GFieldNames[FieldIndex]) && GFieldQuantization[FieldIndex] != ELUTSnapshotQuantization::None)
+				{
+					OutSteps[FieldIndex] = FMath::Max(FCString::Atof(*Value), 0.0f);
+					bFound = true;
+				}
+			}
+
+			if (!bFound)
+			{
+				UE_LOG(TonemapOverrideLog, Warning, TEXT("Unknown quantization override %s"), *Name);
+			}
+		}
+	}
+
+	void UpdateCVarDerivedValues(uint32 Epoch, FCVarDerivedValues& OutValues)
+	{
+		OutValues.Epoch = Epoch;
+
+		if (IsInRenderingThread())
+		{
+			GetACESTonemapParameters(OutValues.ACESParams);
+
+			FScopeLock Lock(&GACESParamsLock);
+			GRenderThreadACESParams = OutValues.ACESParams;
+		}
+		else
+		{
+			FScopeLock Lock(&GACESParamsLock);
+			OutValues.ACESParams = GRenderThreadACESParams;
+		}
+
+		OutValues.MappingPolynomial = GetMappingPolynomial();
+		UpdateQuantizationSteps(OutValues.QuantizationSteps);
+		OutValues.QuantizationHysteresis = FMath::Max(CVarTonemapOverrideQuantizeHysteresis.GetValueOnAnyThread(), 0.0f);
+	}
+
+	// Values of the calling thread, LocalValues holds them on threads without a copy
+	const FCVarDerivedValues& GetCVarDerivedValues(FCVarDerivedValues& LocalValues)
+	{
+		const uint32 Epoch = GTonemapOverrideCVarEpoch.load(std::memory_order_relaxed);
+
+		FCVarDerivedValues& Values = IsInRenderingThread() ? GRenderThreadCVarValues : IsInGameThread() ? GGameThreadCVarValues : LocalValues;
+		if (Values.Epoch != Epoch)
+		{
+			UpdateCVarDerivedValues(Epoch, Values);
+		}
+
+		return Values;
+	}
+
+	// Values still within the bucket of the previous snapshot, widened by the hysteresis band, keep the previous value
+	void Quantize(float& Value, float Step, float Hysteresis, const float* Previous)
+	{
+		if (Step <= 0.0f)
+		{
+			return;
+		}
+
+		if (Previous && FMath::Abs(Value - *Previous) <= Step * (0.5f + Hysteresis))
+		{
+			Value = *Previous;
+			return;
+		}
+
+		Value = FMath::RoundToFloat(Value / Step) * Step;
+	}
+
+	void Quantize(FVector3f& Value, float Step, float Hysteresis, const FVector3f* Previous)
+	{
+		Quantize(Value.X, Step, Hysteresis, Previous ? &Previous->X : nullptr);
+		Quantize(Value.Y, Step, Hysteresis, Previous ? &Previous->Y : nullptr);
+		Quantize(Value.Z, Step, Hysteresis, Previous ? &Previous->Z : nullptr);
+	}
+
+	void Quantize(FVector4f& Value, float Step, float Hysteresis, const FVector4f* Previous)
+	{
+		Quantize(Value.X, Step, Hysteresis, Previous ? &Previous->X : nullptr);
+		Quantize(Value.Y, Step, Hysteresis, Previous ? &Previous->Y : nullptr);
+		Quantize(Value.Z, Step, Hysteresis, Previous ? &Previous->Z : nullptr);
+		Quantize(Value.W, Step, Hysteresis, Previous ? &Previous->W : nullptr);
+	}
+
+	template<typename T>
+	void Quantize(T& Value, float Step, float Hysteresis, const T* Previous)
+	{
+	}
+
+	FString FieldValueToString(float Value) { return FString::Printf(TEXT("%g"), Value); }
+	FString FieldValueToString(uint32 Value) { return FString::Printf(TEXT("%u"), Value); }
+	FString FieldValueToString(const FVector3f& Value) { return FString::Printf(TEXT("(%g, %g, %g)"), Value.X, Value.Y, Value.Z); }
+	FString FieldValueToString(const FVector4f& Value) { return FString::Printf(TEXT("(%g, %g, %g, %g)"), Value.X, Value.Y, Value.Z, Value.W); }
+	FString FieldValueToString(const FMatrix44f& Value) { return FString::Printf(TEXT("matrix %08x"), FCrc::MemCrc32(&Value, sizeof(Value))); }
+}
+
+ETonyLUTMode TonemapOverride::GetTonyLUTMode(const FTonemapOverrideLUTSnapshot& Snapshot)
+{
+	if (Snapshot.LUTTextureId == 0)
+	{
+		return ETonyLUTMode::Fallback;
+	}
+
+	return Snapshot.bLUTTexturePrecomposed != 0 ? ETonyLUTMode::Precomposed : ETonyLUTMode::TonyEncoding;
+}
+
+uint32 TonemapOverride::GetLUTTextureId(const UTexture* Texture)
+{
+	if (!Texture)
+	{
+		return 0;
+	}
+
+	// Path based id stays the same between sessions, which is needed for anything persisted with the snapshot
+	static const UTexture* CachedTexture = nullptr;
+	static uint32 CachedTextureId = 0;
+
+	if (CachedTexture != Texture)
+	{
+		CachedTexture = Texture;
+		CachedTextureId = FCrc::StrCrc32(*Texture->GetPathName()) | 1;
+	}
+
+	return CachedTextureId;
+}
+
+namespace
+{
+	// Render thread only, replaced by UpdateRenderSettings
+	FTonemapOverrideRenderSettings GRenderSettings;
+
+	// Game thread only
+	uint32 GRenderSettingsGeneration = 0;
+
+#if WITH_EDITORONLY_DATA
+	// Game thread only, source data of the operator textures by id, read again when the source changes (reimport)
+	struct FCPUTextureEntry
+	{
+		FGuid SourceId;
+		TSharedPtr<const FTonemapOverrideCPUTexture3D> Texture;
+	};
+	TMap<uint32, FCPUTextureEntry> GCPUTextures;
+#endif
+
+	TSharedPtr<const FTonemapOverrideCPUTexture3D> GetCPUTexture(const UTexture* Texture, uint32 LUTTextureId)
+	{
+#if WITH_EDITORONLY_DATA
+		const FGuid SourceId = Texture->Source.GetId();
+		if (const FCPUTextureEntry* Entry = GCPUTextures.Find(LUTTextureId); Entry && Entry->SourceId == SourceId)
+		{
+			return Entry->Texture;
+		}
+
+		// Textures that can not be read are remembered as well, so they are not read again with every update
+		TSharedPtr<FTonemapOverrideCPUTexture3D> CPUTexture = MakeShared<FTonemapOverrideCPUTexture3D>();
+		FCPUTextureEntry& Entry = GCPUTextures.Add(LUTTextureId);
+		Entry.SourceId = SourceId;
+		Entry.Texture = FTonemapOverrideCPUTexture3D::LoadFromTexture(Texture, *CPUTexture) ? CPUTexture : nullptr;
+		return Entry.Texture;
+#else
+		return nullptr;
+#endif
+	}
+
+	FTonemapOverrideRenderTexture GetRenderTexture(const TSoftObjectPtr<UTexture>& TexturePtr)
+	{
+		FTonemapOverrideRenderTexture RenderTexture;
+
+		const UTexture* Texture = TexturePtr.Get();
+		if (Texture && Texture->GetResource())
+		{
+			RenderTexture.Id = TonemapOverride::GetLUTTextureId(Texture);
+			RenderTexture.Resource = Texture->GetResource();
+			RenderTexture.CPUTexture = GetCPUTexture(Texture, RenderTexture.Id);
+		}
+
+		return RenderTexture;
+	}
+
+	ECustomTonemapOperator GetTonemapOperator(const UTonemapOverrideSettings& TonemapOverrideSettings)
+	{
+		const int32 Operator = CVarTonemapOverrideOperator.GetValueOnAnyThread();
+		return Operator >= 0 && Operator < int32(ECustomTonemapOperator::MAX) ? ECustomTonemapOperator(Operator) : TonemapOverrideSettings.CustomTonemapOperator;
+	}
+
+	void ResolveRenderTexture(FTonemapOverrideRenderTexture& RenderTexture)
+	{
+		RenderTexture.TextureRHI = RenderTexture.Resource ? RenderTexture.Resource->TextureRHI : nullptr;
+		RenderTexture.Resource = nullptr;
+
+		// Not initialized yet, the operator uses the fallback until the next update
+		if (!RenderTexture.TextureRHI)
+		{
+			RenderTexture.Id = 0;
+			RenderTexture.CPUTexture.Reset();
+		}
+	}
+
+	// Render thread only, LUT textures of the post process volumes by id for GetLUTShaderParameters
+	// Snapshots in flight (time sliced, async and deferred LUTs) name the texture by id, so an entry is kept until it was
+	// not used for VolumeLUTTextureFrames instead of being dropped when other textures come in
+	struct FVolumeLUTTexture
+	{
+		FTextureRHIRef TextureRHI;
+		uint32 LastUsedFrame = 0;
+	};
+	TMap<uint32, FVolumeLUTTexture> GVolumeLUTTextures;
+	constexpr uint32 VolumeLUTTextureFrames = 256;
+
+	FRHITexture* FindVolumeLUTTexture(uint32 LUTTextureId)
+	{
+		FVolumeLUTTexture* VolumeTexture = GVolumeLUTTextures.Find(LUTTextureId);
+		if (!VolumeTexture)
+		{
+			return nullptr;
+		}
+
+		VolumeTexture->LastUsedFrame = GFrameNumberRenderThread;
+		return VolumeTexture->TextureRHI;
+	}
+
+	// Blendables of the view blended over the render settings in the order the engine pushed them (volume priority)
+	// Floats are interpolated with the weight, the texture is switched at half weight. False when the view has none
+	bool BlendVolumeSettings(const FFinalPostProcessSettings& Settings, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideRenderSettings& OutSettings)
+	{
+		FBlendableEntry* Iterator = nullptr;
+		const FTonemapOverrideBlendableData* Data = Settings.BlendableManager.IterateBlendables<FTonemapOverrideBlendableData>(Iterator);
+		if (!Data)
+		{
+			return false;
+		}
+
+		OutSettings = RenderSettings;
+
+		for (; Data; Data = Settings.BlendableManager.IterateBlendables<FTonemapOverrideBlendableData>(Iterator))
+		{
+			const float Weight = FMath::Clamp(Data->Weight, 0.0f, 1.0f);
+
+#define TONEMAPOVERRIDE_BLEND_VALUE(Name) if (Data->bOverride_##Name) { OutSettings.Name = FMath::Lerp(OutSettings.Name, Data->Name, Weight); }
+			TONEMAPOVERRIDE_BLEND_VALUE(ReinhardWhitePoint)
+			TONEMAPOVERRIDE_BLEND_VALUE(HejlWhitePoint)
+			TONEMAPOVERRIDE_BLEND_VALUE(GT7BlendRatio)
+			TONEMAPOVERRIDE_BLEND_VALUE(GT7FadeStart)
+			TONEMAPOVERRIDE_BLEND_VALUE(GT7FadeEnd)
+#undef TONEMAPOVERRIDE_BLEND_VALUE
+
+			// Registered by the blendable before the frame is rendered, not there while the resource is not initialized
+			FRHITexture* VolumeTexture = Data->bOverride_LUTTexture && Weight >= 0.5f ? FindVolumeLUTTexture(Data->LUTTextureId) : nullptr;
+			if (VolumeTexture)
+			{
+				OutSettings.LUTTexture.Id = Data->LUTTextureId;
+				OutSettings.LUTTexture.TextureRHI = VolumeTexture;
+				OutSettings.bLUTTexturePrecomposed = Data->bLUTTexturePrecomposed;
+			}
+		}
+
+		return true;
+	}
+
+	// Texture of the snapshot, from the settings or from a post process volume
+	FRHITexture* FindLUTTexture(uint32 LUTTextureId, const FTonemapOverrideRenderTexture* OperatorTexture)
+	{
+		if (LUTTextureId == 0 || !OperatorTexture)
+		{
+			return nullptr;
+		}
+
+		if (OperatorTexture->Id == LUTTextureId)
+		{
+			return OperatorTexture->TextureRHI;
+		}
+
+		// Never another texture than the one in the key, the LUT would be cached under the wrong snapshot. The fallback is
+		// used when the texture is gone, which needs the snapshot to outlive VolumeLUTTextureFrames without being used
+		FRHITexture* VolumeTexture = FindVolumeLUTTexture(LUTTextureId);
+		UE_CLOG(!VolumeTexture, TonemapOverrideLog, Verbose, TEXT("LUT texture %08x of the snapshot is no longer referenced, the operator fallback is used"), LUTTextureId);
+		return VolumeTexture;
+	}
+}
+
+void TonemapOverride::RegisterVolumeLUTTexture(const UTexture* Texture)
+{
+	check(IsInGameThread());
+
+	const FTextureResource* Resource = Texture ? Texture->GetResource() : nullptr;
+	if (!Resource)
+	{
+		return;
+	}
+
+	// Texture resources are released with render commands, so the resource is still alive when this one runs
+	ENQUEUE_RENDER_COMMAND(RegisterTonemapOverrideVolumeLUTTexture)(
+		[Resource, LUTTextureId = GetLUTTextureId(Texture)](FRHICommandListImmediate& RHICmdList)
+		{
+			const uint32 FrameNumber = GFrameNumberRenderThread;
+
+			for (auto It = GVolumeLUTTextures.CreateIterator(); It; ++It)
+			{
+				if (FrameNumber - It.Value().LastUsedFrame > VolumeLUTTextureFrames)
+				{
+					It.RemoveCurrent();
+				}
+			}
+
+			if (Resource->TextureRHI)
+			{
+				FVolumeLUTTexture& VolumeTexture = GVolumeLUTTextures.FindOrAdd(LUTTextureId);
+				VolumeTexture.TextureRHI = Resource->TextureRHI;
+				VolumeTexture.LastUsedFrame = FrameNumber;
+			}
+		});
+}
+
+FTonemapOverrideRenderSettings::FTonemapOverrideRenderSettings(const UTonemapOverrideSettings& TonemapOverrideSettings)
+	: bUseCustomTonemapper(TonemapOverrideSettings.bUseCustomTonemapper)
+	, CustomTonemapOperator(GetTonemapOperator(TonemapOverrideSettings))
+	, LUTTexture(GetRenderTexture(TonemapOverrideSettings.LUTTexture))
+	, bLUTTexturePrecomposed(TonemapOverrideSettings.bLUTTexturePrecomposed)
+	, CustomLUTTexture(GetRenderTexture(TonemapOverrideSettings.CustomLUTTexture))
+	, CustomLUTInput(TonemapOverrideSettings.CustomLUTInput)
+	, CustomLUTOutput(TonemapOverrideSettings.CustomLUTOutput)
+	, CustomLUTDomainMin(FVector3f(TonemapOverrideSettings.CustomLUTDomainMin))
+	, CustomLUTDomainMax(FVector3f(TonemapOverrideSettings.CustomLUTDomainMax))
+	, ReinhardWhitePoint(TonemapOverrideSettings.ReinhardWhitePoint)
+	, HejlWhitePoint(TonemapOverrideSettings.HejlWhitePoint)
+	, UCSType(TonemapOverrideSettings.UCSType)
+	, GT7BlendRatio(TonemapOverrideSettings.GT7BlendRatio)
+	, GT7FadeStart(TonemapOverrideSettings.GT7FadeStart)
+	, GT7FadeEnd(TonemapOverrideSettings.GT7FadeEnd)
+	, FlimPreset(TonemapOverrideSettings.GetFlimPreset())
+	, FastMathMaxDeltaE(TonemapOverrideSettings.FastMathMaxDeltaE)
+	, bFastMath(CVarTonemapOverrideFastMath.GetValueOnAnyThread() != 0)
+	, bSeparableCurve(CVarTonemapOverrideSeparableCurve.GetValueOnAnyThread() != 0)
+	, bTetrahedralLUT(CVarTonemapOverrideTetrahedralLUT.GetValueOnAnyThread() != 0)
+	, CompiledPermutations(TonemapOverride::GetCompiledPermutations())
+{
+}
+
+const FTonemapOverrideRenderTexture* FTonemapOverrideRenderSettings::GetOperatorLUTTexture(ECustomTonemapOperator Operator) const
+{
+	switch (Operator)
+	{
+	case ECustomTonemapOperator::TonyMcMapface: return &LUTTexture;
+	case ECustomTonemapOperator::CustomLUT: return &CustomLUTTexture;
+	default: return nullptr;
+	}
+}
+
+void TonemapOverride::UpdateRenderSettings()
+{
+	check(IsInGameThread());
+
+	FTonemapOverrideRenderSettings RenderSettings(UTonemapOverrideSettings::Get());
+	RenderSettings.Generation = ++GRenderSettingsGeneration;
+
+	// Texture resources are released with render commands, so they are still alive when this one runs
+	ENQUEUE_RENDER_COMMAND(UpdateTonemapOverrideRenderSettings)(
+		[RenderSettings = MoveTemp(RenderSettings)](FRHICommandListImmediate& RHICmdList) mutable
+		{
+			ResolveRenderTexture(RenderSettings.LUTTexture);
+			ResolveRenderTexture(RenderSettings.CustomLUTTexture);
+			GRenderSettings = MoveTemp(RenderSettings);
+		});
+}
+
+const FTonemapOverrideRenderSettings& TonemapOverride::GetRenderSettings()
+{
+	check(IsInRenderingThread());
+	return GRenderSettings;
+}
+
+const TSoftObjectPtr<UTexture>* TonemapOverride::GetOperatorLUTTexture(const UTonemapOverrideSettings& TonemapOverrideSettings, ECustomTonemapOperator Operator)
+{
+	switch (Operator)
+	{
+	case ECustomTonemapOperator::TonyMcMapface: return &TonemapOverrideSettings.LUTTexture;
+	case ECustomTonemapOperator::CustomLUT: return &TonemapOverrideSettings.CustomLUTTexture;
+	default: return nullptr;
+	}
+}
+
+void TonemapOverride::SetSnapshotOperator(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings, uint32 LUTTextureId, FTonemapOverrideLUTSnapshot& OutSnapshot)
+{
+	OutSnapshot.TonemapOperator = uint32(Operator);
+	OutSnapshot.LUTTextureId = RenderSettings.GetOperatorLUTTexture(Operator) ? LUTTextureId : 0;
+
+	// Settings of the other operators stay zero so they don't split the cache
+	OutSnapshot.bLUTTexturePrecomposed = Operator == ECustomTonemapOperator::TonyMcMapface && LUTTextureId != 0 && RenderSettings.bLUTTexturePrecomposed ? 1 : 0;
+	OutSnapshot.CustomLUTInput = 0;
+	OutSnapshot.CustomLUTOutput = 0;
+	OutSnapshot.CustomLUTDomainMin = FVector3f::ZeroVector;
+	OutSnapshot.CustomLUTDomainMax = FVector3f::ZeroVector;
+	OutSnapshot.bTetrahedralLUT = OutSnapshot.LUTTextureId != 0 && RenderSettings.bTetrahedralLUT ? 1 : 0;
+
+	if (Operator == ECustomTonemapOperator::CustomLUT)
+	{
+		OutSnapshot.CustomLUTInput = uint32(RenderSettings.CustomLUTInput);
+		OutSnapshot.CustomLUTOutput = uint32(RenderSettings.CustomLUTOutput);
+		OutSnapshot.CustomLUTDomainMin = RenderSettings.CustomLUTDomainMin;
+		OutSnapshot.CustomLUTDomainMax = RenderSettings.CustomLUTDomainMax;
+	}
+
+	// Fast math variant only within the accuracy budget, decided per operator so the field stays stable
+	OutSnapshot.bFastMath = uint32(RenderSettings.bFastMath && TonemapOverride::IsFastMathVariantAllowed(Operator, RenderSettings));
+	OutSnapshot.bSeparableCurve = uint32(RenderSettings.bSeparableCurve && FTonemapOverrideCPULUT::HasSeparableCurve(Operator));
+}
+
+void TonemapOverride::SetSnapshotOperator(ECustomTonemapOperator Operator, const UTonemapOverrideSettings& TonemapOverrideSettings, uint32 LUTTextureId, FTonemapOverrideLUTSnapshot& OutSnapshot)
+{
+	SetSnapshotOperator(Operator, FTonemapOverrideRenderSettings(TonemapOverrideSettings), LUTTextureId, OutSnapshot);
+}
+
+uint64 FTonemapOverrideLUTSnapshot::GetHash() const
+{
+	return CityHash64(reinterpret_cast<const char*>(this), sizeof(*this));
+}
+
+uint64 FTonemapOverrideLUTSnapshot::GetContentHash() const
+{
+	FTonemapOverrideLUTSnapshot Content = *this;
+	Content.ShaderPlatform = 0;
+	Content.bUseCompute = 0;
+	return Content.GetHash();
+}
+
+uint64 FTonemapOverrideLUTSnapshot::GetBatchHash() const
+{
+	FTonemapOverrideLUTSnapshot Shared = *this;
+#define TONEMAPOVERRIDE_SNAPSHOT_CLEAR_QUANTIZED(Type, Name, Quantization) \
+	if (ELUTSnapshotQuantization::Quantization != ELUTSnapshotQuantization::None) { FMemory::Memzero(&Shared.Name, sizeof(Type)); }
+	TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_CLEAR_QUANTIZED)
+#undef TONEMAPOVERRIDE_SNAPSHOT_CLEAR_QUANTIZED
+	return Shared.GetHash();
+}
+
+uint64 FTonemapOverrideLUTSnapshot::GetOperatorStageHash() const
+{
+	FTonemapOverrideLUTSnapshot OperatorStage = *this;
+	OperatorStage.ColorScale = FVector3f::ZeroVector;
+	OperatorStage.OverlayColor = FVector4f::Zero();
+	OperatorStage.InverseGamma = FVector3f::ZeroVector;
+	OperatorStage.OutputGamut = 0;
+	return OperatorStage.GetHash();
+}
+
+const TCHAR* FTonemapOverrideLUTSnapshot::GetFieldName(ELUTSnapshotField Field)
+{
+	return Field < ELUTSnapshotField::Num ? GFieldNames[int32(Field)] : TEXT("");
+}
+
+FString FTonemapOverrideLUTSnapshot::GetFieldValueString(ELUTSnapshotField Field) const
+{
+	switch (Field)
+	{
+#define TONEMAPOVERRIDE_SNAPSHOT_VALUE(Type, Name, Quantization) case ELUTSnapshotField::Name: return FieldValueToString(Name);
+		TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_VALUE)
+#undef TONEMAPOVERRIDE_SNAPSHOT_VALUE
+	default: return FString();
+	}
+}
+
+void TonemapOverride::BuildLUTSnapshot(const FViewInfo& View, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot)
+{
+	BuildLUTSnapshot(static_cast<const FSceneView&>(View), LUTSize, RenderSettings, OutSnapshot, PreviousSnapshot);
+	OutSnapshot.bUseCompute = uint32(View.bUseComputePasses);
+}
+
+void TonemapOverride::BuildLUTSnapshot(const FSceneView& View, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot)
+{
+	static const FPostProcessSettings DefaultSettings;
+
+	const FSceneViewFamily& ViewFamily = *(View.Family);
+
+	const FPostProcessSettings& Settings = ViewFamily.EngineShowFlags.ColorGrading
+		? View.FinalPostProcessSettings
+		: DefaultSettings;
+
+	const FTonemapperOutputDeviceParameters OutputDeviceParameters = GetTonemapperOutputDeviceParameters(ViewFamily);
+
+	// Operator parameters of the post process volumes follow the color grading show flag like the engine grading
+	FTonemapOverrideRenderSettings BlendedSettings;
+	const bool bBlended = ViewFamily.EngineShowFlags.ColorGrading && BlendVolumeSettings(View.FinalPostProcessSettings, RenderSettings, BlendedSettings);
+
+	BuildLUTSnapshot(Settings, OutputDeviceParameters, View.ColorScale, View.OverlayColor, LUTSize, bBlended ? BlendedSettings : RenderSettings, OutSnapshot, PreviousSnapshot);
+
+	OutSnapshot.ShaderPlatform = uint32(View.GetShaderPlatform());
+}
+
+void TonemapOverride::ResetEngineLUTSettings(FSceneView& View)
+{
+	// With the defaults the engine LUT settings are the same whether the color grading show flag is on or not
+	View.FinalPostProcessSettings = FFinalPostProcessSettings();
+}
+
+void TonemapOverride::BuildLUTSnapshot(const FPostProcessSettings& Settings, const FTonemapperOutputDeviceParameters& OutputDeviceParameters, const FLinearColor& ColorScale, const FLinearColor& OverlayColor, int32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideLUTSnapshot& OutSnapshot)
+{
+	BuildLUTSnapshot(Settings, OutputDeviceParameters, ColorScale, OverlayColor, LUTSize, FTonemapOverrideRenderSettings(TonemapOverrideSettings), OutSnapshot);
+}
+
+void TonemapOverride::BuildLUTSnapshot(const FPostProcessSettings& Settings, const FTonemapperOutputDeviceParameters& OutputDeviceParameters, const FLinearColor& ColorScale, const FLinearColor& OverlayColor, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot)
+{
+	FCVarDerivedValues LocalCVarValues;
+	const FCVarDerivedValues& CVarValues = GetCVarDerivedValues(LocalCVarValues);
+	FTonemapOverrideLUTSnapshot& S = OutSnapshot;
+
+	const FWorkingColorSpaceShaderParameters* WorkingColorSpace = reinterpret_cast<const FWorkingColorSpaceShaderParameters*>(GDefaultWorkingColorSpaceUniformBuffer.GetContents());
+	if (WorkingColorSpace)
+	{
+		S.WorkingColorSpaceToXYZ = WorkingColorSpace->ToXYZ;
+		S.WorkingColorSpaceFromXYZ = WorkingColorSpace->FromXYZ;
+		S.WorkingColorSpaceToAP1 = WorkingColorSpace->ToAP1;
+		S.WorkingColorSpaceFromAP1 = WorkingColorSpace->FromAP1;
+		S.WorkingColorSpaceToAP0 = WorkingColorSpace->ToAP0;
+		S.bWorkingColorSpaceIsSRGB = WorkingColorSpace->bIsSRGB;
+	}
+
+	S.ACESMinMaxData = CVarValues.ACESParams.ACESMinMaxData;
+	S.ACESMidData = CVarValues.ACESParams.ACESMidData;
+	S.ACESCoefsLow_0 = CVarValues.ACESParams.ACESCoefsLow_0;
+	S.ACESCoefsHigh_0 = CVarValues.ACESParams.ACESCoefsHigh_0;
+	S.ACESCoefsLow_4 = CVarValues.ACESParams.ACESCoefsLow_4;
+	S.ACESCoefsHigh_4 = CVarValues.ACESParams.ACESCoefsHigh_4;
+	S.ACESSceneColorMultiplier = CVarValues.ACESParams.ACESSceneColorMultiplier;
+	S.ACESGamutCompression = CVarValues.ACESParams.ACESGamutCompression;
+	S.MappingPolynomial = CVarValues.MappingPolynomial;
+
+	S.ColorScale = FVector3f(ColorScale);
+	S.OverlayColor = FVector4f(OverlayColor);
+
+	// White balance
+	S.bIsTemperatureWhiteBalance = uint32(Settings.TemperatureType == ETemperatureMethod::TEMP_WhiteBalance);
+	S.LUTSize = LUTSize;
+	S.WhiteTemp = Settings.WhiteTemp;
+	S.WhiteTint = Settings.WhiteTint;
+
+	// Color grade
+	S.ColorSaturation = FVector4f(Settings.ColorSaturation);
+	S.ColorContrast = FVector4f(Settings.ColorContrast);
+	S.ColorGamma = FVector4f(Settings.ColorGamma);
+	S.ColorGain = FVector4f(Settings.ColorGain);
+	S.ColorOffset = FVector4f(Settings.ColorOffset);
+
+	S.ColorSaturationShadows = FVector4f(Settings.ColorSaturationShadows);
+	S.ColorContrastShadows = FVector4f(Settings.ColorContrastShadows);
+	S.ColorGammaShadows = FVector4f(Settings.ColorGammaShadows);
+	S.ColorGainShadows = FVector4f(Settings.ColorGainShadows);
+	S.ColorOffsetShadows = FVector4f(Settings.ColorOffsetShadows);
+
+	S.ColorSaturationMidtones = FVector4f(Settings.ColorSaturationMidtones);
+	S.ColorContrastMidtones = FVector4f(Settings.ColorContrastMidtones);
+	S.ColorGammaMidtones = FVector4f(Settings.ColorGammaMidtones);
+	S.ColorGainMidtones = FVector4f(Settings.ColorGainMidtones);
+	S.ColorOffsetMidtones = FVector4f(Settings.ColorOffsetMidtones);
+
+	S.ColorSaturationHighlights = FVector4f(Settings.ColorSaturationHighlights);
+	S.ColorContrastHighlights = FVector4f(Settings.ColorContrastHighlights);
+	S.ColorGammaHighlights = FVector4f(Settings.ColorGammaHighlights);
+	S.ColorGainHighlights = FVector4f(Settings.ColorGainHighlights);
+	S.ColorOffsetHighlights = FVector4f(Settings.ColorOffsetHighlights);
+
+	S.ColorCorrectionShadowsMax = Settings.ColorCorrectionShadowsMax;
+	S.ColorCorrectionHighlightsMin = Settings.ColorCorrectionHighlightsMin;
+	S.ColorCorrectionHighlightsMax = Settings.ColorCorrectionHighlightsMax;
+
+	S.BlueCorrection = Settings.BlueCorrection;
+	S.ExpandGamut = Settings.ExpandGamut;
+	S.ToneCurveAmount = Settings.ToneCurveAmount;
+
+	S.FilmSlope = Settings.FilmSlope;
+	S.FilmToe = Settings.FilmToe;
+	S.FilmShoulder = Settings.FilmShoulder;
+	S.FilmBlackClip = Settings.FilmBlackClip;
+	S.FilmWhiteClip = Settings.FilmWhiteClip;
+
+	S.InverseGamma = OutputDeviceParameters.InverseGamma;
+	S.OutputDevice = OutputDeviceParameters.OutputDevice;
+	S.OutputGamut = OutputDeviceParameters.OutputGamut;
+	S.OutputMaxLuminance = OutputDeviceParameters.OutputMaxLuminance;
+
+	// Custom tonemapper
+	S.ReinhardWhitePoint = RenderSettings.ReinhardWhitePoint;
+	S.HejlWhitePoint = RenderSettings.HejlWhitePoint;
+	S.GT7BlendRatio = RenderSettings.GT7BlendRatio;
+	S.GT7FadeStart = RenderSettings.GT7FadeStart;
+	S.GT7FadeEnd = RenderSettings.GT7FadeEnd;
+	S.GT7UCSType = uint32(RenderSettings.UCSType);
+
+	// Texture only affects the LUT while it is loaded, otherwise the fallback is used
+	const FTonemapOverrideRenderTexture* OperatorTexture = RenderSettings.GetOperatorLUTTexture(RenderSettings.CustomTonemapOperator);
+	TonemapOverride::SetSnapshotOperator(RenderSettings.CustomTonemapOperator, RenderSettings, OperatorTexture ? OperatorTexture->Id : 0, S);
+
+	// Flim preset only affects Flim, the default preset is folded into the shader and needs no values
+	if (RenderSettings.CustomTonemapOperator == ECustomTonemapOperator::Flim)
+	{
+		const FTonemapOverrideFlimPreset& Preset = RenderSettings.FlimPreset;
+		if (Preset != FTonemapOverrideFlimPreset())
+		{
+			S.bFlimCustomPreset = 1;
+			S.FlimPreExposure = Preset.PreExposure;
+			S.FlimPreFormationFilter = FVector3f(Preset.PreFormationFilter);
+			S.FlimPreFormationFilterStrength = Preset.PreFormationFilterStrength;
+			S.FlimExtendedGamutScale = FVector3f(Preset.ExtendedGamutScale);
+			S.FlimExtendedGamutRotation = FVector3f(Preset.ExtendedGamutRotation);
+			S.FlimExtendedGamutMul = FVector3f(Preset.ExtendedGamutMul);
+			S.FlimSigmoidLog2Min = Preset.SigmoidLog2Min;
+			S.FlimSigmoidLog2Max = Preset.SigmoidLog2Max;
+			S.FlimSigmoidToeX = Preset.SigmoidToeX;
+			S.FlimSigmoidToeY = Preset.SigmoidToeY;
+			S.FlimSigmoidShoulderX = Preset.SigmoidShoulderX;
+			S.FlimSigmoidShoulderY = Preset.SigmoidShoulderY;
+			S.FlimNegativeFilmExposure = Preset.NegativeFilmExposure;
+			S.FlimNegativeFilmDensity = Preset.NegativeFilmDensity;
+			S.FlimPrintBacklight = FVector3f(Preset.PrintBacklight);
+			S.FlimPrintFilmExposure = Preset.PrintFilmExposure;
+			S.FlimPrintFilmDensity = Preset.PrintFilmDensity;
+			S.FlimBlackPoint = Preset.BlackPoint;
+			S.FlimPostFormationFilter = FVector3f(Preset.PostFormationFilter);
+			S.FlimPostFormationFilterStrength = Preset.PostFormationFilterStrength;
+			S.FlimMidtoneSaturation = Preset.MidtoneSaturation;
+		}
+	}
+
+	// Quantize so that blending jitter below the tolerance maps to the same snapshot, and values wobbling around a bucket edge stay in the previous bucket
+#define TONEMAPOVERRIDE_SNAPSHOT_QUANTIZE(Type, Name, Quantization) Quantize(S.Name, CVarValues.QuantizationSteps[int32(ELUTSnapshotField::Name)], CVarValues.QuantizationHysteresis, PreviousSnapshot ? &PreviousSnapshot->Name : nullptr);
+	TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_QUANTIZE)
+#undef TONEMAPOVERRIDE_SNAPSHOT_QUANTIZE
+}
+
+FTonemapOverrideFlimPreset TonemapOverride::GetFlimPreset(const FTonemapOverrideLUTSnapshot& S)
+{
+	FTonemapOverrideFlimPreset Preset;
+
+	if (S.bFlimCustomPreset != 0)
+	{
+		Preset.PreExposure = S.FlimPreExposure;
+		Preset.PreFormationFilter = FLinearColor(S.FlimPreFormationFilter);
+		Preset.PreFormationFilterStrength = S.FlimPreFormationFilterStrength;
+		Preset.ExtendedGamutScale = FVector(S.FlimExtendedGamutScale);
+		Preset.ExtendedGamutRotation = FVector(S.FlimExtendedGamutRotation);
+		Preset.ExtendedGamutMul = FVector(S.FlimExtendedGamutMul);
+		Preset.SigmoidLog2Min = S.FlimSigmoidLog2Min;
+		Preset.SigmoidLog2Max = S.FlimSigmoidLog2Max;
+		Preset.SigmoidToeX = S.FlimSigmoidToeX;
+		Preset.SigmoidToeY = S.FlimSigmoidToeY;
+		Preset.SigmoidShoulderX = S.FlimSigmoidShoulderX;
+		Preset.SigmoidShoulderY = S.FlimSigmoidShoulderY;
+		Preset.NegativeFilmExposure = S.FlimNegativeFilmExposure;
+		Preset.NegativeFilmDensity = S.FlimNegativeFilmDensity;
+		Preset.PrintBacklight = FLinearColor(S.FlimPrintBacklight);
+		Preset.PrintFilmExposure = S.FlimPrintFilmExposure;
+		Preset.PrintFilmDensity = S.FlimPrintFilmDensity;
+		Preset.BlackPoint = S.FlimBlackPoint;
+		Preset.PostFormationFilter = FLinearColor(S.FlimPostFormationFilter);
+		Preset.PostFormationFilterStrength = S.FlimPostFormationFilterStrength;
+		Preset.MidtoneSaturation = S.FlimMidtoneSaturation;
+	}
+
+	return Preset;
+}
+
+FTonemapperOutputDeviceParameters TonemapOverride::GetDefaultOutputDeviceParameters(EDisplayOutputFormat OutputDevice, EDisplayColorGamut OutputGamut)
+{
+	// Same as the engine for a render target with the default display gamma of 2.2 and r.TonemapperGamma 0
+	const float DisplayGamma = 2.2f;
+
+	FTonemapperOutputDeviceParameters Parameters;
+	Parameters.InverseGamma = FVector3f(1.0f / DisplayGamma, 2.2f / DisplayGamma, 1.0f);
+	Parameters.OutputDevice = uint32(OutputDevice);
+	Parameters.OutputGamut = uint32(OutputGamut);
+	Parameters.OutputMaxLuminance = 100.0f;
+
+	// Nominal peak of the HDR outputs
+	switch (OutputDevice)
+	{
+	case EDisplayOutputFormat::HDR_ACES_1000nit_ST2084:
+	case EDisplayOutputFormat::HDR_ACES_1000nit_ScRGB:
+		Parameters.OutputMaxLuminance = 1000.0f;
+		break;
+	case EDisplayOutputFormat::HDR_ACES_2000nit_ST2084:
+	case EDisplayOutputFormat::HDR_ACES_2000nit_ScRGB:
+		Parameters.OutputMaxLuminance = 2000.0f;
+		break;
+	default:
+		break;
+	}
+	return Parameters;
+}
+
+void TonemapOverride::GetLUTShaderParameters(const FTonemapOverrideLUTSnapshot& S, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTParameters& Parameters)
+{
+	Parameters.WorkingColorSpace = GDefaultWorkingColorSpaceUniformBuffer.GetUniformBufferRef();
+
+	Parameters.ACESTonemapParameters.ACESMinMaxData = S.ACESMinMaxData;
+	Parameters.ACESTonemapParameters.ACESMidData = S.ACESMidData;
+	Parameters.ACESTonemapParameters.ACESCoefsLow_0 = S.ACESCoefsLow_0;
+	Parameters.ACESTonemapParameters.ACESCoefsHigh_0 = S.ACESCoefsHigh_0;
+	Parameters.ACESTonemapParameters.ACESCoefsLow_4 = S.ACESCoefsLow_4;
+	Parameters.ACESTonemapParameters.ACESCoefsHigh_4 = S.ACESCoefsHigh_4;
+	Parameters.ACESTonemapParameters.ACESSceneColorMultiplier = S.ACESSceneColorMultiplier;
+	Parameters.ACESTonemapParameters.ACESGamutCompression = S.ACESGamutCompression;
+
+	Parameters.LUTSize = S.LUTSize;
+	Parameters.ColorScale = S.ColorScale;
+	Parameters.OverlayColor = S.OverlayColor;
+	Parameters.MappingPolynomial = S.MappingPolynomial;
+
+	Parameters.bIsTemperatureWhiteBalance = S.bIsTemperatureWhiteBalance;
+	Parameters.WhiteTemp = S.WhiteTemp;
+	Parameters.WhiteTint = S.WhiteTint;
+
+	Parameters.ColorSaturation = S.ColorSaturation;
+	Parameters.ColorContrast = S.ColorContrast;
+	Parameters.ColorGamma = S.ColorGamma;
+	Parameters.ColorGain = S.ColorGain;
+	Parameters.ColorOffset = S.ColorOffset;
+
+	Parameters.ColorSaturationShadows = S.ColorSaturationShadows;
+	Parameters.ColorContrastShadows = S.ColorContrastShadows;
+	Parameters.ColorGammaShadows = S.ColorGammaShadows;
+	Parameters.ColorGainShadows = S.ColorGainShadows;
+	Parameters.ColorOffsetShadows = S.ColorOffsetShadows;
+
+	Parameters.ColorSaturationMidtones = S.ColorSaturationMidtones;
+	Parameters.ColorContrastMidtones = S.ColorContrastMidtones;
+	Parameters.ColorGammaMidtones = S.ColorGammaMidtones;
+	Parameters.ColorGainMidtones = S.ColorGainMidtones;
+	Parameters.ColorOffsetMidtones = S.ColorOffsetMidtones;
+
+	Parameters.ColorSaturationHighlights = S.ColorSaturationHighlights;
+	Parameters.ColorContrastHighlights = S.ColorContrastHighlights;
+	Parameters.ColorGammaHighlights = S.ColorGammaHighlights;
+	Parameters.ColorGainHighlights = S.ColorGainHighlights;
+	Parameters.ColorOffsetHighlights = S.ColorOffsetHighlights;
+
+	Parameters.ColorCorrectionShadowsMax = S.ColorCorrectionShadowsMax;
+	Parameters.ColorCorrectionHighlightsMin = S.ColorCorrectionHighlightsMin;
+	Parameters.ColorCorrectionHighlightsMax = S.ColorCorrectionHighlightsMax;
+
+	Parameters.BlueCorrection = S.BlueCorrection;
+	Parameters.ExpandGamut = S.ExpandGamut;
+	Parameters.ToneCurveAmount = S.ToneCurveAmount;
+
+	Parameters.FilmSlope = S.FilmSlope;
+	Parameters.FilmToe = S.FilmToe;
+	Parameters.FilmShoulder = S.FilmShoulder;
+	Parameters.FilmBlackClip = S.FilmBlackClip;
+	Parameters.FilmWhiteClip = S.FilmWhiteClip;
+
+	Parameters.OutputDevice.InverseGamma = S.InverseGamma;
+	Parameters.OutputDevice.OutputDevice = S.OutputDevice;
+	Parameters.OutputDevice.OutputGamut = S.OutputGamut;
+	Parameters.OutputDevice.OutputMaxLuminance = S.OutputMaxLuminance;
+
+	FCustomTonemapperParameters& Custom = Parameters.CustomTonemapperParameters;
+	Custom.TonemapOperator = int32(S.TonemapOperator);
+	Custom.ReinhardWhitePoint = S.ReinhardWhitePoint;
+	Custom.HejlWhitePoint = S.HejlWhitePoint;
+	Custom.GT7BlendRatio = S.GT7BlendRatio;
+	Custom.GT7FadeStart = S.GT7FadeStart;
+	Custom.GT7FadeEnd = S.GT7FadeEnd;
+	Custom.EGT7UCSType = int32(S.GT7UCSType);
+
+	// Curve and UCS constants for the output device, initializeAsSDR / initializeAsHDR of the shader done once here
+	if (S.GetTonemapOperator() == ECustomTonemapOperator::GT7)
+	{
+		FTonemapOverrideGT7Constants GT7;
+		TonemapOverride::GetGT7Constants(S.OutputDevice, S.OutputMaxLuminance, S.GetGT7UCSType(), GT7);
+
+		Custom.GT7PeakIntensity = GT7.PeakIntensity;
+		Custom.GT7SdrCorrectionFactor = GT7.SdrCorrectionFactor;
+		Custom.GT7LuminanceTargetUcs = GT7.LuminanceTargetUcs;
+		Custom.GT7CurveShoulder = FVector3f(GT7.kA, GT7.kB, GT7.kC);
+	}
+
+	// Caps and gamut matrices of the preset are resolved here once instead of per texel
+	if (S.bFlimCustomPreset != 0)
+	{
+		FTonemapOverrideFlimConstants Flim;
+		TonemapOverride::GetFlimConstants(GetFlimPreset(S), Flim);
+
+		FFlimTonemapperParameters& FlimParameters = Parameters.FlimParameters;
+		FlimParameters.FlimExtendMat = Flim.Extend.ToShaderMatrix();
+		FlimParameters.FlimExtendMatInv = Flim.ExtendInverse.ToShaderMatrix();
+		FlimParameters.FlimBacklightExt = FVector3f(Flim.BacklightExt);
+		FlimParameters.FlimWhiteCap = FVector3f(Flim.WhiteCap);
+		FlimParameters.FlimBlackPoint = Flim.BlackPoint;
+		FlimParameters.FlimPreExposure = Flim.PreExposure;
+		FlimParameters.FlimPreFormationFilter = FVector3f(Flim.PreFormationFilter);
+		FlimParameters.FlimPreFormationFilterStrength = Flim.PreFormationFilterStrength;
+		FlimParameters.FlimPostFormationFilter = FVector3f(Flim.PostFormationFilter);
+		FlimParameters.FlimPostFormationFilterStrength = Flim.PostFormationFilterStrength;
+		FlimParameters.FlimSigmoidLog2Min = Flim.SigmoidLog2Min;
+		FlimParameters.FlimSigmoidLog2Max = Flim.SigmoidLog2Max;
+		FlimParameters.FlimSigmoidToeShoulder = FVector4f(Flim.SigmoidToeX, Flim.SigmoidToeY, Flim.SigmoidShoulderX, Flim.SigmoidShoulderY);
+		FlimParameters.FlimNegativeFilmExposure = Flim.NegativeFilmExposure;
+		FlimParameters.FlimNegativeFilmDensity = Flim.NegativeFilmDensity;
+		FlimParameters.FlimPrintFilmExposure = Flim.PrintFilmExposure;
+		FlimParameters.FlimPrintFilmDensity = Flim.PrintFilmDensity;
+		FlimParameters.FlimMidtoneSaturation = Flim.MidtoneSaturation;
+	}
+
+	// Use fallback texture if not set, the shader then skips the texture
+	Custom.LUTTexture = GBlackVolumeTexture->TextureRHI;
+	Custom.LUTTextureSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+	Custom.TonyLUTMode = uint32(ETonyLUTMode::Fallback);
+	Custom.bTetrahedralLUT = S.bTetrahedralLUT;
+
+	if (FRHITexture* OperatorTexture = FindLUTTexture(S.LUTTextureId, RenderSettings.GetOperatorLUTTexture(S.GetTonemapOperator())))
+	{
+		Custom.LUTTexture = OperatorTexture;
+		Custom.TonyLUTMode = uint32(TonemapOverride::GetTonyLUTMode(S));
+	}
+
+	// Domain scale is guarded here so that the shader can multiply
+	const FVector3f DomainRange = S.CustomLUTDomainMax - S.CustomLUTDomainMin;
+	Custom.CustomLUTInput = S.CustomLUTInput;
+	Custom.CustomLUTOutput = S.CustomLUTOutput;
+	Custom.CustomLUTDomainMin = S.CustomLUTDomainMin;
+	Custom.CustomLUTDomainScale = FVector3f(
+		FMath::Abs(DomainRange.X) > UE_SMALL_NUMBER ? 1.0f / DomainRange.X : 1.0f,
+		FMath::Abs(DomainRange.Y) > UE_SMALL_NUMBER ? 1.0f / DomainRange.Y : 1.0f,
+		FMath::Abs(DomainRange.Z) > UE_SMALL_NUMBER ? 1.0f / DomainRange.Z : 1.0f);
+}
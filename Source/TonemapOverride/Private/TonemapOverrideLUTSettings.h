@@ -0,0 +1,484 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShaderParameterMacros.h"
+#include "PostProcess/PostProcessing.h"
+#include "PostProcess/PostProcessTonemap.h"
+#include "HDRHelper.h"
+#include "TonemapOverrideSettings.h"
+#include <type_traits>
+
+class FViewInfo;
+class FSceneView;
+class UTexture;
+class FTextureResource;
+struct FTonemapOverrideCPUTexture3D;
+
+// Custom parameters implemented outside native Engine tonemapping/color grading
+BEGIN_SHADER_PARAMETER_STRUCT(FCustomTonemapperParameters, )
+	SHADER_PARAMETER(int32, TonemapOperator)
+	SHADER_PARAMETER(float, ReinhardWhitePoint)
+	SHADER_PARAMETER_TEXTURE(Texture3D<float>, LUTTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, LUTTextureSampler)
+	SHADER_PARAMETER(uint32, TonyLUTMode)
+	SHADER_PARAMETER(uint32, CustomLUTInput)
+	SHADER_PARAMETER(uint32, CustomLUTOutput)
+	SHADER_PARAMETER(FVector3f, CustomLUTDomainMin)
+	SHADER_PARAMETER(FVector3f, CustomLUTDomainScale)
+	SHADER_PARAMETER(uint32, bTetrahedralLUT)
+	SHADER_PARAMETER(float, HejlWhitePoint)
+	SHADER_PARAMETER(float, GT7BlendRatio)
+	SHADER_PARAMETER(float, GT7FadeStart)
+	SHADER_PARAMETER(float, GT7FadeEnd)
+	SHADER_PARAMETER(int32, EGT7UCSType)
+	SHADER_PARAMETER(float, GT7PeakIntensity)
+	SHADER_PARAMETER(float, GT7SdrCorrectionFactor)
+	SHADER_PARAMETER(float, GT7LuminanceTargetUcs)
+	SHADER_PARAMETER(FVector3f, GT7CurveShoulder)
+	SHADER_PARAMETER_RDG_BUFFER_SRV(Buffer<float4>, SeparableCurve)
+END_SHADER_PARAMETER_STRUCT()
+
+// Flim preset and the values derived from it, only read by the custom preset permutation
+BEGIN_SHADER_PARAMETER_STRUCT(FFlimTonemapperParameters, )
+	SHADER_PARAMETER(FMatrix44f, FlimExtendMat)
+	SHADER_PARAMETER(FMatrix44f, FlimExtendMatInv)
+	SHADER_PARAMETER(FVector3f, FlimBacklightExt)
+	SHADER_PARAMETER(FVector3f, FlimWhiteCap)
+	SHADER_PARAMETER(FVector3f, FlimPreFormationFilter)
+	SHADER_PARAMETER(FVector3f, FlimPostFormationFilter)
+	SHADER_PARAMETER(FVector4f, FlimSigmoidToeShoulder)
+	SHADER_PARAMETER(float, FlimBlackPoint)
+	SHADER_PARAMETER(float, FlimPreExposure)
+	SHADER_PARAMETER(float, FlimPreFormationFilterStrength)
+	SHADER_PARAMETER(float, FlimPostFormationFilterStrength)
+	SHADER_PARAMETER(float, FlimSigmoidLog2Min)
+	SHADER_PARAMETER(float, FlimSigmoidLog2Max)
+	SHADER_PARAMETER(float, FlimNegativeFilmExposure)
+	SHADER_PARAMETER(float, FlimNegativeFilmDensity)
+	SHADER_PARAMETER(float, FlimPrintFilmExposure)
+	SHADER_PARAMETER(float, FlimPrintFilmDensity)
+	SHADER_PARAMETER(float, FlimMidtoneSaturation)
+END_SHADER_PARAMETER_STRUCT()
+
+// Need to bind all parameters for Full ACES Tonemapping & Color Grading for full implementation
+// When doing just custom, can limit these to the required
+BEGIN_SHADER_PARAMETER_STRUCT(FACESTonemapShaderParameters, )
+	SHADER_PARAMETER(FVector4f, ACESMinMaxData)
+	SHADER_PARAMETER(FVector4f, ACESMidData)
+	SHADER_PARAMETER(FVector4f, ACESCoefsLow_0)
+	SHADER_PARAMETER(FVector4f, ACESCoefsHigh_0)
+	SHADER_PARAMETER(float, ACESCoefsLow_4)
+	SHADER_PARAMETER(float, ACESCoefsHigh_4)
+	SHADER_PARAMETER(float, ACESSceneColorMultiplier)
+	SHADER_PARAMETER(float, ACESGamutCompression)
+END_SHADER_PARAMETER_STRUCT()
+
+BEGIN_SHADER_PARAMETER_STRUCT(FTonemapOverrideLUTParameters, )
+	// Tonemap parameters
+	SHADER_PARAMETER_STRUCT_REF(FWorkingColorSpaceShaderParameters, WorkingColorSpace)
+	SHADER_PARAMETER_STRUCT_INCLUDE(FACESTonemapShaderParameters, ACESTonemapParameters)
+	SHADER_PARAMETER(float, LUTSize)
+	SHADER_PARAMETER(FVector4f, OverlayColor)
+	SHADER_PARAMETER(FVector3f, ColorScale)
+	SHADER_PARAMETER(FVector4f, ColorSaturation)
+	SHADER_PARAMETER(FVector4f, ColorContrast)
+	SHADER_PARAMETER(FVector4f, ColorGamma)
+	SHADER_PARAMETER(FVector4f, ColorGain)
+	SHADER_PARAMETER(FVector4f, ColorOffset)
+	SHADER_PARAMETER(FVector4f, ColorSaturationShadows)
+	SHADER_PARAMETER(FVector4f, ColorContrastShadows)
+	SHADER_PARAMETER(FVector4f, ColorGammaShadows)
+	SHADER_PARAMETER(FVector4f, ColorGainShadows)
+	SHADER_PARAMETER(FVector4f, ColorOffsetShadows)
+	SHADER_PARAMETER(FVector4f, ColorSaturationMidtones)
+	SHADER_PARAMETER(FVector4f, ColorContrastMidtones)
+	SHADER_PARAMETER(FVector4f, ColorGammaMidtones)
+	SHADER_PARAMETER(FVector4f, ColorGainMidtones)
+	SHADER_PARAMETER(FVector4f, ColorOffsetMidtones)
+	SHADER_PARAMETER(FVector4f, ColorSaturationHighlights)
+	SHADER_PARAMETER(FVector4f, ColorContrastHighlights)
+	SHADER_PARAMETER(FVector4f, ColorGammaHighlights)
+	SHADER_PARAMETER(FVector4f, ColorGainHighlights)
+	SHADER_PARAMETER(FVector4f, ColorOffsetHighlights)
+	SHADER_PARAMETER(float, ColorCorrectionShadowsMax)
+	SHADER_PARAMETER(float, ColorCorrectionHighlightsMin)
+	SHADER_PARAMETER(float, ColorCorrectionHighlightsMax)
+	SHADER_PARAMETER(float, WhiteTemp)
+	SHADER_PARAMETER(float, WhiteTint)
+	SHADER_PARAMETER(float, BlueCorrection)
+	SHADER_PARAMETER(float, ExpandGamut)
+	SHADER_PARAMETER(float, ToneCurveAmount)
+	SHADER_PARAMETER(float, FilmSlope)
+	SHADER_PARAMETER(float, FilmToe)
+	SHADER_PARAMETER(float, FilmShoulder)
+	SHADER_PARAMETER(float, FilmBlackClip)
+	SHADER_PARAMETER(float, FilmWhiteClip)
+	SHADER_PARAMETER(uint32, bIsTemperatureWhiteBalance)
+	SHADER_PARAMETER(FVector3f, MappingPolynomial)
+	SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapperOutputDeviceParameters, OutputDevice)
+	SHADER_PARAMETER_STRUCT_INCLUDE(FCustomTonemapperParameters, CustomTonemapperParameters)
+	SHADER_PARAMETER_STRUCT_INCLUDE(FFlimTonemapperParameters, FlimParameters)
+END_SHADER_PARAMETER_STRUCT()
+
+// Quantization groups, each group has its own tolerance CVar and single fields can be overridden by name
+enum class ELUTSnapshotQuantization : uint8
+{
+	None,
+	Grading,
+	Temperature,
+	Fade,
+};
+
+// Every input of the LUT generation packed into one contiguous snapshot: X(Type, Name, Quantization)
+// Ordered by alignment so that the struct stays free of internal padding
+#define TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(X) \
+	X(FMatrix44f, WorkingColorSpaceToXYZ, None) \
+	X(FMatrix44f, WorkingColorSpaceFromXYZ, None) \
+	X(FMatrix44f, WorkingColorSpaceToAP1, None) \
+	X(FMatrix44f, WorkingColorSpaceFromAP1, None) \
+	X(FMatrix44f, WorkingColorSpaceToAP0, None) \
+	X(FVector4f, ACESMinMaxData, None) \
+	X(FVector4f, ACESMidData, None) \
+	X(FVector4f, ACESCoefsLow_0, None) \
+	X(FVector4f, ACESCoefsHigh_0, None) \
+	X(FVector4f, OverlayColor, Fade) \
+	X(FVector4f, ColorSaturation, Grading) \
+	X(FVector4f, ColorContrast, Grading) \
+	X(FVector4f, ColorGamma, Grading) \
+	X(FVector4f, ColorGain, Grading) \
+	X(FVector4f, ColorOffset, Grading) \
+	X(FVector4f, ColorSaturationShadows, Grading) \
+	X(FVector4f, ColorContrastShadows, Grading) \
+	X(FVector4f, ColorGammaShadows, Grading) \
+	X(FVector4f, ColorGainShadows, Grading) \
+	X(FVector4f, ColorOffsetShadows, Grading) \
+	X(FVector4f, ColorSaturationMidtones, Grading) \
+	X(FVector4f, ColorContrastMidtones, Grading) \
+	X(FVector4f, ColorGammaMidtones, Grading) \
+	X(FVector4f, ColorGainMidtones, Grading) \
+	X(FVector4f, ColorOffsetMidtones, Grading) \
+	X(FVector4f, ColorSaturationHighlights, Grading) \
+	X(FVector4f, ColorContrastHighlights, Grading) \
+	X(FVector4f, ColorGammaHighlights, Grading) \
+	X(FVector4f, ColorGainHighlights, Grading) \
+	X(FVector4f, ColorOffsetHighlights, Grading) \
+	X(FVector3f, ColorScale, Fade) \
+	X(FVector3f, MappingPolynomial, None) \
+	X(FVector3f, InverseGamma, None) \
+	X(FVector3f, FlimPreFormationFilter, Grading) \
+	X(FVector3f, FlimExtendedGamutScale, Grading) \
+	X(FVector3f, FlimExtendedGamutRotation, Grading) \
+	X(FVector3f, FlimExtendedGamutMul, Grading) \
+	X(FVector3f, FlimPrintBacklight, Grading) \
+	X(FVector3f, FlimPostFormationFilter, Grading) \
+	X(FVector3f, CustomLUTDomainMin, None) \
+	X(FVector3f, CustomLUTDomainMax, None) \
+	X(float, ACESCoefsLow_4, None) \
+	X(float, ACESCoefsHigh_4, None) \
+	X(float, ACESSceneColorMultiplier, None) \
+	X(float, ACESGamutCompression, None) \
+	X(float, LUTSize, None) \
+	X(float, ColorCorrectionShadowsMax, Grading) \
+	X(float, ColorCorrectionHighlightsMin, Grading) \
+	X(float, ColorCorrectionHighlightsMax, Grading) \
+	X(float, WhiteTemp, Temperature) \
+	X(float, WhiteTint, Grading) \
+	X(float, BlueCorrection, Grading) \
+	X(float, ExpandGamut, Grading) \
+	X(float, ToneCurveAmount, Grading) \
+	X(float, FilmSlope, Grading) \
+	X(float, FilmToe, Grading) \
+	X(float, FilmShoulder, Grading) \
+	X(float, FilmBlackClip, Grading) \
+	X(float, FilmWhiteClip, Grading) \
+	X(float, OutputMaxLuminance, None) \
+	X(float, ReinhardWhitePoint, Grading) \
+	X(float, HejlWhitePoint, Grading) \
+	X(float, GT7BlendRatio, Grading) \
+	X(float, GT7FadeStart, Grading) \
+	X(float, GT7FadeEnd, Grading) \
+	X(float, FlimPreExposure, Grading) \
+	X(float, FlimPreFormationFilterStrength, Grading) \
+	X(float, FlimSigmoidLog2Min, Grading) \
+	X(float, FlimSigmoidLog2Max, Grading) \
+	X(float, FlimSigmoidToeX, Grading) \
+	X(float, FlimSigmoidToeY, Grading) \
+	X(float, FlimSigmoidShoulderX, Grading) \
+	X(float, FlimSigmoidShoulderY, Grading) \
+	X(float, FlimNegativeFilmExposure, Grading) \
+	X(float, FlimNegativeFilmDensity, Grading) \
+	X(float, FlimPrintFilmExposure, Grading) \
+	X(float, FlimPrintFilmDensity, Grading) \
+	X(float, FlimBlackPoint, Grading) \
+	X(float, FlimPostFormationFilterStrength, Grading) \
+	X(float, FlimMidtoneSaturation, Grading) \
+	X(uint32, bIsTemperatureWhiteBalance, None) \
+	X(uint32, OutputDevice, None) \
+	X(uint32, OutputGamut, None) \
+	X(uint32, bWorkingColorSpaceIsSRGB, None) \
+	X(uint32, TonemapOperator, None) \
+	X(uint32, GT7UCSType, None) \
+	X(uint32, bFlimCustomPreset, None) \
+	X(uint32, ShaderPlatform, None) \
+	X(uint32, bUseCompute, None) \
+	X(uint32, LUTTextureId, None) \
+	X(uint32, bLUTTexturePrecomposed, None) \
+	X(uint32, CustomLUTInput, None) \
+	X(uint32, CustomLUTOutput, None) \
+	X(uint32, bTetrahedralLUT, None) \
+	X(uint32, bFastMath, None) \
+	X(uint32, bSeparableCurve, None)
+
+enum class ELUTSnapshotField : uint8
+{
+#define TONEMAPOVERRIDE_SNAPSHOT_ENUM(Type, Name, Quantization) Name,
+	TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_ENUM)
+#undef TONEMAPOVERRIDE_SNAPSHOT_ENUM
+	Num
+};
+
+struct FTonemapOverrideLUTSnapshot
+{
+#define TONEMAPOVERRIDE_SNAPSHOT_MEMBER(Type, Name, Quantization) Type Name;
+	TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_MEMBER)
+#undef TONEMAPOVERRIDE_SNAPSHOT_MEMBER
+
+	// Zero everything including the tail padding so that memcmp and hashing are stable
+	FTonemapOverrideLUTSnapshot()
+	{
+		FMemory::Memzero(this, sizeof(*this));
+	}
+
+	uint64 GetHash() const;
+
+	// Hash of the fields affecting the LUT contents only, used to match baked LUTs across platforms and pass types
+	uint64 GetContentHash() const;
+
+	// Hash of the fields that are not quantized (output device, working color space, operator and its textures)
+	// Quantized fields are the grading that the batched LUT pass reads per LUT, LUTs with the same hash can share the pass
+	uint64 GetBatchHash() const;
+
+	// Hash of the fields read by the operator stage of the staged LUT, everything but the fades, gamma and the output gamut
+	uint64 GetOperatorStageHash() const;
+
+	bool operator==(const FTonemapOverrideLUTSnapshot& Other) const
+	{
+		return FMemory::Memcmp(this, &Other, sizeof(*this)) == 0;
+	}
+
+	bool operator!=(const FTonemapOverrideLUTSnapshot& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	ECustomTonemapOperator GetTonemapOperator() const { return ECustomTonemapOperator(TonemapOperator); }
+	EGT7UCSType GetGT7UCSType() const { return EGT7UCSType(GT7UCSType); }
+
+	static const TCHAR* GetFieldName(ELUTSnapshotField Field);
+
+	// Value of a single field for logging
+	FString GetFieldValueString(ELUTSnapshotField Field) const;
+
+	// Fields that differ between the snapshots in field order
+	template<typename AllocatorType>
+	static void GetChangedFields(const FTonemapOverrideLUTSnapshot& A, const FTonemapOverrideLUTSnapshot& B, TArray<ELUTSnapshotField, AllocatorType>& OutFields)
+	{
+#define TONEMAPOVERRIDE_SNAPSHOT_COMPARE(Type, Name, Quantization) \
+		if (FMemory::Memcmp(&A.Name, &B.Name, sizeof(Type)) != 0) { OutFields.Add(ELUTSnapshotField::Name); }
+		TONEMAPOVERRIDE_LUT_SNAPSHOT_FIELDS(TONEMAPOVERRIDE_SNAPSHOT_COMPARE)
+#undef TONEMAPOVERRIDE_SNAPSHOT_COMPARE
+	}
+};
+
+static_assert(std::is_trivially_copyable_v<FTonemapOverrideLUTSnapshot>, "LUT snapshot needs to stay POD for hashing");
+
+// How the Tony LUT texture is read (TonyLUTMode in Tony.usf), the Custom LUT operator only checks for Fallback
+enum class ETonyLUTMode : uint32
+{
+	// Texture is not loaded (yet), the Tony encoding curve is used on its own
+	Fallback,
+	// Original asset, indexed with the Tony encoding x / (x + 1)
+	TonyEncoding,
+	// Resampled on import, indexed with the engine LUT log encoding
+	Precomposed,
+};
+
+// Operator texture of the render settings
+struct FTonemapOverrideRenderTexture
+{
+	// Stable id of the texture (GetLUTTextureId), 0 while the texture is not loaded
+	uint32 Id = 0;
+
+	// Resource captured on the game thread, only dereferenced by the render command resolving TextureRHI
+	const FTextureResource* Resource = nullptr;
+
+	FTextureRHIRef TextureRHI;
+
+	// Source data for the CPU LUT (r.TonemapOverride.CPULUT), editor builds only as cooked textures do not keep it
+	TSharedPtr<const FTonemapOverrideCPUTexture3D> CPUTexture;
+};
+
+// LUT shader permutations selected by Compiled Operators, Compile Fast Math Variants and Compile Batched LUT Pass
+// Read from the config once at module startup (ConfigRestartRequired), so shader compilation on any thread sees the same value
+struct FTonemapOverrideCompiledPermutations
+{
+	// Bit per operator, all operators when Compiled Operators is empty
+	uint32 OperatorMask = (1u << uint32(ECustomTonemapOperator::MAX)) - 1;
+	bool bFastMathVariants = false;
+	bool bBatchedLUTPass = false;
+
+	FTonemapOverrideCompiledPermutations() = default;
+
+	// Settings section of the game config, readable before the settings object exists
+	static FTonemapOverrideCompiledPermutations LoadFromConfig();
+	static FTonemapOverrideCompiledPermutations FromKey(uint32 Key);
+
+	// ACES is always compiled
+	bool IsTonemapOperatorCompiled(ECustomTonemapOperator Operator) const;
+	bool IsFastMathVariantCompiled(ECustomTonemapOperator Operator) const;
+	bool IsBatchedLUTPassCompiled(ECustomTonemapOperator Operator) const;
+
+	// Set as a define of the LUT shaders, so that a change of the settings changes the shader key
+	uint32 GetKey() const;
+};
+
+// Copy of the plugin settings and the console variables the LUT generation reads
+// The render thread keeps one (GetRenderSettings), replaced only when something changes instead of reading the settings object every frame
+// Tools running on the game thread create their own from the settings object
+struct FTonemapOverrideRenderSettings
+{
+	bool bUseCustomTonemapper = false;
+
+	// Plugin settings or r.TonemapOverride.Operator
+	ECustomTonemapOperator CustomTonemapOperator = ECustomTonemapOperator::ACES;
+
+	FTonemapOverrideRenderTexture LUTTexture;
+	bool bLUTTexturePrecomposed = false;
+
+	FTonemapOverrideRenderTexture CustomLUTTexture;
+	ECustomLUTInputEncoding CustomLUTInput = ECustomLUTInputEncoding::EngineLog;
+	ECustomLUTOutputEncoding CustomLUTOutput = ECustomLUTOutputEncoding::sRGB;
+	FVector3f CustomLUTDomainMin = FVector3f::ZeroVector;
+	FVector3f CustomLUTDomainMax = FVector3f::OneVector;
+
+	float ReinhardWhitePoint = 0.0f;
+	float HejlWhitePoint = 0.0f;
+	EGT7UCSType UCSType = EGT7UCSType::ICtCp;
+	float GT7BlendRatio = 0.0f;
+	float GT7FadeStart = 0.0f;
+	float GT7FadeEnd = 0.0f;
+
+	// Selected preset resolved from the name
+	FTonemapOverrideFlimPreset FlimPreset;
+
+	float FastMathMaxDeltaE = 0.0f;
+
+	// r.TonemapOverride.FastMath, r.TonemapOverride.SeparableCurve and r.TonemapOverride.TetrahedralLUT
+	bool bFastMath = false;
+	bool bSeparableCurve = false;
+	bool bTetrahedralLUT = false;
+
+	// Copy of the shader settings, the render thread never reads the settings object
+	FTonemapOverrideCompiledPermutations CompiledPermutations;
+
+	// Bumped by every update, values derived from the render settings are rebuilt when it changes
+	uint32 Generation = 0;
+
+	FTonemapOverrideRenderSettings() = default;
+
+	// Game thread only, the textures count as loaded once they have a resource
+	explicit FTonemapOverrideRenderSettings(const UTonemapOverrideSettings& TonemapOverrideSettings);
+
+	// Texture read by the operator (Tony, Custom LUT), nullptr for operators without a texture
+	const FTonemapOverrideRenderTexture* GetOperatorLUTTexture(ECustomTonemapOperator Operator) const;
+};
+
+// Operator parameters of a UTonemapOverrideBlendable pushed to the blendable manager of the view
+// Copied as raw bytes and never destructed by the engine, so it only holds plain values, the texture is referenced by its id
+struct FTonemapOverrideBlendableData
+{
+	static FName GetFName()
+	{
+		static const FName Name(TEXT("TonemapOverrideBlendable"));
+		return Name;
+	}
+
+	// Weight of the volume times the weight of the blendable
+	float Weight = 0.0f;
+
+	bool bOverride_ReinhardWhitePoint = false;
+	bool bOverride_HejlWhitePoint = false;
+	bool bOverride_GT7BlendRatio = false;
+	bool bOverride_GT7FadeStart = false;
+	bool bOverride_GT7FadeEnd = false;
+	bool bOverride_LUTTexture = false;
+
+	float ReinhardWhitePoint = 0.0f;
+	float HejlWhitePoint = 0.0f;
+	float GT7BlendRatio = 0.0f;
+	float GT7FadeStart = 0.0f;
+	float GT7FadeEnd = 0.0f;
+
+	// Tony LUT, only set while the texture has a resource. The RHI texture is held by RegisterVolumeLUTTexture
+	uint32 LUTTextureId = 0;
+	bool bLUTTexturePrecomposed = false;
+};
+
+namespace TonemapOverride
+{
+	// Copy the settings object and the console variables to the render thread
+	// Called on the game thread when they change: settings edits, the console variable sink and LUT texture loads
+	void UpdateRenderSettings();
+
+	// Render thread copy of the settings
+	const FTonemapOverrideRenderSettings& GetRenderSettings();
+
+	// Keep a reference to the RHI texture of a post process volume LUT texture for the render thread, by its LUT texture id
+	// Game thread, called by the blendable every frame it is used so that a recreated resource is picked up
+	// Textures not used for a while are released, least recently used first
+	void RegisterVolumeLUTTexture(const UTexture* Texture);
+
+	// Gather the LUT inputs of the view into the snapshot, quantized with the configured tolerances
+	// The operator parameters of the TonemapOverride blendables in the post process volumes are blended over the render settings
+	// PreviousSnapshot is the snapshot of the LUT the view shows, quantized values within its bucket and the hysteresis band keep its value
+	void BuildLUTSnapshot(const FViewInfo& View, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot = nullptr);
+
+	// Same for a scene view, the pass type is left zero
+	void BuildLUTSnapshot(const FSceneView& View, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot = nullptr);
+
+	// Stock engine path, once our LUT is in the view state: reset the grading the engine LUT pass of this view reads to the defaults,
+	// so its settings cache keeps matching and it does not write over our LUT
+	// Only the view is changed, the family and its show flags are shared with the views that are not processed yet
+	void ResetEngineLUTSettings(FSceneView& View);
+
+	// View independent version for tools, the shader platform and pass type are left zero
+	void BuildLUTSnapshot(const FPostProcessSettings& Settings, const FTonemapperOutputDeviceParameters& OutputDeviceParameters, const FLinearColor& ColorScale, const FLinearColor& OverlayColor, int32 LUTSize, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTSnapshot& OutSnapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot = nullptr);
+
+	// Game thread tools, with the render settings created from the settings object
+	void BuildLUTSnapshot(const FPostProcessSettings& Settings, const FTonemapperOutputDeviceParameters& OutputDeviceParameters, const FLinearColor& ColorScale, const FLinearColor& OverlayColor, int32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideLUTSnapshot& OutSnapshot);
+
+	// Output device parameters the engine would use for a plain render target of the format
+	FTonemapperOutputDeviceParameters GetDefaultOutputDeviceParameters(EDisplayOutputFormat OutputDevice = EDisplayOutputFormat::SDR_sRGB, EDisplayColorGamut OutputGamut = EDisplayColorGamut::sRGB_D65);
+
+	// Flim preset stored in the snapshot, the default preset when the snapshot has none
+	FTonemapOverrideFlimPreset GetFlimPreset(const FTonemapOverrideLUTSnapshot& Snapshot);
+
+	// Stable id of the Tony LUT texture stored in the snapshot
+	uint32 GetLUTTextureId(const UTexture* Texture);
+
+	// Texture setting read by the operator (Tony, Custom LUT), nullptr for operators without a texture
+	const TSoftObjectPtr<UTexture>* GetOperatorLUTTexture(const UTonemapOverrideSettings& TonemapOverrideSettings, ECustomTonemapOperator Operator);
+
+	// Operator and its texture specific fields, LUTTextureId is 0 while the texture is not available
+	// The fast math and separable curve variants follow the operator and the console variables
+	// Tools use this to evaluate other operators than the configured one
+	void SetSnapshotOperator(ECustomTonemapOperator Operator, const FTonemapOverrideRenderSettings& RenderSettings, uint32 LUTTextureId, FTonemapOverrideLUTSnapshot& OutSnapshot);
+	void SetSnapshotOperator(ECustomTonemapOperator Operator, const UTonemapOverrideSettings& TonemapOverrideSettings, uint32 LUTTextureId, FTonemapOverrideLUTSnapshot& OutSnapshot);
+
+	ETonyLUTMode GetTonyLUTMode(const FTonemapOverrideLUTSnapshot& Snapshot);
+
+	// Expand the snapshot into shader parameters, only needed when the LUT is actually generated
+	void GetLUTShaderParameters(const FTonemapOverrideLUTSnapshot& Snapshot, const FTonemapOverrideRenderSettings& RenderSettings, FTonemapOverrideLUTParameters& OutParameters);
+}
@@ -0,0 +1,474 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverride.h"
+#include "TonemapOverrideSettings.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	double SrgbToLinear(double Value)
+	{
+		return Value <= 0.04045 ? Value / 12.92 : FMath::Pow((Value + 0.055) / 1.055, 2.4);
+	}
+
+	double LabF(double T)
+	{
+		const double Delta = 6.0 / 29.0;
+		return T > Delta * Delta * Delta ? FMath::Pow(T, 1.0 / 3.0) : T / (3.0 * Delta * Delta) + 4.0 / 29.0;
+	}
+
+	// Neutral coordinates through the SIMD path, the last batch is padded with the last coordinate
+	void EvaluateBatch(const FTonemapOverrideCPULUT& LUT, TConstArrayView<FVector3f> Neutral, TArrayView<FLinearColor> OutColors)
+	{
+		alignas(16) float InR[4], InG[4], InB[4], OutR[4], OutG[4], OutB[4];
+
+		for (int32 Index = 0; Index < Neutral.Num(); Index += 4)
+		{
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				const FVector3f& Coordinate = Neutral[FMath::Min(Index + Lane, Neutral.Num() - 1)];
+				InR[Lane] = Coordinate.X;
+				InG[Lane] = Coordinate.Y;
+				InB[Lane] = Coordinate.Z;
+			}
+
+			LUT.Evaluate4(InR, InG, InB, OutR, OutG, OutB);
+
+			for (int32 Lane = 0; Lane < 4 && Index + Lane < Neutral.Num(); ++Lane)
+			{
+				OutColors[Index + Lane] = FLinearColor(OutR[Lane], OutG[Lane], OutB[Lane], 0.0f);
+			}
+		}
+	}
+
+	// Canonical layout texels as a volume texture, sampled like the tonemapper samples the LUT
+	FTonemapOverrideCPUTexture3D MakeLUTTexture(TConstArrayView<FLinearColor> Texels, int32 LUTSize)
+	{
+		FTonemapOverrideCPUTexture3D Texture;
+		Texture.Size = FIntVector(LUTSize);
+		Texture.Texels.SetNumUninitialized(Texels.Num());
+		for (int32 Index = 0; Index < Texels.Num(); ++Index)
+		{
+			Texture.Texels[Index] = FVector3f(Texels[Index].R, Texels[Index].G, Texels[Index].B);
+		}
+		return Texture;
+	}
+
+	FVector3f SampleLUT(const FTonemapOverrideCPUTexture3D& Texture, const FVector3f& Neutral, bool bTetrahedral = false)
+	{
+		const float LUTSize = float(Texture.Size.X);
+		const FVector3f UVW = Neutral * ((LUTSize - 1.0f) / LUTSize) + FVector3f(0.5f / LUTSize);
+		return bTetrahedral ? Texture.SampleTetrahedral(UVW) : Texture.Sample(UVW);
+	}
+
+	// LUT sizes of the console arguments, the defaults when none is valid
+	TArray<int32> ParseLUTSizes(const TArray<FString>& Args, TArray<int32> DefaultSizes)
+	{
+		TArray<int32> LUTSizes;
+		for (const FString& Arg : Args)
+		{
+			const int32 LUTSize = FCString::Atoi(*Arg);
+			if (LUTSize >= 2 && LUTSize <= 256)
+			{
+				LUTSizes.AddUnique(LUTSize);
+			}
+		}
+		return LUTSizes.IsEmpty() ? MoveTemp(DefaultSizes) : LUTSizes;
+	}
+
+	// Jittered grid over the whole input cube, the same points for every operator and size
+	void GetTestPoints(TArray<FVector3f>& OutPoints)
+	{
+		const int32 GridSize = 32;
+		OutPoints.SetNumUninitialized(GridSize * GridSize * GridSize);
+
+		FRandomStream RandomStream(0x70E);
+		for (int32 Index = 0; Index < OutPoints.Num(); ++Index)
+		{
+			const FVector3f Cell(Index % GridSize, (Index / GridSize) % GridSize, Index / (GridSize * GridSize));
+			OutPoints[Index] = (Cell + FVector3f(RandomStream.FRand(), RandomStream.FRand(), RandomStream.FRand())) / float(GridSize);
+		}
+	}
+
+	// Directly evaluated operator at the test points
+	void EvaluateReferenceLab(const FTonemapOverrideCPULUT& LUT, const TArray<FVector3f>& TestPoints, TArray<FVector3d>& OutLab)
+	{
+		OutLab.SetNumUninitialized(TestPoints.Num());
+
+		ParallelFor(FMath::DivideAndRoundUp(TestPoints.Num(), 1024), [&](int32 Batch)
+		{
+			const int32 First = Batch * 1024;
+			const int32 Count = FMath::Min(1024, TestPoints.Num() - First);
+
+			TArray<FLinearColor> Colors;
+			Colors.SetNumUninitialized(Count);
+			EvaluateBatch(LUT, TConstArrayView<FVector3f>(TestPoints).Slice(First, Count), Colors);
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				OutLab[First + Index] = TonemapOverride::LUTOutputToLab(Colors[Index]);
+			}
+		});
+	}
+
+	// Operator snapshot with the tool defaults, the operator texture is loaded from the source data
+	void BuildOperatorSnapshot(ECustomTonemapOperator Operator, const UTonemapOverrideSettings& TonemapOverrideSettings, FTonemapOverrideCPUTexture3D& OutTexture, FTonemapOverrideLUTSnapshot& OutSnapshot)
+	{
+		if (const TSoftObjectPtr<UTexture>* OperatorTexturePtr = TonemapOverride::GetOperatorLUTTexture(TonemapOverrideSettings, Operator))
+		{
+			FTonemapOverrideCPUTexture3D::LoadFromTexture(OperatorTexturePtr->LoadSynchronous(), OutTexture);
+		}
+
+		TonemapOverride::BuildLUTSnapshot(FPostProcessSettings(), TonemapOverride::GetDefaultOutputDeviceParameters(), FLinearColor::White, FLinearColor::Transparent, 32, TonemapOverrideSettings, OutSnapshot);
+		TonemapOverride::SetSnapshotOperator(Operator, TonemapOverrideSettings, OutTexture.IsValid() ? 1 : 0, OutSnapshot);
+	}
+
+	// Max and mean of the finite errors
+	void SummarizeError(const TArray<double>& Errors, double& OutMax, double& OutMean)
+	{
+		OutMax = 0.0;
+		double Sum = 0.0;
+		int32 Count = 0;
+		for (const double Error : Errors)
+		{
+			if (FMath::IsFinite(Error))
+			{
+				OutMax = FMath::Max(OutMax, Error);
+				Sum += Error;
+				++Count;
+			}
+		}
+		OutMean = Count > 0 ? Sum / Count : 0.0;
+	}
+}
+
+float FTonemapOverrideLUTShaper::Apply(float Input) const
+{
+	const float Position = FMath::Clamp(Input, 0.0f, 1.0f) * float(Curve.Num() - 1);
+	const int32 Index = FMath::Min(int32(Position), Curve.Num() - 2);
+	return FMath::Lerp(Curve[Index], Curve[Index + 1], Position - float(Index));
+}
+
+float FTonemapOverrideLUTShaper::ApplyInverse(float Output) const
+{
+	const float Value = FMath::Clamp(Output, 0.0f, 1.0f);
+	const int32 Index = FMath::Clamp(Algo::UpperBound(Curve, Value) - 1, 0, Curve.Num() - 2);
+	const float Range = Curve[Index + 1] - Curve[Index];
+	const float Fraction = Range > 0.0f ? FMath::Clamp((Value - Curve[Index]) / Range, 0.0f, 1.0f) : 0.0f;
+	return (float(Index) + Fraction) / float(Curve.Num() - 1);
+}
+
+void FTonemapOverrideLUTShaper::GetLatticeCoordinates(int32 LUTSize, TArray<float>& OutCoordinates) const
+{
+	OutCoordinates.SetNumUninitialized(LUTSize);
+	for (int32 Index = 0; Index < LUTSize; ++Index)
+	{
+		OutCoordinates[Index] = IsValid() ? ApplyInverse(float(Index) / float(LUTSize - 1)) : float(Index) / float(LUTSize - 1);
+	}
+}
+
+FTonemapOverrideLUTShaper FTonemapOverrideLUTShaper::Fit(const FTonemapOverrideCPULUT& LUT, int32 NumEntries)
+{
+	check(NumEntries > 2);
+
+	// Gray, primary and secondary ramps cover both the tone curve and the gamut mapping of the operator
+	const FVector3f RampDirections[] =
+	{
+		FVector3f(1, 1, 1),
+		FVector3f(1, 0, 0), FVector3f(0, 1, 0), FVector3f(0, 0, 1),
+		FVector3f(0, 1, 1), FVector3f(1, 0, 1), FVector3f(1, 1, 0),
+	};
+
+	TArray<double> Slope;
+	Slope.SetNumZeroed(NumEntries);
+
+	TArray<FVector3f> Neutral;
+	TArray<FLinearColor> Colors;
+	TArray<FVector3d> Lab;
+	Neutral.SetNumUninitialized(NumEntries);
+	Colors.SetNumUninitialized(NumEntries);
+	Lab.SetNumUninitialized(NumEntries);
+
+	for (const FVector3f& Direction : RampDirections)
+	{
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			Neutral[Index] = Direction * (float(Index) / float(NumEntries - 1));
+		}
+
+		EvaluateBatch(LUT, Neutral, Colors);
+
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			Lab[Index] = TonemapOverride::LUTOutputToLab(Colors[Index]);
+		}
+
+		// Perceptual output change per input step, the largest of the ramps
+		for (int32 Index = 1; Index < NumEntries - 1; ++Index)
+		{
+			const double Difference = (Lab[Index + 1] - Lab[Index - 1]).Size();
+			Slope[Index] = FMath::Max(Slope[Index], FMath::IsFinite(Difference) ? Difference : 0.0);
+		}
+	}
+	Slope[0] = Slope[1];
+	Slope[NumEntries - 1] = Slope[NumEntries - 2];
+
+	// Lattice density follows the square root of the slope, so the flat black and clipped white ends of the log encoding
+	// give samples to the range the operator actually maps. Density is smoothed wide and mixed with uniform as the
+	// lookup interpolates in the shaped domain, where a quickly changing density would add error of its own
+	const int32 Radius = FMath::Max(NumEntries / 8, 1);
+	TArray<double> Density;
+	Density.SetNumUninitialized(NumEntries);
+	double DensitySum = 0.0;
+
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		double Sum = 0.0;
+		int32 Count = 0;
+		for (int32 Offset = -Radius; Offset <= Radius; ++Offset)
+		{
+			const int32 Neighbor = Index + Offset;
+			if (Neighbor >= 0 && Neighbor < NumEntries)
+			{
+				Sum += FMath::Sqrt(Slope[Neighbor]);
+				++Count;
+			}
+		}
+		Density[Index] = Sum / Count;
+		DensitySum += Density[Index];
+	}
+
+	const double UniformDensity = DensitySum > 0.0 ? 0.5 * DensitySum / NumEntries : 1.0;
+
+	FTonemapOverrideLUTShaper Shaper;
+	Shaper.Curve.SetNumUninitialized(NumEntries);
+
+	double Cumulative = 0.0;
+	TArray<double> CDF;
+	CDF.SetNumUninitialized(NumEntries);
+	CDF[0] = 0.0;
+	for (int32 Index = 1; Index < NumEntries; ++Index)
+	{
+		Cumulative += 0.5 * (Density[Index - 1] + Density[Index]) + UniformDensity;
+		CDF[Index] = Cumulative;
+	}
+
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		Shaper.Curve[Index] = float(CDF[Index] / Cumulative);
+	}
+	Shaper.Curve[NumEntries - 1] = 1.0f;
+
+	return Shaper;
+}
+
+FVector3d TonemapOverride::LUTOutputToLab(const FLinearColor& Output)
+{
+	const FVector3d Linear(
+		SrgbToLinear(FMath::Max(Output.R * 1.05, 0.0)),
+		SrgbToLinear(FMath::Max(Output.G * 1.05, 0.0)),
+		SrgbToLinear(FMath::Max(Output.B * 1.05, 0.0)));
+
+	return LinearSRGBToLab(Linear);
+}
+
+FVector3d TonemapOverride::LinearSRGBToLab(const FVector3d& Linear)
+{
+	// Linear sRGB to XYZ, relative to the D65 white
+	const double X = (0.4123908 * Linear.X + 0.3575843 * Linear.Y + 0.1804808 * Linear.Z) / 0.95047;
+	const double Y = 0.2126390 * Linear.X + 0.7151687 * Linear.Y + 0.0721923 * Linear.Z;
+	const double Z = (0.0193308 * Linear.X + 0.1191948 * Linear.Y + 0.9505322 * Linear.Z) / 1.08883;
+
+	const double FX = LabF(X);
+	const double FY = LabF(Y);
+	const double FZ = LabF(Z);
+
+	return FVector3d(116.0 * FY - 16.0, 500.0 * (FX - FY), 200.0 * (FY - FZ));
+}
+
+double TonemapOverride::DeltaE2000(const FVector3d& Lab1, const FVector3d& Lab2)
+{
+	// Sharma, Wu, Dalal: The CIEDE2000 Color-Difference Formula
+	const double C1 = FMath::Sqrt(Lab1.Y * Lab1.Y + Lab1.Z * Lab1.Z);
+	const double C2 = FMath::Sqrt(Lab2.Y * Lab2.Y + Lab2.Z * Lab2.Z);
+	const double CMean7 = FMath::Pow(0.5 * (C1 + C2), 7.0);
+	const double G = 0.5 * (1.0 - FMath::Sqrt(CMean7 / (CMean7 + 6103515625.0)));
+
+	const double A1 = (1.0 + G) * Lab1.Y;
+	const double A2 = (1.0 + G) * Lab2.Y;
+	const double CP1 = FMath::Sqrt(A1 * A1 + Lab1.Z * Lab1.Z);
+	const double CP2 = FMath::Sqrt(A2 * A2 + Lab2.Z * Lab2.Z);
+
+	auto Hue = [](double B, double A)
+	{
+		if (A == 0.0 && B == 0.0)
+		{
+			return 0.0;
+		}
+		const double H = FMath::RadiansToDegrees(FMath::Atan2(B, A));
+		return H < 0.0 ? H + 360.0 : H;
+	};
+	const double HP1 = Hue(Lab1.Z, A1);
+	const double HP2 = Hue(Lab2.Z, A2);
+
+	const double DeltaL = Lab2.X - Lab1.X;
+	const double DeltaC = CP2 - CP1;
+
+	double DeltaHue = 0.0;
+	if (CP1 * CP2 != 0.0)
+	{
+		DeltaHue = HP2 - HP1;
+		DeltaHue += DeltaHue > 180.0 ? -360.0 : (DeltaHue < -180.0 ? 360.0 : 0.0);
+	}
+	const double DeltaH = 2.0 * FMath::Sqrt(CP1 * CP2) * FMath::Sin(FMath::DegreesToRadians(DeltaHue * 0.5));
+
+	const double LMean = 0.5 * (Lab1.X + Lab2.X);
+	const double CPMean = 0.5 * (CP1 + CP2);
+
+	double HMean = HP1 + HP2;
+	if (CP1 * CP2 != 0.0)
+	{
+		HMean = FMath::Abs(HP1 - HP2) <= 180.0 ? 0.5 * HMean : (HMean < 360.0 ? 0.5 * (HMean + 360.0) : 0.5 * (HMean - 360.0));
+	}
+
+	const double T = 1.0
+		- 0.17 * FMath::Cos(FMath::DegreesToRadians(HMean - 30.0))
+		+ 0.24 * FMath::Cos(FMath::DegreesToRadians(2.0 * HMean))
+		+ 0.32 * FMath::Cos(FMath::DegreesToRadians(3.0 * HMean + 6.0))
+		- 0.20 * FMath::Cos(FMath::DegreesToRadians(4.0 * HMean - 63.0));
+
+	const double LMean50 = (LMean - 50.0) * (LMean - 50.0);
+	const double SL = 1.0 + 0.015 * LMean50 / FMath::Sqrt(20.0 + LMean50);
+	const double SC = 1.0 + 0.045 * CPMean;
+	const double SH = 1.0 + 0.015 * CPMean * T;
+
+	const double CPMean7 = FMath::Pow(CPMean, 7.0);
+	const double DeltaTheta = 30.0 * FMath::Exp(-FMath::Square((HMean - 275.0) / 25.0));
+	const double RT = -2.0 * FMath::Sqrt(CPMean7 / (CPMean7 + 6103515625.0)) * FMath::Sin(FMath::DegreesToRadians(2.0 * DeltaTheta));
+
+	const double L = DeltaL / SL;
+	const double C = DeltaC / SC;
+	const double H = DeltaH / SH;
+
+	return FMath::Sqrt(L * L + C * C + H * H + RT * C * H);
+}
+
+void TonemapOverride::MeasureLUTError(const FTonemapOverrideCPULUT& LUT, int32 LUTSize, const FTonemapOverrideLUTShaper* Shaper, double& OutMaxDeltaE, double& OutMeanDeltaE, bool bTetrahedral)
+{
+	TArray<FVector3f> TestPoints;
+	GetTestPoints(TestPoints);
+
+	TArray<FVector3d> ReferenceLab;
+	EvaluateReferenceLab(LUT, TestPoints, ReferenceLab);
+
+	TArray<FLinearColor> Texels;
+	if (Shaper)
+	{
+		TArray<float> LatticeCoordinates;
+		Shaper->GetLatticeCoordinates(LUTSize, LatticeCoordinates);
+		LUT.GenerateAt(LatticeCoordinates, Texels);
+	}
+	else
+	{
+		LUT.Generate(LUTSize, Texels);
+	}
+	const FTonemapOverrideCPUTexture3D LUTTexture = MakeLUTTexture(Texels, LUTSize);
+
+	TArray<double> Errors;
+	Errors.SetNumUninitialized(TestPoints.Num());
+
+	ParallelFor(TestPoints.Num(), [&](int32 Index)
+	{
+		const FVector3f& Point = TestPoints[Index];
+		const FVector3f LookupPoint = Shaper ? FVector3f(Shaper->Apply(Point.X), Shaper->Apply(Point.Y), Shaper->Apply(Point.Z)) : Point;
+		const FVector3f Value = SampleLUT(LUTTexture, LookupPoint, bTetrahedral);
+
+		Errors[Index] = TonemapOverride::DeltaE2000(ReferenceLab[Index], TonemapOverride::LUTOutputToLab(FLinearColor(Value.X, Value.Y, Value.Z)));
+	}, EParallelForFlags::Unbalanced);
+
+	SummarizeError(Errors, OutMaxDeltaE, OutMeanDeltaE);
+}
+
+// Interpolation error of uniform and shaped LUTs against the directly evaluated operator, sRGB output
+
+static void ReportShaperError(const TArray<FString>& Args)
+{
+	const TArray<int32> LUTSizes = ParseLUTSizes(Args, { 17, 32, 33, 64, 65 });
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		FTonemapOverrideCPUTexture3D OperatorTexture;
+		FTonemapOverrideLUTSnapshot Snapshot;
+		BuildOperatorSnapshot(ECustomTonemapOperator(Operator), TonemapOverrideSettings, OperatorTexture, Snapshot);
+
+		const FTonemapOverrideCPULUT CPULUT(Snapshot, &OperatorTexture);
+		const FTonemapOverrideLUTShaper Shaper = FTonemapOverrideLUTShaper::Fit(CPULUT);
+
+		for (const int32 LUTSize : LUTSizes)
+		{
+			double UniformMax, UniformMean, ShapedMax, ShapedMean;
+			TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, UniformMax, UniformMean);
+			TonemapOverride::MeasureLUTError(CPULUT, LUTSize, &Shaper, ShapedMax, ShapedMean);
+
+			UE_LOG(TonemapOverrideLog, Display, TEXT("%-12s %3d^3: uniform dE2000 max %6.3f mean %6.4f, shaped max %6.3f mean %6.4f"),
+				*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator), LUTSize, UniformMax, UniformMean, ShapedMax, ShapedMean);
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideShaperReport(
+	TEXT("r.TonemapOverride.CPU.ShaperReport"),
+	TEXT("Report max and mean CIEDE2000 of uniform and shaped LUTs against the directly evaluated operator for every operator. Optional LUT sizes (17 32 33 64 65)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ReportShaperError));
+
+// Interpolation error of trilinear and tetrahedral lookups of the uniform LUT against the directly evaluated operator
+// Memory is the engine volume LUT (10:10:10:2, 4 bytes per texel), to pick the smallest r.LUT.Size per operator
+
+static void ReportInterpolationError(const TArray<FString>& Args)
+{
+	const TArray<int32> LUTSizes = ParseLUTSizes(Args, { 17, 33, 48, 65 });
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	for (int32 Operator = 0; Operator < int32(ECustomTonemapOperator::MAX); ++Operator)
+	{
+		if (!FTonemapOverrideCPULUT::IsOperatorSupported(ECustomTonemapOperator(Operator)))
+		{
+			continue;
+		}
+
+		FTonemapOverrideCPUTexture3D OperatorTexture;
+		FTonemapOverrideLUTSnapshot Snapshot;
+		BuildOperatorSnapshot(ECustomTonemapOperator(Operator), TonemapOverrideSettings, OperatorTexture, Snapshot);
+
+		const FTonemapOverrideCPULUT CPULUT(Snapshot, &OperatorTexture);
+
+		for (const int32 LUTSize : LUTSizes)
+		{
+			double TrilinearMax, TrilinearMean, TetrahedralMax, TetrahedralMean;
+			TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, TrilinearMax, TrilinearMean);
+			TonemapOverride::MeasureLUTError(CPULUT, LUTSize, nullptr, TetrahedralMax, TetrahedralMean, true);
+
+			const double MemoryKB = double(LUTSize) * LUTSize * LUTSize * 4.0 / 1024.0;
+
+			UE_LOG(TonemapOverrideLog, Display, TEXT("%-12s %3d^3 (%6.1f KB): trilinear dE2000 max %6.3f mean %6.4f, tetrahedral max %6.3f mean %6.4f"),
+				*StaticEnum<ECustomTonemapOperator>()->GetNameStringByValue(Operator), LUTSize, MemoryKB, TrilinearMax, TrilinearMean, TetrahedralMax, TetrahedralMean);
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdTonemapOverrideInterpolationReport(
+	TEXT("r.TonemapOverride.CPU.InterpolationReport"),
+	TEXT("Report max and mean CIEDE2000 of trilinear and tetrahedral LUT lookups against the directly evaluated operator for every operator, with the LUT memory. Optional LUT sizes (17 33 48 65)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ReportInterpolationError));
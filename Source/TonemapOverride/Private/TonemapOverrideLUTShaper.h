@@ -0,0 +1,44 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FTonemapOverrideCPULUT;
+
+// 1D pre-curve in front of the 3D LUT that moves the lattice where the operator output changes the most
+// The curve is applied to each channel of the LUT input (engine log encoding of the scene color)
+// Export only: the engine tonemapper samples the runtime LUT with its own encoding and has no place for the curve
+struct FTonemapOverrideLUTShaper
+{
+	// Shaper output at uniform steps of the input 0..1, monotonic from 0 to 1
+	TArray<float> Curve;
+
+	bool IsValid() const { return Curve.Num() > 1; }
+
+	float Apply(float Input) const;
+	float ApplyInverse(float Output) const;
+
+	// Neutral LUT coordinates of a shaped lattice, the inverse curve at uniform steps
+	void GetLatticeCoordinates(int32 LUTSize, TArray<float>& OutCoordinates) const;
+
+	// Fitted to the perceptual output change along the gray and primary / secondary ramps
+	static FTonemapOverrideLUTShaper Fit(const FTonemapOverrideCPULUT& LUT, int32 NumEntries = 1024);
+};
+
+namespace TonemapOverride
+{
+	// CIELAB (D65) of an sRGB encoded LUT output, the 1.05 tonemapper scale is applied here
+	FVector3d LUTOutputToLab(const FLinearColor& Output);
+
+	// CIELAB (D65) of a linear sRGB color, 1.0 is the diffuse white
+	FVector3d LinearSRGBToLab(const FVector3d& Linear);
+
+	// CIEDE2000 color difference
+	double DeltaE2000(const FVector3d& Lab1, const FVector3d& Lab2);
+
+	// Max and mean CIEDE2000 of a LUTSize^3 LUT against the directly evaluated operator at jittered points over the whole
+	// input cube, sRGB output. With a shaper the lattice and the lookup go through the curve, bTetrahedral interpolates
+	// the lookup like r.TonemapOverride.TetrahedralLUT instead of trilinearly
+	void MeasureLUTError(const FTonemapOverrideCPULUT& LUT, int32 LUTSize, const FTonemapOverrideLUTShaper* Shaper, double& OutMaxDeltaE, double& OutMeanDeltaE, bool bTetrahedral = false);
+}
@@ -9,9 +9,16 @@
 #include "ScenePrivate.h"
 #include "NUTUtil.h"
 #include "TonemapOverride.h"
-#include "HDRHelper.h"
-#include "PixelShaderUtils.h"
-#include "PostProcess/DrawRectangle.h"
+#include "TonemapOverrideLUTCache.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverrideLUTRendering.h"
+#include "TonemapOverrideLUTBake.h"
+#include "TonemapOverrideBakedLUTs.h"
+#include "TonemapOverrideStats.h"
+#include "TonemapOverrideCPU.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RHIGPUReadback.h"
+#include "Tasks/Task.h"
 
 
 IMPLEMENT_GET_PRIVATE_VAR(FSceneView, EyeAdaptationViewState, FSceneViewStateInterface*);
@@ -19,474 +26,719 @@ IMPLEMENT_GET_PRIVATE_VAR(FSceneViewState, CombinedLUTRenderTarget, TRefCountPtr
 // With current setup we visit the TonemappingLUT
 IMPLEMENT_GET_PRIVATE_VAR(FSceneViewState, bValidTonemappingLUT, bool);
 
-class FTonemapOverrideShaderCommon : public FGlobalShader
+static TAutoConsoleVariable<int32> CVarTonemapOverrideBakeUse(
+	TEXT("r.TonemapOverride.Bake.Use"),
+	1,
+	TEXT("Use pre-baked LUTs from the Baked LUTs asset when the settings match, instead of generating the LUT."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideAsyncCompute(
+	TEXT("r.TonemapOverride.AsyncCompute"),
+	0,
+	TEXT("Generate changed LUTs on the async compute queue at the start of the frame instead of right before tonemapping.\n")
+	TEXT("Views keep their previous LUT until the new one is ready on the next frame, so grading changes show up one frame late."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideTimeSliceTexelBudget(
+	TEXT("r.TonemapOverride.TimeSlice.TexelBudget"),
+	0,
+	TEXT("Number of LUT texels generated per frame and view when the grading changes, rounded to whole blue slices. 0 generates the whole LUT at once.\n")
+	TEXT("Views keep their previous LUT until the new one is complete, which keeps the cost flat during animated grading. Requires the compute pass (r.LUT.UpdateEveryFrame 0) and overrides r.TonemapOverride.AsyncCompute."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideBatchedLUT(
+	TEXT("r.TonemapOverride.BatchedLUT"),
+	0,
+	TEXT("Generate the changed LUTs of all views at the start of the frame, LUTs with the same operator permutation and output device in one dispatch (split-screen, side by side viewports).\n")
+	TEXT("Requires Compile Batched LUT Pass in the plugin settings and the compute pass (r.LUT.UpdateEveryFrame 0). Combines with r.TonemapOverride.AsyncCompute, time sliced LUTs are not batched."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideStagedLUT(
+	TEXT("r.TonemapOverride.StagedLUT"),
+	0,
+	TEXT("While only ColorScale, OverlayColor (fades), gamma or the output gamut of a view change, generate its LUT in two compute passes and keep the operator stage (grading and the operator) in a float texture per view, so only the cheap output stage runs again.\n")
+	TEXT("The float texture counts against r.TonemapOverride.LUTCache.BudgetMB and is released with the next other change. Requires the compute pass (r.LUT.UpdateEveryFrame 0), batched and time sliced LUTs are generated in one pass."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarTonemapOverrideCPULUT(
+	TEXT("r.TonemapOverride.CPULUT"),
+	1,
+	TEXT("Evaluate LUTs on worker threads and upload them instead of generating them on the GPU, for every operator but ACES. Tony McMapface and Custom LUT need the source data of their texture, which only editor builds keep.\n")
+	TEXT("Views keep their previous LUT until the upload. The first LUT of a view and of a changed LUT size is started before the frame is rendered and generated on the GPU when the workers are not done by the LUT pass. Works with either LUT pass and layout."),
+	ECVF_RenderThreadSafe);
+
+#if ENGINE_VERSION_CUSTOM != true
+static TAutoConsoleVariable<int32> CVarTonemapOverrideVerifyViewStateLUT(
+	TEXT("r.TonemapOverride.VerifyViewStateLUT"),
+	0,
+	TEXT("Read the view state LUT back after the tonemapper and compare it with the LUT copied into it. Frames where the engine LUT pass wrote it are counted in stat TonemapOverride as Engine LUT passes detected, and logged when the copy was skipped on that frame. For verifying the engine version, not for shipping."),
+	ECVF_RenderThreadSafe);
+#endif
+
+// LUT of a view evaluated on worker threads (r.TonemapOverride.CPULUT)
+struct FTonemapOverrideCPULUTJob
 {
-public:
-	static const int32 GroupSize = 8;
-	
-	static bool PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(EShaderPlatform Platform)
+	FTonemapOverrideLUTSnapshot Snapshot;
+	EPixelFormat Format = PF_Unknown;
+	int32 TextureLUTSize = 0;
+	// Texel data in the LUT format and canonical layout, uploaded into either layout
+	UE::Tasks::TTask<TArray<uint8>> Task;
+};
+
+// The CPU evaluation mirrors the custom operators, ACES goes through the engine implementation. Texture operators are
+// evaluated when the source data of the texture in the render settings was read, textures of post process volumes are not
+static bool IsCPULUTSupported(const FTonemapOverrideLUTSnapshot& Snapshot, const EPixelFormat Format, TSharedPtr<const FTonemapOverrideCPUTexture3D>* OutLUTTexture = nullptr)
+{
+	const ECustomTonemapOperator TonemapOperator = ECustomTonemapOperator(Snapshot.TonemapOperator);
+	if (CVarTonemapOverrideCPULUT.GetValueOnRenderThread() <= 0 || !FTonemapOverrideCPULUT::IsOperatorSupported(TonemapOperator)
+		|| (Format != PF_A2B10G10R10 && Format != PF_FloatRGBA))
 	{
-		return RHIVolumeTextureRenderingSupportGuaranteed(Platform) && (RHISupportsGeometryShaders(Platform) || RHISupportsVertexShaderLayer(Platform));
+		return false;
 	}
-	
-	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+
+	// Operator fallback
+	if (Snapshot.LUTTextureId == 0)
 	{
-		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
-		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), GroupSize);
+		return true;
+	}
 
-		const int UseVolumeLUT = PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(Parameters.Platform) ? 1 : 0;
-		OutEnvironment.SetDefine(TEXT("USE_VOLUME_LUT"), UseVolumeLUT);
+	const FTonemapOverrideRenderTexture* OperatorTexture = TonemapOverride::GetRenderSettings().GetOperatorLUTTexture(TonemapOperator);
+	if (!OperatorTexture || OperatorTexture->Id != Snapshot.LUTTextureId || !OperatorTexture->CPUTexture)
+	{
+		return false;
 	}
 
-	class FTonemapOperator : SHADER_PERMUTATION_ENUM_CLASS("TONEMAP_OPERATOR", ECustomTonemapOperator);
-	class FOutputDeviceSRGB : SHADER_PERMUTATION_BOOL("OUTPUT_DEVICE_SRGB");
-	class FSkipTemperature : SHADER_PERMUTATION_BOOL("SKIP_TEMPERATURE");
-	class FGT7UCSType : SHADER_PERMUTATION_ENUM_CLASS("TONE_MAPPING_UCSTYPE", EGT7UCSType);
-	using FPermutationDomain = TShaderPermutationDomain<FOutputDeviceSRGB, FTonemapOperator, FSkipTemperature, FGT7UCSType>;
-	
-	FTonemapOverrideShaderCommon() {}
-	
-	FTonemapOverrideShaderCommon(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FGlobalShader(Initializer)
-	{ }
-};
+	if (OutLUTTexture)
+	{
+		*OutLUTTexture = OperatorTexture->CPUTexture;
+	}
+	return true;
+}
 
-// Custom parameters implemented outside native Engine tonemapping/color grading
-BEGIN_SHADER_PARAMETER_STRUCT(FCustomTonemapperParameters, )
-	SHADER_PARAMETER(int32, TonemapOperator)
-	SHADER_PARAMETER(float, ReinhardWhitePoint)
-	SHADER_PARAMETER_TEXTURE(Texture3D<float>, LUTTexture)
-	SHADER_PARAMETER_SAMPLER(SamplerState, LUTTextureSampler)
-	SHADER_PARAMETER(float, HejlWhitePoint)
-	SHADER_PARAMETER(float, GT7BlendRatio)
-	SHADER_PARAMETER(float, GT7FadeStart)
-	SHADER_PARAMETER(float, GT7FadeEnd)
-	SHADER_PARAMETER(int32, EGT7UCSType)
-END_SHADER_PARAMETER_STRUCT()
-
-// Need to bind all parameters for Full ACES Tonemapping & Color Grading for full implementation
-// When doing just custom, can limit these to the required 
-BEGIN_SHADER_PARAMETER_STRUCT(FACESTonemapShaderParameters, )
-	SHADER_PARAMETER(FVector4f, ACESMinMaxData)
-	SHADER_PARAMETER(FVector4f, ACESMidData)
-	SHADER_PARAMETER(FVector4f, ACESCoefsLow_0)
-	SHADER_PARAMETER(FVector4f, ACESCoefsHigh_0)
-	SHADER_PARAMETER(float, ACESCoefsLow_4)
-	SHADER_PARAMETER(float, ACESCoefsHigh_4)
-	SHADER_PARAMETER(float, ACESSceneColorMultiplier)
-	SHADER_PARAMETER(float, ACESGamutCompression)
-END_SHADER_PARAMETER_STRUCT()
-
-BEGIN_SHADER_PARAMETER_STRUCT(FTonemapOverrideLUTParameters, )
-	// Tonemap parameters
-	SHADER_PARAMETER_STRUCT_REF(FWorkingColorSpaceShaderParameters, WorkingColorSpace)
-	SHADER_PARAMETER_STRUCT_INCLUDE(FACESTonemapShaderParameters, ACESTonemapParameters)
-	SHADER_PARAMETER(float, LUTSize)
-	SHADER_PARAMETER(FVector4f, OverlayColor)
-	SHADER_PARAMETER(FVector3f, ColorScale)
-	SHADER_PARAMETER(FVector4f, ColorSaturation)
-	SHADER_PARAMETER(FVector4f, ColorContrast)
-	SHADER_PARAMETER(FVector4f, ColorGamma)
-	SHADER_PARAMETER(FVector4f, ColorGain)
-	SHADER_PARAMETER(FVector4f, ColorOffset)
-	SHADER_PARAMETER(FVector4f, ColorSaturationShadows)
-	SHADER_PARAMETER(FVector4f, ColorContrastShadows)
-	SHADER_PARAMETER(FVector4f, ColorGammaShadows)
-	SHADER_PARAMETER(FVector4f, ColorGainShadows)
-	SHADER_PARAMETER(FVector4f, ColorOffsetShadows)
-	SHADER_PARAMETER(FVector4f, ColorSaturationMidtones)
-	SHADER_PARAMETER(FVector4f, ColorContrastMidtones)
-	SHADER_PARAMETER(FVector4f, ColorGammaMidtones)
-	SHADER_PARAMETER(FVector4f, ColorGainMidtones)
-	SHADER_PARAMETER(FVector4f, ColorOffsetMidtones)
-	SHADER_PARAMETER(FVector4f, ColorSaturationHighlights)
-	SHADER_PARAMETER(FVector4f, ColorContrastHighlights)
-	SHADER_PARAMETER(FVector4f, ColorGammaHighlights)
-	SHADER_PARAMETER(FVector4f, ColorGainHighlights)
-	SHADER_PARAMETER(FVector4f, ColorOffsetHighlights)
-	SHADER_PARAMETER(float, ColorCorrectionShadowsMax)
-	SHADER_PARAMETER(float, ColorCorrectionHighlightsMin)
-	SHADER_PARAMETER(float, ColorCorrectionHighlightsMax)
-	SHADER_PARAMETER(float, WhiteTemp)
-	SHADER_PARAMETER(float, WhiteTint)
-	SHADER_PARAMETER(float, BlueCorrection)
-	SHADER_PARAMETER(float, ExpandGamut)
-	SHADER_PARAMETER(float, ToneCurveAmount)
-	SHADER_PARAMETER(float, FilmSlope)
-	SHADER_PARAMETER(float, FilmToe)
-	SHADER_PARAMETER(float, FilmShoulder)
-	SHADER_PARAMETER(float, FilmBlackClip)
-	SHADER_PARAMETER(float, FilmWhiteClip)
-	SHADER_PARAMETER(uint32, bIsTemperatureWhiteBalance)
-	SHADER_PARAMETER(FVector3f, MappingPolynomial)
-	SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapperOutputDeviceParameters, OutputDevice)
-	SHADER_PARAMETER_STRUCT_INCLUDE(FCustomTonemapperParameters, CustomTonemapperParameters)
-END_SHADER_PARAMETER_STRUCT()
-
-#define UPDATE_CACHE_SETTINGS(DestParameters, ParamValue, bOutHasChanged) \
-if(DestParameters != (ParamValue)) \
-{ \
-	DestParameters = (ParamValue); \
-	bOutHasChanged = true; \
+// LUT format of the engine LUT pass, float for the HDR scene capture sources and 8 bit where 10 bit is not supported
+static EPixelFormat GetEngineLUTFormat(const FSceneViewFamily& ViewFamily)
+{
+	const bool bUseFloatOutput = ViewFamily.SceneCaptureSource == SCS_FinalColorHDR || ViewFamily.SceneCaptureSource == SCS_FinalToneCurveHDR;
+	const EPixelFormat Format = bUseFloatOutput ? PF_FloatRGBA : PF_A2B10G10R10;
+	return GPixelFormats[Format].Supported ? Format : PF_R8G8B8A8;
 }
 
-struct FCachedLUTSettings
+// Slices generated per frame by the time sliced generation, 0 if the LUT is generated at once
+static int32 GetTimeSliceNumSlices(const int32 TextureLUTSize)
 {
-	uint32 UniqueID = 0;
-	EShaderPlatform ShaderPlatform = GMaxRHIShaderPlatform;
-	FTonemapOverrideLUTParameters Parameters;
-	FWorkingColorSpaceShaderParameters WorkingColorSpaceShaderParameters;
-	bool bUseCompute = false;
-	ECustomTonemapOperator CachedTonemapOperator;
-	EGT7UCSType CachedGT7UCSType;
-	
-	bool UpdateCachedValues(const FViewInfo& View, uint32 LUTSize, const UTonemapOverrideSettings& TonemapOverrideSettings)
-	{
-		bool bHasChanged = false;
-		GetCombineLUTParameters(View, LUTSize, bHasChanged);
-		GetCustomLUTParameters(TonemapOverrideSettings, bHasChanged);
-		UPDATE_CACHE_SETTINGS(UniqueID, View.State ? View.State->GetViewKey() : 0, bHasChanged);
-		UPDATE_CACHE_SETTINGS(ShaderPlatform, View.GetShaderPlatform(), bHasChanged);
-		UPDATE_CACHE_SETTINGS(bUseCompute, View.bUseComputePasses, bHasChanged);
-		UPDATE_CACHE_SETTINGS(CachedTonemapOperator,TonemapOverrideSettings.CustomTonemapOperator, bHasChanged);
-		UPDATE_CACHE_SETTINGS(CachedGT7UCSType,TonemapOverrideSettings.UCSType, bHasChanged);
-		
-		const FWorkingColorSpaceShaderParameters* InWorkingColorSpaceShaderParameters = reinterpret_cast<const FWorkingColorSpaceShaderParameters*>(GDefaultWorkingColorSpaceUniformBuffer.GetContents());
-		if (InWorkingColorSpaceShaderParameters)
+	const int32 TexelBudget = CVarTonemapOverrideTimeSliceTexelBudget.GetValueOnRenderThread();
+	if (TexelBudget <= 0)
+	{
+		return 0;
+	}
+
+	const int32 NumSlices = FMath::Max(TexelBudget / (TextureLUTSize * TextureLUTSize), 1);
+	return NumSlices < TextureLUTSize ? NumSlices : 0;
+}
+
+FTonemapOverrideSceneViewExtension::FTonemapOverrideSceneViewExtension(const FAutoRegister& AutoRegister, const UTonemapOverrideBakedLUTs* InBakedLUTs) : FSceneViewExtensionBase(AutoRegister), BakedLUTs(InBakedLUTs)
+{
+	UE_LOG(TonemapOverrideLog, Log, TEXT("Tonemap SceneViewExtension registered"));
+
+	// Tony LUT texture is loaded asynchronously by the engine subsystem
+	LUTCache = MakeUnique<FTonemapOverrideLUTCache>();
+}
+
+FTonemapOverrideSceneViewExtension::~FTonemapOverrideSceneViewExtension()
+{
+	// Pooled render targets need to be released on the render thread
+	ENQUEUE_RENDER_COMMAND(ReleaseTonemapOverrideLUTCache)(
+		[LUTCache = MoveTemp(LUTCache)](FRHICommandListImmediate& RHICmdList) mutable
 		{
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToXYZ, InWorkingColorSpaceShaderParameters->ToXYZ, bHasChanged);
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.FromXYZ, InWorkingColorSpaceShaderParameters->FromXYZ, bHasChanged);
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToAP1, InWorkingColorSpaceShaderParameters->ToAP1, bHasChanged);
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.FromAP1, InWorkingColorSpaceShaderParameters->FromAP1, bHasChanged);
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.ToAP0, InWorkingColorSpaceShaderParameters->ToAP0, bHasChanged);
-			UPDATE_CACHE_SETTINGS(WorkingColorSpaceShaderParameters.bIsSRGB, InWorkingColorSpaceShaderParameters->bIsSRGB, bHasChanged);
+			LUTCache.Reset();
+		});
+}
+
+#if ENGINE_VERSION_CUSTOM == true
+void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessCombineLUTPass(const FSceneView& InView, FTonemapLUTCallbackDelegateArray& LUTPassCallbacks)
+{
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+
+	if (bCachedOverride != RenderSettings.bUseCustomTonemapper)
+	{
+		UE_LOG(TonemapOverrideLog, Warning, TEXT("Manually refresh postprocess settings"));
+		bCachedOverride = RenderSettings.bUseCustomTonemapper;
+	}
+
+	if (RenderSettings.bUseCustomTonemapper)
+	{
+		LUTPassCallbacks.Add(FTonemapLUTCallbackDelegate::CreateRaw(this, &FTonemapOverrideSceneViewExtension::CreateOverrideLUT_RenderThread));
+	}
+}
+#else
+
+#if UE_VERSION_OLDER_THAN(5, 5, 0)
+void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass PassId, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
+#else
+void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass PassId, const FSceneView& InView, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
+#endif
+{
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+
+	if (RenderSettings.bUseCustomTonemapper)
+	{
+		if (PassId == EPostProcessingPass::MotionBlur)
+		{
+			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FTonemapOverrideSceneViewExtension::CreateOverrideLUT));
 		}
+		else if (PassId == EPostProcessingPass::Tonemap && CVarTonemapOverrideVerifyViewStateLUT.GetValueOnRenderThread() > 0)
+		{
+			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FTonemapOverrideSceneViewExtension::VerifyViewStateLUT));
+		}
+	}
 
-		return bHasChanged;
+}
+#endif
+
+void FTonemapOverrideSceneViewExtension::PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily)
+{
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+	static const auto CVarUpdateEveryFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.UpdateEveryFrame"));
+
+	const bool bAsyncCompute = CVarTonemapOverrideAsyncCompute.GetValueOnRenderThread() > 0 && GSupportsEfficientAsyncCompute;
+	const bool bBatched = CVarTonemapOverrideBatchedLUT.GetValueOnRenderThread() > 0;
+
+	if (!RenderSettings.bUseCustomTonemapper || CVarUpdateEveryFrame->GetInt() > 0)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("TonemapOverride::PreRenderViewFamily", TonemapOverrideChannel);
+
+	LaunchFirstCPULUTs(InViewFamily);
+
+	if (!(bAsyncCompute || bBatched) || CVarTonemapOverrideTimeSliceTexelBudget.GetValueOnRenderThread() > 0)
+	{
+		return;
 	}
 
-	FVector3f GetMappingPolynomial()
+	const uint32 FrameNumber = InViewFamily.FrameNumber;
+
+	// LUTs left for the batched passes, grouped by the batch key and the texture description
+	struct FBatchedLUT
+	{
+		const FViewInfo* View = nullptr;
+		const FViewLUT* ViewLUT = nullptr;
+		FTonemapOverrideLUTSnapshot Snapshot;
+		FRDGTextureRef Texture = nullptr;
+		uint64 EntryKey = 0;
+	};
+	TArray<FBatchedLUT, TInlineAllocator<TonemapOverride::MaxBatchedLUTs>> BatchedLUTs;
+	TMap<uint64, TArray<int32, TInlineAllocator<TonemapOverride::MaxBatchedLUTs>>> BatchGroups;
+
+	for (const FSceneView* SceneView : InViewFamily.Views)
 	{
-		static const auto CVarMinValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Min"));
-		static const auto CVarMidValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Mid"));
-		static const auto CVarMaxValue = IConsoleManager::Get().FindConsoleVariable(TEXT("r.Color.Max"));
+		const FViewInfo& View = static_cast<const FViewInfo&>(*SceneView);
+
+		// The LUT description is only known in the LUT pass, so a view generates its first LUT there
+		const FViewLUT* ViewLUT = View.GetViewKey() != 0 ? ViewLUTs.Find(View.GetViewKey()) : nullptr;
+		if (!ViewLUT || !ViewLUT->bUseComputePass)
+		{
+			continue;
+		}
+
+		FTonemapOverrideLUTSnapshot Snapshot;
+		TonemapOverride::BuildLUTSnapshot(View, ViewLUT->TextureLUTSize, RenderSettings, Snapshot, FindDisplayedSnapshot(View));
+		const uint64 Fingerprint = Snapshot.GetHash();
+
+		// Displayed LUT stays on screen this frame, so it must survive the eviction of the new entry
+		LUTCache->Touch(ViewLUT->DisplayedKey, FrameNumber);
 
-		float MinValue = FMath::Clamp(CVarMinValue->GetFloat() , -10.0f, 10.0f);
-		float MidValue = FMath::Clamp(CVarMidValue->GetFloat(), -10.0f, 10.0f);
-		float MaxValue = FMath::Clamp(CVarMaxValue->GetFloat(), -10.0f, 10.0f);
+		bool bNeedsRender = false;
+		FRDGTextureRef CachedTexture = LUTCache->FindOrCreate(GraphBuilder, Snapshot, Fingerprint, ViewLUT->Desc, FrameNumber, bNeedsRender);
 
-		float c = MinValue;
-		float b = 4 * MidValue - 3 * MinValue - MaxValue;
-		float a = MaxValue - MinValue - b;
-
-		return FVector3f(a, b, c);
-	}
-
-	void GetCombineLUTParameters(
-		const FViewInfo& View,
-		int32 LUTSize,
-		bool& bHasChanged)
-	{
-
-		static const FPostProcessSettings DefaultSettings;
-
-		const FSceneViewFamily& ViewFamily = *(View.Family);
-
-		const FPostProcessSettings& Settings = ViewFamily.EngineShowFlags.ColorGrading
-			? View.FinalPostProcessSettings
-			: DefaultSettings;
-
-		Parameters.WorkingColorSpace = GDefaultWorkingColorSpaceUniformBuffer.GetUniformBufferRef();
-
-		FACESTonemapParams TonemapperParams;
-		GetACESTonemapParameters(TonemapperParams);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESMinMaxData, TonemapperParams.ACESMinMaxData, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESMidData, TonemapperParams.ACESMidData, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsLow_0, TonemapperParams.ACESCoefsLow_0, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsHigh_0, TonemapperParams.ACESCoefsHigh_0, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsLow_4, TonemapperParams.ACESCoefsLow_4, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESCoefsHigh_4, TonemapperParams.ACESCoefsHigh_4, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESSceneColorMultiplier, TonemapperParams.ACESSceneColorMultiplier, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ACESTonemapParameters.ACESGamutCompression, TonemapperParams.ACESGamutCompression, bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.ColorScale, FVector3f(View.ColorScale), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.OverlayColor, FVector4f(View.OverlayColor), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.MappingPolynomial, GetMappingPolynomial(), bHasChanged);
-
-		// White balance
-		UPDATE_CACHE_SETTINGS(Parameters.bIsTemperatureWhiteBalance, uint32(Settings.TemperatureType == ETemperatureMethod::TEMP_WhiteBalance), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.LUTSize, LUTSize, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.WhiteTemp, Settings.WhiteTemp, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.WhiteTint, Settings.WhiteTint, bHasChanged);
-
-		// Color grade
-		UPDATE_CACHE_SETTINGS(Parameters.ColorSaturation, FVector4f(Settings.ColorSaturation), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorContrast, FVector4f(Settings.ColorContrast), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGamma, FVector4f(Settings.ColorGamma), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGain, FVector4f(Settings.ColorGain), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorOffset, FVector4f(Settings.ColorOffset), bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationShadows, FVector4f(Settings.ColorSaturationShadows), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorContrastShadows, FVector4f(Settings.ColorContrastShadows), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGammaShadows, FVector4f(Settings.ColorGammaShadows), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGainShadows, FVector4f(Settings.ColorGainShadows), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetShadows, FVector4f(Settings.ColorOffsetShadows), bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationMidtones, FVector4f(Settings.ColorSaturationMidtones), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorContrastMidtones, FVector4f(Settings.ColorContrastMidtones), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGammaMidtones, FVector4f(Settings.ColorGammaMidtones), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGainMidtones, FVector4f(Settings.ColorGainMidtones), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetMidtones, FVector4f(Settings.ColorOffsetMidtones), bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.ColorSaturationHighlights, FVector4f(Settings.ColorSaturationHighlights), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorContrastHighlights, FVector4f(Settings.ColorContrastHighlights), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGammaHighlights, FVector4f(Settings.ColorGammaHighlights), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorGainHighlights, FVector4f(Settings.ColorGainHighlights), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorOffsetHighlights, FVector4f(Settings.ColorOffsetHighlights), bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionShadowsMax, Settings.ColorCorrectionShadowsMax, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionHighlightsMin, Settings.ColorCorrectionHighlightsMin, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ColorCorrectionHighlightsMax, Settings.ColorCorrectionHighlightsMax, bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.BlueCorrection, Settings.BlueCorrection, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ExpandGamut, Settings.ExpandGamut, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.ToneCurveAmount, Settings.ToneCurveAmount, bHasChanged);
-
-		UPDATE_CACHE_SETTINGS(Parameters.FilmSlope, Settings.FilmSlope, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.FilmToe, Settings.FilmToe, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.FilmShoulder, Settings.FilmShoulder, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.FilmBlackClip, Settings.FilmBlackClip, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.FilmWhiteClip, Settings.FilmWhiteClip, bHasChanged);
-
-		FTonemapperOutputDeviceParameters TonemapperOutputDeviceParameters = GetTonemapperOutputDeviceParameters(ViewFamily);
-		UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.InverseGamma, TonemapperOutputDeviceParameters.InverseGamma, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputDevice, TonemapperOutputDeviceParameters.OutputDevice, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputGamut, TonemapperOutputDeviceParameters.OutputGamut, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.OutputDevice.OutputMaxLuminance, TonemapperOutputDeviceParameters.OutputMaxLuminance, bHasChanged);
-	}
-
-	void GetCustomLUTParameters(
-	const UTonemapOverrideSettings& TonemapOverrideSettings,
-	bool& bHasChanged)
-	{
-//		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.TonemapOperator, int32(TonemapOverrideSettings.CustomTonemapOperator), bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.ReinhardWhitePoint, TonemapOverrideSettings.ReinhardWhitePoint, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.HejlWhitePoint, TonemapOverrideSettings.HejlWhitePoint, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7BlendRatio, TonemapOverrideSettings.GT7BlendRatio, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7FadeStart, TonemapOverrideSettings.GT7FadeStart, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.GT7FadeEnd, TonemapOverrideSettings.GT7FadeEnd, bHasChanged);
-		
-		// Use fallback texture if not set
-		FTextureRHIRef LUTTexture = GBlackTexture->TextureRHI;
-		FRHISamplerState* LUTSamplerState = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
-		
-		if (TonemapOverrideSettings.CustomTonemapOperator == ECustomTonemapOperator::TonyMcMapface)
+		if (!bNeedsRender)
 		{
-			if (TonemapOverrideSettings.LUTTexture && TonemapOverrideSettings.LUTTexture->GetResource() && TonemapOverrideSettings.LUTTexture->GetResource()->TextureRHI)
+			continue;
+		}
+
+		// Views with the same settings share the entry, which is generated by the first one
+		const uint64 EntryKey = FTonemapOverrideLUTCache::GetEntryKey(Fingerprint, ViewLUT->Desc);
+		if (BatchedLUTs.ContainsByPredicate([EntryKey](const FBatchedLUT& Batched) { return Batched.EntryKey == EntryKey; }))
+		{
+			continue;
+		}
+
+		// Evaluated on worker threads in the LUT pass
+		if (IsCPULUTSupported(Snapshot, ViewLUT->Desc.Format))
+		{
+			continue;
+		}
+
+		const bool bBaked = BakedLUTs && CVarTonemapOverrideBakeUse.GetValueOnRenderThread() > 0 && BakedLUTs->Find(Snapshot.GetContentHash(), ViewLUT->TextureLUTSize, ViewLUT->Desc.Format);
+		const uint64 BatchKey = bBatched && !bBaked ? TonemapOverride::GetLUTBatchKey(Snapshot) : 0;
+
+		if (BatchKey == 0)
+		{
+			RenderLUT(GraphBuilder, View, Snapshot, CachedTexture, ViewLUT->Desc, ViewLUT->bUseComputePass, ViewLUT->bUseVolumeTextureLUT, ViewLUT->TextureLUTSize, bAsyncCompute);
+			continue;
+		}
+
+		BatchGroups.FindOrAdd(FTonemapOverrideLUTCache::GetEntryKey(BatchKey, ViewLUT->Desc)).Add(BatchedLUTs.Num());
+		BatchedLUTs.Add({ &View, ViewLUT, Snapshot, CachedTexture, EntryKey });
+	}
+
+	for (const auto& Group : BatchGroups)
+	{
+		for (int32 First = 0; First < Group.Value.Num(); First += TonemapOverride::MaxBatchedLUTs)
+		{
+			const int32 Count = FMath::Min(Group.Value.Num() - First, TonemapOverride::MaxBatchedLUTs);
+			const FBatchedLUT& FirstLUT = BatchedLUTs[Group.Value[First]];
+			const FViewLUT& PassSetup = *FirstLUT.ViewLUT;
+
+			if (Count == 1)
+			{
+				RenderLUT(GraphBuilder, *FirstLUT.View, FirstLUT.Snapshot, FirstLUT.Texture, PassSetup.Desc, PassSetup.bUseComputePass, PassSetup.bUseVolumeTextureLUT, PassSetup.TextureLUTSize, bAsyncCompute);
+				continue;
+			}
+
+			SCOPE_CYCLE_COUNTER(STAT_TonemapOverrideRenderLUT);
+			CSV_SCOPED_TIMING_STAT(TonemapOverride, RenderLUT);
+
+			TArray<FTonemapOverrideLUTBatchItem, TInlineAllocator<TonemapOverride::MaxBatchedLUTs>> Items;
+			for (int32 Index = First; Index < First + Count; ++Index)
+			{
+				const FBatchedLUT& Batched = BatchedLUTs[Group.Value[Index]];
+				Items.Add({ &Batched.Snapshot, Batched.Texture });
+			}
+
+			TonemapOverride::AddBatchedLUTPass(GraphBuilder, FirstLUT.View->ShaderMap, Items, PassSetup.bUseVolumeTextureLUT, PassSetup.TextureLUTSize, bAsyncCompute);
+			INC_DWORD_STAT(STAT_TonemapOverrideBatchedPasses);
+
+			for (int32 Index = First; Index < First + Count; ++Index)
 			{
-				LUTTexture = TonemapOverrideSettings.LUTTexture->GetResource()->TextureRHI;
+				const FBatchedLUT& Batched = BatchedLUTs[Group.Value[Index]];
+				TonemapOverride::RecordLUTBakeKey(Batched.Snapshot, PassSetup.Desc.Format);
+				TonemapOverride::RecordLUTBuild(bAsyncCompute ? ETonemapOverrideLUTBuild::Async : ETonemapOverrideLUTBuild::Live, FrameNumber, Batched.View->GetViewKey(), Batched.Snapshot, FindDisplayedSnapshot(*Batched.View), false);
+				LUTCache->MarkValid(Batched.Snapshot.GetHash(), PassSetup.Desc, FrameNumber, bAsyncCompute);
 			}
 		}
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.LUTTexture, LUTTexture, bHasChanged);
-		UPDATE_CACHE_SETTINGS(Parameters.CustomTonemapperParameters.LUTTextureSampler, LUTSamplerState, bHasChanged);
 	}
+}
 
-};
+void FTonemapOverrideSceneViewExtension::RenderLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, FRDGTextureRef CachedTexture, const FRDGTextureDesc& LUTDesc, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize, const bool bAsyncCompute)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TonemapOverrideRenderLUT);
+	CSV_SCOPED_TIMING_STAT(TonemapOverride, RenderLUT);
 
+	const uint64 Fingerprint = Snapshot.GetHash();
+	const uint32 FrameNumber = View.Family->FrameNumber;
 
-class FTonemapOverrideLUTShaderPS : public FTonemapOverrideShaderCommon
-{
-public:
-	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTShaderPS);
-	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTShaderPS, FTonemapOverrideShaderCommon);
+	// Valid entry is only generated again with r.LUT.UpdateEveryFrame
+	const bool bForced = LUTCache->IsValid(FTonemapOverrideLUTCache::GetEntryKey(Fingerprint, LUTDesc));
 
-	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
-		RENDER_TARGET_BINDING_SLOTS()
-	END_SHADER_PARAMETER_STRUCT()
+	// Baked LUTs are matched by content only, so a LUT baked on another platform or pass type can be used as well
+	const FTonemapOverrideBakedLUT* BakedLUT = (BakedLUTs && CVarTonemapOverrideBakeUse.GetValueOnRenderThread() > 0)
+		? BakedLUTs->Find(Snapshot.GetContentHash(), TextureLUTSize, LUTDesc.Format)
+		: nullptr;
 
-	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	if (BakedLUT)
 	{
-		return true;
+		// Upload is a copy on the graphics queue and ready within the frame
+		TonemapOverride::AddUploadLUTPass(GraphBuilder, CachedTexture, BakedLUT->Data, bUseVolumeTextureLUT, TextureLUTSize);
+		TonemapOverride::RecordLUTBuild(ETonemapOverrideLUTBuild::Baked, FrameNumber, View.GetViewKey(), Snapshot, FindDisplayedSnapshot(View), bForced);
+		LUTCache->MarkValid(Fingerprint, LUTDesc);
+		return;
 	}
-};
 
-class FTonemapOverrideLUTShaderCS : public FTonemapOverrideShaderCommon
-{
-public:
-	DECLARE_GLOBAL_SHADER(FTonemapOverrideLUTShaderCS);
-	SHADER_USE_PARAMETER_STRUCT(FTonemapOverrideLUTShaderCS, FTonemapOverrideShaderCommon);
+	FViewLUT* ViewLUT = View.GetViewKey() != 0 ? ViewLUTs.Find(View.GetViewKey()) : nullptr;
 
-	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_INCLUDE(FTonemapOverrideLUTParameters, TonemapLUTParameters)
-		SHADER_PARAMETER(FVector2f, OutputExtentInverse)
-		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWOutputTexture)
-	END_SHADER_PARAMETER_STRUCT()
+	// Staged only while the output stage fields animate, the LUT the view shows differs from this one in those fields alone
+	const FTonemapOverrideLUTSnapshot* DisplayedSnapshot = ViewLUT ? FindDisplayedSnapshot(View) : nullptr;
+	const uint64 OperatorStageHash = Snapshot.GetOperatorStageHash();
+	const bool bOutputStageChange = DisplayedSnapshot && DisplayedSnapshot->GetHash() != Fingerprint && DisplayedSnapshot->GetOperatorStageHash() == OperatorStageHash;
 
-	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	if (bOutputStageChange && CVarTonemapOverrideStagedLUT.GetValueOnRenderThread() > 0 && TonemapOverride::IsStagedLUTPassSupported(Snapshot, bUseComputePass))
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		// Operator stage of the view is reused when only the output stage fields changed
+		const FRDGTextureDesc StageDesc = TonemapOverride::GetOperatorStageTextureDesc(TextureLUTSize, bUseVolumeTextureLUT);
+		const bool bRenderOperatorStage = !ViewLUT->OperatorStage.IsValid() || ViewLUT->OperatorStage->GetDesc() != StageDesc || ViewLUT->OperatorStageHash != OperatorStageHash;
+
+		FRDGTextureRef OperatorStageTexture = bRenderOperatorStage
+			? GraphBuilder.CreateTexture(StageDesc, TEXT("TonemapOverride.LUTOperatorStage"))
+			: GraphBuilder.RegisterExternalTexture(ViewLUT->OperatorStage);
+
+		TonemapOverride::AddStagedLUTPass(GraphBuilder, View.ShaderMap, CachedTexture, OperatorStageTexture, Snapshot, bRenderOperatorStage, bUseVolumeTextureLUT, TextureLUTSize, bAsyncCompute);
+
+		if (bRenderOperatorStage)
+		{
+			ViewLUT->OperatorStage = GraphBuilder.ConvertToExternalTexture(OperatorStageTexture);
+			ViewLUT->OperatorStageHash = OperatorStageHash;
+			UpdateOperatorStageMemory();
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_TonemapOverrideOutputStageBuilds);
+		}
 	}
-};
+	else
+	{
+		TonemapOverride::AddLUTPass(GraphBuilder, View.ShaderMap, CachedTexture, Snapshot, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize, bAsyncCompute);
+
+		// Fade is over or the grading changed with it, the float operator stage is not kept for a static LUT
+		if (ViewLUT && ViewLUT->OperatorStage.IsValid())
+		{
+			ViewLUT->OperatorStage.SafeRelease();
+			ViewLUT->OperatorStageHash = 0;
+			UpdateOperatorStageMemory();
+		}
+	}
+
+	TonemapOverride::RecordLUTBakeKey(Snapshot, LUTDesc.Format);
+	TonemapOverride::RecordLUTBuild(bAsyncCompute ? ETonemapOverrideLUTBuild::Async : ETonemapOverrideLUTBuild::Live, FrameNumber, View.GetViewKey(), Snapshot, FindDisplayedSnapshot(View), bForced);
 
-IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTShaderPS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTPS", SF_Pixel);
-IMPLEMENT_GLOBAL_SHADER(FTonemapOverrideLUTShaderCS, "/Plugins/TonemapOverride/CustomTonemapLUT.usf", "CreateLUTCS", SF_Compute);
+	LUTCache->MarkValid(Fingerprint, LUTDesc, FrameNumber, bAsyncCompute);
+}
 
-FTonemapOverrideSceneViewExtension::FTonemapOverrideSceneViewExtension(const FAutoRegister& AutoRegister) : FSceneViewExtensionBase(AutoRegister)
+const FTonemapOverrideLUTSnapshot* FTonemapOverrideSceneViewExtension::FindDisplayedSnapshot(const FViewInfo& View) const
 {
-	UE_LOG(TonemapOverrideLog, Log, TEXT("Tonemap SceneViewExtension registered"));
+	const FViewLUT* ViewLUT = View.GetViewKey() != 0 ? ViewLUTs.Find(View.GetViewKey()) : nullptr;
+	return ViewLUT && ViewLUT->DisplayedKey != 0 ? LUTCache->FindSnapshot(ViewLUT->DisplayedKey) : nullptr;
+}
 
-	// TODO: Loading pre-set asset might fail
-	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
-	TonemapOverrideSettings.LUTTexture.LoadSynchronous();
-	
+void FTonemapOverrideSceneViewExtension::UpdateOperatorStageMemory()
+{
+	uint64 SizeInBytes = 0;
+	for (const auto& Pair : ViewLUTs)
+	{
+		if (Pair.Value.OperatorStage.IsValid())
+		{
+			const FPooledRenderTargetDesc& Desc = Pair.Value.OperatorStage->GetDesc();
+			SizeInBytes += uint64(GPixelFormats[Desc.Format].BlockBytes) * Desc.Extent.X * Desc.Extent.Y * FMath::Max<uint32>(Desc.Depth, 1);
+		}
+	}
+
+	LUTCache->SetReservedSizeInBytes(SizeInBytes);
 }
 
-#if ENGINE_VERSION_CUSTOM == true
-void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessCombineLUTPass(const FSceneView& InView, FTonemapLUTCallbackDelegateArray& LUTPassCallbacks)
+FRDGTextureRef FTonemapOverrideSceneViewExtension::GetOrRenderTimeSlicedLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize)
 {
-	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	FViewLUT* ViewLUT = View.GetViewKey() != 0 ? ViewLUTs.Find(View.GetViewKey()) : nullptr;
+	if (!ViewLUT)
+	{
+		return nullptr;
+	}
+
+	static const auto CVarUpdateEveryFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.UpdateEveryFrame"));
+
+	const int32 SlicesPerFrame = GetTimeSliceNumSlices(TextureLUTSize);
+	const uint64 EntryKey = FTonemapOverrideLUTCache::GetEntryKey(Snapshot.GetHash(), LUTDesc);
+	const uint32 FrameNumber = View.Family->FrameNumber;
+
+	const bool bBaked = BakedLUTs && CVarTonemapOverrideBakeUse.GetValueOnRenderThread() > 0 && BakedLUTs->Find(Snapshot.GetContentHash(), TextureLUTSize, LUTDesc.Format);
 
-	if (bCachedOverride != TonemapOverrideSettings.bUseCustomTonemapper)
+	// Cached and baked LUTs are used right away, a changed LUT size has nothing to show meanwhile
+	if (SlicesPerFrame == 0 || CVarUpdateEveryFrame->GetInt() > 0 || ViewLUT->Desc != LUTDesc || LUTCache->IsValid(EntryKey) || bBaked)
 	{
-		UE_LOG(TonemapOverrideLog, Warning, TEXT("Manually refresh postprocess settings"));
-		bCachedOverride = TonemapOverrideSettings.bUseCustomTonemapper;
+		ViewLUT->PendingKey = 0;
+		return nullptr;
 	}
 
-	if (TonemapOverrideSettings.bUseCustomTonemapper)
+	FRDGTextureRef DisplayedTexture = LUTCache->FindReadable(GraphBuilder, ViewLUT->DisplayedKey, FrameNumber);
+	if (!DisplayedTexture)
 	{
-		LUTPassCallbacks.Add(FTonemapLUTCallbackDelegate::CreateRaw(this, &FTonemapOverrideSceneViewExtension::CreateOverrideLUT_RenderThread));
+		ViewLUT->PendingKey = 0;
+		return nullptr;
 	}
-}
-#else
 
-#if UE_VERSION_OLDER_THAN(5, 5, 0)
-void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass PassId, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
-#else
-void FTonemapOverrideSceneViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass PassId, const FSceneView& InView, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
-#endif
-{
-	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+	// Settings of the pending LUT are kept until it is complete, changes made meanwhile go to the next one
+	const FTonemapOverrideLUTSnapshot* PendingSnapshot = ViewLUT->PendingKey != 0 ? LUTCache->FindSnapshot(ViewLUT->PendingKey) : nullptr;
+	const FTonemapOverrideLUTSnapshot SliceSnapshot = PendingSnapshot ? *PendingSnapshot : Snapshot;
+	const uint64 SliceFingerprint = SliceSnapshot.GetHash();
 
-	if (TonemapOverrideSettings.bUseCustomTonemapper)
+	bool bNeedsRender = false;
+	FRDGTextureRef PendingTexture = LUTCache->FindOrCreate(GraphBuilder, SliceSnapshot, SliceFingerprint, LUTDesc, FrameNumber, bNeedsRender);
+	ViewLUT->PendingKey = FTonemapOverrideLUTCache::GetEntryKey(SliceFingerprint, LUTDesc);
+
+	if (bNeedsRender)
 	{
-		if (PassId == EPostProcessingPass::MotionBlur)
+		const int32 FirstSlice = LUTCache->GetNumGeneratedSlices(ViewLUT->PendingKey);
+		const int32 NumSlices = FMath::Min(SlicesPerFrame, TextureLUTSize - FirstSlice);
+
+		if (FirstSlice == 0)
 		{
-			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FTonemapOverrideSceneViewExtension::CreateOverrideLUT));
+			TonemapOverride::RecordLUTBuild(ETonemapOverrideLUTBuild::TimeSliced, FrameNumber, View.GetViewKey(), SliceSnapshot, LUTCache->FindSnapshot(ViewLUT->DisplayedKey), false);
 		}
+
+		TonemapOverride::AddLUTPass(GraphBuilder, View.ShaderMap, PendingTexture, SliceSnapshot, true, bUseVolumeTextureLUT, TextureLUTSize, false, FirstSlice, NumSlices);
+		INC_DWORD_STAT_BY(STAT_TonemapOverrideLUTSlices, NumSlices);
+
+		if (FirstSlice + NumSlices < TextureLUTSize)
+		{
+			LUTCache->SetNumGeneratedSlices(ViewLUT->PendingKey, FirstSlice + NumSlices);
+			INC_DWORD_STAT(STAT_TonemapOverrideDeferredViews);
+			return DisplayedTexture;
+		}
+
+		TonemapOverride::RecordLUTBakeKey(SliceSnapshot, LUTDesc.Format);
+		LUTCache->MarkValid(SliceFingerprint, LUTDesc);
 	}
 
+	// Complete LUT is swapped in, the next change starts a new one
+	ViewLUT->DisplayedKey = ViewLUT->PendingKey;
+	ViewLUT->PendingKey = 0;
+	return PendingTexture;
 }
-#endif
 
-FRDGTextureRef FTonemapOverrideSceneViewExtension::RenderOverrideLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, FRDGTextureRef OutputTexture, FCachedLUTSettings& CachedLUTSettings, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize)
+FRDGTextureRef FTonemapOverrideSceneViewExtension::GetOrRenderCPULUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize)
 {
-	const FIntPoint OutputViewSize(bUseVolumeTextureLUT ? TextureLUTSize : TextureLUTSize * TextureLUTSize, TextureLUTSize);
+	const uint32 ViewKey = View.GetViewKey();
+	if (ViewKey == 0)
+	{
+		return nullptr;
+	}
 
-	FTonemapOverrideShaderCommon::FPermutationDomain PermutationVector;
+	TSharedPtr<const FTonemapOverrideCPUTexture3D> LUTTexture;
+	if (!IsCPULUTSupported(Snapshot, LUTDesc.Format, &LUTTexture))
+	{
+		CPULUTJobs.Remove(ViewKey);
+		return nullptr;
+	}
 
-	const float DefaultTemperature = 6500;
-	const float DefaultTint = 0;
+	const uint32 FrameNumber = View.Family->FrameNumber;
 
-	FGlobalShaderMap* GlobalShaderMap = GetGlobalShaderMap(View.GetFeatureLevel());
+	// Data of a job for another LUT size or format does not fit the LUT anymore, the layout is converted by the upload
+	TSharedPtr<FTonemapOverrideCPULUTJob> Job = CPULUTJobs.FindRef(ViewKey);
+	if (Job && (Job->Format != LUTDesc.Format || Job->TextureLUTSize != TextureLUTSize))
+	{
+		CPULUTJobs.Remove(ViewKey);
+		Job.Reset();
+	}
 
-	if (bUseComputePass)
+	// Finished LUT is swapped in, it may be for settings that changed again meanwhile. The first LUT of a view started
+	// in PreRenderViewFamily_RenderThread is used from here when the workers are done by now
+	if (Job && Job->Task.IsCompleted())
 	{
-		FTonemapOverrideLUTShaderCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTShaderCS::FParameters>();
-		PassParameters->TonemapLUTParameters = CachedLUTSettings.Parameters;
-		PassParameters->OutputExtentInverse = FVector2f(1.0f, 1.0f) / FVector2f(OutputViewSize);
-		PassParameters->RWOutputTexture = GraphBuilder.CreateUAV(OutputTexture);
+		UploadCPULUT(GraphBuilder, View, *Job, LUTDesc, bUseVolumeTextureLUT);
+		CPULUTJobs.Remove(ViewKey);
+		Job.Reset();
+	}
 
-		const bool ShouldSkipTemperature = FMath::IsNearlyEqual(PassParameters->TonemapLUTParameters.WhiteTemp, DefaultTemperature) && FMath::IsNearlyEqual(PassParameters->TonemapLUTParameters.WhiteTint, DefaultTint);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FSkipTemperature>(ShouldSkipTemperature);
+	const uint64 EntryKey = FTonemapOverrideLUTCache::GetEntryKey(Snapshot.GetHash(), LUTDesc);
+	const bool bBaked = BakedLUTs && CVarTonemapOverrideBakeUse.GetValueOnRenderThread() > 0 && BakedLUTs->Find(Snapshot.GetContentHash(), TextureLUTSize, LUTDesc.Format);
 
-		const bool bOutputDeviceSRGB = (PassParameters->TonemapLUTParameters.OutputDevice.OutputDevice == (uint32)EDisplayOutputFormat::SDR_sRGB);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FOutputDeviceSRGB>(bOutputDeviceSRGB);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FTonemapOperator>(CachedLUTSettings.CachedTonemapOperator);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FGT7UCSType>(CachedLUTSettings.CachedGT7UCSType);
+	// Cached and baked LUTs are used right away
+	if (LUTCache->IsValid(EntryKey) || bBaked)
+	{
+		return nullptr;
+	}
 
-		const uint32 GroupSizeXY = FMath::DivideAndRoundUp(OutputViewSize.X, FTonemapOverrideLUTShaderCS::GroupSize);
-		const uint32 GroupSizeZ = bUseVolumeTextureLUT ? GroupSizeXY : 1;
+	// A view without a LUT to show can not wait for the worker threads, the LUT pass generates its LUT this frame
+	// The job started for it is dropped, the LUT it would upload is in the cache by then
+	FViewLUT* ViewLUT = ViewLUTs.Find(ViewKey);
+	FRDGTextureRef DisplayedTexture = ViewLUT && ViewLUT->Desc == LUTDesc ? LUTCache->FindReadable(GraphBuilder, ViewLUT->DisplayedKey, FrameNumber) : nullptr;
 
-		TShaderMapRef<FTonemapOverrideLUTShaderCS> ComputeShader(GlobalShaderMap, PermutationVector);
+	if (!DisplayedTexture)
+	{
+		CPULUTJobs.Remove(ViewKey);
+		return nullptr;
+	}
 
-		FComputeShaderUtils::AddPass(
-			GraphBuilder,
-			RDG_EVENT_NAME("Tonemap Create LUT CS Shader %d", TextureLUTSize),
-			ComputeShader,
-			PassParameters,
-			FIntVector(GroupSizeXY, GroupSizeXY, GroupSizeZ));
+	// Settings of the job in flight are kept until it is done, changes made meanwhile go to the next one
+	if (!Job)
+	{
+		LaunchCPULUTJob(ViewKey, Snapshot, LUTDesc.Format, TextureLUTSize, MoveTemp(LUTTexture));
 	}
-	else
+
+	ViewLUT->LastUsedFrame = FrameNumber;
+	INC_DWORD_STAT(STAT_TonemapOverrideDeferredViews);
+	return DisplayedTexture;
+}
+
+void FTonemapOverrideSceneViewExtension::LaunchCPULUTJob(const uint32 ViewKey, const FTonemapOverrideLUTSnapshot& Snapshot, const EPixelFormat Format, const int32 TextureLUTSize, TSharedPtr<const FTonemapOverrideCPUTexture3D> LUTTexture)
+{
+	TSharedPtr<FTonemapOverrideCPULUTJob> Job = MakeShared<FTonemapOverrideCPULUTJob>();
+	Job->Snapshot = Snapshot;
+	Job->Format = Format;
+	Job->TextureLUTSize = TextureLUTSize;
+
+	// The task holds the texture, the render settings may replace it meanwhile
+	Job->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Key = FTonemapOverrideLUTBakeKey{ Snapshot, Format }, LUTTexture = MoveTemp(LUTTexture)]()
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("TonemapOverride::GenerateCPULUT", TonemapOverrideChannel);
+
+			FTonemapOverrideBakedLUT LUT;
+			TonemapOverride::BakeCPULUT(Key, LUTTexture.Get(), LUT);
+			return MoveTemp(LUT.Data);
+		});
+
+	CPULUTJobs.Add(ViewKey, MoveTemp(Job));
+}
+
+void FTonemapOverrideSceneViewExtension::LaunchFirstCPULUTs(const FSceneViewFamily& ViewFamily)
+{
+	if (CVarTonemapOverrideCPULUT.GetValueOnRenderThread() <= 0)
 	{
-		FTonemapOverrideLUTShaderPS::FParameters* PassParameters = GraphBuilder.AllocParameters<FTonemapOverrideLUTShaderPS::FParameters>();
-		PassParameters->TonemapLUTParameters = CachedLUTSettings.Parameters;
-		PassParameters->RenderTargets[0] = FRenderTargetBinding(OutputTexture, ERenderTargetLoadAction::ENoAction);
+		return;
+	}
 
-		const bool ShouldSkipTemperature = FMath::IsNearlyEqual(PassParameters->TonemapLUTParameters.WhiteTemp, DefaultTemperature) && FMath::IsNearlyEqual(PassParameters->TonemapLUTParameters.WhiteTint, DefaultTint);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FSkipTemperature>(ShouldSkipTemperature);
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+	static const auto CVarLUTSize = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.Size"));
+	const int32 TextureLUTSize = CVarLUTSize->GetInt();
+	const EPixelFormat Format = GetEngineLUTFormat(ViewFamily);
+
+	for (const FSceneView* SceneView : ViewFamily.Views)
+	{
+		const FViewInfo& View = static_cast<const FViewInfo&>(*SceneView);
+		const uint32 ViewKey = View.GetViewKey();
 
-		const bool bOutputDeviceSRGB = (PassParameters->TonemapLUTParameters.OutputDevice.OutputDevice == (uint32)EDisplayOutputFormat::SDR_sRGB);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FOutputDeviceSRGB>(bOutputDeviceSRGB);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FTonemapOperator>(CachedLUTSettings.CachedTonemapOperator);
-		PermutationVector.Set<FTonemapOverrideShaderCommon::FGT7UCSType>(CachedLUTSettings.CachedGT7UCSType);
+		// Views with a LUT of this size keep it while the LUT pass starts the job of a change
+		const FViewLUT* ViewLUT = ViewKey != 0 ? ViewLUTs.Find(ViewKey) : nullptr;
+		if (ViewKey == 0 || (ViewLUT && ViewLUT->TextureLUTSize == TextureLUTSize && ViewLUT->Desc.Format == Format))
+		{
+			continue;
+		}
 
-		TShaderMapRef<FTonemapOverrideLUTShaderPS> PixelShader(View.ShaderMap, PermutationVector);
+		FTonemapOverrideLUTSnapshot Snapshot;
+		TonemapOverride::BuildLUTSnapshot(View, TextureLUTSize, RenderSettings, Snapshot, FindDisplayedSnapshot(View));
 
-		GraphBuilder.AddPass(
-			RDG_EVENT_NAME("Tonemap Create LUT PS Shader %d", TextureLUTSize),
-			PassParameters,
-			ERDGPassFlags::Raster,
-			[&View, PixelShader, PassParameters, bUseVolumeTextureLUT, TextureLUTSize](FRHICommandList& RHICmdList)
-			{
-				FGraphicsPipelineStateInitializer GraphicsPSOInit;
-				RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-				GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
-				GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
-				GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+		const TSharedPtr<FTonemapOverrideCPULUTJob> Job = CPULUTJobs.FindRef(ViewKey);
+		if (Job && Job->Snapshot.GetHash() == Snapshot.GetHash() && Job->Format == Format && Job->TextureLUTSize == TextureLUTSize)
+		{
+			continue;
+		}
 
-				if (bUseVolumeTextureLUT)
-				{
-					const FVolumeBounds VolumeBounds(TextureLUTSize);
+		// Baked LUTs are uploaded by the LUT pass right away
+		const bool bBaked = BakedLUTs && CVarTonemapOverrideBakeUse.GetValueOnRenderThread() > 0 && BakedLUTs->Find(Snapshot.GetContentHash(), TextureLUTSize, Format);
 
-					TShaderMapRef<FWriteToSliceVS> VertexShader(View.ShaderMap);
-					TOptionalShaderMapRef<FWriteToSliceGS> GeometryShader(View.ShaderMap);
+		TSharedPtr<const FTonemapOverrideCPUTexture3D> LUTTexture;
+		if (!bBaked && IsCPULUTSupported(Snapshot, Format, &LUTTexture))
+		{
+			LaunchCPULUTJob(ViewKey, Snapshot, Format, TextureLUTSize, MoveTemp(LUTTexture));
+		}
+	}
+}
+
+void FTonemapOverrideSceneViewExtension::UploadCPULUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, FTonemapOverrideCPULUTJob& Job, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT)
+{
+	// Empty when the snapshot could not be evaluated, the LUT pass generates the LUT then
+	TArray<uint8>& Result = Job.Task.GetResult();
+	if (Result.IsEmpty())
+	{
+		return;
+	}
+
+	const uint64 Fingerprint = Job.Snapshot.GetHash();
+	const uint32 FrameNumber = View.Family->FrameNumber;
+
+	bool bNeedsRender = false;
+	FRDGTextureRef CachedTexture = LUTCache->FindOrCreate(GraphBuilder, Job.Snapshot, Fingerprint, LUTDesc, FrameNumber, bNeedsRender);
+
+	if (bNeedsRender)
+	{
+		// Upload reads the data when the graph is executed
+		const TArray<uint8>& Data = *GraphBuilder.AllocObject<TArray<uint8>>(MoveTemp(Result));
+		TonemapOverride::AddUploadLUTPass(GraphBuilder, CachedTexture, Data, bUseVolumeTextureLUT, Job.TextureLUTSize);
+		TonemapOverride::RecordLUTBuild(ETonemapOverrideLUTBuild::CPU, FrameNumber, View.GetViewKey(), Job.Snapshot, FindDisplayedSnapshot(View), false);
+		LUTCache->MarkValid(Fingerprint, LUTDesc);
+	}
+
+	if (FViewLUT* ViewLUT = ViewLUTs.Find(View.GetViewKey()))
+	{
+		ViewLUT->DisplayedKey = FTonemapOverrideLUTCache::GetEntryKey(Fingerprint, LUTDesc);
+	}
+}
+
+FRDGTextureRef FTonemapOverrideSceneViewExtension::GetOrRenderCachedLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FRDGTextureDesc& LUTDesc, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TonemapOverrideGetLUT);
+	CSV_SCOPED_TIMING_STAT(TonemapOverride, GetLUT);
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("TonemapOverride::GetLUT", TonemapOverrideChannel);
+
+	// Settings are gathered per view into a packed snapshot, its hash decides which cached LUT the view uses
+	FTonemapOverrideLUTSnapshot Snapshot;
+	const FTonemapOverrideRenderSettings& RenderSettings = TonemapOverride::GetRenderSettings();
+	TonemapOverride::BuildLUTSnapshot(View, TextureLUTSize, RenderSettings, Snapshot, FindDisplayedSnapshot(View));
+	const uint64 Fingerprint = Snapshot.GetHash();
+	const uint64 EntryKey = FTonemapOverrideLUTCache::GetEntryKey(Fingerprint, LUTDesc);
+	const uint32 FrameNumber = View.Family->FrameNumber;
+
+	if (FRDGTextureRef CPUTexture = GetOrRenderCPULUT(GraphBuilder, View, Snapshot, LUTDesc, bUseVolumeTextureLUT, TextureLUTSize))
+	{
+		return CPUTexture;
+	}
+
+	if (bUseComputePass)
+	{
+		if (FRDGTextureRef SlicedTexture = GetOrRenderTimeSlicedLUT(GraphBuilder, View, Snapshot, LUTDesc, bUseVolumeTextureLUT, TextureLUTSize))
+		{
+			ViewLUTs.FindChecked(View.GetViewKey()).LastUsedFrame = FrameNumber;
+			return SlicedTexture;
+		}
+	}
 
-					GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
-					GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GScreenVertexDeclaration.VertexDeclarationRHI;
-					GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
-					GraphicsPSOInit.BoundShaderState.SetGeometryShader(GeometryShader.GetGeometryShader());
-					GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
-					SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+	bool bNeedsRender = false;
+	FRDGTextureRef CachedTexture = LUTCache->FindOrCreate(GraphBuilder, Snapshot, Fingerprint, LUTDesc, FrameNumber, bNeedsRender);
 
-					SetShaderParametersLegacyVS(RHICmdList, VertexShader, VolumeBounds, FIntVector(VolumeBounds.MaxX - VolumeBounds.MinX));
-					SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *PassParameters);
+	static const auto CVarUpdateEveryFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.UpdateEveryFrame"));
+
+	if (bNeedsRender || CVarUpdateEveryFrame->GetInt() > 0)
+	{
+		RenderLUT(GraphBuilder, View, Snapshot, CachedTexture, LUTDesc, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize, false);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_TonemapOverrideCacheHits);
+	}
 
-					RasterizeToVolumeTexture(RHICmdList, VolumeBounds);
-				}
-				else
-				{
-					TShaderMapRef<FScreenPassVS> VertexShader(View.ShaderMap);
+	SET_MEMORY_STAT(STAT_TonemapOverrideCacheMemory, LUTCache->GetTotalSizeInBytes());
 
-					GraphicsPSOInit.PrimitiveType = PT_TriangleList;
-					GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
-					GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
-					GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
-					SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+	// Remember the pass setup so the next change can be generated ahead of the pass
+	const uint32 ViewKey = View.GetViewKey();
+	if (ViewKey == 0)
+	{
+		return CachedTexture;
+	}
 
-					SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *PassParameters);
+	FViewLUT& ViewLUT = ViewLUTs.FindOrAdd(ViewKey);
+	ViewLUT.Desc = LUTDesc;
+	ViewLUT.TextureLUTSize = TextureLUTSize;
+	ViewLUT.bUseComputePass = bUseComputePass;
+	ViewLUT.bUseVolumeTextureLUT = bUseVolumeTextureLUT;
+	ViewLUT.LastUsedFrame = FrameNumber;
 
-					const int32 LUTSize = TextureLUTSize;
-					FRHIBatchedShaderParameters& BatchedParameters = RHICmdList.GetScratchShaderParameters();
-					UE::Renderer::PostProcess::SetDrawRectangleParameters(BatchedParameters, VertexShader.GetShader(), 0, 0, LUTSize*LUTSize, LUTSize, 0, 0, LUTSize*LUTSize, LUTSize, FIntPoint(LUTSize* LUTSize, LUTSize), FIntPoint(LUTSize* LUTSize, LUTSize));
-					RHICmdList.SetBatchedShaderParameters(VertexShader.GetVertexShader(), BatchedParameters);
+	// Async generated LUT is swapped in on the next frame, the previous one is shown until then
+	if (LUTCache->IsPending(EntryKey, FrameNumber) && ViewLUT.DisplayedKey != EntryKey)
+	{
+		if (FRDGTextureRef DisplayedTexture = LUTCache->FindReadable(GraphBuilder, ViewLUT.DisplayedKey, FrameNumber))
+		{
+			INC_DWORD_STAT(STAT_TonemapOverrideDeferredViews);
+			return DisplayedTexture;
+		}
+	}
 
-					FPixelShaderUtils::DrawFullscreenTriangle(RHICmdList, 1);
+	ViewLUT.DisplayedKey = EntryKey;
 
-				}
-			});
+	// Forget views that are gone (closed viewports, released scene captures)
+	if ((FrameNumber & 255) == 0)
+	{
+		for (auto It = ViewLUTs.CreateIterator(); It; ++It)
+		{
+			if (FrameNumber - It.Value().LastUsedFrame > 256)
+			{
+				CPULUTJobs.Remove(It.Key());
+				It.RemoveCurrent();
+			}
+		}
+		UpdateOperatorStageMemory();
 
+#if ENGINE_VERSION_CUSTOM != true
+		for (auto It = ViewStateLUTs.CreateIterator(); It; ++It)
+		{
+			if (FrameNumber - It.Value().WrittenFrame > 256)
+			{
+				It.RemoveCurrent();
+			}
+		}
+#endif
 	}
-	return OutputTexture;
+
+	return CachedTexture;
 }
 
 #if ENGINE_VERSION_CUSTOM == true
@@ -499,31 +751,53 @@ FRDGTextureRef FTonemapOverrideSceneViewExtension::CreateOverrideLUT_RenderThrea
 
 	const FViewInfo& ViewInfo = static_cast<const FViewInfo&>(View);
 
-	static FCachedLUTSettings CachedLUTSettings;
+	// The engine uses whichever texture we return, so the cached LUT can be handed over without a copy
+	return GetOrRenderCachedLUT(GraphBuilder, ViewInfo, OutputTexture->Desc, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize);
+}
 
-	// Check if postprocessing values have been updated
-	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
-	const bool bHasChanged = CachedLUTSettings.UpdateCachedValues(ViewInfo, TextureLUTSize, TonemapOverrideSettings);
+#else
 
+bool FTonemapOverrideSceneViewExtension::NeedsViewStateLUTCopy(FSceneViewState& ViewState, uint32 ViewStateKey, const IPooledRenderTarget* Target, uint64 EntryKey, uint32 FrameNumber)
+{
 	static const auto CVarUpdateEveryFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.UpdateEveryFrame"));
-
-	if (bHasChanged || CVarUpdateEveryFrame->GetInt() > 0)
+	const bool bUpdateEveryFrame = CVarUpdateEveryFrame->GetInt() > 0;
+
+	FViewStateLUT& ViewStateLUT = ViewStateLUTs.FindOrAdd(ViewStateKey);
+
+	// Engine pass keeps the pooled LUT while its settings cache matches, which after the first frame are the defaults set below
+	// It writes the LUT again when the LUT is reallocated, on a frame we did not override (thumbnails, the override toggled off)
+	// and when its output device inputs change, which also change our settings and so the cache entry
+	const bool bTargetChanged = ViewStateLUT.Target != Target;
+	// Stereo views share the view state of the primary view and come in the same frame
+	const bool bSameFrame = ViewStateLUT.Target != nullptr && ViewStateLUT.WrittenFrame == FrameNumber;
+	const bool bMissedFrame = !bSameFrame && ViewStateLUT.WrittenFrame + 1 != FrameNumber;
+	const bool bEntryChanged = EntryKey == 0 || ViewStateLUT.WrittenKey != EntryKey;
+	const bool bInvalid = !GET_PRIVATE_REF(FSceneViewState, &ViewState, bValidTonemappingLUT);
+
+	const bool bNeedsCopy = bTargetChanged || bMissedFrame || bEntryChanged || bInvalid || ViewStateLUT.bEngineMayOverwrite || bUpdateEveryFrame;
+
+	// Our copy is added after motion blur, an engine LUT pass on the same frame comes later and writes over it, so a frame it
+	// may have run in is followed by another copy. r.TonemapOverride.VerifyViewStateLUT reads the LUT back to check this
+	const bool bEngineMayOverwrite = bTargetChanged || bMissedFrame || bEntryChanged;
+	ViewStateLUT.bEngineMayOverwrite = bEngineMayOverwrite || (bSameFrame && ViewStateLUT.bEngineMayOverwrite);
+	ViewStateLUT.Target = Target;
+	ViewStateLUT.WrittenKey = EntryKey;
+	ViewStateLUT.WrittenFrame = FrameNumber;
+
+	if (bEngineMayOverwrite || bUpdateEveryFrame)
 	{
-		RenderOverrideLUT(GraphBuilder, ViewInfo, OutputTexture, CachedLUTSettings, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize);
+		INC_DWORD_STAT(STAT_TonemapOverrideEngineLUTPasses);
 	}
 
-	return OutputTexture;
+	return bNeedsCopy;
 }
 
-#else
-
 FScreenPassTexture FTonemapOverrideSceneViewExtension::CreateOverrideLUT(FRDGBuilder& GraphBuilder, const FSceneView& SceneView, const FPostProcessMaterialInputs& Inputs)
 {
 	// Save SceneColor for exit and exit early if not a valid pass
 	const FScreenPassTexture& SceneColor = Inputs.ReturnUntouchedSceneColorForPostProcessing(GraphBuilder);
 	if (!SceneColor.IsValid()) return SceneColor;
 	
-	FGlobalShaderMap* GlobalShaderMap = GetGlobalShaderMap(SceneView.GetFeatureLevel());
 	const FSceneViewFamily& ViewFamily = *(SceneView.Family);
 
 	const FViewInfo& View = static_cast<const FViewInfo&>(SceneView);
@@ -533,66 +807,153 @@ FScreenPassTexture FTonemapOverrideSceneViewExtension::CreateOverrideLUT(FRDGBui
 	FSceneViewStateInterface* Interface = GET_PRIVATE(FSceneView, &View, EyeAdaptationViewState);
 	FSceneViewState* ViewState = static_cast<FSceneViewState*>(Interface);
 
-	static FCachedLUTSettings CachedLUTSettings;
-	
 	// Engine LUT adds the LDR Luts here, but we skip them as those shouldn't be used with HDR grading in the first place at all
-	
-	bool _bUseFloatOutput = false;
 
 	const bool bUseComputePass = View.bUseComputePasses;
-	const bool bUseVolumeTextureLUT =  FTonemapOverrideLUTShaderCS::PipelineVolumeTextureLUTSupportGuaranteedAtRuntime(View.GetShaderPlatform());
-	const bool bUseFloatOutput = ViewFamily.SceneCaptureSource == SCS_FinalColorHDR || ViewFamily.SceneCaptureSource == SCS_FinalToneCurveHDR;
+	const bool bUseVolumeTextureLUT =  TonemapOverride::IsVolumeTextureLUTSupported(View.GetShaderPlatform());
 
-	if (_bUseFloatOutput != bUseFloatOutput)
-	{
-		UE_LOG(LogTemp, Log, TEXT("Use float output not consistent"));
-		return SceneColor;
-	}
+	// Float output (SCS_FinalColorHDR / SCS_FinalToneCurveHDR) is handled through the output device parameters and the
+	// texture format of the view LUT, which both are part of the cache key
 
 	// Use which ever LUT size is the biggest (native engine or one implemented in settings)  
 	static const auto CVarLUTSize = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.Size"));
 	const int32 TextureLUTSize = CVarLUTSize->GetInt();
 
-	FRDGTextureRef OutputTexture = nullptr;
-	
-	// Not being able to register viewstate (ie. when hovering thumbnail in editor) will fail the update of tonemapLUT
-	// Have tried to cache the texture pointers and viewstate, but none really works here, maybe there is a solution
-	// This is a hack anyways so maybe some flickering in editor can be tolerated
-	if (ViewState)
-	{
-		IPooledRenderTarget* CombinedLUTRenderTarget = GET_PRIVATE_REF(FSceneViewState, ViewState, CombinedLUTRenderTarget);
-		OutputTexture = TryRegisterExternalTexture(GraphBuilder, CombinedLUTRenderTarget);
-	}
-	
+	// Views without a view state (editor thumbnails, asset previews, scene captures without persistent state) get their
+	// LUT in a transient texture of the engine LUT pass, which is out of reach here, and so does a view state without a
+	// pooled LUT. Those views are left untouched and keep the engine tonemapper for the frame, counted in stat TonemapOverride
+	IPooledRenderTarget* CombinedLUTRenderTarget = ViewState ? GET_PRIVATE_REF(FSceneViewState, ViewState, CombinedLUTRenderTarget).GetReference() : nullptr;
+	FRDGTextureRef OutputTexture = CombinedLUTRenderTarget ? TryRegisterExternalTexture(GraphBuilder, CombinedLUTRenderTarget) : nullptr;
+
 	if (!OutputTexture)
 	{
-		// Either this is not supported or the creation of persistent texture has failed
-		// There is nothing we can really do
-		UE_LOG(TonemapOverrideLog, Error, TEXT("LUT Texture register/creation failed"));
+		INC_DWORD_STAT(STAT_TonemapOverrideEngineLUTViews);
+		UE_LOG(TonemapOverrideLog, Verbose, TEXT("%s, the view keeps the engine LUT"), ViewState ? TEXT("View state has no LUT") : TEXT("View has no view state"));
 		return SceneColor;
 	}
 
 	bProcessed = true;
 	
-	// Check if postprocessing values have been updated
-	const UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
-	const bool bHasChanged = CachedLUTSettings.UpdateCachedValues(View, TextureLUTSize, TonemapOverrideSettings);
+	// Shared LUT is generated once per settings, each view state gets a copy as the engine reads the LUT from there
+	FRDGTextureRef CachedTexture = GetOrRenderCachedLUT(GraphBuilder, View, OutputTexture->Desc, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize);
+
+	// Key of the returned texture, which is the previous LUT while a new one is generated over several frames
+	const FViewLUT* ViewLUT = View.GetViewKey() != 0 ? ViewLUTs.Find(View.GetViewKey()) : nullptr;
+	const uint64 EntryKey = ViewLUT ? ViewLUT->DisplayedKey : 0;
+
+	if (NeedsViewStateLUTCopy(*ViewState, ViewState->GetViewKey(), CombinedLUTRenderTarget, EntryKey, ViewFamily.FrameNumber))
+	{
+		AddCopyTexturePass(GraphBuilder, CachedTexture, OutputTexture);
+		INC_DWORD_STAT(STAT_TonemapOverrideViewStateCopies);
 
-	// Doesn't really work as the editor might overwrite our LUT texture later with updated values
-	// So we need to be regenerating this, but might work better in runtime
-	// if (!bHasChanged) return SceneColor;
+		// The engine LUT pass is skipped for a valid LUT whose settings did not change, so it keeps our copy
+		// A skipped copy leaves the flag as it was, NeedsViewStateLUTCopy copies again when the engine cleared it
+		GET_PRIVATE_REF(FSceneViewState, ViewState, bValidTonemappingLUT) = true;
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_TonemapOverrideViewStateSkips);
+	}
 
 	// Hack viewinfo to set postprocess settings to default to prevent the settings-cache update at the tonemapLUT pass
-	FViewInfo& nonConstView = const_cast<FViewInfo&>(View);
-	nonConstView.FinalPostProcessSettings = FFinalPostProcessSettings();
-	
-	// Another hack, set viewfamily to skip colorgrading
-	FSceneViewFamily& nonConstViewFamily = const_cast<FSceneViewFamily&>(ViewFamily);
-	nonConstViewFamily.EngineShowFlags.ColorGrading = 0;
+	// The view family is left alone, clearing its color grading show flag would leave the following views ungraded
+	TonemapOverride::ResetEngineLUTSettings(const_cast<FViewInfo&>(View));
+
+	return SceneColor;
+}
+
+FScreenPassTexture FTonemapOverrideSceneViewExtension::VerifyViewStateLUT(FRDGBuilder& GraphBuilder, const FSceneView& SceneView, const FPostProcessMaterialInputs& Inputs)
+{
+	const FScreenPassTexture SceneColor = Inputs.ReturnUntouchedSceneColorForPostProcessing(GraphBuilder);
+
+	ResolveViewStateLUTChecks();
+
+	const FViewInfo& View = static_cast<const FViewInfo&>(SceneView);
+	FSceneViewState* ViewState = static_cast<FSceneViewState*>(GET_PRIVATE(FSceneView, &View, EyeAdaptationViewState));
+	const FViewStateLUT* ViewStateLUT = ViewState ? ViewStateLUTs.Find(ViewState->GetViewKey()) : nullptr;
+	const uint32 FrameNumber = View.Family->FrameNumber;
+
+	// Only view states our LUT was handed to this frame, a few read backs in flight are enough
+	if (!ViewStateLUT || ViewStateLUT->WrittenFrame != FrameNumber || ViewStateLUTChecks.Num() >= 4)
+	{
+		return SceneColor;
+	}
+
+	FRDGTextureRef ViewStateTexture = TryRegisterExternalTexture(GraphBuilder, GET_PRIVATE_REF(FSceneViewState, ViewState, CombinedLUTRenderTarget));
+	FRDGTextureRef CachedTexture = LUTCache->FindReadable(GraphBuilder, ViewStateLUT->WrittenKey, FrameNumber);
+
+	if (!ViewStateTexture || !CachedTexture || ViewStateTexture->Desc.Format != CachedTexture->Desc.Format || ViewStateTexture->Desc.GetSize() != CachedTexture->Desc.GetSize())
+	{
+		return SceneColor;
+	}
+
+	static const auto CVarUpdateEveryFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.UpdateEveryFrame"));
 
-	RenderOverrideLUT(GraphBuilder, View, OutputTexture, CachedLUTSettings, bUseComputePass, bUseVolumeTextureLUT, TextureLUTSize);
+	FViewStateLUTCheck& Check = ViewStateLUTChecks.AddDefaulted_GetRef();
+	Check.ViewStateReadback = MakeShared<FRHIGPUTextureReadback>(TEXT("TonemapOverride.ViewStateLUTReadback"));
+	Check.CachedReadback = MakeShared<FRHIGPUTextureReadback>(TEXT("TonemapOverride.CachedLUTReadback"));
+	Check.Size = ViewStateTexture->Desc.GetSize();
+	Check.BytesPerTexel = GPixelFormats[ViewStateTexture->Desc.Format].BlockBytes;
+	Check.bEngineMayOverwrite = ViewStateLUT->bEngineMayOverwrite || CVarUpdateEveryFrame->GetInt() > 0;
+
+	AddEnqueueCopyPass(GraphBuilder, Check.ViewStateReadback.Get(), ViewStateTexture);
+	AddEnqueueCopyPass(GraphBuilder, Check.CachedReadback.Get(), CachedTexture);
 
 	return SceneColor;
 }
 
+void FTonemapOverrideSceneViewExtension::ResolveViewStateLUTChecks()
+{
+	for (int32 Index = 0; Index < ViewStateLUTChecks.Num();)
+	{
+		FViewStateLUTCheck& Check = ViewStateLUTChecks[Index];
+		if (!Check.ViewStateReadback->IsReady() || !Check.CachedReadback->IsReady())
+		{
+			++Index;
+			continue;
+		}
+
+		int32 ViewStatePitch = 0;
+		int32 ViewStateHeight = 0;
+		int32 CachedPitch = 0;
+		int32 CachedHeight = 0;
+		const uint8* ViewStateData = static_cast<const uint8*>(Check.ViewStateReadback->Lock(ViewStatePitch, &ViewStateHeight));
+		const uint8* CachedData = static_cast<const uint8*>(Check.CachedReadback->Lock(CachedPitch, &CachedHeight));
+
+		// Rows of a volume LUT are read slice by slice, a 2D LUT is a single slice
+		bool bEqual = ViewStateData && CachedData;
+		const int32 RowBytes = Check.Size.X * Check.BytesPerTexel;
+
+		for (int32 Slice = 0; bEqual && Slice < Check.Size.Z; ++Slice)
+		{
+			for (int32 Row = 0; bEqual && Row < Check.Size.Y; ++Row)
+			{
+				const uint8* ViewStateRow = ViewStateData + int64(Slice * ViewStateHeight + Row) * ViewStatePitch * Check.BytesPerTexel;
+				const uint8* CachedRow = CachedData + int64(Slice * CachedHeight + Row) * CachedPitch * Check.BytesPerTexel;
+				bEqual = FMemory::Memcmp(ViewStateRow, CachedRow, RowBytes) == 0;
+			}
+		}
+
+		if (ViewStateData)
+		{
+			Check.ViewStateReadback->Unlock();
+		}
+		if (CachedData)
+		{
+			Check.CachedReadback->Unlock();
+		}
+
+		if (!bEqual)
+		{
+			INC_DWORD_STAT(STAT_TonemapOverrideEngineLUTWrites);
+			UE_CLOG(!Check.bEngineMayOverwrite, TonemapOverrideLog, Warning, TEXT("Engine LUT pass wrote the view state LUT on a frame the copy was skipped for, the tonemapper used the engine LUT"));
+		}
+
+		UE_LOG(TonemapOverrideLog, Verbose, TEXT("View state LUT %s after the tonemapper, engine LUT pass %s"),
+			bEqual ? TEXT("matches the copied LUT") : TEXT("was written by the engine"), Check.bEngineMayOverwrite ? TEXT("possible") : TEXT("not expected"));
+
+		ViewStateLUTChecks.RemoveAtSwap(Index);
+	}
+}
+
 #endif
\ No newline at end of file
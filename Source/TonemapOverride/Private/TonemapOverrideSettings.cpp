@@ -2,6 +2,7 @@
 
 
 #include "TonemapOverrideSettings.h"
+#include "TonemapOverrideLUTSettings.h"
 
 
 UTonemapOverrideSettings& UTonemapOverrideSettings::Get()
@@ -9,4 +10,75 @@ UTonemapOverrideSettings& UTonemapOverrideSettings::Get()
 	UTonemapOverrideSettings* MutableCDO = GetMutableDefault<UTonemapOverrideSettings>();
 	check(MutableCDO != nullptr)
 	return *MutableCDO;
-}
\ No newline at end of file
+}
+
+const FName UTonemapOverrideSettings::DefaultFlimPresetName(TEXT("Default"));
+
+#if WITH_EDITOR
+void UTonemapOverrideSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// A newly selected LUT texture is loaded here, the render thread only sees loaded textures
+	LUTTexture.LoadSynchronous();
+	CustomLUTTexture.LoadSynchronous();
+
+	TonemapOverride::UpdateRenderSettings();
+}
+#endif
+
+bool FTonemapOverrideFlimPreset::operator==(const FTonemapOverrideFlimPreset& Other) const
+{
+	return PreExposure == Other.PreExposure
+		&& PreFormationFilter == Other.PreFormationFilter
+		&& PreFormationFilterStrength == Other.PreFormationFilterStrength
+		&& ExtendedGamutScale == Other.ExtendedGamutScale
+		&& ExtendedGamutRotation == Other.ExtendedGamutRotation
+		&& ExtendedGamutMul == Other.ExtendedGamutMul
+		&& SigmoidLog2Min == Other.SigmoidLog2Min
+		&& SigmoidLog2Max == Other.SigmoidLog2Max
+		&& SigmoidToeX == Other.SigmoidToeX
+		&& SigmoidToeY == Other.SigmoidToeY
+		&& SigmoidShoulderX == Other.SigmoidShoulderX
+		&& SigmoidShoulderY == Other.SigmoidShoulderY
+		&& NegativeFilmExposure == Other.NegativeFilmExposure
+		&& NegativeFilmDensity == Other.NegativeFilmDensity
+		&& PrintBacklight == Other.PrintBacklight
+		&& PrintFilmExposure == Other.PrintFilmExposure
+		&& PrintFilmDensity == Other.PrintFilmDensity
+		&& BlackPoint == Other.BlackPoint
+		&& PostFormationFilter == Other.PostFormationFilter
+		&& PostFormationFilterStrength == Other.PostFormationFilterStrength
+		&& MidtoneSaturation == Other.MidtoneSaturation;
+}
+
+const FTonemapOverrideFlimPreset& UTonemapOverrideSettings::GetFlimPreset() const
+{
+	static const FTonemapOverrideFlimPreset DefaultPreset;
+
+	if (FlimPreset != DefaultFlimPresetName)
+	{
+		for (const FTonemapOverrideFlimNamedPreset& NamedPreset : FlimPresets)
+		{
+			if (NamedPreset.Name == FlimPreset)
+			{
+				return NamedPreset.Preset;
+			}
+		}
+	}
+
+	return DefaultPreset;
+}
+
+TArray<FName> UTonemapOverrideSettings::GetFlimPresetNames() const
+{
+	TArray<FName> Names;
+	Names.Add(DefaultFlimPresetName);
+
+	for (const FTonemapOverrideFlimNamedPreset& NamedPreset : FlimPresets)
+	{
+		Names.AddUnique(NamedPreset.Name);
+	}
+
+	return Names;
+}
@@ -0,0 +1,200 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideStats.h"
+#include "TonemapOverrideLUTSettings.h"
+#include "TonemapOverride.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_STAT(STAT_TonemapOverrideGetLUT);
+DEFINE_STAT(STAT_TonemapOverrideRenderLUT);
+DEFINE_STAT(STAT_TonemapOverrideLUTBuilds);
+DEFINE_STAT(STAT_TonemapOverrideLUTUploads);
+DEFINE_STAT(STAT_TonemapOverrideBatchedPasses);
+DEFINE_STAT(STAT_TonemapOverrideLUTSlices);
+DEFINE_STAT(STAT_TonemapOverrideOutputStageBuilds);
+DEFINE_STAT(STAT_TonemapOverrideCacheHits);
+DEFINE_STAT(STAT_TonemapOverrideDeferredViews);
+DEFINE_STAT(STAT_TonemapOverrideViewStateCopies);
+DEFINE_STAT(STAT_TonemapOverrideViewStateSkips);
+DEFINE_STAT(STAT_TonemapOverrideEngineLUTViews);
+DEFINE_STAT(STAT_TonemapOverrideEngineLUTPasses);
+DEFINE_STAT(STAT_TonemapOverrideEngineLUTWrites);
+DEFINE_STAT(STAT_TonemapOverridePrecachedPipelines);
+DEFINE_STAT(STAT_TonemapOverrideOnDemandPipelines);
+DEFINE_STAT(STAT_TonemapOverrideCacheMemory);
+
+CSV_DEFINE_CATEGORY(TonemapOverride, true);
+
+UE_TRACE_CHANNEL_DEFINE(TonemapOverrideChannel);
+
+UE_TRACE_EVENT_BEGIN(TonemapOverride, LUTBuild)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Fingerprint)
+	UE_TRACE_EVENT_FIELD(uint32, FrameNumber)
+	UE_TRACE_EVENT_FIELD(uint32, ViewKey)
+	UE_TRACE_EVENT_FIELD(uint32, LUTSize)
+	UE_TRACE_EVENT_FIELD(uint8, Build)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Reason)
+UE_TRACE_EVENT_END()
+
+static FAutoConsoleCommand CmdTonemapOverrideDumpRegenerations(
+	TEXT("r.TonemapOverride.DumpRegenerations"),
+	TEXT("Log the last N (default 32) LUT regenerations with the settings fields that caused them, and the fields that caused most regenerations."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		TonemapOverride::DumpLUTRegenerations(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 32);
+	}));
+
+namespace
+{
+	const int32 MaxRegenerations = 256;
+
+	// Fields listed with their values per regeneration, the rest are only named
+	const int32 MaxFieldValues = 3;
+
+	struct FLUTRegeneration
+	{
+		uint32 FrameNumber = 0;
+		uint32 ViewKey = 0;
+		int32 LUTSize = 0;
+		ETonemapOverrideLUTBuild Build = ETonemapOverrideLUTBuild::Live;
+		FString Reason;
+		TArray<ELUTSnapshotField, TInlineAllocator<4>> Fields;
+	};
+
+	// Ring buffer written on the render thread and read by the console command
+	struct FLUTRegenerationLog
+	{
+		FCriticalSection Lock;
+		TArray<FLUTRegeneration> Entries;
+		int32 Next = 0;
+		uint32 FieldCounts[int32(ELUTSnapshotField::Num)] = {};
+		uint32 NumFirstLUTs = 0;
+		uint32 NumForced = 0;
+	};
+
+	FLUTRegenerationLog GLUTRegenerationLog;
+
+	const TCHAR* GetBuildName(ETonemapOverrideLUTBuild Build)
+	{
+		switch (Build)
+		{
+		case ETonemapOverrideLUTBuild::Async: return TEXT("Async");
+		case ETonemapOverrideLUTBuild::TimeSliced: return TEXT("TimeSliced");
+		case ETonemapOverrideLUTBuild::Baked: return TEXT("Baked");
+		case ETonemapOverrideLUTBuild::CPU: return TEXT("CPU");
+		default: return TEXT("Live");
+		}
+	}
+}
+
+void TonemapOverride::RecordLUTBuild(ETonemapOverrideLUTBuild Build, uint32 FrameNumber, uint32 ViewKey, const FTonemapOverrideLUTSnapshot& Snapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot, bool bForced)
+{
+	if (Build == ETonemapOverrideLUTBuild::Baked)
+	{
+		INC_DWORD_STAT(STAT_TonemapOverrideLUTUploads);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_TonemapOverrideLUTBuilds);
+	}
+	CSV_CUSTOM_STAT(TonemapOverride, LUTBuilds, 1, ECsvCustomStatOp::Accumulate);
+
+	FLUTRegeneration Regeneration;
+	Regeneration.FrameNumber = FrameNumber;
+	Regeneration.ViewKey = ViewKey;
+	Regeneration.LUTSize = FMath::RoundToInt(Snapshot.LUTSize);
+	Regeneration.Build = Build;
+
+	if (bForced)
+	{
+		Regeneration.Reason = TEXT("r.LUT.UpdateEveryFrame");
+	}
+	else if (!PreviousSnapshot)
+	{
+		Regeneration.Reason = TEXT("No previous LUT");
+	}
+	else
+	{
+		FTonemapOverrideLUTSnapshot::GetChangedFields(*PreviousSnapshot, Snapshot, Regeneration.Fields);
+
+		for (int32 Index = 0; Index < Regeneration.Fields.Num(); ++Index)
+		{
+			const ELUTSnapshotField Field = Regeneration.Fields[Index];
+			Regeneration.Reason += Index > 0 ? TEXT(", ") : TEXT("");
+			Regeneration.Reason += FTonemapOverrideLUTSnapshot::GetFieldName(Field);
+
+			if (Index < MaxFieldValues)
+			{
+				Regeneration.Reason += FString::Printf(TEXT(" %s -> %s"), *PreviousSnapshot->GetFieldValueString(Field), *Snapshot.GetFieldValueString(Field));
+			}
+		}
+
+		// Same settings for another texture description (LUT format or pass type) or an evicted LUT
+		if (Regeneration.Fields.IsEmpty())
+		{
+			Regeneration.Reason = TEXT("Settings unchanged");
+		}
+	}
+
+	UE_TRACE_LOG(TonemapOverride, LUTBuild, TonemapOverrideChannel)
+		<< LUTBuild.Cycle(FPlatformTime::Cycles64())
+		<< LUTBuild.Fingerprint(Snapshot.GetHash())
+		<< LUTBuild.FrameNumber(FrameNumber)
+		<< LUTBuild.ViewKey(ViewKey)
+		<< LUTBuild.LUTSize(uint32(Regeneration.LUTSize))
+		<< LUTBuild.Build(uint8(Build))
+		<< LUTBuild.Reason(*Regeneration.Reason, Regeneration.Reason.Len());
+
+	FScopeLock ScopeLock(&GLUTRegenerationLog.Lock);
+
+	for (const ELUTSnapshotField Field : Regeneration.Fields)
+	{
+		++GLUTRegenerationLog.FieldCounts[int32(Field)];
+	}
+	GLUTRegenerationLog.NumFirstLUTs += !bForced && !PreviousSnapshot ? 1 : 0;
+	GLUTRegenerationLog.NumForced += bForced ? 1 : 0;
+
+	if (GLUTRegenerationLog.Entries.Num() < MaxRegenerations)
+	{
+		GLUTRegenerationLog.Entries.Add(MoveTemp(Regeneration));
+	}
+	else
+	{
+		GLUTRegenerationLog.Entries[GLUTRegenerationLog.Next] = MoveTemp(Regeneration);
+	}
+	GLUTRegenerationLog.Next = (GLUTRegenerationLog.Next + 1) % MaxRegenerations;
+}
+
+void TonemapOverride::DumpLUTRegenerations(int32 NumEntries)
+{
+	FScopeLock ScopeLock(&GLUTRegenerationLog.Lock);
+
+	const TArray<FLUTRegeneration>& Entries = GLUTRegenerationLog.Entries;
+	NumEntries = FMath::Clamp(NumEntries, 0, Entries.Num());
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Last %d LUT regenerations (oldest first):"), NumEntries);
+
+	for (int32 Age = NumEntries; Age > 0; --Age)
+	{
+		const FLUTRegeneration& Entry = Entries[(GLUTRegenerationLog.Next - Age + MaxRegenerations) % MaxRegenerations];
+		UE_LOG(TonemapOverrideLog, Display, TEXT("  Frame %u View %u Size %d %s: %s"), Entry.FrameNumber, Entry.ViewKey, Entry.LUTSize, GetBuildName(Entry.Build), *Entry.Reason);
+	}
+
+	// Fields that keep changing point at jittering volumes, blends or sequences
+	TArray<TPair<uint32, ELUTSnapshotField>> FieldCounts;
+	for (int32 Field = 0; Field < int32(ELUTSnapshotField::Num); ++Field)
+	{
+		if (GLUTRegenerationLog.FieldCounts[Field] > 0)
+		{
+			FieldCounts.Emplace(GLUTRegenerationLog.FieldCounts[Field], ELUTSnapshotField(Field));
+		}
+	}
+	FieldCounts.Sort([](const TPair<uint32, ELUTSnapshotField>& A, const TPair<uint32, ELUTSnapshotField>& B) { return A.Key > B.Key; });
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Regenerations per field since start (first LUTs %u, forced %u):"), GLUTRegenerationLog.NumFirstLUTs, GLUTRegenerationLog.NumForced);
+	for (const TPair<uint32, ELUTSnapshotField>& FieldCount : FieldCounts)
+	{
+		UE_LOG(TonemapOverrideLog, Display, TEXT("  %-32s %u"), FTonemapOverrideLUTSnapshot::GetFieldName(FieldCount.Value), FieldCount.Key);
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+// Runtime instrumentation of the LUT generation: stat TonemapOverride, the TonemapOverride CSV category and trace channel,
+// and a log of why LUTs were regenerated (r.TonemapOverride.DumpRegenerations)
+
+DECLARE_STATS_GROUP(TEXT("TonemapOverride"), STATGROUP_TonemapOverride, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get LUT"), STAT_TonemapOverrideGetLUT, STATGROUP_TonemapOverride, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Render LUT"), STAT_TonemapOverrideRenderLUT, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT builds"), STAT_TonemapOverrideLUTBuilds, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT baked uploads"), STAT_TonemapOverrideLUTUploads, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT batched passes"), STAT_TonemapOverrideBatchedPasses, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT slices"), STAT_TonemapOverrideLUTSlices, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT output stage builds"), STAT_TonemapOverrideOutputStageBuilds, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cache hits"), STAT_TonemapOverrideCacheHits, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Views on previous LUT"), STAT_TonemapOverrideDeferredViews, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("View state LUT copies"), STAT_TonemapOverrideViewStateCopies, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("View state LUT copies skipped"), STAT_TonemapOverrideViewStateSkips, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Views on engine LUT"), STAT_TonemapOverrideEngineLUTViews, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Engine LUT passes possible"), STAT_TonemapOverrideEngineLUTPasses, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Engine LUT passes detected"), STAT_TonemapOverrideEngineLUTWrites, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("LUT pipelines precached"), STAT_TonemapOverridePrecachedPipelines, STATGROUP_TonemapOverride, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LUT pipelines created on demand"), STAT_TonemapOverrideOnDemandPipelines, STATGROUP_TonemapOverride, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("LUT cache"), STAT_TonemapOverrideCacheMemory, STATGROUP_TonemapOverride, );
+
+CSV_DECLARE_CATEGORY_EXTERN(TonemapOverride);
+
+UE_TRACE_CHANNEL_EXTERN(TonemapOverrideChannel);
+
+struct FTonemapOverrideLUTSnapshot;
+
+// How a LUT got its contents
+enum class ETonemapOverrideLUTBuild : uint8
+{
+	// Generated in the LUT pass
+	Live,
+	// Generated on the async compute queue ahead of the post processing
+	Async,
+	// First slices of a time sliced LUT
+	TimeSliced,
+	// Uploaded from the baked LUTs
+	Baked,
+	// Evaluated on worker threads and uploaded (r.TonemapOverride.CPULUT)
+	CPU,
+};
+
+namespace TonemapOverride
+{
+	// Count the build and remember what changed against the LUT the view showed before, render thread only
+	// PreviousSnapshot is null for the first LUT of a view or when the previous LUT was evicted from the cache
+	void RecordLUTBuild(ETonemapOverrideLUTBuild Build, uint32 FrameNumber, uint32 ViewKey, const FTonemapOverrideLUTSnapshot& Snapshot, const FTonemapOverrideLUTSnapshot* PreviousSnapshot, bool bForced);
+
+	// Log the last regenerations and how often each field caused one
+	void DumpLUTRegenerations(int32 NumEntries);
+}
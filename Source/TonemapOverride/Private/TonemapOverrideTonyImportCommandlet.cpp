@@ -0,0 +1,200 @@
+// Copyright 2025 Ossi Luoto
+
+#include "TonemapOverrideTonyImportCommandlet.h"
+#include "TonemapOverrideCPU.h"
+#include "TonemapOverrideLUTImport.h"
+#include "TonemapOverrideLUTShaper.h"
+#include "TonemapOverrideSettings.h"
+#include "TonemapOverride.h"
+#include "Engine/VolumeTexture.h"
+
+static const TCHAR* DefaultTonyLUTPackage = TEXT("/Game/TonemapOverride/TonyLUT");
+
+namespace
+{
+	FVector3f QuantizeHalf(const FVector3f& Color)
+	{
+		return FVector3f(FFloat16(Color.X).GetFloat(), FFloat16(Color.Y).GetFloat(), FFloat16(Color.Z).GetFloat());
+	}
+
+	// Shared exponent format of PF_R9G9B9EXP5 (EXT_texture_shared_exponent), round to nearest
+	FVector3f QuantizeRGB9E5(const FVector3f& Color)
+	{
+		const int32 MantissaBits = 9;
+		const int32 ExponentBias = 15;
+		const float MaxValue = float(511.0 / 512.0 * 65536.0);
+
+		const FVector3f Clamped(FMath::Clamp(Color.X, 0.0f, MaxValue), FMath::Clamp(Color.Y, 0.0f, MaxValue), FMath::Clamp(Color.Z, 0.0f, MaxValue));
+		const float MaxComponent = Clamped.GetMax();
+		if (MaxComponent <= 0.0f)
+		{
+			return FVector3f::ZeroVector;
+		}
+
+		int32 SharedExponent = FMath::Max(-ExponentBias - 1, FMath::FloorToInt(FMath::Log2(MaxComponent))) + 1 + ExponentBias;
+		double Denominator = FMath::Pow(2.0, double(SharedExponent - ExponentBias - MantissaBits));
+
+		if (FMath::FloorToDouble(MaxComponent / Denominator + 0.5) >= double(1 << MantissaBits))
+		{
+			Denominator *= 2.0;
+			++SharedExponent;
+		}
+
+		auto Quantize = [Denominator](float Value)
+		{
+			return float(FMath::FloorToDouble(Value / Denominator + 0.5) * Denominator);
+		};
+
+		return FVector3f(Quantize(Clamped.X), Quantize(Clamped.Y), Quantize(Clamped.Z));
+	}
+
+	// Error of the quantized texels against the float32 texels, in linear values and in CIEDE2000 of the Tony output
+	void ReportQuantizationError(const TCHAR* FormatName, int32 BytesPerTexel, TConstArrayView<FVector3f> Texels, TFunctionRef<FVector3f(const FVector3f&)> Quantize)
+	{
+		double MaxAbsError = 0.0;
+		double MaxRelativeError = 0.0;
+		double MaxDeltaE = 0.0;
+		double SumDeltaE = 0.0;
+
+		for (const FVector3f& Texel : Texels)
+		{
+			const FVector3f Quantized = Quantize(Texel);
+
+			for (int32 Channel = 0; Channel < 3; ++Channel)
+			{
+				const double AbsError = FMath::Abs(double(Quantized[Channel]) - double(Texel[Channel]));
+				MaxAbsError = FMath::Max(MaxAbsError, AbsError);
+				MaxRelativeError = FMath::Max(MaxRelativeError, AbsError / FMath::Max(double(FMath::Abs(Texel[Channel])), 1e-4));
+			}
+
+			const double DeltaE = TonemapOverride::DeltaE2000(TonemapOverride::LinearSRGBToLab(FVector3d(Texel)), TonemapOverride::LinearSRGBToLab(FVector3d(Quantized)));
+			MaxDeltaE = FMath::Max(MaxDeltaE, DeltaE);
+			SumDeltaE += DeltaE;
+		}
+
+		UE_LOG(TonemapOverrideLog, Display, TEXT("%-8s %7.1f KB  max abs %.3g  max relative %.3f%%  dE2000 max %.4f mean %.5f"),
+			FormatName, double(Texels.Num()) * BytesPerTexel / 1024.0, MaxAbsError, MaxRelativeError * 100.0, MaxDeltaE, Texels.IsEmpty() ? 0.0 : SumDeltaE / Texels.Num());
+	}
+
+	// Tony sampled at the lattice of an engine LUT: texel i holds the input LogToLin(i / (Size - 1)) - LogToLin(0)
+	void PrecomposeToLUTEncoding(const FTonemapOverrideCPUTexture3D& Source, int32 LUTSize, FTonemapOverrideCPUTexture3D& OutTexture)
+	{
+		auto LogToLin = [](double LogColor)
+		{
+			return FMath::Pow(2.0, (LogColor - 444.0 / 1023.0) * 14.0) * 0.18;
+		};
+
+		const FVector3d SourceDims(Source.Size);
+
+		TArray<double> Coordinates;
+		Coordinates.SetNumUninitialized(LUTSize);
+		for (int32 Index = 0; Index < LUTSize; ++Index)
+		{
+			const double Stimulus = LogToLin(double(Index) / (LUTSize - 1)) - LogToLin(0.0);
+			Coordinates[Index] = Stimulus / (Stimulus + 1.0);
+		}
+
+		OutTexture.Size = FIntVector(LUTSize);
+		OutTexture.Texels.SetNumUninitialized(LUTSize * LUTSize * LUTSize);
+
+		for (int32 Blue = 0; Blue < LUTSize; ++Blue)
+		{
+			for (int32 Green = 0; Green < LUTSize; ++Green)
+			{
+				for (int32 Red = 0; Red < LUTSize; ++Red)
+				{
+					const FVector3d Encoded(Coordinates[Red], Coordinates[Green], Coordinates[Blue]);
+					const FVector3d UVW = (Encoded * (SourceDims - 1.0) + 0.5) / SourceDims;
+					OutTexture.Texels[Red + (Green + Blue * LUTSize) * LUTSize] = Source.Sample(FVector3f(UVW));
+				}
+			}
+		}
+	}
+}
+
+UTonemapOverrideTonyImportCommandlet::UTonemapOverrideTonyImportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTonemapOverrideTonyImportCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	UTonemapOverrideSettings& TonemapOverrideSettings = UTonemapOverrideSettings::Get();
+
+	const FString* SourceParam = ParamVals.Find(TEXT("Source"));
+	if (!SourceParam && TonemapOverrideSettings.bLUTTexturePrecomposed)
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Configured Tony LUT texture is already precomposed, give the original float32 texture with -Source"));
+		return 1;
+	}
+
+	const UTexture* SourceTexture = SourceParam ? LoadObject<UTexture>(nullptr, **SourceParam) : TonemapOverrideSettings.LUTTexture.LoadSynchronous();
+
+	FTonemapOverrideCPUTexture3D Source;
+	if (!FTonemapOverrideCPUTexture3D::LoadFromTexture(SourceTexture, Source))
+	{
+		UE_LOG(TonemapOverrideLog, Error, TEXT("Tony LUT texture source data is not available"));
+		return 1;
+	}
+
+	const bool bPrecompose = Switches.Contains(TEXT("Precompose"));
+
+	FTonemapOverrideCPUTexture3D Converted;
+	if (bPrecompose)
+	{
+		static const auto CVarLUTSize = IConsoleManager::Get().FindConsoleVariable(TEXT("r.LUT.Size"));
+		int32 LUTSize = CVarLUTSize ? CVarLUTSize->GetInt() : 32;
+		if (const FString* SizeParam = ParamVals.Find(TEXT("Size")))
+		{
+			LUTSize = FCString::Atoi(**SizeParam);
+		}
+
+		if (LUTSize < 2)
+		{
+			UE_LOG(TonemapOverrideLog, Error, TEXT("Invalid LUT size %d"), LUTSize);
+			return 1;
+		}
+
+		PrecomposeToLUTEncoding(Source, LUTSize, Converted);
+		UE_LOG(TonemapOverrideLog, Display, TEXT("Precomposed %dx%dx%d Tony LUT to the engine LUT encoding at size %d"), Source.Size.X, Source.Size.Y, Source.Size.Z, LUTSize);
+	}
+	else
+	{
+		Converted = Source;
+	}
+
+	// Float32 is the reference, the engine texture build has no shared exponent format so RGB9E5 is reported for comparison only
+	ReportQuantizationError(TEXT("FP32"), sizeof(FLinearColor), Converted.Texels, [](const FVector3f& Color) { return Color; });
+	ReportQuantizationError(TEXT("FP16"), sizeof(FFloat16Color), Converted.Texels, &QuantizeHalf);
+	ReportQuantizationError(TEXT("RGB9E5"), sizeof(uint32), Converted.Texels, &QuantizeRGB9E5);
+
+	// Half float texture, half the memory of the float32 asset
+	const FString* AssetParam = ParamVals.Find(TEXT("Asset"));
+	const FString PackageName = AssetParam ? *AssetParam : DefaultTonyLUTPackage;
+
+	UVolumeTexture* Texture = TonemapOverride::SaveLUTVolumeTexture(PackageName, Converted.Size, Converted.Texels);
+	if (!Texture)
+	{
+		return 1;
+	}
+
+	TonemapOverrideSettings.LUTTexture = Texture;
+	TonemapOverrideSettings.bLUTTexturePrecomposed = bPrecompose;
+	TonemapOverrideSettings.TryUpdateDefaultConfigFile();
+
+	UE_LOG(TonemapOverrideLog, Display, TEXT("Saved Tony LUT texture %s%s"), *PackageName, bPrecompose ? TEXT(" (precomposed)") : TEXT(""));
+	return 0;
+#else
+	UE_LOG(TonemapOverrideLog, Error, TEXT("Tony LUT import requires an editor build"));
+	return 1;
+#endif
+}
@@ -0,0 +1,23 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TonemapOverrideBakeCommandlet.generated.h"
+
+/**
+ * Generates the LUTs for the settings keys recorded at runtime and stores them into the baked LUT asset
+ * UnrealEditor-Cmd.exe Project.uproject -run=TonemapOverrideBake -AllowCommandletRendering [-Keys=File] [-Asset=/Game/Path] [-Clean]
+ * With -nullrhi the LUTs are evaluated on the CPU, ACES LUTs need the GPU and are skipped
+ */
+UCLASS()
+class UTonemapOverrideBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTonemapOverrideBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,56 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "PixelFormat.h"
+#include "TonemapOverrideBakedLUTs.generated.h"
+
+// One pre-generated LUT, texels are stored in the pixel format of the runtime LUT in canonical layout
+// (R + G * Size + B * Size * Size) so they can be uploaded directly to either volume or unwrapped 2D LUTs
+USTRUCT()
+struct TONEMAPOVERRIDE_API FTonemapOverrideBakedLUT
+{
+	GENERATED_BODY()
+
+	// Content hash of the LUT settings snapshot the LUT was generated from
+	UPROPERTY(VisibleAnywhere, Category = "TonemapOverride")
+	uint64 ContentHash = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "TonemapOverride")
+	int32 LUTSize = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "TonemapOverride")
+	TEnumAsByte<EPixelFormat> Format = PF_Unknown;
+
+	UPROPERTY()
+	TArray<uint8> Data;
+};
+
+// Pre-baked LUTs for static grading setups, generated with the TonemapOverrideBake commandlet
+UCLASS(BlueprintType)
+class TONEMAPOVERRIDE_API UTonemapOverrideBakedLUTs : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "TonemapOverride")
+	TArray<FTonemapOverrideBakedLUT> LUTs;
+
+	// Safe to call from the render thread once loaded, the asset is not modified at runtime
+	const FTonemapOverrideBakedLUT* Find(uint64 ContentHash, int32 LUTSize, EPixelFormat Format) const;
+
+	// Adds or replaces the LUT with the same key
+	void AddLUT(FTonemapOverrideBakedLUT&& LUT);
+
+	void Reset();
+
+	virtual void PostLoad() override;
+
+private:
+	static uint64 GetKey(uint64 ContentHash, int32 LUTSize, EPixelFormat Format);
+	void RebuildIndex();
+
+	TMap<uint64, int32> LUTIndices;
+};
@@ -0,0 +1,26 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TonemapOverrideBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures the LUT generation cost of every tonemap operator at several LUT sizes in the volume and unwrapped 2D layouts
+ * UnrealEditor-Cmd.exe Project.uproject -run=TonemapOverrideBenchmark -nullrhi [-Size=16,32,48,64] [-Operator=Agx,Flim] [-Iterations=50] [-Output=Dir] [-Name=Name]
+ * Stages are the settings snapshot and cache key update, the change detection of the first plugin version, the CPU LUT generation and,
+ * with -AllowCommandletRendering instead of -nullrhi, the GPU LUT pass
+ * Min / median / p99 / mean are written as CSV and JSON to Saved/TonemapOverride/Benchmark, the TonemapOverride.Perf.LUTBenchmark automation test runs the same
+ * Only timings are measured, the CPU, GPU, shaper, separable curve and pipeline precache checks are the TonemapOverride automation tests
+ */
+UCLASS()
+class UTonemapOverrideBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTonemapOverrideBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
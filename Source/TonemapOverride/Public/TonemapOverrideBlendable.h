@@ -0,0 +1,61 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/BlendableInterface.h"
+#include "TonemapOverrideBlendable.generated.h"
+
+class UTexture;
+
+// Custom operator parameters of a post process volume, added to Post Process Materials of the volume (or a camera)
+// Blended by the volume weight into the LUT generated for the view, so a per area look costs no extra pass
+UCLASS(BlueprintType, EditInlineNew, DisplayName = "TonemapOverride Blendable")
+class TONEMAPOVERRIDE_API UTonemapOverrideBlendable : public UObject, public IBlendableInterface
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Reinhard", meta = (InlineEditConditionToggle))
+	bool bOverride_ReinhardWhitePoint = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Reinhard", meta = (DisplayName = "WhitePoint", ToolTip = "Reinhard Whitepoint", EditCondition = "bOverride_ReinhardWhitePoint"))
+	float ReinhardWhitePoint = 20.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Hejl", meta = (InlineEditConditionToggle))
+	bool bOverride_HejlWhitePoint = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Hejl", meta = (DisplayName = "WhitePoint", ToolTip = "Hejl Whitepoint", EditCondition = "bOverride_HejlWhitePoint"))
+	float HejlWhitePoint = 20.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (InlineEditConditionToggle))
+	bool bOverride_GT7BlendRatio = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (DisplayName = "GT7 Blend Ratio", ToolTip = "GT7 Blend Ratio between Skewed and Scaled Colors", EditCondition = "bOverride_GT7BlendRatio"))
+	float GT7BlendRatio = 0.6f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (InlineEditConditionToggle))
+	bool bOverride_GT7FadeStart = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (DisplayName = "GT7 Fade Start", ToolTip = "GT7 Fade Start", EditCondition = "bOverride_GT7FadeStart"))
+	float GT7FadeStart = 0.98f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (InlineEditConditionToggle))
+	bool bOverride_GT7FadeEnd = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | GT7", meta = (DisplayName = "GT7 Fade End", ToolTip = "GT7 Fade End", EditCondition = "bOverride_GT7FadeEnd"))
+	float GT7FadeEnd = 1.16f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Tony", meta = (InlineEditConditionToggle))
+	bool bOverride_LUTTexture = false;
+
+	// Textures can't be interpolated, the texture is used from half of the volume weight on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Tony", meta = (DisplayName = "LUT Texture", ToolTip = "Tony LUT texture used instead of the one in the plugin settings from half of the volume weight on", EditCondition = "bOverride_LUTTexture"))
+	TObjectPtr<UTexture> LUTTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TonemapOverride | Tony", meta = (DisplayName = "LUT Texture Precomposed", ToolTip = "LUT texture is indexed with the engine LUT log encoding (TonemapOverrideTonyImport -Precompose) instead of the Tony encoding", EditCondition = "bOverride_LUTTexture"))
+	bool bLUTTexturePrecomposed = false;
+
+	// IBlendableInterface
+	virtual void OverrideBlendableSettings(class FSceneView& View, float Weight) const override;
+};
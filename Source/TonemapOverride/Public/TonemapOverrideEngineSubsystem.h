@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/EngineSubsystem.h"
+#include "TonemapOverrideSettings.h"
 #include "TonemapOverrideEngineSubsystem.generated.h"
 
 /**
@@ -19,7 +20,25 @@ public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
+	// Switch the operator at runtime, ie. from a graphics quality menu, by setting r.TonemapOverride.Operator
+	// The LUT pipelines of the compiled operators are precached, switching between them doesn't create pipelines on the fly
+	UFUNCTION(BlueprintCallable, Category = "TonemapOverride")
+	void SetTonemapOperator(ECustomTonemapOperator Operator);
+
+	// Back to the operator of the plugin settings
+	UFUNCTION(BlueprintCallable, Category = "TonemapOverride")
+	void ResetTonemapOperator();
+
 private:
+	void OnPostLoadMapWithWorld(UWorld* World);
+
 	TSharedPtr<class FTonemapOverrideSceneViewExtension, ESPMode::ThreadSafe> TonemapOverrideSceneViewExtension;
+
+	UPROPERTY()
+	TObjectPtr<class UTonemapOverrideBakedLUTs> BakedLUTs;
+
+	// Keeps the asynchronously loaded Tony and Custom LUT textures alive, the settings only hold soft references
+	UPROPERTY()
+	TArray<TObjectPtr<class UTexture>> LUTTextures;
 	
 };
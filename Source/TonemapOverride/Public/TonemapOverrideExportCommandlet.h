@@ -0,0 +1,24 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TonemapOverrideExportCommandlet.generated.h"
+
+/**
+ * Generates the LUT of the plugin settings and optionally a post process volume on the CPU and writes it for grading applications
+ * UnrealEditor-Cmd.exe Project.uproject -run=TonemapOverrideExport -nullrhi [-Size=33,65] [-Format=cube,spi3d,exr] [-Operator=Agx]
+ *     [-Volume=/Game/Maps/Map.Map:PersistentLevel.PostProcessVolume_0] [-Output=Dir] [-Name=BaseName] [-Shaper]
+ * -Shaper fits a 1D pre-curve to the operator so smaller LUTs keep their accuracy, see r.TonemapOverride.CPU.ShaperReport
+ */
+UCLASS()
+class UTonemapOverrideExportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTonemapOverrideExportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
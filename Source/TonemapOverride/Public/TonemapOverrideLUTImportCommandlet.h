@@ -0,0 +1,25 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TonemapOverrideLUTImportCommandlet.generated.h"
+
+/**
+ * Imports a .cube / .3dl 3D LUT as the volume texture of the Custom LUT operator
+ * UnrealEditor-Cmd.exe Project.uproject -run=TonemapOverrideLUTImport -File=Look.cube [-Asset=/Game/TonemapOverride/CustomLUT]
+ *     [-Input=EngineLog|ACEScct|Linear] [-Output=sRGB|Linear] [-Size=33]
+ * -Input and -Output are the encodings the LUT was authored for, -Size resamples the LUT to another lattice size
+ * The texture, encodings and the domain of the file are assigned to the plugin settings
+ */
+UCLASS()
+class UTonemapOverrideLUTImportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTonemapOverrideLUTImportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
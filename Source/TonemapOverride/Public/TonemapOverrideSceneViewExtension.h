@@ -10,17 +10,27 @@
 #include "PostProcess/PostProcessTonemap.h"
 #include "TonemapOverrideSettings.h"
 
-struct FCachedLUTSettings;
+struct FTonemapOverrideLUTSnapshot;
+struct FTonemapOverrideCPULUTJob;
+struct FTonemapOverrideCPUTexture3D;
+class FTonemapOverrideLUTCache;
+class UTonemapOverrideBakedLUTs;
+class FSceneViewState;
+class FRHIGPUTextureReadback;
 
 class TONEMAPOVERRIDE_API FTonemapOverrideSceneViewExtension : public FSceneViewExtensionBase
 {
 public:
-	FTonemapOverrideSceneViewExtension(const FAutoRegister& AutoRegister);
+	FTonemapOverrideSceneViewExtension(const FAutoRegister& AutoRegister, const UTonemapOverrideBakedLUTs* InBakedLUTs);
+	virtual ~FTonemapOverrideSceneViewExtension();
 
 	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {};
 	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {};
 	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {};
 
+	// Early in the frame, changed LUTs are generated on the async compute queue (r.TonemapOverride.AsyncCompute)
+	virtual void PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily) override;
+
 	// With small modifications to Engine SceneViewExtension.h and PostProcessCombineLUT.cpp we can more gracefully implement a custom tonemapper
 #if ENGINE_VERSION_CUSTOM == true
 	virtual void SubscribeToPostProcessCombineLUTPass(const FSceneView& InView, FTonemapLUTCallbackDelegateArray& LUTPassCallbacks) override;
@@ -35,17 +45,109 @@ public:
 #endif
 
 private:
-	// Internal render call
-	FRDGTextureRef RenderOverrideLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, FRDGTextureRef OutputTexture, FCachedLUTSettings& CachedLUTSettings, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize);
-
 #if ENGINE_VERSION_CUSTOM == true
 	// For the engine modification, callback from PostProcessCombineLUT
 	FRDGTextureRef CreateOverrideLUT_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, FRDGTextureRef OutputTexture);
 #else
 	// MotionBlur SVE callback for hacking the Tonemap pass without modified engine
 	FScreenPassTexture CreateOverrideLUT(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs);
+
+	// Tonemap SVE callback reading back the view state LUT after the engine LUT pass and the tonemapper (r.TonemapOverride.VerifyViewStateLUT)
+	FScreenPassTexture VerifyViewStateLUT(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs);
 #endif
 
+	// Find the LUT matching the view settings from the cache and generate it if needed
+	FRDGTextureRef GetOrRenderCachedLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FRDGTextureDesc& LUTDesc, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize);
+
+	// Upload the baked LUT or add the generation pass for the snapshot into the cached texture
+	void RenderLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, FRDGTextureRef CachedTexture, const FRDGTextureDesc& LUTDesc, const bool bUseComputePass, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize, const bool bAsyncCompute);
+
+	// Generate a changed LUT a few slices per frame while the view keeps its previous LUT (r.TonemapOverride.TimeSlice.TexelBudget)
+	// Returns nullptr when the LUT should be generated at once
+	FRDGTextureRef GetOrRenderTimeSlicedLUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize);
+
+	// Evaluate a changed LUT on worker threads while the view keeps its previous LUT (r.TonemapOverride.CPULUT)
+	// Returns nullptr when the LUT is ready in the cache or is generated on the GPU, which includes views without a LUT to keep
+	// whose first LUT was not done in time
+	FRDGTextureRef GetOrRenderCPULUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FTonemapOverrideLUTSnapshot& Snapshot, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT, const int32 TextureLUTSize);
+
+	// Start the evaluation of a LUT on worker threads, replacing the job of the view
+	void LaunchCPULUTJob(const uint32 ViewKey, const FTonemapOverrideLUTSnapshot& Snapshot, const EPixelFormat Format, const int32 TextureLUTSize, TSharedPtr<const FTonemapOverrideCPUTexture3D> LUTTexture);
+
+	// Start the first LUT of new views and of views with a changed LUT size or format before the frame is rendered,
+	// the LUT pass uploads it when the workers are done by then and generates it on the GPU otherwise
+	void LaunchFirstCPULUTs(const FSceneViewFamily& ViewFamily);
+
+	// Upload the finished job into its cache entry and make it the LUT the view shows
+	void UploadCPULUT(FRDGBuilder& GraphBuilder, const FViewInfo& View, FTonemapOverrideCPULUTJob& Job, const FRDGTextureDesc& LUTDesc, const bool bUseVolumeTextureLUT);
+
+	// Settings of the LUT the view showed last, nullptr for a new view or when the LUT has been evicted
+	const FTonemapOverrideLUTSnapshot* FindDisplayedSnapshot(const FViewInfo& View) const;
+
+	// Count the operator stages kept by the views against the LUT cache budget
+	void UpdateOperatorStageMemory();
+
+	// LUT pass setup of a view from its last frame, used to generate the LUT ahead of the pass
+	struct FViewLUT
+	{
+		FRDGTextureDesc Desc;
+		int32 TextureLUTSize = 0;
+		bool bUseComputePass = false;
+		bool bUseVolumeTextureLUT = false;
+		// Cache entry the view displayed last, kept on screen while its replacement is generated asynchronously
+		uint64 DisplayedKey = 0;
+		// Cache entry being generated over several frames, swapped in once complete
+		uint64 PendingKey = 0;
+		uint32 LastUsedFrame = 0;
+		// Operator stage of the staged LUT, kept while only the fades, gamma or the output gamut change and released otherwise
+		TRefCountPtr<IPooledRenderTarget> OperatorStage;
+		uint64 OperatorStageHash = 0;
+	};
+
+#if ENGINE_VERSION_CUSTOM != true
+	// What was last copied to the pooled LUT of a view state, so unchanged LUTs are not copied again every frame
+	struct FViewStateLUT
+	{
+		// Pooled LUT the copy went to, the engine allocates a new one when the LUT size or format changes
+		const IPooledRenderTarget* Target = nullptr;
+		// Cache entry that was copied
+		uint64 WrittenKey = 0;
+		uint32 WrittenFrame = 0;
+		// Engine LUT pass may have run after the copy on the frame it was made, so it is made again on the next frame
+		bool bEngineMayOverwrite = false;
+	};
+
+	// Whether the pooled LUT of the view state still holds the cache entry, updates the bookkeeping for the copy when it does not
+	bool NeedsViewStateLUTCopy(FSceneViewState& ViewState, uint32 ViewStateKey, const IPooledRenderTarget* Target, uint64 EntryKey, uint32 FrameNumber);
+
+	// View state LUT read back after the tonemapper and the cache entry it should hold, compared once both are ready
+	struct FViewStateLUTCheck
+	{
+		TSharedPtr<FRHIGPUTextureReadback> ViewStateReadback;
+		TSharedPtr<FRHIGPUTextureReadback> CachedReadback;
+		FIntVector Size = FIntVector::ZeroValue;
+		int32 BytesPerTexel = 0;
+		// Frame the engine LUT pass was expected to run in, see FViewStateLUT::bEngineMayOverwrite
+		bool bEngineMayOverwrite = false;
+	};
+
+	// Compare the finished read backs, counts and logs the frames where the engine LUT pass wrote the view state LUT
+	void ResolveViewStateLUTChecks();
+#endif
+
+	// Render thread only
+	TUniquePtr<FTonemapOverrideLUTCache> LUTCache;
+	TMap<uint32, FViewLUT> ViewLUTs;
+	// CPU evaluated LUT in flight per view
+	TMap<uint32, TSharedPtr<FTonemapOverrideCPULUTJob>> CPULUTJobs;
+#if ENGINE_VERSION_CUSTOM != true
+	TMap<uint32, FViewStateLUT> ViewStateLUTs;
+	TArray<FViewStateLUTCheck> ViewStateLUTChecks;
+#endif
+
+	// Kept alive by the engine subsystem for the lifetime of the extension
+	const UTonemapOverrideBakedLUTs* BakedLUTs = nullptr;
+
 	bool bProcessed = false;
 	bool bCachedOverride = false;
 };
@@ -6,6 +6,8 @@
 #include "Engine/DeveloperSettingsBackedByCVars.h"
 #include "TonemapOverrideSettings.generated.h"
 
+class UTonemapOverrideBakedLUTs;
+
 UENUM(BlueprintType)
 enum class ECustomTonemapOperator : uint8
 {
@@ -18,9 +20,29 @@ enum class ECustomTonemapOperator : uint8
 	GranTurismo,
 	GT7,
 	ACES,
+	CustomLUT,
 	MAX,
 };
 
+// How the operator input (linear sRGB) is encoded into the custom LUT coordinates
+UENUM(BlueprintType)
+enum class ECustomLUTInputEncoding : uint8
+{
+	EngineLog UMETA(ToolTip = "Engine LUT log encoding, the input of the LUTs written by TonemapOverrideExport"),
+	ACEScct UMETA(ToolTip = "ACEScct with AP1 primaries"),
+	Linear UMETA(ToolTip = "Linear values mapped by the LUT domain"),
+	MAX UMETA(Hidden)
+};
+
+// What the custom LUT outputs, the result is converted to linear sRGB for the rest of the LUT pass
+UENUM(BlueprintType)
+enum class ECustomLUTOutputEncoding : uint8
+{
+	sRGB UMETA(ToolTip = "Display encoded with the sRGB transfer function"),
+	Linear UMETA(ToolTip = "Linear display values"),
+	MAX UMETA(Hidden)
+};
+
 UENUM(BlueprintType)
 enum class EGT7UCSType : uint8
 {
@@ -29,6 +51,91 @@ enum class EGT7UCSType : uint8
 	MAX
 };
 
+// Flim parameters, the defaults are the default preset of Flim
+USTRUCT(BlueprintType)
+struct FTonemapOverrideFlimPreset
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ToolTip = "Exposure in stops applied before the film"))
+	float PreExposure = 4.3f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	FLinearColor PreFormationFilter = FLinearColor::White;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PreFormationFilterStrength = 0.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ToolTip = "Scale of the red, green and blue primaries in the extended gamut"))
+	FVector ExtendedGamutScale = FVector(1.05, 1.12, 1.045);
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ToolTip = "Hue rotation of the red, green and blue primaries in degrees"))
+	FVector ExtendedGamutRotation = FVector(0.5, 2.0, 0.1);
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ToolTip = "Multiplier of the red, green and blue primaries"))
+	FVector ExtendedGamutMul = FVector(1.0, 1.0, 1.0);
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float SigmoidLog2Min = -10.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float SigmoidLog2Max = 22.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SigmoidToeX = 0.44f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SigmoidToeY = 0.28f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SigmoidShoulderX = 0.591f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SigmoidShoulderY = 0.779f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float NegativeFilmExposure = 6.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float NegativeFilmDensity = 5.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	FLinearColor PrintBacklight = FLinearColor::White;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float PrintFilmExposure = 6.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float PrintFilmDensity = 27.5f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ToolTip = "Black point of the print, -1 = auto"))
+	float BlackPoint = -1.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	FLinearColor PostFormationFilter = FLinearColor::White;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PostFormationFilterStrength = 0.0f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	float MidtoneSaturation = 1.02f;
+
+	bool operator==(const FTonemapOverrideFlimPreset& Other) const;
+	bool operator!=(const FTonemapOverrideFlimPreset& Other) const { return !(*this == Other); }
+};
+
+USTRUCT(BlueprintType)
+struct FTonemapOverrideFlimNamedPreset
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	FName Name;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "Flim")
+	FTonemapOverrideFlimPreset Preset;
+};
+
 UCLASS(Config=Game, DefaultConfig, DisplayName = "TonemapOverride")
 class TONEMAPOVERRIDE_API UTonemapOverrideSettings : public UDeveloperSettingsBackedByCVars
 {
@@ -44,6 +151,24 @@ public:
 	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Tony", meta = (DisplayName = "LUT Texture", ToolTip = "Texture asset for tonemapper"))
 	TSoftObjectPtr<UTexture> LUTTexture = TSoftObjectPtr<UTexture>(FSoftObjectPath(TEXT("/TonemapOverride/Content/Textures/tony_mc_mapface_f32.tony_mc_mapface_f32")).ResolveObject());
 
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Tony", meta = (DisplayName = "LUT Texture Precomposed", ToolTip = "LUT texture is indexed with the engine LUT log encoding (TonemapOverrideTonyImport -Precompose) instead of the Tony encoding"))
+	bool bLUTTexturePrecomposed = false;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Custom LUT", meta = (DisplayName = "Custom LUT Texture", ToolTip = "Volume texture of the Custom LUT operator, imported from .cube / .3dl with the TonemapOverrideLUTImport commandlet"))
+	TSoftObjectPtr<UTexture> CustomLUTTexture;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Custom LUT", meta = (DisplayName = "Input Encoding", ToolTip = "Encoding of the custom LUT input"))
+	ECustomLUTInputEncoding CustomLUTInput = ECustomLUTInputEncoding::EngineLog;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Custom LUT", meta = (DisplayName = "Output Encoding", ToolTip = "Encoding of the custom LUT output"))
+	ECustomLUTOutputEncoding CustomLUTOutput = ECustomLUTOutputEncoding::sRGB;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Custom LUT", meta = (DisplayName = "Domain Min", ToolTip = "Encoded input mapped to the first texel (DOMAIN_MIN)"))
+	FVector CustomLUTDomainMin = FVector::ZeroVector;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Custom LUT", meta = (DisplayName = "Domain Max", ToolTip = "Encoded input mapped to the last texel (DOMAIN_MAX)"))
+	FVector CustomLUTDomainMax = FVector::OneVector;
+
 	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Reinhard", meta = (DisplayName = "WhitePoint", ToolTip = "Reinhard Whitepoint"))
 	float ReinhardWhitePoint = 20.0;
 
@@ -61,6 +186,27 @@ public:
 
 	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | GT7", meta = (DisplayName = "GT7 Fade End", ToolTip = "GT7 Fade End"))
 	float GT7FadeEnd = 1.16f;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Flim", meta = (DisplayName = "Flim Preset", ToolTip = "Flim preset to use, Default is the built-in default preset", GetOptions = "GetFlimPresetNames"))
+	FName FlimPreset = DefaultFlimPresetName;
+
+	UPROPERTY(Config, BlueprintReadOnly, EditAnywhere, Category = "TonemapOverride | Flim", meta = (DisplayName = "Flim Presets", ToolTip = "Named Flim presets"))
+	TArray<FTonemapOverrideFlimNamedPreset> FlimPresets;
+
+	UPROPERTY(Config, EditAnywhere, Category = "TonemapOverride | Baking", meta = (DisplayName = "Baked LUTs", ToolTip = "Pre-generated LUTs used instead of live generation when the settings match. Created with the TonemapOverrideBake commandlet"))
+	TSoftObjectPtr<UTonemapOverrideBakedLUTs> BakedLUTs;
+
+	UPROPERTY(Config, EditAnywhere, Category = "TonemapOverride | Shaders", meta = (DisplayName = "Compiled Operators", ToolTip = "Operators compiled into the LUT shaders, empty compiles all. ACES is always compiled and used when the selected operator is not compiled", ConfigRestartRequired = true))
+	TArray<ECustomTonemapOperator> CompiledTonemapOperators;
+
+	UPROPERTY(Config, EditAnywhere, Category = "TonemapOverride | Shaders", meta = (DisplayName = "Compile Fast Math Variants", ToolTip = "Compile the fast math permutation of AgX, Flim and GT7 (polynomial log2 / exp2 / pow), used with r.TonemapOverride.FastMath 1", ConfigRestartRequired = true))
+	bool bCompileFastMathVariants = false;
+
+	UPROPERTY(Config, EditAnywhere, Category = "TonemapOverride | Shaders", meta = (DisplayName = "Fast Math Max Delta E", ToolTip = "Largest CIEDE2000 difference to the exact operator over the LUT domain that a fast math variant may have to be used", ClampMin = "0.0", UIMin = "0.0", UIMax = "5.0"))
+	float FastMathMaxDeltaE = 1.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "TonemapOverride | Shaders", meta = (DisplayName = "Compile Batched LUT Pass", ToolTip = "Compile the compute shader generating the LUTs of several views in one dispatch, used with r.TonemapOverride.BatchedLUT 1 for split-screen and side by side viewports", ConfigRestartRequired = true))
+	bool bCompileBatchedLUTPass = false;
 	
 	virtual FName GetContainerName() const override { return FName("Project"); };
 	virtual FName GetCategoryName() const override { return FName("Plugins"); };
@@ -68,4 +214,16 @@ public:
 
 	static UTonemapOverrideSettings& Get();
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// Selected Flim preset, the default preset when the name is not found
+	const FTonemapOverrideFlimPreset& GetFlimPreset() const;
+
+	UFUNCTION()
+	TArray<FName> GetFlimPresetNames() const;
+
+	static const FName DefaultFlimPresetName;
+
 };
\ No newline at end of file
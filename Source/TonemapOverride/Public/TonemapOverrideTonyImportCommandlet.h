@@ -0,0 +1,25 @@
+// Copyright 2025 Ossi Luoto
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TonemapOverrideTonyImportCommandlet.generated.h"
+
+/**
+ * Converts the float32 Tony McMapface LUT texture to a half float volume texture and reports the error of the compact formats
+ * UnrealEditor-Cmd.exe Project.uproject -run=TonemapOverrideTonyImport [-Source=/TonemapOverride/Textures/tony_mc_mapface_f32.tony_mc_mapface_f32]
+ *     [-Asset=/Game/TonemapOverride/TonyLUT] [-Precompose] [-Size=32]
+ * -Precompose resamples the LUT to the engine LUT log encoding at the LUT size (r.LUT.Size by default), the LUT pass then reads it at texel centers
+ * The converted texture is assigned to the plugin settings
+ */
+UCLASS()
+class UTonemapOverrideTonyImportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTonemapOverrideTonyImportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -42,6 +42,7 @@ public class TonemapOverride : ModuleRules
 				"CoreUObject",
 				"DeveloperSettings",
 				"Engine",
+				"ImageWrapper",
 				"NetcodeUnitTest",
 				"Renderer",
 				"Slate",